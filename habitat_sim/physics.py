@@ -3,6 +3,7 @@
 # LICENSE file in the root directory of this source tree.
 
 from habitat_sim._ext.habitat_sim_bindings import (
+    BatchRaycastResults,
     MotionType,
     PhysicsSimulationLibrary,
     RaycastResults,
@@ -11,6 +12,7 @@ from habitat_sim._ext.habitat_sim_bindings import (
 )
 
 __all__ = [
+    "BatchRaycastResults",
     "PhysicsSimulationLibrary",
     "MotionType",
     "VelocityControl",
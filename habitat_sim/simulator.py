@@ -110,6 +110,18 @@ class Simulator(SimulatorBackend):
             )
         )
 
+        if config.sim_cfg.max_texture_resolution == -1:
+            # no texture detail beyond what the largest color sensor can resolve
+            config.sim_cfg.max_texture_resolution = max(
+                (
+                    max(sens_spec.resolution)
+                    for cfg in config.agents
+                    for sens_spec in cfg.sensor_specifications
+                    if sens_spec.sensor_type == SensorType.COLOR
+                ),
+                default=0,
+            )
+
     def __attrs_post_init__(self) -> None:
         self._sanitize_config(self.config)
         self.__set_from_config(self.config)
@@ -574,6 +586,8 @@ class Sensor:
 
         if self._sim.frustum_culling:
             render_flags |= habitat_sim.gfx.Camera.Flags.FRUSTUM_CULLING
+        if self._sim.instancing:
+            render_flags |= habitat_sim.gfx.Camera.Flags.INSTANCING
 
         with self._sensor_object.render_target:
             self._sim.renderer.draw(self._sensor_object, scene, render_flags)
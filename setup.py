@@ -66,6 +66,12 @@ Use "HEADLESS=True pip install ." to build in headless mode with pip""",
         action="store_true",
         help="Build data tool",
     )
+    parser.add_argument(
+        "--build-replay-renderer",
+        dest="build_replay_renderer",
+        action="store_true",
+        help="Build headless gfx replay renderer tool",
+    )
     parser.add_argument(
         "--cmake-args",
         type=str,
@@ -257,6 +263,11 @@ class CMakeBuild(build_ext):
         cmake_args += [
             "-DBUILD_DATATOOL={}".format("ON" if args.build_datatool else "OFF")
         ]
+        cmake_args += [
+            "-DBUILD_REPLAY_RENDERER={}".format(
+                "ON" if args.build_replay_renderer else "OFF"
+            )
+        ]
         cmake_args += ["-DBUILD_WITH_CUDA={}".format("ON" if args.with_cuda else "OFF")]
 
         env = os.environ.copy()
@@ -0,0 +1,208 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "AssetCache.h"
+
+#include <sstream>
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/Context.h>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+namespace {
+Mn::GL::Context* currentContext() {
+  return Mn::GL::Context::hasCurrent() ? &Mn::GL::Context::current()
+                                       : nullptr;
+}
+}  // namespace
+
+AssetCache& AssetCache::instance() {
+  static AssetCache cache;
+  return cache;
+}
+
+std::string AssetCache::makeKey(const AssetInfo& info,
+                                bool loadTextures,
+                                bool buildPhongFromPbr) {
+  std::ostringstream key;
+  key << info.filepath << "|" << static_cast<int>(info.type) << "|"
+      << info.frame << "|" << info.virtualUnitToMeters << "|"
+      << info.requiresLighting << info.splitInstanceMesh << loadTextures
+      << buildPhongFromPbr;
+  return key.str();
+}
+
+AssetCache::Entry::ptr AssetCache::get(const std::string& key,
+                                       Mn::GL::Context* glContext) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (glContext) {
+    flushPendingRelease(glContext);
+  }
+
+  auto it = records_.find(key);
+  if (it == records_.end()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  // mark as most recently used
+  lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+
+  const Entry& cached = *it->second.entry;
+  auto result = Entry::create();
+  result->meshMetaData = cached.meshMetaData;
+  result->cpuMeshes = cached.cpuMeshes;
+  result->cpuByteSize = cached.cpuByteSize;
+  if (cached.hasGPUData() && cached.glContext == glContext) {
+    result->glContext = cached.glContext;
+    result->meshes = cached.meshes;
+    result->textures = cached.textures;
+    result->materials = cached.materials;
+    result->gpuByteSize = cached.gpuByteSize;
+    ++stats_.gpuHits;
+  } else {
+    ++stats_.cpuHits;
+  }
+  return result;
+}
+
+void AssetCache::put(const std::string& key, Entry::ptr entry) {
+  CORRADE_INTERNAL_ASSERT(entry);
+  std::lock_guard<std::mutex> lock(mutex_);
+  Mn::GL::Context* glContext = currentContext();
+
+  // never keep GPU-side data for a context nobody will unregister
+  if (entry->hasGPUData() && contextUsers_.count(entry->glContext) == 0) {
+    releaseGPUData(*entry, glContext);
+  }
+
+  auto it = records_.find(key);
+  if (it != records_.end()) {
+    Entry& existing = *it->second.entry;
+    if (existing.hasGPUData()) {
+      lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+      return;
+    }
+    erase(it, glContext);
+  }
+
+  byteSize_ += byteSizeOf(*entry);
+  lru_.push_back(key);
+  records_.emplace(key, Record{std::move(entry), std::prev(lru_.end())});
+
+  evictToBudget(glContext);
+}
+
+void AssetCache::registerContextUser(Mn::GL::Context* glContext) {
+  CORRADE_INTERNAL_ASSERT(glContext);
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++contextUsers_[glContext];
+}
+
+void AssetCache::unregisterContextUser(Mn::GL::Context* glContext) {
+  CORRADE_INTERNAL_ASSERT(glContext);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto users = contextUsers_.find(glContext);
+  if (users == contextUsers_.end() || --users->second > 0) {
+    return;
+  }
+  contextUsers_.erase(users);
+
+  for (auto& record : records_) {
+    Entry& entry = *record.second.entry;
+    if (entry.glContext == glContext) {
+      byteSize_ -= entry.gpuByteSize;
+      releaseGPUData(entry, glContext);
+    }
+  }
+  flushPendingRelease(glContext);
+}
+
+void AssetCache::setMemoryBudget(std::size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  memoryBudget_ = bytes;
+  evictToBudget(currentContext());
+}
+
+std::size_t AssetCache::getMemoryBudget() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return memoryBudget_;
+}
+
+AssetCache::Stats AssetCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.numEntries = records_.size();
+  stats.byteSize = byteSize_;
+  return stats;
+}
+
+void AssetCache::resetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_ = Stats{};
+}
+
+void AssetCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Mn::GL::Context* glContext = currentContext();
+  while (!records_.empty()) {
+    erase(records_.begin(), glContext);
+  }
+}
+
+void AssetCache::evictToBudget(Mn::GL::Context* glContext) {
+  if (memoryBudget_ == 0) {
+    return;
+  }
+  // never evict the most recently used entry, so that an asset larger than the
+  // whole budget can still be shared while it is in use
+  while (byteSize_ > memoryBudget_ && lru_.size() > 1) {
+    erase(records_.find(lru_.front()), glContext);
+    ++stats_.evictions;
+  }
+}
+
+void AssetCache::erase(std::unordered_map<std::string, Record>::iterator it,
+                       Mn::GL::Context* glContext) {
+  Entry& entry = *it->second.entry;
+  byteSize_ -= byteSizeOf(entry);
+  releaseGPUData(entry, glContext);
+  lru_.erase(it->second.lruPosition);
+  records_.erase(it);
+}
+
+void AssetCache::releaseGPUData(Entry& entry, Mn::GL::Context* glContext) {
+  if (!entry.hasGPUData()) {
+    return;
+  }
+  if (entry.glContext != glContext) {
+    // GL objects may only be destroyed with their own context current; if
+    // this is the last reference, defer destruction until that context is
+    // seen again
+    auto deferred = Entry::create();
+    deferred->glContext = entry.glContext;
+    deferred->meshes = std::move(entry.meshes);
+    deferred->textures = std::move(entry.textures);
+    deferred->materials = std::move(entry.materials);
+    pendingRelease_[entry.glContext].push_back(std::move(deferred));
+  }
+  entry.meshes.clear();
+  entry.textures.clear();
+  entry.materials.clear();
+  entry.glContext = nullptr;
+  entry.gpuByteSize = 0;
+}
+
+void AssetCache::flushPendingRelease(Mn::GL::Context* glContext) {
+  auto it = pendingRelease_.find(glContext);
+  if (it != pendingRelease_.end()) {
+    pendingRelease_.erase(it);
+  }
+}
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,261 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_ASSETCACHE_H_
+#define ESP_ASSETS_ASSETCACHE_H_
+
+/** @file
+ * @brief Class @ref esp::assets::AssetCache
+ */
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Magnum/GL/GL.h>
+#include <Magnum/GL/Texture.h>
+
+#include "Asset.h"
+#include "BaseMesh.h"
+#include "GenericMeshData.h"
+#include "MeshMetaData.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/MaterialData.h"
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief Process-wide, reference-counted cache of loaded render assets, shared
+ * by all @ref ResourceManager instances in the process.
+ *
+ * Entries are keyed by a string built from the @ref AssetInfo and the load
+ * options affecting the produced data (see @ref makeKey). Each entry stores
+ * the CPU-side mesh data of the asset, which can be shared by any @ref
+ * ResourceManager, and optionally the GPU-side meshes, textures and materials
+ * built by one @ref ResourceManager, which can only be shared by @ref
+ * ResourceManager instances rendering with the same GL context.
+ *
+ * Cached data is held by shared pointers, so evicting an entry never frees
+ * data still in use by a @ref ResourceManager. Entries are evicted in least
+ * recently used order whenever the total size of the cached entries exceeds
+ * the memory budget.
+ *
+ * Only general mesh assets (see @ref ResourceManager::loadRenderAssetGeneral)
+ * are cached.
+ */
+class AssetCache {
+ public:
+  /**
+   * @brief A cached asset.
+   */
+  struct Entry {
+    /**
+     * @brief Meta data of the asset, with all index ranges starting at 0.
+     */
+    MeshMetaData meshMetaData;
+
+    /**
+     * @brief Shared CPU-side storage of each mesh of the asset, in the same
+     * order as the meshes were loaded.
+     */
+    std::vector<GenericMeshData::CPUData::ptr> cpuMeshes;
+
+    /**
+     * @brief The GL context the GPU-side data below belongs to, or nullptr if
+     * the entry only holds CPU-side data.
+     */
+    Magnum::GL::Context* glContext = nullptr;
+
+    /** @brief Compiled meshes of the asset, valid only on @ref glContext */
+    std::vector<std::shared_ptr<BaseMesh>> meshes;
+
+    /**
+     * @brief Textures of the asset, valid only on @ref glContext. Entries may
+     * be nullptr for textures which failed to load.
+     */
+    std::vector<std::shared_ptr<Magnum::GL::Texture2D>> textures;
+
+    /**
+     * @brief Materials of the asset, referencing @ref textures. Entries may be
+     * nullptr for materials which failed to load.
+     */
+    std::vector<std::shared_ptr<gfx::MaterialData>> materials;
+
+    /** @brief Approximate size in bytes of the CPU-side data */
+    std::size_t cpuByteSize = 0;
+
+    /** @brief Approximate size in bytes of the GPU-side data */
+    std::size_t gpuByteSize = 0;
+
+    /** @brief Whether the entry holds GPU-side data */
+    bool hasGPUData() const { return glContext != nullptr; }
+
+    ESP_SMART_POINTERS(Entry)
+  };
+
+  /**
+   * @brief Cache usage statistics.
+   */
+  struct Stats {
+    /** @brief Lookups which could reuse GPU-side data */
+    std::size_t gpuHits = 0;
+    /** @brief Lookups which could reuse only CPU-side data */
+    std::size_t cpuHits = 0;
+    /** @brief Lookups which found no entry */
+    std::size_t misses = 0;
+    /** @brief Entries evicted to satisfy the memory budget */
+    std::size_t evictions = 0;
+    /** @brief Current number of entries */
+    std::size_t numEntries = 0;
+    /** @brief Current total size in bytes of all entries */
+    std::size_t byteSize = 0;
+  };
+
+  /**
+   * @brief Returns the process-wide cache instance.
+   */
+  static AssetCache& instance();
+
+  /**
+   * @brief Build the key identifying an asset in the cache.
+   * @param info The @ref AssetInfo the asset was loaded from.
+   * @param loadTextures Whether textures and materials were loaded.
+   * @param buildPhongFromPbr Whether PBR materials were converted to Phong.
+   */
+  static std::string makeKey(const AssetInfo& info,
+                             bool loadTextures,
+                             bool buildPhongFromPbr);
+
+  /**
+   * @brief Look up an asset, marking it as most recently used.
+   * @param key The key of the asset, see @ref makeKey.
+   * @param glContext The GL context current for the caller.
+   * @return A copy of the cached entry, holding its GPU-side data only if it
+   * belongs to @p glContext, or nullptr if not found.
+   */
+  Entry::ptr get(const std::string& key, Magnum::GL::Context* glContext);
+
+  /**
+   * @brief Add or replace an asset, then evict least recently used entries
+   * until the memory budget is satisfied.
+   *
+   * An existing entry holding GPU-side data is not replaced, so that the
+   * context which first loaded an asset keeps sharing it. GPU-side data is
+   * only cached if its context has been registered with @ref
+   * registerContextUser.
+   * @param key The key of the asset, see @ref makeKey.
+   * @param entry The asset data to cache.
+   */
+  void put(const std::string& key, Entry::ptr entry);
+
+  /**
+   * @brief Register a user (typically a @ref ResourceManager) of GPU-side data
+   * on a GL context.
+   */
+  void registerContextUser(Magnum::GL::Context* glContext);
+
+  /**
+   * @brief Unregister a user of GPU-side data on a GL context. Once a context
+   * has no more users, all GPU-side data belonging to it is dropped from the
+   * cache, keeping the CPU-side data. Must be called while the context is
+   * still current.
+   */
+  void unregisterContextUser(Magnum::GL::Context* glContext);
+
+  /**
+   * @brief Set the memory budget in bytes. 0 means no limit.
+   */
+  void setMemoryBudget(std::size_t bytes);
+
+  /**
+   * @brief Get the memory budget in bytes. 0 means no limit.
+   */
+  std::size_t getMemoryBudget() const;
+
+  /**
+   * @brief Get a copy of the current cache statistics.
+   */
+  Stats getStats() const;
+
+  /**
+   * @brief Reset hit, miss and eviction counters.
+   */
+  void resetStats();
+
+  /**
+   * @brief Remove all entries from the cache. Data still in use by a @ref
+   * ResourceManager is kept alive by it.
+   */
+  void clear();
+
+ private:
+  AssetCache() = default;
+
+  struct Record {
+    Entry::ptr entry;
+    std::list<std::string>::iterator lruPosition;
+  };
+
+  /**
+   * @brief Size in bytes an entry counts against the budget.
+   */
+  static std::size_t byteSizeOf(const Entry& entry) {
+    return entry.cpuByteSize + (entry.hasGPUData() ? entry.gpuByteSize : 0);
+  }
+
+  /**
+   * @brief Evict least recently used entries until within budget. Must be
+   * called with @ref mutex_ held.
+   */
+  void evictToBudget(Magnum::GL::Context* glContext);
+
+  /**
+   * @brief Remove an entry from the cache. Must be called with @ref mutex_
+   * held.
+   */
+  void erase(std::unordered_map<std::string, Record>::iterator it,
+             Magnum::GL::Context* glContext);
+
+  /**
+   * @brief Detach the GPU-side data of an entry. If the entry belongs to a
+   * context other than the current one, the data is kept in @ref
+   * pendingRelease_ until it can be destroyed with its context current. Must
+   * be called with @ref mutex_ held.
+   */
+  void releaseGPUData(Entry& entry, Magnum::GL::Context* glContext);
+
+  /**
+   * @brief Destroy GPU-side data deferred for the given context. Must be
+   * called with @ref mutex_ held and the context current.
+   */
+  void flushPendingRelease(Magnum::GL::Context* glContext);
+
+  mutable std::mutex mutex_;
+
+  std::unordered_map<std::string, Record> records_;
+
+  //! Keys in least (front) to most (back) recently used order.
+  std::list<std::string> lru_;
+
+  //! Number of registered users per GL context.
+  std::map<Magnum::GL::Context*, int> contextUsers_;
+
+  //! GPU-side data which has to be destroyed with its own context current.
+  std::map<Magnum::GL::Context*, std::vector<Entry::ptr>> pendingRelease_;
+
+  std::size_t memoryBudget_ = 0;
+  std::size_t byteSize_ = 0;
+  Stats stats_;
+};
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_ASSETCACHE_H_
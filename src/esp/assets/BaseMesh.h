@@ -24,6 +24,10 @@
 #include "esp/gfx/magnum.h"
 
 namespace esp {
+namespace gfx {
+class InstancedMesh;
+}
+
 namespace assets {
 
 /**
@@ -121,6 +125,14 @@ class BaseMesh {
    * sub-component of the asset.
    */
   virtual Magnum::GL::Mesh* getMagnumGLMesh(int) { return nullptr; }
+
+  /**
+   * @brief Get a pointer to the instanced variant of the compiled rendering
+   * buffer, see @ref gfx::GenericDrawable::drawInstances.
+   *
+   * Always nullptr for @ref BaseMesh.
+   */
+  virtual gfx::InstancedMesh* getInstancedMesh() { return nullptr; }
   Corrade::Containers::Optional<Magnum::Trade::MeshData>& getMeshData() {
     return meshData_;
   }
@@ -7,14 +7,46 @@
 #include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/DebugStl.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/MeshTools/Compile.h>
+#include <Magnum/MeshTools/GenerateNormals.h>
 #include <Magnum/MeshTools/Interleave.h>
+#include <Magnum/MeshTools/Reference.h>
+
+#include "esp/gfx/RenderCamera.h"
+
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
 namespace esp {
 namespace assets {
 
+namespace {
+
+/**
+ * @brief Copy of @p meshData with normals added, as
+ * MeshTools::CompileFlag::GenerateSmoothNormals would generate them: smooth
+ * for indexed meshes, flat otherwise.
+ */
+Mn::Trade::MeshData withSmoothNormals(const Mn::Trade::MeshData& meshData) {
+  const Cr::Containers::Array<Mn::Vector3> positions =
+      meshData.positions3DAsArray();
+  Cr::Containers::Array<Mn::Vector3> normals;
+  if (meshData.isIndexed()) {
+    const Cr::Containers::Array<Mn::UnsignedInt> indices =
+        meshData.indicesAsArray();
+    normals = Mn::MeshTools::generateSmoothNormals(indices, positions);
+  } else {
+    normals = Mn::MeshTools::generateFlatNormals(positions);
+  }
+  return Mn::MeshTools::interleave(
+      meshData, {Mn::Trade::MeshAttributeData{
+                    Mn::Trade::MeshAttribute::Normal,
+                    Cr::Containers::arrayView(normals)}});
+}
+
+}  // namespace
+
 void GenericMeshData::uploadBuffersToGPU(bool forceReload) {
   if (forceReload) {
     buffersOnGPU_ = false;
@@ -25,13 +57,42 @@ void GenericMeshData::uploadBuffersToGPU(bool forceReload) {
 
   renderingBuffer_.reset();
   renderingBuffer_ = std::make_unique<GenericMeshData::RenderingBuffer>();
-  Magnum::MeshTools::CompileFlags compileFlags{};
+  Cr::Containers::Optional<Mn::Trade::MeshData> meshWithNormals;
   if (needsNormals_ &&
       !meshData_->hasAttribute(Mn::Trade::MeshAttribute::Normal)) {
-    compileFlags |= Magnum::MeshTools::CompileFlag::GenerateSmoothNormals;
+    meshWithNormals = withSmoothNormals(*meshData_);
+  }
+  const Mn::Trade::MeshData& meshData =
+      meshWithNormals ? *meshWithNormals : *meshData_;
+
+  // the buffers are owned here instead of by the mesh, so the instanced
+  // variant can share them
+  RenderingBuffer& buffer = *renderingBuffer_;
+  buffer.vertexBuffer = Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::Array};
+  buffer.vertexBuffer.setData(meshData.vertexData());
+  if (meshData.isIndexed()) {
+    buffer.indexBuffer =
+        Mn::GL::Buffer{Mn::GL::Buffer::TargetHint::ElementArray};
+    buffer.indexBuffer.setData(meshData.indexData());
   }
   // position, normals, uv, colors are bound to corresponding attributes
-  renderingBuffer_->mesh = Magnum::MeshTools::compile(*meshData_, compileFlags);
+  buffer.mesh = Mn::MeshTools::compile(meshData, buffer.indexBuffer,
+                                       buffer.vertexBuffer);
+  // the instanced variant only gets its GL objects when first drawn
+  // instanced, and not at all where instancing isn't supported
+  if (gfx::RenderCamera::isInstancingSupported()) {
+    buffer.instancedMesh = gfx::InstancedMesh::create_unique([this]() {
+      // same vertex layout as the data uploaded above
+      RenderingBuffer& buffer = *renderingBuffer_;
+      if (needsNormals_ &&
+          !meshData_->hasAttribute(Mn::Trade::MeshAttribute::Normal)) {
+        return Mn::MeshTools::compile(withSmoothNormals(*meshData_),
+                                      buffer.indexBuffer, buffer.vertexBuffer);
+      }
+      return Mn::MeshTools::compile(*meshData_, buffer.indexBuffer,
+                                    buffer.vertexBuffer);
+    });
+  }
 
   buffersOnGPU_ = true;
 }
@@ -44,6 +105,14 @@ Magnum::GL::Mesh* GenericMeshData::getMagnumGLMesh() {
   return &(renderingBuffer_->mesh);
 }
 
+gfx::InstancedMesh* GenericMeshData::getInstancedMesh() {
+  if (renderingBuffer_ == nullptr) {
+    return nullptr;
+  }
+
+  return renderingBuffer_->instancedMesh.get();
+}
+
 void GenericMeshData::setMeshData(Magnum::Trade::MeshData&& meshData) {
   /* Interleave the mesh, if not already. This makes the GPU happier (better
      cache locality for vertex fetching) and is a no-op if the source data is
@@ -52,24 +121,37 @@ void GenericMeshData::setMeshData(Magnum::Trade::MeshData&& meshData) {
   /* TODO: Address that non-triangle meshes will have their collisionMeshData_
    * incorrectly calculated */
 
-  meshData_ = Mn::MeshTools::interleave(std::move(meshData));
-
-  collisionMeshData_.primitive = meshData_->primitive();
+  auto cpuData = CPUData::create();
+  cpuData->meshData = Mn::MeshTools::interleave(std::move(meshData));
 
   /* For collision data we need positions as Vector3 in a contiguous array.
      There's little chance the data are stored like that in MeshData, so unpack
      them to an array. */
-  collisionMeshData_.positions = positionData_ =
-      meshData_->positions3DAsArray();
+  cpuData->positionData = cpuData->meshData.positions3DAsArray();
 
   /* For collision data we need indices as UnsignedInt. If the mesh already has
      those, just make the collision data reference them. If not, unpack them
      and store them here. */
+  if (cpuData->meshData.indexType() != Mn::MeshIndexType::UnsignedInt)
+    cpuData->indexData = cpuData->meshData.indicesAsArray();
+
+  setSharedCPUData(cpuData);
+}  // setMeshData
+
+void GenericMeshData::setSharedCPUData(const CPUData::ptr& cpuData) {
+  CORRADE_INTERNAL_ASSERT(cpuData);
+  cpuData_ = cpuData;
+
+  /* meshData_ is a non-owning view on the (possibly shared) storage */
+  meshData_ = Mn::MeshTools::mutableReference(cpuData_->meshData);
+
+  collisionMeshData_.primitive = meshData_->primitive();
+  collisionMeshData_.positions = cpuData_->positionData;
   if (meshData_->indexType() == Mn::MeshIndexType::UnsignedInt)
     collisionMeshData_.indices = meshData_->mutableIndices<Mn::UnsignedInt>();
   else
-    collisionMeshData_.indices = indexData_ = meshData_->indicesAsArray();
-}  // setMeshData
+    collisionMeshData_.indices = cpuData_->indexData;
+}  // setSharedCPUData
 
 void GenericMeshData::importAndSetMeshData(
     Magnum::Trade::AbstractImporter& importer,
@@ -11,11 +11,13 @@
  */
 
 #include <Corrade/Containers/Optional.h>
+#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Trade/AbstractImporter.h>
 
 #include "BaseMesh.h"
 #include "esp/core/esp.h"
+#include "esp/gfx/InstancedMesh.h"
 
 namespace esp {
 namespace assets {
@@ -26,14 +28,57 @@ namespace assets {
  */
 class GenericMeshData : public BaseMesh {
  public:
+  /**
+   * @brief CPU-side storage for an imported mesh. Held by shared pointer so
+   * that several @ref GenericMeshData instances (e.g. belonging to different
+   * @ref ResourceManager instances, see @ref AssetCache) can reference the
+   * same imported data without re-importing it.
+   */
+  struct CPUData {
+    /** @brief The interleaved mesh data owning the vertex and index storage */
+    Magnum::Trade::MeshData meshData{Magnum::MeshPrimitive::Points, 0};
+
+    /**
+     * @brief Unpacked positions referenced by @ref
+     * CollisionMeshData::positions
+     */
+    Corrade::Containers::Array<Magnum::Vector3> positionData;
+
+    /**
+     * @brief Unpacked indices referenced by @ref CollisionMeshData::indices,
+     * empty if @ref meshData already stores 32-bit indices.
+     */
+    Corrade::Containers::Array<Magnum::UnsignedInt> indexData;
+
+    ESP_SMART_POINTERS(CPUData)
+  };
+
   /**
    * @brief Stores render data for the mesh necessary for gltf format.
    */
   struct RenderingBuffer {
+    /**
+     * @brief Vertex data referenced by @ref mesh and @ref instancedMesh.
+     */
+    Magnum::GL::Buffer vertexBuffer{Magnum::NoCreate};
+
+    /**
+     * @brief Index data referenced by @ref mesh and @ref instancedMesh, not
+     * created for non-indexed meshes.
+     */
+    Magnum::GL::Buffer indexBuffer{Magnum::NoCreate};
+
     /**
      * @brief Compiled openGL render data for the mesh.
      */
     Magnum::GL::Mesh mesh;
+
+    /**
+     * @brief Variant of @ref mesh for instanced drawing, sharing its buffers.
+     * Null where instancing isn't supported, see
+     * @ref gfx::RenderCamera::isInstancingSupported.
+     */
+    gfx::InstancedMesh::uptr instancedMesh = nullptr;
   };
 
   /** @brief Constructor. Sets @ref SupportedMeshType::GENERIC_MESH to identify
@@ -82,6 +127,21 @@ class GenericMeshData : public BaseMesh {
   void importAndSetMeshData(Magnum::Trade::AbstractImporter& importer,
                             const std::string& meshName);
 
+  /**
+   * @brief Reference CPU-side mesh data already imported by another @ref
+   * GenericMeshData (see @ref getCPUData), rather than importing it again.
+   * Sets the @ref collisionMeshData_ references. GPU buffers are not shared;
+   * @ref uploadBuffersToGPU must still be called for the current GL context.
+   * @param cpuData The shared CPU-side storage to reference.
+   */
+  void setSharedCPUData(const CPUData::ptr& cpuData);
+
+  /**
+   * @brief Returns the shared CPU-side storage of this mesh, or nullptr if no
+   * mesh data has been set.
+   */
+  const CPUData::ptr& getCPUData() const { return cpuData_; }
+
   /**
    * @brief Returns a pointer to the compiled render data storage structure.
    * @return Pointer to the @ref renderingBuffer_.
@@ -97,6 +157,12 @@ class GenericMeshData : public BaseMesh {
    */
   virtual Magnum::GL::Mesh* getMagnumGLMesh() override;
 
+  /**
+   * @brief Returns a pointer to the instanced variant of the compiled render
+   * mesh stored in the @ref renderingBuffer_.
+   */
+  gfx::InstancedMesh* getInstancedMesh() override;
+
  protected:
   /**
    * @brief Storage structure for compiled render data. We will use a smart
@@ -108,10 +174,10 @@ class GenericMeshData : public BaseMesh {
   bool needsNormals_ = true;
 
  private:
-  /* Internal; can store data referenced by positions / indices if the original
-     MeshData doesn't have them in desired type */
-  Corrade::Containers::Array<Magnum::Vector3> positionData_;
-  Corrade::Containers::Array<Magnum::UnsignedInt> indexData_;
+  /* Internal; owns the imported MeshData referenced by meshData_ and can store
+     data referenced by positions / indices if the original MeshData doesn't
+     have them in desired type. Possibly shared with other instances. */
+  CPUData::ptr cpuData_ = nullptr;
 };
 }  // namespace assets
 }  // namespace esp
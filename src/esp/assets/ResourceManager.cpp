@@ -4,6 +4,10 @@
 
 #include "ResourceManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/PointerStl.h>
 #include <Corrade/PluginManager/Manager.h>
@@ -95,6 +99,12 @@ ResourceManager::ResourceManager(
   buildImporters();
 }
 
+ResourceManager::~ResourceManager() {
+  if (assetCacheContext_ != nullptr) {
+    AssetCache::instance().unregisterContextUser(assetCacheContext_);
+  }
+}
+
 void ResourceManager::buildImporters() {
   // instantiate a primitive importer
   CORRADE_INTERNAL_ASSERT_OUTPUT(
@@ -1088,6 +1098,29 @@ bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
   const std::string dispFileName = Cr::Utility::Directory::filename(filename);
   CHECK(resourceDict_.count(filename) == 0);
 
+  // look the asset up in the process-wide cache shared with other
+  // ResourceManagers
+  std::string cacheKey;
+  AssetCache::Entry::ptr cached = nullptr;
+  if (useSharedAssetCache_) {
+    Mn::GL::Context* glContext = &Mn::GL::Context::current();
+    if (assetCacheContext_ == nullptr) {
+      assetCacheContext_ = glContext;
+      AssetCache::instance().registerContextUser(glContext);
+    }
+    CORRADE_INTERNAL_ASSERT(assetCacheContext_ == glContext);
+    cacheKey = AssetCache::makeKey(info, requiresTextures_,
+                                   bool(flags_ & Flag::BuildPhongFromPbr));
+    cached = AssetCache::instance().get(cacheKey, glContext);
+    // textures managed for residency can't be shared with other
+    // ResourceManagers, their GL objects get recreated
+    if (cached && cached->hasGPUData() && !textureResidency_) {
+      LOG(INFO) << "Reusing loaded meshes, textures and materials for "
+                << dispFileName;
+      return loadRenderAssetFromCache(info, *cached);
+    }
+  }
+
   // Preferred plugins, Basis target GPU format
   importerManager_.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
 #ifdef ESP_BUILD_ASSIMP_SUPPORT
@@ -1168,7 +1201,10 @@ bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
 #endif
   }
 
-  if (!fileImporter_->openFile(filename)) {
+  // with CPU-side mesh data already cached, the file is only needed for
+  // textures and materials
+  const bool needsImporter = !cached || requiresTextures_;
+  if (needsImporter && !fileImporter_->openFile(filename)) {
     LOG(ERROR) << "Cannot open file " << filename;
     return false;
   }
@@ -1179,6 +1215,17 @@ bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
     loadTextures(*fileImporter_, loadedAssetData);
     loadMaterials(*fileImporter_, loadedAssetData);
   }
+  if (cached) {
+    LOG(INFO) << "Reusing loaded mesh data for " << dispFileName;
+    loadMeshesFromCache(*cached, loadedAssetData);
+    loadedAssetData.meshMetaData.root = cached->meshMetaData.root;
+    auto inserted = resourceDict_.emplace(filename, std::move(loadedAssetData));
+    // publish this context's GPU-side data, if the cache has none for the
+    // asset anymore
+    AssetCache::instance().put(cacheKey,
+                               buildAssetCacheEntry(inserted.first->second));
+    return true;
+  }
   loadMeshes(*fileImporter_, loadedAssetData);
   auto inserted = resourceDict_.emplace(filename, std::move(loadedAssetData));
   MeshMetaData& meshMetaData = inserted.first->second.meshMetaData;
@@ -1211,9 +1258,156 @@ bool ResourceManager::loadRenderAssetGeneral(const AssetInfo& info) {
   meshMetaData.root.transformFromLocalToParent =
       R * meshMetaData.root.transformFromLocalToParent;
 
+  if (useSharedAssetCache_) {
+    AssetCache::instance().put(cacheKey,
+                               buildAssetCacheEntry(inserted.first->second));
+  }
+
   return true;
 }
 
+namespace {
+//! Copy a material so that it can be owned by another ShaderManager
+std::unique_ptr<gfx::MaterialData> cloneMaterialData(
+    const gfx::MaterialData& material) {
+  switch (material.type) {
+    case gfx::MaterialDataType::Phong:
+      return std::make_unique<gfx::PhongMaterialData>(
+          static_cast<const gfx::PhongMaterialData&>(material));
+    case gfx::MaterialDataType::Pbr:
+      return std::make_unique<gfx::PbrMaterialData>(
+          static_cast<const gfx::PbrMaterialData&>(material));
+    case gfx::MaterialDataType::None:
+      break;
+  }
+  return std::make_unique<gfx::MaterialData>(material);
+}
+
+//! Offset a cached, 0-based index range to start at @p start
+std::pair<int, int> rebaseIndexRange(const std::pair<int, int>& range,
+                                     int start) {
+  if (range.first == ID_UNDEFINED) {
+    return range;
+  }
+  return std::make_pair(start + range.first, start + range.second);
+}
+
+//! Offset an index range to start at 0
+std::pair<int, int> zeroBaseIndexRange(const std::pair<int, int>& range) {
+  if (range.first == ID_UNDEFINED) {
+    return range;
+  }
+  return std::make_pair(0, range.second - range.first);
+}
+}  // namespace
+
+bool ResourceManager::loadRenderAssetFromCache(
+    const AssetInfo& info,
+    const AssetCache::Entry& cached) {
+  CORRADE_INTERNAL_ASSERT(cached.glContext == assetCacheContext_);
+  LoadedAssetData loadedAssetData{info, cached.meshMetaData};
+  MeshMetaData& meshMetaData = loadedAssetData.meshMetaData;
+
+  meshMetaData.meshIndex =
+      rebaseIndexRange(cached.meshMetaData.meshIndex, nextMeshID_);
+  for (const auto& mesh : cached.meshes) {
+    meshes_.emplace(nextMeshID_++, mesh);
+  }
+
+  meshMetaData.textureIndex =
+      rebaseIndexRange(cached.meshMetaData.textureIndex, nextTextureID_);
+  for (const auto& texture : cached.textures) {
+    textures_.emplace(nextTextureID_++, texture);
+  }
+
+  // the cached materials reference the shared textures, so they can be copied
+  // as they are
+  meshMetaData.materialIndex =
+      rebaseIndexRange(cached.meshMetaData.materialIndex, nextMaterialID_);
+  for (const auto& material : cached.materials) {
+    int currentMaterialID = nextMaterialID_++;
+    if (material) {
+      shaderManager_.set(std::to_string(currentMaterialID),
+                         cloneMaterialData(*material).release());
+    }
+  }
+
+  resourceDict_.emplace(info.filepath, std::move(loadedAssetData));
+  return true;
+}  // ResourceManager::loadRenderAssetFromCache
+
+void ResourceManager::loadMeshesFromCache(const AssetCache::Entry& cached,
+                                          LoadedAssetData& loadedAssetData) {
+  int meshStart = nextMeshID_;
+  int meshEnd = meshStart + static_cast<int>(cached.cpuMeshes.size()) - 1;
+  nextMeshID_ = meshEnd + 1;
+  loadedAssetData.meshMetaData.setMeshIndices(meshStart, meshEnd);
+
+  for (int iMesh = 0; iMesh <= meshEnd - meshStart; ++iMesh) {
+    auto gltfMeshData = std::make_unique<GenericMeshData>(
+        loadedAssetData.assetInfo.requiresLighting);
+    gltfMeshData->setSharedCPUData(cached.cpuMeshes[iMesh]);
+    gltfMeshData->BB = computeMeshBB(gltfMeshData.get());
+    gltfMeshData->uploadBuffersToGPU(false);
+    meshes_.emplace(meshStart + iMesh, std::move(gltfMeshData));
+  }
+}  // ResourceManager::loadMeshesFromCache
+
+AssetCache::Entry::ptr ResourceManager::buildAssetCacheEntry(
+    const LoadedAssetData& loadedAssetData) {
+  const MeshMetaData& meshMetaData = loadedAssetData.meshMetaData;
+  auto entry = AssetCache::Entry::create();
+  entry->meshMetaData = meshMetaData;
+  entry->meshMetaData.meshIndex = zeroBaseIndexRange(meshMetaData.meshIndex);
+  entry->meshMetaData.textureIndex =
+      zeroBaseIndexRange(meshMetaData.textureIndex);
+  entry->meshMetaData.materialIndex =
+      zeroBaseIndexRange(meshMetaData.materialIndex);
+  // only share CPU-side data if textures are managed for residency
+  entry->glContext = textureResidency_ ? nullptr : assetCacheContext_;
+
+  for (int iMesh = meshMetaData.meshIndex.first;
+       iMesh <= meshMetaData.meshIndex.second; ++iMesh) {
+    const std::shared_ptr<BaseMesh>& mesh = meshes_.at(iMesh);
+    const GenericMeshData::CPUData::ptr& cpuData =
+        static_cast<GenericMeshData&>(*mesh).getCPUData();
+    const std::size_t meshByteSize = cpuData->meshData.vertexData().size() +
+                                     cpuData->meshData.indexData().size();
+    entry->cpuByteSize += meshByteSize +
+                          cpuData->positionData.size() * sizeof(Mn::Vector3) +
+                          cpuData->indexData.size() * sizeof(Mn::UnsignedInt);
+    entry->cpuMeshes.push_back(cpuData);
+    if (entry->hasGPUData()) {
+      entry->gpuByteSize += meshByteSize;
+      entry->meshes.push_back(mesh);
+    }
+  }
+  if (!entry->hasGPUData()) {
+    return entry;
+  }
+
+  if (meshMetaData.textureIndex.first != ID_UNDEFINED) {
+    for (int iTexture = meshMetaData.textureIndex.first;
+         iTexture <= meshMetaData.textureIndex.second; ++iTexture) {
+      entry->textures.push_back(textures_.at(iTexture));
+    }
+    entry->gpuByteSize += loadedAssetData.textureByteSize;
+  }
+
+  if (meshMetaData.materialIndex.first != ID_UNDEFINED) {
+    for (int iMaterial = meshMetaData.materialIndex.first;
+         iMaterial <= meshMetaData.materialIndex.second; ++iMaterial) {
+      Mn::Resource<gfx::MaterialData> material =
+          shaderManager_.get<gfx::MaterialData>(std::to_string(iMaterial));
+      entry->materials.push_back(
+          material ? std::shared_ptr<gfx::MaterialData>(
+                         cloneMaterialData(*material))
+                   : nullptr);
+    }
+  }
+  return entry;
+}  // ResourceManager::buildAssetCacheEntry
+
 scene::SceneNode* ResourceManager::createRenderAssetInstanceGeneralPrimitive(
     const RenderAssetInstanceCreationInfo& creation,
     scene::SceneNode* parent,
@@ -1698,77 +1892,241 @@ void ResourceManager::loadTextures(Importer& importer,
   nextTextureID_ = textureEnd + 1;
   loadedAssetData.meshMetaData.setTextureIndices(textureStart, textureEnd);
 
-  for (int iTexture = 0; iTexture < importer.textureCount(); ++iTexture) {
-    auto currentTextureID = textureStart + iTexture;
-    textures_.emplace(currentTextureID,
-                      std::make_shared<Magnum::GL::Texture2D>());
-    auto& currentTexture = textures_.at(currentTextureID);
-
-    auto textureData = importer.texture(iTexture);
-    if (!textureData ||
-        textureData->type() != Magnum::Trade::TextureData::Type::Texture2D) {
+  // the Basis target format picked in loadRenderAssetGeneral()
+  std::string basisTargetFormat;
+  if (Cr::PluginManager::PluginMetadata* const metadata =
+          importerManager_.metadata("BasisImporter")) {
+    basisTargetFormat = metadata->configuration().value("format");
+  }
+
+  const int textureCount = importer.textureCount();
+  std::vector<Cr::Containers::Optional<Mn::Trade::TextureData>> textureData(
+      textureCount);
+  std::vector<std::vector<Mn::Trade::ImageData2D>> textureLevels(
+      textureCount);
+  std::vector<int> texturesToImport;
+  for (int iTexture = 0; iTexture < textureCount; ++iTexture) {
+    textureData[iTexture] = importer.texture(iTexture);
+    if (!textureData[iTexture] ||
+        textureData[iTexture]->type() !=
+            Magnum::Trade::TextureData::Type::Texture2D) {
       LOG(ERROR) << "Cannot load texture " << iTexture << " skipping";
-      currentTexture = nullptr;
+      textureData[iTexture] = Cr::Containers::NullOpt;
+      continue;
+    }
+
+    // images pre-transcoded to the Basis target format can be used as-is,
+    // whatever their source format
+    if (transcodedTextureCache_) {
+      Cr::Containers::Optional<std::vector<Mn::Trade::ImageData2D>>
+          cachedLevels = transcodedTextureCache_->load(
+              loadedAssetData.assetInfo.filepath,
+              textureData[iTexture]->image(), basisTargetFormat);
+      if (cachedLevels) {
+        textureLevels[iTexture] = std::move(*cachedLevels);
+        continue;
+      }
+    }
+    texturesToImport.push_back(iTexture);
+  }
+
+  // Load all mip levels of the remaining textures, possibly in parallel
+  importTextureImages(importer, loadedAssetData.assetInfo.filepath,
+                      basisTargetFormat, textureData, texturesToImport,
+                      textureLevels);
+
+  // Upload in texture order, independently of how the import got scheduled
+  for (int iTexture = 0; iTexture < textureCount; ++iTexture) {
+    auto currentTextureID = textureStart + iTexture;
+    // Mip level loading failed, fail the whole texture
+    if (!textureData[iTexture] || textureLevels[iTexture].empty()) {
+      textures_.emplace(currentTextureID, nullptr);
       continue;
     }
+    auto texture = std::make_shared<Magnum::GL::Texture2D>();
+    uploadTexture(*texture, *textureData[iTexture],
+                  std::move(textureLevels[iTexture]), loadedAssetData);
+    textures_.emplace(currentTextureID, std::move(texture));
+  }
+}  // ResourceManager::loadTextures
 
-    // Configure the texture
-    Mn::GL::Texture2D& texture = *(textures_.at(textureStart + iTexture).get());
-    texture.setMagnificationFilter(textureData->magnificationFilter())
-        .setMinificationFilter(textureData->minificationFilter(),
-                               textureData->mipmapFilter())
-        .setWrapping(textureData->wrapping().xy());
-
-    // Load all mip levels
-    const std::uint32_t levelCount =
-        importer.image2DLevelCount(textureData->image());
-    bool generateMipmap = false;
+void ResourceManager::importTextureImages(
+    Importer& importer,
+    const std::string& filename,
+    const std::string& basisTargetFormat,
+    const std::vector<Cr::Containers::Optional<Mn::Trade::TextureData>>&
+        textureData,
+    const std::vector<int>& texturesToImport,
+    std::vector<std::vector<Mn::Trade::ImageData2D>>& textureLevels) {
+  auto importLevels = [&](Importer& imageImporter, int iTexture) {
+    const Mn::UnsignedInt image = textureData[iTexture]->image();
+    const std::uint32_t levelCount = imageImporter.image2DLevelCount(image);
+    std::vector<Mn::Trade::ImageData2D>& levels = textureLevels[iTexture];
+    levels.reserve(levelCount);
     for (std::uint32_t level = 0; level != levelCount; ++level) {
       // TODO:
       // it seems we have a way to just load the image once in this case,
       // as long as the image2DName include the full path to the image
-      Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
-          importer.image2D(textureData->image(), level);
-      if (!image) {
+      Cr::Containers::Optional<Mn::Trade::ImageData2D> imageData =
+          imageImporter.image2D(image, level);
+      if (!imageData) {
         LOG(ERROR) << "Cannot load texture image, skipping";
-        currentTexture = nullptr;
-        break;
+        levels.clear();
+        return;
       }
+      levels.push_back(std::move(*imageData));
+    }
+  };
 
-      Mn::GL::TextureFormat format;
-      if (image->isCompressed()) {
-        format = Mn::GL::textureFormat(image->compressedFormat());
-      } else {
-        format = Mn::GL::textureFormat(image->format());
-      }
+  std::size_t threadCount =
+      textureLoadThreadCount_ > 0
+          ? static_cast<std::size_t>(textureLoadThreadCount_)
+          : std::thread::hardware_concurrency();
+  threadCount = std::min(threadCount, texturesToImport.size());
+  if (threadCount <= 1) {
+    for (int iTexture : texturesToImport) {
+      importLevels(importer, iTexture);
+    }
+    return;
+  }
 
-      // For the very first level, allocate the texture
-      if (level == 0) {
-        // If there is just one level and the image is not compressed, we'll
-        // generate mips ourselves
-        if (levelCount == 1 && !image->isCompressed()) {
-          texture.setStorage(Mn::Math::log2(image->size().max()) + 1, format,
-                             image->size());
-          generateMipmap = true;
-        } else
-          texture.setStorage(levelCount, format, image->size());
-      }
+  // Neither importers nor plugin managers are thread-safe, and the scene
+  // importers instantiate the image importers doing the actual decoding and
+  // Basis transcoding through their manager, so each worker gets its own of
+  // both
+  std::vector<std::unique_ptr<Cr::PluginManager::Manager<Importer>>> managers;
+  std::vector<Cr::Containers::Pointer<Importer>> importers;
+  for (std::size_t iThread = 0; iThread != threadCount; ++iThread) {
+#ifdef MAGNUM_BUILD_STATIC
+    // avoid using plugins that might depend on different library versions
+    managers.push_back(
+        std::make_unique<Cr::PluginManager::Manager<Importer>>("nonexistent"));
+#else
+    managers.push_back(std::make_unique<Cr::PluginManager::Manager<Importer>>());
+#endif
+    Cr::PluginManager::Manager<Importer>& manager = *managers.back();
+    manager.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
+#ifdef ESP_BUILD_ASSIMP_SUPPORT
+    manager.setPreferredPlugins("ObjImporter", {"AssimpImporter"});
+#endif
+    if (Cr::PluginManager::PluginMetadata* const metadata =
+            manager.metadata("BasisImporter")) {
+      metadata->configuration().setValue("format", basisTargetFormat);
+    }
+    Cr::Containers::Pointer<Importer> workerImporter =
+        manager.loadAndInstantiate("AnySceneImporter");
+    if (!workerImporter || !workerImporter->openFile(filename)) {
+      LOG(WARNING) << "Cannot open " << filename
+                   << " for parallel texture import";
+      break;
+    }
+    importers.push_back(std::move(workerImporter));
+  }
+  if (importers.empty()) {
+    for (int iTexture : texturesToImport) {
+      importLevels(importer, iTexture);
+    }
+    return;
+  }
 
-      if (image->isCompressed())
-        texture.setCompressedSubImage(level, {}, *image);
-      else
-        texture.setSubImage(level, {}, *image);
+  // Each worker writes only the levels of the textures it picked, so the
+  // result doesn't depend on the scheduling
+  std::atomic<std::size_t> nextTexture{0};
+  auto work = [&](Importer& workerImporter) {
+    for (std::size_t i = nextTexture++; i < texturesToImport.size();
+         i = nextTexture++) {
+      importLevels(workerImporter, texturesToImport[i]);
     }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t iThread = 1; iThread < importers.size(); ++iThread) {
+    threads.emplace_back(work, std::ref(*importers[iThread]));
+  }
+  work(*importers[0]);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}  // ResourceManager::importTextureImages
 
-    // Mip level loading failed, fail the whole texture
-    if (currentTexture == nullptr)
-      continue;
+void ResourceManager::uploadTexture(Mn::GL::Texture2D& texture,
+                                    const Mn::Trade::TextureData& textureData,
+                                    std::vector<Mn::Trade::ImageData2D>&& levels,
+                                    LoadedAssetData& loadedAssetData) {
+  // With a full mip chain available, let the residency manager decide which
+  // levels get uploaded
+  if (textureResidency_ && levels.size() > 1) {
+    gfx::TextureResidencyManager::SamplerState sampler;
+    sampler.magnificationFilter = textureData.magnificationFilter();
+    sampler.minificationFilter = textureData.minificationFilter();
+    sampler.mipmapFilter = textureData.mipmapFilter();
+    sampler.wrapping = textureData.wrapping().xy();
+    textureResidency_->addTexture(texture, std::move(levels), sampler);
+    loadedAssetData.textureByteSize +=
+        textureResidency_->getTextureByteSize(texture);
+    return;
+  }
+
+  // Configure the texture
+  texture.setMagnificationFilter(textureData.magnificationFilter())
+      .setMinificationFilter(textureData.minificationFilter(),
+                             textureData.mipmapFilter())
+      .setWrapping(textureData.wrapping().xy());
 
-    // Generate a mipmap if requested
-    if (generateMipmap)
-      texture.generateMipmap();
+  const Mn::Trade::ImageData2D& first = levels.front();
+  Mn::GL::TextureFormat format;
+  if (first.isCompressed()) {
+    format = Mn::GL::textureFormat(first.compressedFormat());
+  } else {
+    format = Mn::GL::textureFormat(first.format());
+  }
+
+  // If there is just one level and the image is not compressed, we'll
+  // generate mips ourselves
+  const bool generateMipmap = levels.size() == 1 && !first.isCompressed();
+  if (generateMipmap) {
+    texture.setStorage(Mn::Math::log2(first.size().max()) + 1, format,
+                       first.size());
+  } else {
+    texture.setStorage(levels.size(), format, first.size());
   }
-}  // ResourceManager::loadTextures
+
+  std::size_t textureByteSize = 0;
+  for (std::size_t level = 0; level != levels.size(); ++level) {
+    const Mn::Trade::ImageData2D& image = levels[level];
+    if (image.isCompressed())
+      texture.setCompressedSubImage(level, {}, image);
+    else
+      texture.setSubImage(level, {}, image);
+    textureByteSize += image.data().size();
+  }
+
+  // Generate a mipmap if requested
+  if (generateMipmap) {
+    texture.generateMipmap();
+    // the full mip chain adds about a third to the base level
+    textureByteSize += textureByteSize / 3;
+  }
+  loadedAssetData.textureByteSize += textureByteSize;
+  if (textureResidency_)
+    textureResidency_->addUnmanagedTexture(texture, textureByteSize);
+}  // ResourceManager::uploadTexture
+
+void ResourceManager::setTextureResidency(std::size_t memoryBudget,
+                                          int maxResolution) {
+  if (memoryBudget == 0 && maxResolution <= 0) {
+    // textures already managed keep their current levels
+    if (textureResidency_) {
+      textureResidency_->setMemoryBudget(0);
+      textureResidency_->setMaxResolution(0);
+    }
+    return;
+  }
+  if (!textureResidency_) {
+    textureResidency_ = std::make_unique<gfx::TextureResidencyManager>();
+  }
+  textureResidency_->setMaxResolution(maxResolution);
+  textureResidency_->setMemoryBudget(memoryBudget);
+}  // ResourceManager::setTextureResidency
 
 bool ResourceManager::instantiateAssetsOnDemand(
     const std::string& objectTemplateHandle) {
@@ -1783,15 +2141,22 @@ bool ResourceManager::instantiateAssetsOnDemand(
   // object has acquired a copy of its parent attributes.  No object should
   // ever have a copy of attributes with isDirty == true - any editing of
   // attributes for objects requires object rebuilding.
+  // A copy gets registered, as the library's instance may be read through
+  // snapshots concurrently.
   if (ObjectAttributes->getIsDirty()) {
     CORRADE_ASSERT(
-        (ID_UNDEFINED != getObjectAttributesManager()->registerObject(
-                             ObjectAttributes, objectTemplateHandle)),
+        (ID_UNDEFINED !=
+         getObjectAttributesManager()->registerObject(
+             getObjectAttributesManager()->getObjectCopyByHandle(
+                 objectTemplateHandle),
+             objectTemplateHandle)),
         "ResourceManager::instantiateAssetsOnDemand : Unknown failure "
         "attempting to register modified template :"
             << objectTemplateHandle
             << "before asset instantiation.  Aborting. ",
         false);
+    ObjectAttributes =
+        getObjectAttributesManager()->getObjectByHandle(objectTemplateHandle);
   }
 
   // get render asset handle
@@ -1934,7 +2299,8 @@ void ResourceManager::addComponent(
                    node,                // scene node
                    lightSetupKey,       // lightSetup Key
                    materialKey,         // material key
-                   drawables);          // drawable group
+                   drawables,           // drawable group
+                   meshes_.at(meshID)->getInstancedMesh());  // instanced mesh
 
     // compute the bounding box for the mesh we are adding
     if (computeAbsoluteAABBs) {
@@ -1984,30 +2350,36 @@ void ResourceManager::createDrawable(Mn::GL::Mesh& mesh,
                                      scene::SceneNode& node,
                                      const Mn::ResourceKey& lightSetupKey,
                                      const Mn::ResourceKey& materialKey,
-                                     DrawableGroup* group /* = nullptr */) {
+                                     DrawableGroup* group /* = nullptr */,
+                                     gfx::InstancedMesh* instancedMesh
+                                     /* = nullptr */) {
   const auto& materialDataType =
       shaderManager_.get<gfx::MaterialData>(materialKey)->type;
   switch (materialDataType) {
     case gfx::MaterialDataType::None:
       CORRADE_INTERNAL_ASSERT_UNREACHABLE();
       break;
-    case gfx::MaterialDataType::Phong:
-      node.addFeature<gfx::GenericDrawable>(
+    case gfx::MaterialDataType::Phong: {
+      gfx::GenericDrawable& drawable = node.addFeature<gfx::GenericDrawable>(
           mesh,                // render mesh
           meshAttributeFlags,  // mesh attribute flags
           shaderManager_,      // shader manager
           lightSetupKey,       // lightSetup key
           materialKey,         // material key
           group);              // drawable group
+      drawable.setTextureResidencyManager(textureResidency_.get());
+      drawable.setInstancedMesh(instancedMesh);
       break;
+    }
     case gfx::MaterialDataType::Pbr:
       node.addFeature<gfx::PbrDrawable>(
-          mesh,                // render mesh
-          meshAttributeFlags,  // mesh attribute flags
-          shaderManager_,      // shader manager
-          lightSetupKey,       // lightSetup key
-          materialKey,         // material key
-          group);              // drawable group
+              mesh,                // render mesh
+              meshAttributeFlags,  // mesh attribute flags
+              shaderManager_,      // shader manager
+              lightSetupKey,       // lightSetup key
+              materialKey,         // material key
+              group)               // drawable group
+          .setTextureResidencyManager(textureResidency_.get());
       break;
   }
 }
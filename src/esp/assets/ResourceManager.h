@@ -23,18 +23,22 @@
 #include <Magnum/MeshTools/Compile.h>
 #include <Magnum/MeshTools/Transform.h>
 #include <Magnum/SceneGraph/MatrixTransformation3D.h>
+#include <Magnum/Trade/TextureData.h>
 
 #include "Asset.h"
+#include "AssetCache.h"
 #include "BaseMesh.h"
 #include "CollisionMeshData.h"
 #include "GenericMeshData.h"
 #include "MeshData.h"
 #include "MeshMetaData.h"
 #include "RenderAssetInstanceCreationInfo.h"
+#include "TranscodedTextureCache.h"
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/DrawableGroup.h"
 #include "esp/gfx/MaterialData.h"
 #include "esp/gfx/ShaderManager.h"
+#include "esp/gfx/TextureResidencyManager.h"
 #include "esp/physics/configure.h"
 #include "esp/scene/SceneManager.h"
 #include "esp/scene/SceneNode.h"
@@ -106,7 +110,7 @@ class ResourceManager {
                            Flags flags = {});
 
   /** @brief Destructor */
-  ~ResourceManager() {}
+  ~ResourceManager();
 
   /**
    * @brief This function will build the various @ref Importers used by the
@@ -273,6 +277,15 @@ class ResourceManager {
     return meshes_.at(meshIndex)->meshTransform_;
   }
 
+  /**
+   * @brief Retrieve the collision data of a mesh, referencing the mesh's
+   * CPU-side storage.
+   * @param meshIndex Index of the mesh in @ref meshes_.
+   */
+  const CollisionMeshData& getMeshCollisionData(const int meshIndex) const {
+    return meshes_.at(meshIndex)->getCollisionMeshData();
+  }
+
   /**
    * @brief Retrieve the meta data for a particular asset.
    *
@@ -429,6 +442,71 @@ class ResourceManager {
    */
   inline void setRequiresTextures(bool newVal) { requiresTextures_ = newVal; }
 
+  /**
+   * @brief Sets whether general mesh assets are looked up in, and published
+   * to, the process-wide @ref AssetCache, so that several ResourceManagers in
+   * one process share the loaded data instead of loading it again.
+   */
+  inline void setUseSharedAssetCache(bool newVal) {
+    useSharedAssetCache_ = newVal;
+  }
+
+  /**
+   * @brief Configure texture residency management for textures loaded
+   * afterwards. See @ref gfx::TextureResidencyManager.
+   *
+   * Textures loaded with a full mip chain are uploaded starting from the
+   * largest mip level not exceeding @p maxResolution, and the least recently
+   * drawn ones are demoted to low resolution mips whenever the resident size
+   * exceeds @p memoryBudget. When both are 0, textures are uploaded in full
+   * and never demoted. GPU-side data is not shared through the @ref AssetCache
+   * while residency management is enabled.
+   * @param memoryBudget Budget in bytes for resident texture data, 0 for no
+   * limit.
+   * @param maxResolution Largest texture dimension uploaded, 0 for no limit.
+   */
+  void setTextureResidency(std::size_t memoryBudget, int maxResolution);
+
+  /**
+   * @brief Set the directory of a @ref TranscodedTextureCache to load texture
+   * images from instead of importing them, typically populated with the
+   * datatool `pretranscode_textures` task. Empty (the default) disables it.
+   * Images missing from the cache, or outdated, are imported as usual.
+   */
+  void setTranscodedTextureCacheDir(const std::string& cacheDir) {
+    transcodedTextureCache_ =
+        cacheDir.empty() ? nullptr
+                         : TranscodedTextureCache::create_unique(cacheDir);
+  }
+
+  /**
+   * @brief Set the number of threads importing texture images, which for
+   * Basis compressed textures includes transcoding them. Each thread uses its
+   * own importer. 0 uses one thread per CPU core; 1 (the default) imports on
+   * the calling thread only. Textures are uploaded in the same order
+   * regardless.
+   */
+  void setTextureLoadThreadCount(int threadCount) {
+    textureLoadThreadCount_ = threadCount;
+  }
+
+  /**
+   * @brief Get the texture residency manager, nullptr if texture residency
+   * management is disabled. See @ref setTextureResidency.
+   */
+  gfx::TextureResidencyManager* getTextureResidencyManager() {
+    return textureResidency_.get();
+  }
+
+  /**
+   * @brief Get the texture residency statistics. All zero if texture residency
+   * management is disabled. See @ref setTextureResidency.
+   */
+  gfx::TextureResidencyManager::Stats getTextureResidencyStats() const {
+    return textureResidency_ ? textureResidency_->getStats()
+                             : gfx::TextureResidencyManager::Stats{};
+  }
+
   /**
    * @brief Set a replay recorder so that ResourceManager can notify it about
    * render assets.
@@ -491,6 +569,8 @@ class ResourceManager {
   struct LoadedAssetData {
     AssetInfo assetInfo;
     MeshMetaData meshMetaData;
+    //! Approximate size in bytes of the textures uploaded for this asset
+    std::size_t textureByteSize = 0;
   };
 
   /**
@@ -560,6 +640,43 @@ class ResourceManager {
    */
   void loadTextures(Importer& importer, LoadedAssetData& loadedAssetData);
 
+  /**
+   * @brief Import all mip levels of the images of textures, on several
+   * threads if enabled. See @ref setTextureLoadThreadCount.
+   *
+   * @param importer The importer already loaded with the asset, used when
+   * importing on a single thread.
+   * @param filename The asset file, opened by each worker thread's importer.
+   * @param basisTargetFormat The format Basis images get transcoded to.
+   * @param textureData The importer's texture descriptions, by texture index.
+   * @param texturesToImport Indices of the textures to import.
+   * @param textureLevels Receives the levels of each imported texture, by
+   * texture index. Left empty if importing a texture failed.
+   */
+  void importTextureImages(
+      Importer& importer,
+      const std::string& filename,
+      const std::string& basisTargetFormat,
+      const std::vector<Corrade::Containers::Optional<Mn::Trade::TextureData>>&
+          textureData,
+      const std::vector<int>& texturesToImport,
+      std::vector<std::vector<Mn::Trade::ImageData2D>>& textureLevels);
+
+  /**
+   * @brief Upload all mip levels of a texture, or hand them to the texture
+   * residency manager if enabled. See @ref setTextureResidency.
+   *
+   * @param texture The texture to upload to, without storage allocated.
+   * @param textureData The importer's texture description, for the sampler.
+   * @param levels All mip levels of the image, largest first. If there is a
+   * single uncompressed level, the remaining mips are generated.
+   * @param loadedAssetData The asset's @ref LoadedAssetData object.
+   */
+  void uploadTexture(Mn::GL::Texture2D& texture,
+                     const Mn::Trade::TextureData& textureData,
+                     std::vector<Mn::Trade::ImageData2D>&& levels,
+                     LoadedAssetData& loadedAssetData);
+
   /**
    * @brief Load meshes from importer into assets.
    *
@@ -721,6 +838,36 @@ class ResourceManager {
    */
   bool loadRenderAssetGeneral(const AssetInfo& info);
 
+  /**
+   * @brief Backend for @ref loadRenderAssetGeneral reusing the meshes,
+   * textures and materials of an asset already loaded on the current GL
+   * context by another ResourceManager.
+   * @param info The @ref AssetInfo of the asset.
+   * @param cached The @ref AssetCache entry holding GPU-side data.
+   */
+  bool loadRenderAssetFromCache(const AssetInfo& info,
+                                const AssetCache::Entry& cached);
+
+  /**
+   * @brief Create meshes referencing the CPU-side mesh data of a cached
+   * asset, and upload them for the current GL context.
+   *
+   * Replaces @ref loadMeshes when the asset was previously loaded by another
+   * ResourceManager.
+   * @param cached The @ref AssetCache entry.
+   * @param loadedAssetData The asset's @ref LoadedAssetData object.
+   */
+  void loadMeshesFromCache(const AssetCache::Entry& cached,
+                           LoadedAssetData& loadedAssetData);
+
+  /**
+   * @brief Build an @ref AssetCache entry for a newly loaded general mesh
+   * asset.
+   * @param loadedAssetData The asset's @ref LoadedAssetData object.
+   */
+  AssetCache::Entry::ptr buildAssetCacheEntry(
+      const LoadedAssetData& loadedAssetData);
+
   /**
    * @brief Create a render asset instance.
    *
@@ -869,6 +1016,8 @@ class ResourceManager {
    * @param texture Optional texture for the mesh.
    * @param color Optional color parameter for the shader program. Defaults to
    * white.
+   * @param instancedMesh Optional instanced variant of the render mesh, see
+   * @ref gfx::GenericDrawable::setInstancedMesh.
    */
 
   void createDrawable(Mn::GL::Mesh& mesh,
@@ -876,7 +1025,8 @@ class ResourceManager {
                       scene::SceneNode& node,
                       const Mn::ResourceKey& lightSetupKey,
                       const Mn::ResourceKey& materialKey,
-                      DrawableGroup* group = nullptr);
+                      DrawableGroup* group = nullptr,
+                      gfx::InstancedMesh* instancedMesh = nullptr);
 
   Flags flags_;
 
@@ -905,6 +1055,23 @@ class ResourceManager {
    */
   std::map<int, std::shared_ptr<Mn::GL::Texture2D>> textures_;
 
+  /**
+   * @brief Residency manager of @ref textures_, nullptr if disabled. See @ref
+   * setTextureResidency. Declared after @ref textures_ so it is destroyed
+   * first.
+   */
+  std::unique_ptr<gfx::TextureResidencyManager> textureResidency_;
+
+  /**
+   * @brief See @ref setTranscodedTextureCacheDir, nullptr if disabled.
+   */
+  TranscodedTextureCache::uptr transcodedTextureCache_;
+
+  /**
+   * @brief See @ref setTextureLoadThreadCount.
+   */
+  int textureLoadThreadCount_ = 1;
+
   /**
    * @brief The next available unique ID for loaded materials
    */
@@ -969,6 +1136,17 @@ class ResourceManager {
    */
   bool requiresTextures_ = true;
 
+  /**
+   * @brief See @ref setUseSharedAssetCache.
+   */
+  bool useSharedAssetCache_ = false;
+
+  /**
+   * @brief The GL context this ResourceManager registered with the @ref
+   * AssetCache, nullptr if it did not use the cache yet.
+   */
+  Mn::GL::Context* assetCacheContext_ = nullptr;
+
   /**
    * @brief See @ref setRecorder.
    */
@@ -0,0 +1,278 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TranscodedTextureCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Directory.h>
+#include <Magnum/PixelFormat.h>
+
+#include "esp/io/io.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+namespace esp {
+namespace assets {
+
+namespace {
+
+// bump whenever the layout below changes
+constexpr std::uint32_t CacheFileVersion = 2;
+constexpr char CacheFileMagic[4] = {'E', 'T', 'X', 'C'};
+
+// an image has at most one level per bit of its size
+constexpr std::uint32_t MaxLevelCount = 32;
+
+struct FileHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t sourceSize;
+  std::int64_t sourceModificationTime;
+  std::uint32_t levelCount;
+  //! See formatEnumVersion()
+  std::uint32_t formatEnumVersion;
+};
+
+struct LevelHeader {
+  std::uint32_t isCompressed;
+  //! Value of Magnum::PixelFormat or Magnum::CompressedPixelFormat
+  std::uint32_t format;
+  std::int32_t width;
+  std::int32_t height;
+  std::uint32_t alignment;
+  std::uint32_t reserved;
+  std::uint64_t byteSize;
+};
+
+//! Fingerprint of the Magnum pixel format enum values stored in the level
+//! headers, which change between Magnum versions
+std::uint32_t formatEnumVersion() {
+  const std::uint32_t values[]{
+      std::uint32_t(Mn::PixelFormat::RGBA8Unorm),
+      std::uint32_t(Mn::PixelFormat::Depth32FStencil8UI),
+      std::uint32_t(Mn::CompressedPixelFormat::Bc7RGBAUnorm),
+      std::uint32_t(Mn::CompressedPixelFormat::Astc4x4RGBAUnorm),
+      std::uint32_t(Mn::CompressedPixelFormat::PvrtcRGBA4bppSrgb)};
+  return std::uint32_t(io::hashBytes(values, sizeof(values)));
+}
+
+//! Byte size an image of this level needs, or 0 if the level header doesn't
+//! describe a valid image
+std::uint64_t expectedLevelByteSize(const LevelHeader& levelHeader) {
+  if (levelHeader.width <= 0 || levelHeader.height <= 0) {
+    return 0;
+  }
+  const std::uint64_t width = levelHeader.width;
+  const std::uint64_t height = levelHeader.height;
+  if (levelHeader.isCompressed) {
+    if (levelHeader.format == 0 ||
+        levelHeader.format >
+            std::uint32_t(Mn::CompressedPixelFormat::PvrtcRGBA4bppSrgb)) {
+      return 0;
+    }
+    const auto format = Mn::CompressedPixelFormat(levelHeader.format);
+    const Mn::Vector3i blockSize = Mn::compressedBlockSize(format);
+    return (width + blockSize.x() - 1) / blockSize.x() *
+           ((height + blockSize.y() - 1) / blockSize.y()) *
+           Mn::compressedBlockDataSize(format);
+  }
+  if (levelHeader.format == 0 ||
+      levelHeader.format >
+          std::uint32_t(Mn::PixelFormat::Depth32FStencil8UI) ||
+      Mn::isPixelFormatImplementationSpecific(
+          Mn::PixelFormat(levelHeader.format))) {
+    return 0;
+  }
+  const std::uint64_t alignment = levelHeader.alignment;
+  if (alignment != 1 && alignment != 2 && alignment != 4 && alignment != 8) {
+    return 0;
+  }
+  const std::uint64_t rowSize =
+      width * Mn::pixelSize(Mn::PixelFormat(levelHeader.format));
+  return (rowSize + alignment - 1) / alignment * alignment * height;
+}
+
+//! Datatool and simulator may refer to the same asset by different relative
+//! paths
+std::string absolutePath(const std::string& path) {
+  if (!path.empty() && path[0] == '/') {
+    return path;
+  }
+  return Cr::Utility::Directory::join(Cr::Utility::Directory::current(), path);
+}
+
+}  // namespace
+
+TranscodedTextureCache::TranscodedTextureCache(std::string cacheDir)
+    : cacheDir_(std::move(cacheDir)) {}
+
+std::string TranscodedTextureCache::getCacheFilename(
+    const std::string& sourceFile,
+    unsigned int imageId,
+    const std::string& targetFormat) const {
+  // the hash disambiguates equally named assets in different directories
+  std::ostringstream name;
+  name << Cr::Utility::Directory::filename(sourceFile) << "-" << std::hex
+       << io::hashString(Cr::Utility::Directory::path(absolutePath(sourceFile)))
+       << std::dec
+       << "-" << imageId << "-" << targetFormat << ".etxc";
+  return Cr::Utility::Directory::join(cacheDir_, name.str());
+}
+
+Cr::Containers::Optional<std::vector<Mn::Trade::ImageData2D>>
+TranscodedTextureCache::load(const std::string& sourceFile,
+                             unsigned int imageId,
+                             const std::string& targetFormat) const {
+  const std::string filename =
+      getCacheFilename(sourceFile, imageId, targetFormat);
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.good()) {
+    return Cr::Containers::NullOpt;
+  }
+
+  const std::uint64_t fileSize = io::fileSize(filename);
+  FileHeader header{};
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      !std::equal(header.magic, header.magic + 4, CacheFileMagic) ||
+      header.version != CacheFileVersion ||
+      header.formatEnumVersion != formatEnumVersion() ||
+      header.levelCount > MaxLevelCount) {
+    LOG(WARNING) << "Ignoring invalid transcoded texture cache file "
+                 << filename;
+    return Cr::Containers::NullOpt;
+  }
+  if (header.sourceSize != io::fileSize(sourceFile) ||
+      header.sourceModificationTime != io::fileModificationTime(sourceFile)) {
+    LOG(WARNING) << "Ignoring outdated transcoded texture cache file "
+                 << filename;
+    return Cr::Containers::NullOpt;
+  }
+
+  std::vector<Mn::Trade::ImageData2D> levels;
+  levels.reserve(header.levelCount);
+  std::uint64_t offset = sizeof(header);
+  for (std::uint32_t level = 0; level != header.levelCount; ++level) {
+    LevelHeader levelHeader{};
+    if (!file.read(reinterpret_cast<char*>(&levelHeader),
+                   sizeof(levelHeader))) {
+      break;
+    }
+    offset += sizeof(levelHeader);
+    // never allocate more than the file holds, nor hand Magnum an image
+    // whose format or size doesn't match its data
+    const std::uint64_t expectedByteSize = expectedLevelByteSize(levelHeader);
+    if (levelHeader.byteSize > fileSize - offset || expectedByteSize == 0 ||
+        levelHeader.byteSize < expectedByteSize) {
+      LOG(WARNING) << "Ignoring corrupted transcoded texture cache file "
+                   << filename;
+      return Cr::Containers::NullOpt;
+    }
+    offset += levelHeader.byteSize;
+    Cr::Containers::Array<char> data{Cr::Containers::NoInit,
+                                     std::size_t(levelHeader.byteSize)};
+    if (!file.read(data.data(), data.size())) {
+      break;
+    }
+    const Mn::Vector2i size{levelHeader.width, levelHeader.height};
+    if (levelHeader.isCompressed) {
+      levels.emplace_back(Mn::CompressedPixelFormat(levelHeader.format), size,
+                          std::move(data));
+    } else {
+      levels.emplace_back(
+          Mn::PixelStorage{}.setAlignment(levelHeader.alignment),
+          Mn::PixelFormat(levelHeader.format), size, std::move(data));
+    }
+  }
+  if (levels.size() != header.levelCount) {
+    LOG(WARNING) << "Ignoring truncated transcoded texture cache file "
+                 << filename;
+    return Cr::Containers::NullOpt;
+  }
+  return levels;
+}  // TranscodedTextureCache::load
+
+bool TranscodedTextureCache::save(
+    const std::string& sourceFile,
+    unsigned int imageId,
+    const std::string& targetFormat,
+    const std::vector<Mn::Trade::ImageData2D>& levels) const {
+  for (const Mn::Trade::ImageData2D& image : levels) {
+    const bool isSupported =
+        image.isCompressed()
+            ? !Mn::isCompressedPixelFormatImplementationSpecific(
+                  image.compressedFormat())
+            : !Mn::isPixelFormatImplementationSpecific(image.format()) &&
+                  image.storage().rowLength() == 0 &&
+                  image.storage().skip().isZero();
+    if (!isSupported) {
+      LOG(WARNING) << "Can't cache image " << imageId << " of " << sourceFile
+                   << ", unsupported format or pixel storage";
+      return false;
+    }
+  }
+
+  if (!Cr::Utility::Directory::mkpath(cacheDir_)) {
+    LOG(ERROR) << "Can't create transcoded texture cache directory "
+               << cacheDir_;
+    return false;
+  }
+
+  // write to a temporary file first so concurrent readers never see a
+  // partially written one
+  const std::string filename =
+      getCacheFilename(sourceFile, imageId, targetFormat);
+  const std::string tmpFilename = io::getTemporaryFilename(filename);
+  {
+    std::ofstream file(tmpFilename, std::ios::binary | std::ios::trunc);
+    FileHeader header{};
+    std::copy(CacheFileMagic, CacheFileMagic + 4, header.magic);
+    header.version = CacheFileVersion;
+    header.sourceSize = io::fileSize(sourceFile);
+    header.sourceModificationTime = io::fileModificationTime(sourceFile);
+    header.levelCount = levels.size();
+    header.formatEnumVersion = formatEnumVersion();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const Mn::Trade::ImageData2D& image : levels) {
+      LevelHeader levelHeader{};
+      levelHeader.isCompressed = image.isCompressed();
+      levelHeader.format =
+          image.isCompressed()
+              ? static_cast<std::uint32_t>(image.compressedFormat())
+              : static_cast<std::uint32_t>(image.format());
+      levelHeader.width = image.size().x();
+      levelHeader.height = image.size().y();
+      levelHeader.alignment =
+          image.isCompressed() ? 1 : image.storage().alignment();
+      levelHeader.byteSize = image.data().size();
+      file.write(reinterpret_cast<const char*>(&levelHeader),
+                 sizeof(levelHeader));
+      file.write(image.data().data(), image.data().size());
+    }
+    if (!file.good()) {
+      LOG(ERROR) << "Failed writing transcoded texture cache file "
+                 << tmpFilename;
+      file.close();
+      std::remove(tmpFilename.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+    LOG(ERROR) << "Failed renaming " << tmpFilename << " to " << filename;
+    std::remove(tmpFilename.c_str());
+    return false;
+  }
+  return true;
+}  // TranscodedTextureCache::save
+
+}  // namespace assets
+}  // namespace esp
@@ -0,0 +1,94 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_ASSETS_TRANSCODEDTEXTURECACHE_H_
+#define ESP_ASSETS_TRANSCODEDTEXTURECACHE_H_
+
+/** @file
+ * @brief Class @ref esp::assets::TranscodedTextureCache
+ */
+
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace assets {
+
+/**
+ * @brief On-disk cache of texture images already decoded or transcoded to
+ * their GPU upload format.
+ *
+ * Basis Universal textures are transcoded by the BasisImporter to a target
+ * format chosen at runtime from the GPU capabilities (see @ref
+ * ResourceManager::loadRenderAssetGeneral), which costs significant CPU time
+ * on every load. The datatool `pretranscode_textures` task imports every
+ * texture of an asset once for a given target format and stores all its mip
+ * levels here; @ref ResourceManager then loads them directly, bypassing the
+ * importer.
+ *
+ * Each cached texture image is a file in the cache directory, named after the
+ * source asset path, the image index and the target format. The file stores
+ * the size and modification time of the source asset and is ignored once they
+ * no longer match.
+ */
+class TranscodedTextureCache {
+ public:
+  /**
+   * @brief Constructor
+   * @param cacheDir Directory holding the cached images. Created on @ref save
+   * if it doesn't exist.
+   */
+  explicit TranscodedTextureCache(std::string cacheDir);
+
+  /**
+   * @brief Directory holding the cached images.
+   */
+  const std::string& getCacheDir() const { return cacheDir_; }
+
+  /**
+   * @brief Path of the cache file of an image.
+   * @param sourceFile The asset file the image is imported from.
+   * @param imageId Index of the 2D image in the asset importer.
+   * @param targetFormat The BasisImporter target format, e.g. "Bc7RGBA".
+   */
+  std::string getCacheFilename(const std::string& sourceFile,
+                               unsigned int imageId,
+                               const std::string& targetFormat) const;
+
+  /**
+   * @brief Load all mip levels of a cached image, largest first.
+   * @return The levels, or @ref Corrade::Containers::NullOpt if the image is
+   * not cached, the cache file is invalid or the source file changed since
+   * it was cached.
+   */
+  Corrade::Containers::Optional<std::vector<Magnum::Trade::ImageData2D>> load(
+      const std::string& sourceFile,
+      unsigned int imageId,
+      const std::string& targetFormat) const;
+
+  /**
+   * @brief Store all mip levels of an image, largest first.
+   * @return Whether the cache file was written. Images in
+   * implementation-specific pixel formats can't be cached.
+   */
+  bool save(const std::string& sourceFile,
+            unsigned int imageId,
+            const std::string& targetFormat,
+            const std::vector<Magnum::Trade::ImageData2D>& levels) const;
+
+  ESP_SMART_POINTERS(TranscodedTextureCache)
+
+ private:
+  std::string cacheDir_;
+};
+
+}  // namespace assets
+}  // namespace esp
+
+#endif  // ESP_ASSETS_TRANSCODEDTEXTURECACHE_H_
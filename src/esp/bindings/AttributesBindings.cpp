@@ -315,7 +315,14 @@ void initAttributesBindings(py::module& m) {
           &PhysicsManagerAttributes::getRestitutionCoefficient,
           &PhysicsManagerAttributes::setRestitutionCoefficient,
           R"(Default restitution coefficient for contact modeling.  Can be overridden by
-          stage and object values.)");
+          stage and object values.)")
+      .def_property(
+          "use_stage_bvh_cache",
+          &PhysicsManagerAttributes::getUseStageBvhCache,
+          &PhysicsManagerAttributes::setUseStageBvhCache,
+          R"(Whether to cache the BVHs of static stage collision meshes in files
+          next to the collision assets, to skip building them when loading the
+          stage again.)");
 
   // ==== AbstractPrimitiveAttributes ====
   py::class_<AbstractPrimitiveAttributes, AbstractAttributes,
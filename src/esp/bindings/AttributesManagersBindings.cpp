@@ -83,6 +83,11 @@ void declareBaseAttributesManager(py::module& m,
             that exist in the provided file or directory path. If save_as_defaults
             is true, then these templates will be unable to be deleted)",
           "path"_a, "save_as_defaults"_a = false)
+      .def_property(
+          "num_config_load_threads", &MgrClass::getNumConfigLoadThreads,
+          &MgrClass::setNumConfigLoadThreads,
+          R"(Number of threads reading and parsing config files in load_configs.
+            Setting 0 uses the hardware concurrency.)")
       .def("create_template",
            static_cast<AttribsPtr (MgrClass::*)(const std::string&, bool)>(
                &MgrClass::createObject),
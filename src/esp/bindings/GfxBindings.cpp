@@ -51,6 +51,7 @@ void initGfxBindings(py::module& m) {
 
   flags.value("FRUSTUM_CULLING", RenderCamera::Flag::FrustumCulling)
       .value("OBJECTS_ONLY", RenderCamera::Flag::ObjectsOnly)
+      .value("INSTANCING", RenderCamera::Flag::Instancing)
       .value("NONE", RenderCamera::Flag{});
   corrade::enumOperators(flags);
 
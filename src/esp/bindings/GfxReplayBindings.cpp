@@ -7,6 +7,7 @@
 #include <Magnum/PythonBindings.h>
 #include <Magnum/SceneGraph/PythonBindings.h>
 
+#include "esp/gfx/replay/BinaryKeyframes.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/ReplayManager.h"
 
@@ -18,6 +19,21 @@ namespace gfx {
 namespace replay {
 
 void initGfxReplayBindings(py::module& m) {
+  py::enum_<BinaryTransformPrecision>(
+      m, "BinaryTransformPrecision",
+      R"(How transforms get stored in binary replay files.)")
+      .value("FLOAT32", BinaryTransformPrecision::Float32)
+      .value("FLOAT16_ROTATIONS", BinaryTransformPrecision::Float16Rotations);
+
+  m.def("convert_json_keyframes_to_binary", &convertJsonKeyframesToBinary,
+        "json_filepath"_a, "binary_filepath"_a,
+        "precision"_a = BinaryTransformPrecision::Float32,
+        R"(Convert a JSON replay file to the binary format. Returns whether the conversion succeeded.)");
+
+  m.def("convert_binary_keyframes_to_json", &convertBinaryKeyframesToJson,
+        "binary_filepath"_a, "json_filepath"_a,
+        R"(Convert a binary replay file to JSON. Returns whether the conversion succeeded.)");
+
   py::class_<Player, Player::ptr>(m, "Player")
       .def("get_num_keyframes", &Player::getNumKeyframes,
            R"(Get the currently-set keyframe, or -1 if no keyframe is set.)")
@@ -29,6 +45,18 @@ void initGfxReplayBindings(py::module& m) {
       .def("get_keyframe_index", &Player::getKeyframeIndex,
            R"(Get the number of keyframes read from file.)")
 
+      .def_property(
+          "full_state_keyframe_interval",
+          &Player::getFullStateKeyframeInterval,
+          [](Player& self, int interval) {
+            if (interval <= 0) {
+              throw py::value_error(
+                  "full_state_keyframe_interval must be positive");
+            }
+            self.setFullStateKeyframeInterval(interval);
+          },
+          R"(Number of keyframes between the full-state keyframes set_keyframe_index starts from.)")
+
       .def(
           "get_user_transform",
           [](Player& self, const std::string& name) {
@@ -81,6 +109,45 @@ void initGfxReplayBindings(py::module& m) {
           },
           R"(Write all saved keyframes to a file, then discard the keyframes.)")
 
+      .def(
+          "write_saved_keyframes_to_binary_file",
+          [](ReplayManager& self, const std::string& filepath,
+             BinaryTransformPrecision precision) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            return self.getRecorder()->writeSavedKeyframesToBinaryFile(
+                filepath, precision);
+          },
+          "filepath"_a, "precision"_a = BinaryTransformPrecision::Float32,
+          R"(Write all saved keyframes to a compact binary file, then discard the keyframes.)")
+
+      .def(
+          "start_binary_keyframe_stream",
+          [](ReplayManager& self, const std::string& filepath,
+             BinaryTransformPrecision precision) {
+            if (!self.getRecorder()) {
+              throw std::runtime_error(
+                  "replay save not enabled. See "
+                  "SimulatorConfiguration.enable_gfx_replay_save.");
+            }
+            return self.getRecorder()->startBinaryKeyframeStream(filepath,
+                                                                 precision);
+          },
+          "filepath"_a, "precision"_a = BinaryTransformPrecision::Float32,
+          R"(Write each keyframe to a binary file as soon as it's saved, instead of keeping it in memory.)")
+
+      .def(
+          "stop_binary_keyframe_stream",
+          [](ReplayManager& self) {
+            if (self.getRecorder()) {
+              self.getRecorder()->stopBinaryKeyframeStream();
+            }
+          },
+          R"(Close the file opened by start_binary_keyframe_stream.)")
+
       .def("read_keyframes_from_file", &ReplayManager::readKeyframesFromFile,
            R"(Create a Player object from a replay file.)");
 }
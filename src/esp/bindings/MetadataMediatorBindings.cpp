@@ -22,6 +22,13 @@ void initMetadataMediatorBindings(py::module& m) {
           &MetadataMediator::setActiveSceneDatasetName,
           R"(The currently active dataset being used.  Will attempt to load
             configuration files specified if does not already exist.)")
+      .def_property(
+          "dataset_snapshot_directory",
+          &MetadataMediator::getDatasetSnapshotDirectory,
+          &MetadataMediator::setDatasetSnapshotDirectory,
+          R"(Directory to cache dataset metadata in. Datasets whose configs
+            haven't changed since they were cached are restored from there
+            instead of parsing their configs. Empty disables caching.)")
 
       /* --- Template Manager accessors --- */
       .def_property_readonly(
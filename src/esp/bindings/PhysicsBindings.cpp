@@ -1,4 +1,7 @@
 #include "esp/bindings/bindings.h"
+
+#include <pybind11/numpy.h>
+
 #include "esp/physics/PhysicsManager.h"
 #include "esp/physics/RigidObject.h"
 
@@ -48,6 +51,82 @@ void initPhysicsBindings(py::module& m) {
       .def_readonly("hits", &RaycastResults::hits)
       .def_readonly("ray", &RaycastResults::ray)
       .def("has_hits", &RaycastResults::hasHits);
+
+  // ==== struct object BatchRaycastResults ====
+  // the per-hit arrays are returned as numpy views keeping the results alive,
+  // so large batches neither create a python object per hit nor get copied
+  py::class_<BatchRaycastResults, BatchRaycastResults::ptr>(
+      m, "BatchRaycastResults",
+      R"(Hits of a batch of rays. The hits of ray i are at indices
+      [ray_hit_offsets[i], ray_hit_offsets[i + 1]) of the per-hit arrays,
+      sorted by distance. The arrays are views on the results, which are only
+      valid until the results are reused for another batch.)")
+      .def(py::init(&BatchRaycastResults::create<>))
+      .def_property_readonly(
+          "ray_hit_offsets",
+          [](const py::object& self) {
+            const auto& results = self.cast<const BatchRaycastResults&>();
+            return py::array_t<int>(results.rayHitOffsets.size(),
+                                    results.rayHitOffsets.data(), self);
+          })
+      .def_property_readonly(
+          "object_ids",
+          [](const py::object& self) {
+            const auto& results = self.cast<const BatchRaycastResults&>();
+            return py::array_t<int>(results.objectIds.size(),
+                                    results.objectIds.data(), self);
+          })
+      .def_property_readonly(
+          "points",
+          [](const py::object& self) {
+            const auto& results = self.cast<const BatchRaycastResults&>();
+            return py::array_t<float>(
+                {results.points.size(), std::size_t{3}},
+                reinterpret_cast<const float*>(results.points.data()), self);
+          })
+      .def_property_readonly(
+          "normals",
+          [](const py::object& self) {
+            const auto& results = self.cast<const BatchRaycastResults&>();
+            return py::array_t<float>(
+                {results.normals.size(), std::size_t{3}},
+                reinterpret_cast<const float*>(results.normals.data()), self);
+          })
+      .def_property_readonly(
+          "ray_distances",
+          [](const py::object& self) {
+            const auto& results = self.cast<const BatchRaycastResults&>();
+            return py::array_t<double>(results.rayDistances.size(),
+                                       results.rayDistances.data(), self);
+          })
+      .def_property_readonly("num_rays", &BatchRaycastResults::getNumRays)
+      .def("num_hits",
+           py::overload_cast<>(&BatchRaycastResults::getNumHits, py::const_))
+      .def("num_ray_hits",
+           py::overload_cast<int>(&BatchRaycastResults::getNumHits,
+                                  py::const_),
+           "ray_index"_a);
+
+  // ==== struct object PlacementTestResults ====
+  py::class_<PlacementTestResults, PlacementTestResults::ptr>(
+      m, "PlacementTestResults",
+      R"(Results of testing a batch of candidate poses of an object, one
+      entry per pose.)")
+      .def(py::init(&PlacementTestResults::create<>))
+      .def_property_readonly(
+          "collisions",
+          [](const PlacementTestResults& self) {
+            return py::array_t<bool>(
+                self.collisions.size(),
+                reinterpret_cast<const bool*>(self.collisions.data()));
+          })
+      .def_property_readonly("penetration_depths",
+                             [](const PlacementTestResults& self) {
+                               return py::array_t<double>(
+                                   self.penetrationDepths.size(),
+                                   self.penetrationDepths.data());
+                             })
+      .def_property_readonly("num_poses", &PlacementTestResults::getNumPoses);
 }
 
 }  // namespace physics
@@ -4,6 +4,8 @@
 
 #include "esp/bindings/bindings.h"
 
+#include <pybind11/numpy.h>
+
 #include <Magnum/ImageView.h>
 #include <Magnum/Magnum.h>
 #include <Magnum/SceneGraph/SceneGraph.h>
@@ -24,6 +26,32 @@ using py::literals::operator""_a;
 namespace esp {
 namespace sim {
 
+namespace {
+
+typedef py::array_t<float, py::array::c_style | py::array::forcecast>
+    RayArray;
+
+//! Rays from (N, 3) arrays of origins and directions
+std::vector<esp::geo::Ray> raysFromArrays(const RayArray& origins,
+                                          const RayArray& directions) {
+  if (origins.ndim() != 2 || origins.shape(1) != 3 ||
+      directions.ndim() != 2 || directions.shape(1) != 3 ||
+      origins.shape(0) != directions.shape(0)) {
+    throw py::value_error(
+        "origins and directions must both have shape (N, 3)");
+  }
+  std::vector<esp::geo::Ray> rays(origins.shape(0));
+  auto o = origins.unchecked<2>();
+  auto d = directions.unchecked<2>();
+  for (std::size_t i = 0; i < rays.size(); ++i) {
+    rays[i].origin = Magnum::Vector3{o(i, 0), o(i, 1), o(i, 2)};
+    rays[i].direction = Magnum::Vector3{d(i, 0), d(i, 1), d(i, 2)};
+  }
+  return rays;
+}
+
+}  // namespace
+
 void initSimBindings(py::module& m) {
   // ==== SimulatorConfiguration ====
   py::class_<SimulatorConfiguration, SimulatorConfiguration::ptr>(
@@ -47,6 +75,10 @@ void initSimBindings(py::module& m) {
       .def_readwrite("allow_sliding", &SimulatorConfiguration::allowSliding)
       .def_readwrite("create_renderer", &SimulatorConfiguration::createRenderer)
       .def_readwrite("frustum_culling", &SimulatorConfiguration::frustumCulling)
+      .def_readwrite(
+          "enable_instancing", &SimulatorConfiguration::enableInstancing,
+          R"(Draw drawables sharing the same mesh, material and lights with a
+          single instanced draw call, if supported by the GPU.)")
       .def_readwrite("enable_physics", &SimulatorConfiguration::enablePhysics)
       .def_readwrite(
           "enable_gfx_replay_save",
@@ -69,9 +101,79 @@ void initSimBindings(py::module& m) {
           stage with a semantic mesh. Set to false otherwise.)")
       .def_readwrite("requires_textures",
                      &SimulatorConfiguration::requiresTextures)
+      .def_readwrite(
+          "enable_shared_asset_cache",
+          &SimulatorConfiguration::enableSharedAssetCache,
+          R"(Share loaded meshes, textures and materials with other simulators in
+          this process instead of loading them again.)")
+      .def_readwrite(
+          "shared_asset_cache_budget_mb",
+          &SimulatorConfiguration::sharedAssetCacheBudgetMB,
+          R"(Memory budget of the process-wide asset cache in megabytes, 0 for no
+          limit. Applies to all simulators in this process.)")
+      .def_readwrite(
+          "texture_memory_budget_mb",
+          &SimulatorConfiguration::textureMemoryBudgetMB,
+          R"(Memory budget for resident texture data in megabytes, 0 for no
+          limit. Least recently drawn textures are demoted to low resolution
+          mip levels until drawn again.)")
+      .def_readwrite(
+          "max_texture_resolution",
+          &SimulatorConfiguration::maxTextureResolution,
+          R"(Largest texture dimension uploaded to the GPU, 0 for no limit, -1 to
+          use the largest color sensor resolution.)")
+      .def_readwrite(
+          "transcoded_texture_cache_dir",
+          &SimulatorConfiguration::transcodedTextureCacheDir,
+          R"(Directory of texture images pre-transcoded with the datatool
+          pretranscode_textures task. Empty to always import textures.)")
+      .def_readwrite(
+          "texture_load_threads", &SimulatorConfiguration::textureLoadThreads,
+          R"(Number of threads importing and transcoding textures when loading
+          an asset. 0 for one per CPU core, 1 to import on the calling thread
+          only.)")
       .def(py::self == py::self)
       .def(py::self != py::self);
 
+  // ==== AssetCache ====
+  py::class_<assets::AssetCache::Stats>(m, "AssetCacheStats")
+      .def_readonly("gpu_hits", &assets::AssetCache::Stats::gpuHits)
+      .def_readonly("cpu_hits", &assets::AssetCache::Stats::cpuHits)
+      .def_readonly("misses", &assets::AssetCache::Stats::misses)
+      .def_readonly("evictions", &assets::AssetCache::Stats::evictions)
+      .def_readonly("num_entries", &assets::AssetCache::Stats::numEntries)
+      .def_readonly("byte_size", &assets::AssetCache::Stats::byteSize);
+  m.def(
+      "get_asset_cache_stats",
+      []() { return assets::AssetCache::instance().getStats(); },
+      R"(Hit/miss statistics and size of the process-wide asset cache shared by
+      simulators created with enable_shared_asset_cache.)");
+  m.def(
+      "clear_asset_cache", []() { assets::AssetCache::instance().clear(); },
+      R"(Drop all entries of the process-wide asset cache. Assets in use by a
+      simulator stay loaded.)");
+
+  // ==== TextureResidencyManager ====
+  py::class_<gfx::TextureResidencyManager::Stats>(m, "TextureResidencyStats")
+      .def_readonly("num_textures",
+                    &gfx::TextureResidencyManager::Stats::numTextures)
+      .def_readonly("num_managed_textures",
+                    &gfx::TextureResidencyManager::Stats::numManagedTextures)
+      .def_readonly("num_demoted_textures",
+                    &gfx::TextureResidencyManager::Stats::numDemotedTextures)
+      .def_readonly("resident_bytes",
+                    &gfx::TextureResidencyManager::Stats::residentBytes)
+      .def_readonly("fully_resident_bytes",
+                    &gfx::TextureResidencyManager::Stats::fullyResidentBytes)
+      .def_readonly("skipped_bytes",
+                    &gfx::TextureResidencyManager::Stats::skippedBytes)
+      .def_readonly("demotions",
+                    &gfx::TextureResidencyManager::Stats::demotions)
+      .def_readonly("promotions",
+                    &gfx::TextureResidencyManager::Stats::promotions)
+      .def_readonly("over_budget_frames",
+                    &gfx::TextureResidencyManager::Stats::overBudgetFrames);
+
   // ==== Simulator ====
   py::class_<Simulator, Simulator::ptr>(m, "Simulator")
       .def(py::init<const SimulatorConfiguration&>())
@@ -93,6 +195,9 @@ void initSimBindings(py::module& m) {
       .def_property_readonly(
           "gfx_replay_manager", &Simulator::getGfxReplayManager,
           R"(Use gfx_replay_manager for replay recording and playback.)")
+      .def_property_readonly(
+          "texture_residency_stats", &Simulator::getTextureResidencyStats,
+          R"(Texture memory residency statistics of this simulator.)")
       .def("seed", &Simulator::seed, "new_seed"_a)
       .def("reconfigure", &Simulator::reconfigure, "configuration"_a)
       .def("reset", &Simulator::reset)
@@ -108,6 +213,9 @@ void initSimBindings(py::module& m) {
       .def_property("frustum_culling", &Simulator::isFrustumCullingEnabled,
                     &Simulator::setFrustumCullingEnabled,
                     R"(Enable or disable the frustum culling)")
+      .def_property("instancing", &Simulator::isInstancingEnabled,
+                    &Simulator::setInstancingEnabled,
+                    R"(Enable or disable instanced rendering)")
       .def_property(
           "active_dataset", &Simulator::getActiveSceneDatasetName,
           &Simulator::setActiveSceneDatasetName,
@@ -190,6 +298,9 @@ void initSimBindings(py::module& m) {
           R"(Step the physics simulation by a desired timestep (dt). Note that resulting world time after step may not be exactly t+dt. Use get_world_time to query current simulation time.)")
       .def("get_world_time", &Simulator::getWorldTime,
            R"(Query the current simualtion world time.)")
+      .def("get_updated_object_ids", &Simulator::getUpdatedObjectIDs,
+           "scene_id"_a = 0,
+           R"(Get the ids of the objects moved by the last step_world call. Sleeping and static objects are skipped.)")
       .def("get_gravity", &Simulator::getGravity, "scene_id"_a = 0,
            R"(Query the gravity vector for a scene.)")
       .def("set_gravity", &Simulator::setGravity, "gravity"_a, "scene_id"_a = 0,
@@ -218,6 +329,67 @@ void initSimBindings(py::module& m) {
           "get_rigid_state", &Simulator::getRigidState, "object_id"_a,
           "scene_id"_a = 0,
           R"(Get an object's transformation as a RigidState (i.e. vector, quaternion).)")
+      .def(
+          "get_rigid_states",
+          [](Simulator& self, const std::vector<int>& objectIDs,
+             bool includeVelocities, int sceneID) {
+            // the states get written straight into the numpy array, which
+            // getRigidStates zero-fills if there's no physics
+            const std::size_t stride =
+                includeVelocities
+                    ? std::size_t{esp::physics::PhysicsManager::
+                                      RIGID_STATE_WITH_VELOCITIES_SIZE}
+                    : std::size_t{
+                          esp::physics::PhysicsManager::RIGID_STATE_SIZE};
+            py::array_t<float> states({objectIDs.size(), stride});
+            self.getRigidStates(
+                objectIDs, {states.mutable_data(), std::size_t(states.size())},
+                includeVelocities, sceneID);
+            return states;
+          },
+          "object_ids"_a, "include_velocities"_a = false, "scene_id"_a = 0,
+          R"(Get the states of several objects as an (N, 7) array of translation (x, y, z) and rotation quaternion (x, y, z, w), or an (N, 13) array with linear and angular velocities appended if include_velocities is set. All zeros if the scene has no physics.)")
+      .def(
+          "set_rigid_states",
+          [](Simulator& self, const std::vector<int>& objectIDs,
+             const py::array_t<float, py::array::c_style |
+                                          py::array::forcecast>& states,
+             bool includeVelocities, int sceneID) {
+            const std::size_t stride =
+                includeVelocities
+                    ? std::size_t{esp::physics::PhysicsManager::
+                                      RIGID_STATE_WITH_VELOCITIES_SIZE}
+                    : std::size_t{
+                          esp::physics::PhysicsManager::RIGID_STATE_SIZE};
+            if (std::size_t(states.size()) != objectIDs.size() * stride) {
+              throw py::value_error(
+                  "states must have shape (len(object_ids), " +
+                  std::to_string(stride) + ")");
+            }
+            self.setRigidStates(
+                objectIDs, {states.data(), std::size_t(states.size())},
+                includeVelocities, sceneID);
+          },
+          "object_ids"_a, "states"_a, "include_velocities"_a = false,
+          "scene_id"_a = 0,
+          R"(Set the states of several objects kinematically from an array laid out as returned by get_rigid_states.)")
+      .def(
+          "save_physics_state",
+          [](const Simulator& self, int sceneID) {
+            const std::vector<char> snapshot = self.savePhysicsState(sceneID);
+            return py::bytes(snapshot.data(), snapshot.size());
+          },
+          "scene_id"_a = 0,
+          R"(Save the state of the physical world (objects, motion types, poses, velocities, sleeping state and world time) into a bytes snapshot for restore_physics_state.)")
+      .def(
+          "restore_physics_state",
+          [](Simulator& self, const py::bytes& snapshot, int sceneID) {
+            const std::string data = snapshot;
+            return self.restorePhysicsState({data.begin(), data.end()},
+                                            sceneID);
+          },
+          "snapshot"_a, "scene_id"_a = 0,
+          R"(Restore the state of the physical world from a snapshot of save_physics_state. Objects added since the snapshot are removed. Returns False, leaving the world unchanged, if an object of the snapshot no longer exists.)")
       .def("set_translation", &Simulator::setTranslation, "translation"_a,
            "object_id"_a, "scene_id"_a = 0,
            R"(Set an object's translation and update its simulation state.)")
@@ -274,6 +446,79 @@ void initSimBindings(py::module& m) {
           "cast_ray", &Simulator::castRay, "ray"_a, "max_distance"_a = 100.0,
           "scene_id"_a = 0,
           R"(Cast a ray into the collidable scene and return hit results. Physics must be enabled. max_distance in units of ray length.)")
+      .def(
+          "cast_rays",
+          py::overload_cast<const std::vector<esp::geo::Ray>&, float, bool,
+                            int>(&Simulator::castRays),
+          "rays"_a, "max_distance"_a = 100.0, "closest_only"_a = false,
+          "scene_id"_a = 0, py::call_guard<py::gil_scoped_release>(),
+          R"(Cast a batch of rays into the collidable scene in parallel and return the hits of all of them. Physics must be enabled. max_distance in units of ray length. With closest_only, only the closest hit of each ray is returned.)")
+      .def(
+          "cast_rays",
+          py::overload_cast<const std::vector<esp::geo::Ray>&,
+                            esp::physics::BatchRaycastResults&, float, bool,
+                            int>(&Simulator::castRays),
+          "rays"_a, "results"_a, "max_distance"_a = 100.0,
+          "closest_only"_a = false, "scene_id"_a = 0,
+          py::call_guard<py::gil_scoped_release>(),
+          R"(Cast a batch of rays into caller-owned results, reusing their allocations across batches. Arrays previously obtained from the results become invalid. See the overload returning new results.)")
+      .def(
+          "cast_rays",
+          [](Simulator& self, const RayArray& origins,
+             const RayArray& directions, float maxDistance, bool closestOnly,
+             int sceneID) {
+            const std::vector<esp::geo::Ray> rays =
+                raysFromArrays(origins, directions);
+            // casting doesn't touch python objects
+            py::gil_scoped_release release;
+            return self.castRays(rays, maxDistance, closestOnly, sceneID);
+          },
+          "origins"_a, "directions"_a, "max_distance"_a = 100.0,
+          "closest_only"_a = false, "scene_id"_a = 0,
+          R"(Cast a batch of rays given as (N, 3) arrays of origins and directions. See the overload taking a list of Rays.)")
+      .def(
+          "cast_rays",
+          [](Simulator& self, const RayArray& origins,
+             const RayArray& directions,
+             esp::physics::BatchRaycastResults& results, float maxDistance,
+             bool closestOnly, int sceneID) {
+            const std::vector<esp::geo::Ray> rays =
+                raysFromArrays(origins, directions);
+            py::gil_scoped_release release;
+            self.castRays(rays, results, maxDistance, closestOnly, sceneID);
+          },
+          "origins"_a, "directions"_a, "results"_a, "max_distance"_a = 100.0,
+          "closest_only"_a = false, "scene_id"_a = 0,
+          R"(Cast a batch of rays given as (N, 3) arrays of origins and directions into caller-owned results. See the overload taking a list of Rays and results.)")
+      .def(
+          "test_placements",
+          [](Simulator& self, const std::string& objectTemplateHandle,
+             const py::array_t<float, py::array::c_style |
+                                          py::array::forcecast>& poses,
+             int sceneID) {
+            if (poses.ndim() != 2 || poses.shape(1) != 7) {
+              throw py::value_error("poses must have shape (N, 7)");
+            }
+            std::vector<esp::core::RigidState> states(poses.shape(0));
+            auto p = poses.unchecked<2>();
+            for (std::size_t i = 0; i < states.size(); ++i) {
+              states[i].translation =
+                  Magnum::Vector3{p(i, 0), p(i, 1), p(i, 2)};
+              states[i].rotation = Magnum::Quaternion{
+                  Magnum::Vector3{p(i, 3), p(i, 4), p(i, 5)}, p(i, 6)};
+            }
+            // instantiating the tested template adds an object, which may
+            // call back into python, so it happens before releasing the GIL
+            if (!self.ensurePlacementProbe(objectTemplateHandle, sceneID)) {
+              return self.testPlacements(objectTemplateHandle, states,
+                                         sceneID);
+            }
+            // testing doesn't touch python objects
+            py::gil_scoped_release release;
+            return self.testPlacements(objectTemplateHandle, states, sceneID);
+          },
+          "object_template_handle"_a, "poses"_a, "scene_id"_a = 0,
+          R"(Test whether an object would collide with the collidable scene at each of a batch of candidate poses, without adding it. poses is an (N, 7) array of translations (x, y, z) followed by rotation quaternions (x, y, z, w). Physics must be enabled.)")
       .def("set_object_bb_draw", &Simulator::setObjectBBDraw, "draw_bb"_a,
            "object_id"_a, "scene_id"_a = 0,
            R"(Enable or disable bounding box visualization for an object.)")
@@ -23,7 +23,9 @@ class Configuration {
 
   template <typename T>
   bool set(const std::string& key, const T& value) {
-    return cfg.setValue(key, value);
+    const bool result = cfg.setValue(key, value);
+    valueChanged(key);
+    return result;
   }
   bool setBool(const std::string& key, bool value) { return set(key, value); }
   bool setFloat(const std::string& key, float value) { return set(key, value); }
@@ -81,9 +83,44 @@ class Configuration {
 
   bool hasValue(const std::string& key) const { return cfg.hasValue(key); }
 
-  bool removeValue(const std::string& key) { return cfg.removeValue(key); }
+  bool removeValue(const std::string& key) {
+    const bool result = cfg.removeValue(key);
+    valueChanged(key);
+    return result;
+  }
 
  protected:
+  /**
+   * @brief Called after the value of @p key was set or removed through the
+   * string-keyed interface, or with an empty @p key after all values were
+   * replaced. Subclasses holding frequently read values in typed members
+   * refresh them here, see @ref syncTypedValue.
+   */
+  virtual void valueChanged(CORRADE_UNUSED const std::string& key) {}
+
+  /**
+   * @brief Set a value along with its typed copy, without going through
+   * @ref valueChanged.
+   */
+  template <typename T>
+  void setTypedValue(const std::string& key, const T& value, T& typedValue) {
+    typedValue = value;
+    cfg.setValue(key, value);
+  }
+
+  /**
+   * @brief Refresh @p typedValue from the value of @p key if @p changedKey is
+   * @p key or empty. Meant to be called from @ref valueChanged.
+   */
+  template <typename T>
+  void syncTypedValue(const std::string& changedKey,
+                      const char* key,
+                      T& typedValue) const {
+    if (changedKey.empty() || changedKey == key) {
+      typedValue = cfg.value<T>(key);
+    }
+  }
+
   Corrade::Utility::ConfigurationGroup cfg;
 
   ESP_SMART_POINTERS(Configuration)
@@ -0,0 +1,139 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "HandleIndex.h"
+
+#include <algorithm>
+
+#include <Corrade/Utility/String.h>
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace core {
+
+auto HandleIndex::getTrigrams(const std::string& str) -> std::vector<Trigram> {
+  std::vector<Trigram> res;
+  if (str.length() < 3) {
+    return res;
+  }
+  res.reserve(str.length() - 2);
+  for (std::size_t i = 0; i + 2 < str.length(); ++i) {
+    res.push_back(Trigram(static_cast<unsigned char>(str[i])) << 16 |
+                  Trigram(static_cast<unsigned char>(str[i + 1])) << 8 |
+                  Trigram(static_cast<unsigned char>(str[i + 2])));
+  }
+  std::sort(res.begin(), res.end());
+  res.erase(std::unique(res.begin(), res.end()), res.end());
+  return res;
+}  // HandleIndex::getTrigrams
+
+void HandleIndex::add(int objectID, const std::string& handle) {
+  std::string lowercase = Cr::Utility::String::lowercase(handle);
+  auto iter = lowercaseHandles_.find(objectID);
+  if (iter != lowercaseHandles_.end()) {
+    if (iter->second == lowercase) {
+      return;
+    }
+    remove(objectID);
+  }
+  for (Trigram trigram : getTrigrams(lowercase)) {
+    std::vector<int>& ids = trigramIDs_[trigram];
+    // IDs mostly grow as objects get added, making this an append
+    ids.insert(std::upper_bound(ids.begin(), ids.end(), objectID), objectID);
+  }
+  lowercaseHandles_.emplace(objectID, std::move(lowercase));
+}  // HandleIndex::add
+
+void HandleIndex::remove(int objectID) {
+  auto iter = lowercaseHandles_.find(objectID);
+  if (iter == lowercaseHandles_.end()) {
+    return;
+  }
+  for (Trigram trigram : getTrigrams(iter->second)) {
+    auto idsIter = trigramIDs_.find(trigram);
+    std::vector<int>& ids = idsIter->second;
+    ids.erase(std::lower_bound(ids.begin(), ids.end(), objectID));
+    if (ids.empty()) {
+      trigramIDs_.erase(idsIter);
+    }
+  }
+  lowercaseHandles_.erase(iter);
+}  // HandleIndex::remove
+
+void HandleIndex::clear() {
+  lowercaseHandles_.clear();
+  trigramIDs_.clear();
+}  // HandleIndex::clear
+
+std::vector<int> HandleIndex::find(const std::string& subStr,
+                                   bool contains) const {
+  std::vector<int> res;
+  const std::string strToLookFor = Cr::Utility::String::lowercase(subStr);
+  const std::size_t strSize = strToLookFor.length();
+  auto matches = [&](const std::string& lowercase) {
+    return lowercase.length() >= strSize &&
+           std::string::npos != lowercase.find(strToLookFor);
+  };
+
+  // an empty query matches everything
+  if (strSize == 0) {
+    res.reserve(lowercaseHandles_.size());
+    for (const auto& elem : lowercaseHandles_) {
+      res.push_back(elem.first);
+    }
+    return res;
+  }
+
+  // without trigrams to narrow the search down, check every handle
+  const std::vector<Trigram> trigrams = getTrigrams(strToLookFor);
+  if (trigrams.empty()) {
+    for (const auto& elem : lowercaseHandles_) {
+      // handles shorter than the query never match, either way
+      if (elem.second.length() >= strSize &&
+          matches(elem.second) == contains) {
+        res.push_back(elem.first);
+      }
+    }
+    return res;
+  }
+
+  // candidates are the handles holding the query's rarest trigram
+  const std::vector<int>* candidates = nullptr;
+  for (Trigram trigram : trigrams) {
+    auto iter = trigramIDs_.find(trigram);
+    if (iter == trigramIDs_.end()) {
+      candidates = nullptr;
+      break;
+    }
+    if (candidates == nullptr || iter->second.size() < candidates->size()) {
+      candidates = &iter->second;
+    }
+  }
+  std::vector<int> found;
+  if (candidates != nullptr) {
+    for (int objectID : *candidates) {
+      if (matches(lowercaseHandles_.at(objectID))) {
+        found.push_back(objectID);
+      }
+    }
+  }
+  if (contains) {
+    return found;
+  }
+
+  // everything long enough that wasn't found, merging against sorted matches
+  auto foundIter = found.begin();
+  for (const auto& elem : lowercaseHandles_) {
+    if (foundIter != found.end() && *foundIter == elem.first) {
+      ++foundIter;
+    } else if (elem.second.length() >= strSize) {
+      res.push_back(elem.first);
+    }
+  }
+  return res;
+}  // HandleIndex::find
+
+}  // namespace core
+}  // namespace esp
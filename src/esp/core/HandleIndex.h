@@ -0,0 +1,83 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_HANDLEINDEX_H_
+#define ESP_CORE_HANDLEINDEX_H_
+
+/** @file
+ * @brief Class @ref esp::core::HandleIndex
+ */
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Index of ID-keyed handles answering case-insensitive substring
+ * queries without scanning and lowercasing every handle.
+ *
+ * Each handle is lowercased once, when it's added. Every 3-character sequence
+ * (trigram) of the lowercased handles maps to the sorted IDs of the handles
+ * containing it. A query of at least 3 characters only checks the handles
+ * listed for its rarest trigram; shorter queries check all lowercased handles,
+ * which still saves lowercasing them per query.
+ */
+class HandleIndex {
+ public:
+  /**
+   * @brief Add a handle, replacing the handle already indexed under
+   * @p objectID, if any.
+   */
+  void add(int objectID, const std::string& handle);
+
+  /** @brief Remove the handle indexed under @p objectID, if any */
+  void remove(int objectID);
+
+  /** @brief Remove all handles */
+  void clear();
+
+  /** @brief Number of indexed handles */
+  std::size_t size() const { return lowercaseHandles_.size(); }
+
+  /**
+   * @brief IDs of the handles containing, or not containing, @p subStr,
+   * ignoring case, in ascending order.
+   *
+   * As with @ref ManagedContainerBase::getObjectHandlesBySubstring, handles
+   * shorter than @p subStr match neither way, and an empty @p subStr matches
+   * all handles.
+   * @param subStr substring to search for
+   * @param contains whether to return the handles containing, or not
+   * containing, @p subStr
+   */
+  std::vector<int> find(const std::string& subStr, bool contains) const;
+
+ private:
+  typedef std::uint32_t Trigram;
+
+  /**
+   * @brief The distinct trigrams of a lowercased string
+   */
+  static std::vector<Trigram> getTrigrams(const std::string& str);
+
+  /**
+   * @brief Lowercased handles by ID, in ID order so queries return sorted IDs
+   */
+  std::map<int, std::string> lowercaseHandles_;
+
+  /**
+   * @brief Sorted IDs of the handles containing each trigram
+   */
+  std::unordered_map<Trigram, std::vector<int>> trigramIDs_;
+};
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_HANDLEINDEX_H_
@@ -100,10 +100,7 @@ class ManagedContainer : public ManagedContainerBase {
                  << ". Aborting.";
       return nullptr;
     }
-    // convert doc to const value
-    const io::JsonGenericValue config = docConfig.GetObject();
-    ManagedPtr attr = this->buildManagedObjectFromDoc(filename, config);
-    return this->postCreateRegister(attr, registerObject);
+    return this->createObjectFromJSONDoc(filename, docConfig, registerObject);
   }  // ManagedContainer::createObjectFromJSONFile
 
   /**
@@ -169,6 +166,11 @@ class ManagedContainer : public ManagedContainerBase {
                     "(null) managed object passed to registration. Aborting.";
       return ID_UNDEFINED;
     }
+    // registration modifies the object, so never register the library's own
+    // instance, which snapshots may be reading, but a copy of it
+    if (isLibraryObject(managedObject, managedObject->getID())) {
+      managedObject = copyObject(managedObject);
+    }
     if ("" != objectHandle) {
       return registerObjectFinalize(managedObject, objectHandle,
                                     forceRegistration);
@@ -222,12 +224,13 @@ class ManagedContainer : public ManagedContainerBase {
    * does not exist
    */
   ManagedPtr getObjectByID(int managedObjectID) const {
-    std::string objectHandle = getObjectHandleByID(managedObjectID);
-    if (!checkExistsWithMessage(objectHandle,
+    const std::string* objectHandle = getObjectHandlePtrByID(managedObjectID);
+    if (objectHandle == nullptr ||
+        !checkExistsWithMessage(*objectHandle,
                                 "ManagedContainer::getObjectByID")) {
       return nullptr;
     }
-    return getObjectInternal<T>(objectHandle);
+    return getObjectInternal<T>(*objectHandle);
   }  // ManagedContainer::getObjectByID
 
   /**
@@ -330,12 +333,13 @@ class ManagedContainer : public ManagedContainerBase {
    * does not exist
    */
   ManagedPtr getObjectCopyByID(int managedObjectID) {
-    std::string objectHandle = getObjectHandleByID(managedObjectID);
-    if (!checkExistsWithMessage(objectHandle,
+    const std::string* objectHandle = getObjectHandlePtrByID(managedObjectID);
+    if (objectHandle == nullptr ||
+        !checkExistsWithMessage(*objectHandle,
                                 "ManagedContainer::getObjectCopyByID")) {
       return nullptr;
     }
-    auto orig = getObjectInternal<T>(objectHandle);
+    auto orig = getObjectInternal<T>(*objectHandle);
     return this->copyObject(orig);
   }  // ManagedContainer::getObjectCopyByID
 
@@ -370,7 +374,6 @@ class ManagedContainer : public ManagedContainerBase {
   template <class U>
   std::shared_ptr<U> getObjectCopyByID(int managedObjectID) {
     // call non-template version
-    std::string objectHandle = getObjectHandleByID(managedObjectID);
     auto res = getObjectCopyByID(managedObjectID);
     if (nullptr == res) {
       return nullptr;
@@ -406,11 +409,86 @@ class ManagedContainer : public ManagedContainerBase {
     defaultObj_ = _defaultObj;
   }
 
+  /**
+   * @brief Get the object providing default values upon construction, or
+   * nullptr if there is none. See @ref setDefaultObject.
+   */
+  ManagedPtr getDefaultObject() const { return defaultObj_; }
+
   /**
    * @brief Clear any default objects used for construction.
    */
   void clearDefaultObject() { defaultObj_ = nullptr; }
 
+  /**
+   * @brief Immutable view of the managed objects registered when it was
+   * taken, safe to query from any number of threads without locking while
+   * objects keep getting registered and removed. See @ref getSnapshot.
+   *
+   * The view shares the managed objects with the library; they are returned
+   * as const as they must not be modified. Registering an object with an
+   * existing handle replaces the library's object instead of modifying it,
+   * so views taken before keep seeing the old one.
+   */
+  class Snapshot {
+   public:
+    explicit Snapshot(std::shared_ptr<const LibrarySnapshot> library)
+        : library_(std::move(library)) {}
+
+    /** @brief Number of managed objects in the view */
+    int getNumObjects() const { return library_->objectLibrary.size(); }
+
+    /** @brief Whether the view holds a managed object with this handle */
+    bool getObjectLibHasHandle(const std::string& objectHandle) const {
+      return library_->objectLibrary.count(objectHandle) > 0;
+    }
+
+    /**
+     * @brief Get the managed object with the passed handle, or nullptr if the
+     * view holds none.
+     */
+    std::shared_ptr<const T> getObjectByHandle(
+        const std::string& objectHandle) const {
+      auto iter = library_->objectLibrary.find(objectHandle);
+      if (iter == library_->objectLibrary.end()) {
+        return nullptr;
+      }
+      return std::static_pointer_cast<const T>(iter->second);
+    }
+
+    /**
+     * @brief Get the managed object with the passed ID, or nullptr if the
+     * view holds none.
+     */
+    std::shared_ptr<const T> getObjectByID(int objectID) const {
+      auto iter = library_->objectLibKeyByID.find(objectID);
+      if (iter == library_->objectLibKeyByID.end()) {
+        return nullptr;
+      }
+      return getObjectByHandle(iter->second);
+    }
+
+    /** @brief Handles of all managed objects in the view, in ID order */
+    std::vector<std::string> getObjectHandles() const {
+      std::vector<std::string> res;
+      res.reserve(library_->objectLibKeyByID.size());
+      for (const auto& elem : library_->objectLibKeyByID) {
+        res.push_back(elem.second);
+      }
+      return res;
+    }
+
+   private:
+    std::shared_ptr<const LibrarySnapshot> library_;
+  };
+
+  /**
+   * @brief Take an immutable view of the managed objects currently
+   * registered, for concurrent reads. Views of the same library version share
+   * their storage, so taking one while nothing changes is cheap.
+   */
+  Snapshot getSnapshot() const { return Snapshot{getLibrarySnapshot()}; }
+
  protected:
   //======== Internally accessed functions ========
   /**
@@ -429,6 +507,24 @@ class ManagedContainer : public ManagedContainerBase {
     return (objID == ID_UNDEFINED) ? nullptr : object;
   }  // postCreateRegister
 
+  /**
+   * @brief Build a managed object from a JSON document already read from
+   * @p filename, and register it if specified.
+   *
+   * @param filename the name of the file the document was read from.
+   * @param docConfig the parsed document. Its contents are moved out.
+   * @param registerObject whether to add this managed object to the library.
+   * @return a reference to the desired managed object, or nullptr if fails.
+   */
+  ManagedPtr createObjectFromJSONDoc(const std::string& filename,
+                                     io::JsonDocument& docConfig,
+                                     bool registerObject) {
+    // convert doc to const value
+    const io::JsonGenericValue config = docConfig.GetObject();
+    ManagedPtr attr = this->buildManagedObjectFromDoc(filename, config);
+    return this->postCreateRegister(attr, registerObject);
+  }  // ManagedContainer::createObjectFromJSONDoc
+
   /**
    * @brief Get directory component of managed object handle and call @ref
    * esp::core::AbstractManagedObject::setFileDirectory if a legitimate
@@ -572,19 +668,24 @@ class ManagedContainer : public ManagedContainerBase {
    * @return the managedObjectID of the managed object
    */
   int addObjectToLibrary(ManagedPtr object, const std::string& objectHandle) {
-    // set handle for managed object - might not have been set during
-    // construction
-    object->setHandle(objectHandle);
     // return either the ID of the existing managed object referenced by
     // objectHandle, or the next available ID if not found.
     int objectID = getObjectIDByHandleOrNew(objectHandle, true);
-    object->setID(objectID);
     // make a copy of this managed object so that user can continue to edit
     // original
     ManagedPtr managedObjectCopy = copyObject(object);
+    // set handle for managed object - might not have been set during
+    // construction
+    managedObjectCopy->setHandle(objectHandle);
+    managedObjectCopy->setID(objectID);
+    // the original reflects its registration too, unless it is the library's
+    // own instance
+    if (!isLibraryObject(object, object->getID())) {
+      object->setHandle(objectHandle);
+      object->setID(objectID);
+    }
     // add to libraries
-    setObjectInternal(managedObjectCopy, objectHandle);
-    objectLibKeyByID_.emplace(objectID, objectHandle);
+    setObjectInternal(managedObjectCopy, objectID, objectHandle);
     return objectID;
   }  // ManagedContainer::addObjectToLibrary
 
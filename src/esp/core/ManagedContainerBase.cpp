@@ -42,6 +42,39 @@ bool ManagedContainerBase::setLock(const std::string& objectHandle, bool lock) {
   }
   return true;
 }  // ManagedContainer::setLock
+
+std::shared_ptr<const ManagedContainerBase::LibrarySnapshot>
+ManagedContainerBase::getLibrarySnapshot() const {
+  std::shared_ptr<const LibrarySnapshot> snapshot =
+      std::atomic_load(&librarySnapshot_);
+  if (snapshot != nullptr) {
+    return snapshot;
+  }
+  std::lock_guard<std::mutex> lock(libraryMutex_);
+  // another reader may have rebuilt it while this one waited for the lock
+  snapshot = std::atomic_load(&librarySnapshot_);
+  if (snapshot == nullptr) {
+    auto newSnapshot = std::make_shared<LibrarySnapshot>();
+    newSnapshot->objectLibrary = objectLibrary_;
+    newSnapshot->objectLibKeyByID = objectLibKeyByID_;
+    snapshot = std::move(newSnapshot);
+    std::atomic_store(&librarySnapshot_, snapshot);
+  }
+  return snapshot;
+}  // ManagedContainerBase::getLibrarySnapshot
+
+std::vector<std::string> ManagedContainerBase::getObjectHandlesBySubstring(
+    const std::string& subStr,
+    bool contains) const {
+  std::vector<std::string> res;
+  std::vector<int> objectIDs = objectHandleIndex_.find(subStr, contains);
+  res.reserve(objectIDs.size());
+  for (int objectID : objectIDs) {
+    res.push_back(objectLibKeyByID_.at(objectID));
+  }
+  return res;
+}  // ManagedContainerBase::getObjectHandlesBySubstring
+
 std::string ManagedContainerBase::getRandomObjectHandlePerType(
     const std::map<int, std::string>& mapOfHandles,
     const std::string& type) const {
@@ -14,12 +14,15 @@
 #include <deque>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 
 #include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/String.h>
 
 #include "esp/core/AbstractManagedObject.h"
+#include "esp/core/HandleIndex.h"
 
 #include "esp/io/io.h"
 #include "esp/io/json.h"
@@ -35,6 +38,15 @@ namespace core {
  */
 class ManagedContainerBase {
  public:
+  /**
+   * @brief Frozen copy of the library maps, shared by all readers of the same
+   * library version. See @ref getLibrarySnapshot.
+   */
+  struct LibrarySnapshot {
+    std::map<std::string, std::shared_ptr<void>> objectLibrary;
+    std::map<int, std::string> objectLibKeyByID;
+  };
+
   ManagedContainerBase(const std::string& metadataType)
       : objectType_(metadataType) {}
   virtual ~ManagedContainerBase() = default;
@@ -108,7 +120,8 @@ class ManagedContainerBase {
 
   /**
    * @brief Get a list of all managed objects whose origin handles contain
-   * subStr, ignoring subStr's case
+   * subStr, ignoring subStr's case. Looked up in @ref objectHandleIndex_, so
+   * only the handles that may contain subStr get checked.
    * @param subStr substring to search for within existing managed objects.
    * @param contains whether to search for keys containing, or excluding,
    * passed subStr
@@ -117,10 +130,7 @@ class ManagedContainerBase {
    */
   std::vector<std::string> getObjectHandlesBySubstring(
       const std::string& subStr = "",
-      bool contains = true) const {
-    return getObjectHandlesBySubStringPerType(objectLibKeyByID_, subStr,
-                                              contains);
-  }  // ManagedContainerBase::getObjectHandlesBySubstring
+      bool contains = true) const;
 
   /**
    * @brief returns a vector of managed object handles representing the
@@ -149,8 +159,13 @@ class ManagedContainerBase {
    * @brief clears maps of handle-keyed managed object and ID-keyed handles.
    */
   void reset() {
-    objectLibKeyByID_.clear();
-    objectLibrary_.clear();
+    {
+      std::lock_guard<std::mutex> lock(libraryMutex_);
+      objectLibKeyByID_.clear();
+      objectHandleIndex_.clear();
+      objectLibrary_.clear();
+      invalidateLibrarySnapshot();
+    }
     availableObjectIDs_.clear();
     resetFinalize();
   }  // ManagedContainerBase::reset
@@ -162,16 +177,11 @@ class ManagedContainerBase {
    *
    * @param objectID The unique ID of the desired managed object.
    * @return The key referencing the managed object in @ref
-   * objectLibrary_, or nullptr if does not exist.
+   * objectLibrary_, or an empty string if does not exist.
    */
   std::string getObjectHandleByID(const int objectID) const {
-    if (objectLibKeyByID_.count(objectID) == 0) {
-      LOG(ERROR) << "ManagedContainerBase::getObjectHandleByID : Unknown "
-                 << objectType_ << " managed object ID:" << objectID
-                 << ". Aborting";
-      return nullptr;
-    }
-    return objectLibKeyByID_.at(objectID);
+    const std::string* objectHandle = getObjectHandlePtrByID(objectID);
+    return objectHandle != nullptr ? *objectHandle : std::string{};
   }  // ManagedContainer::getObjectHandleByID
 
   /**
@@ -196,9 +206,40 @@ class ManagedContainerBase {
    */
   const std::string& getObjectType() const { return objectType_; }
 
+  /**
+   * @brief Get an immutable view of the library as of now, safe to read from
+   * any number of threads while the library keeps changing.
+   *
+   * Changes to the library only invalidate the current snapshot; the next
+   * call rebuilds it from the library maps, and all calls until the next
+   * change return that same snapshot without locking. Registering and
+   * removing objects must still happen on one thread at a time.
+   */
+  std::shared_ptr<const LibrarySnapshot> getLibrarySnapshot() const;
+
  protected:
   //======== Internally accessed getter/setter ================
 
+  /**
+   * @brief Get the key in @ref objectLibrary_ for the managed object with the
+   * given unique ID without copying it. The pointer is invalidated once the
+   * object is removed.
+   *
+   * @param objectID The unique ID of the desired managed object.
+   * @return The key held by @ref objectLibKeyByID_, or nullptr if the object
+   * does not exist.
+   */
+  const std::string* getObjectHandlePtrByID(int objectID) const {
+    auto iter = objectLibKeyByID_.find(objectID);
+    if (iter == objectLibKeyByID_.end()) {
+      LOG(ERROR) << "ManagedContainerBase::getObjectHandleByID : Unknown "
+                 << objectType_ << " managed object ID:" << objectID
+                 << ". Aborting";
+      return nullptr;
+    }
+    return &iter->second;
+  }  // ManagedContainerBase::getObjectHandlePtrByID
+
   /**
    * @brief Retrieve shared pointer to object held in library, NOT a copy.
    * @param handle the name of the object held in the smart pointer
@@ -208,15 +249,42 @@ class ManagedContainerBase {
     return std::static_pointer_cast<U>(objectLibrary_.at(handle));
   }
 
+  /**
+   * @brief Whether @p ptr is the instance the library holds under
+   * @p objectID, which snapshots may be reading and so must not be modified.
+   * @param ptr the smart pointer to check
+   * @param objectID the ID of the object @p ptr points to
+   */
+  bool isLibraryObject(const std::shared_ptr<void>& ptr, int objectID) const {
+    auto iter = objectLibKeyByID_.find(objectID);
+    return iter != objectLibKeyByID_.end() &&
+           objectLibrary_.at(iter->second) == ptr;
+  }
+
   /**
    * @brief Only used from class template AddObject method.  put the passed
    * smart poitner in the library.
    * @param ptr the smart pointer to the object being managed
+   * @param objectID the ID of the object being managed
    * @param handle the name (key) to use for the object in the library
    */
   void setObjectInternal(const std::shared_ptr<void>& ptr,
+                         int objectID,
                          const std::string& handle) {
+    std::lock_guard<std::mutex> lock(libraryMutex_);
     objectLibrary_[handle] = ptr;
+    objectLibKeyByID_.emplace(objectID, handle);
+    objectHandleIndex_.add(objectID, handle);
+    invalidateLibrarySnapshot();
+  }
+
+  /**
+   * @brief Drop the published library snapshot after the library maps
+   * changed. Must be called with @ref libraryMutex_ held.
+   */
+  void invalidateLibrarySnapshot() {
+    std::atomic_store(&librarySnapshot_,
+                      std::shared_ptr<const LibrarySnapshot>{});
   }
 
   //======== Common JSON import and utility functions ========
@@ -367,8 +435,13 @@ class ManagedContainerBase {
    * @param objectHandle the handle of the object to remove.
    */
   void deleteObjectInternal(int objectID, const std::string& objectHandle) {
-    objectLibKeyByID_.erase(objectID);
-    objectLibrary_.erase(objectHandle);
+    {
+      std::lock_guard<std::mutex> lock(libraryMutex_);
+      objectLibKeyByID_.erase(objectID);
+      objectHandleIndex_.remove(objectID);
+      objectLibrary_.erase(objectHandle);
+      invalidateLibrarySnapshot();
+    }
     availableObjectIDs_.emplace_front(objectID);
     // call instance-specific update to remove managed object handle from any
     // local lists
@@ -397,6 +470,26 @@ class ManagedContainerBase {
    */
   std::map<int, std::string> objectLibKeyByID_;
 
+  /**
+   * @brief Substring index of the handles in @ref objectLibKeyByID_, kept in
+   * sync with it.
+   */
+  HandleIndex objectHandleIndex_;
+
+  /**
+   * @brief Serializes changes to @ref objectLibrary_, @ref objectLibKeyByID_
+   * and @ref objectHandleIndex_ with rebuilding the library snapshot from
+   * them. Reading them from the thread making the changes needs no lock.
+   */
+  mutable std::mutex libraryMutex_;
+
+  /**
+   * @brief The published library snapshot, or nullptr if the library changed
+   * since it was last built. Only accessed through std::atomic_load and
+   * std::atomic_store.
+   */
+  mutable std::shared_ptr<const LibrarySnapshot> librarySnapshot_;
+
   /**
    * @brief Deque holding all IDs of deleted objects. These ID's should be
    * recycled before using map-size-based IDs
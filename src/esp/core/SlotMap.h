@@ -0,0 +1,195 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_CORE_SLOTMAP_H_
+#define ESP_CORE_SLOTMAP_H_
+
+/** @file
+ * @brief Class @ref esp::core::SlotMap
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace esp {
+namespace core {
+
+/**
+ * @brief Map from small non-negative integer ids to values, with O(1) access.
+ *
+ * Meant for ids allocated densely by the caller and recycled after removal,
+ * such as physics object ids. Values are stored contiguously as (id, value)
+ * pairs, so iteration doesn't chase pointers; a sparse array indexed by id
+ * points into them. Removal moves the last value into the freed spot, so
+ * iteration order is not the id order, and removing invalidates references
+ * and iterators to the moved value.
+ *
+ * Each id has a generation, bumped whenever a value with that id is removed.
+ * A @ref Handle records the generation along with the id, so a handle kept
+ * past the removal of its value is detected as stale even after the id got
+ * reused.
+ *
+ * The interface mirrors the subset of std::map used for id-keyed storage
+ * (@ref at, @ref count, @ref emplace, @ref erase, iteration over pairs).
+ */
+template <typename T>
+class SlotMap {
+ public:
+  typedef std::pair<int, T> value_type;
+  typedef typename std::vector<value_type>::iterator iterator;
+  typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+  /**
+   * @brief Id and generation of a value, see @ref getHandle.
+   */
+  struct Handle {
+    int id = -1;
+    std::uint32_t generation = 0;
+  };
+
+  /** @brief Number of values */
+  std::size_t size() const { return values_.size(); }
+
+  /** @brief Whether there are no values */
+  bool empty() const { return values_.empty(); }
+
+  /** @brief 1 if there is a value with this id, 0 otherwise */
+  std::size_t count(int id) const { return indexOf(id) == -1 ? 0 : 1; }
+
+  /**
+   * @brief Value with given id
+   * @throws std::out_of_range if there is no such value, like std::map::at
+   */
+  T& at(int id) {
+    const int index = indexOf(id);
+    if (index == -1) {
+      throw std::out_of_range{"esp::core::SlotMap::at(): id not found"};
+    }
+    return values_[index].second;
+  }
+
+  //! @overload
+  const T& at(int id) const { return const_cast<SlotMap&>(*this).at(id); }
+
+  /**
+   * @brief Pointer to the value with given id, nullptr if there is none
+   */
+  T* find(int id) {
+    const int index = indexOf(id);
+    return index == -1 ? nullptr : &values_[index].second;
+  }
+
+  //! @overload
+  const T* find(int id) const { return const_cast<SlotMap&>(*this).find(id); }
+
+  /**
+   * @brief Add a value with given id.
+   * @return Pointer to the added value and true, or pointer to the existing
+   * value and false if there already is one with this id, like
+   * std::map::emplace
+   */
+  template <typename... Args>
+  std::pair<T*, bool> emplace(int id, Args&&... args) {
+    if (id < 0) {
+      throw std::out_of_range{"esp::core::SlotMap::emplace(): negative id"};
+    }
+    if (T* existing = find(id)) {
+      return {existing, false};
+    }
+    if (std::size_t(id) >= indices_.size()) {
+      indices_.resize(id + 1, -1);
+      generations_.resize(id + 1, 0);
+    }
+    indices_[id] = static_cast<int>(values_.size());
+    values_.emplace_back(std::piecewise_construct, std::forward_as_tuple(id),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+    return {&values_.back().second, true};
+  }
+
+  /**
+   * @brief Remove the value with given id, if any.
+   * @return Number of removed values, like std::map::erase
+   */
+  std::size_t erase(int id) {
+    const int index = indexOf(id);
+    if (index == -1) {
+      return 0;
+    }
+    // fill the hole with the last value
+    if (std::size_t(index) + 1 != values_.size()) {
+      values_[index] = std::move(values_.back());
+      indices_[values_[index].first] = index;
+    }
+    values_.pop_back();
+    indices_[id] = -1;
+    ++generations_[id];
+    return 1;
+  }
+
+  /** @brief Remove all values, invalidating all handles */
+  void clear() {
+    for (const value_type& value : values_) {
+      indices_[value.first] = -1;
+      ++generations_[value.first];
+    }
+    values_.clear();
+  }
+
+  /**
+   * @brief Handle of the value with given id, with id -1 if there is none.
+   */
+  Handle getHandle(int id) const {
+    if (indexOf(id) == -1) {
+      return {};
+    }
+    return {id, generations_[id]};
+  }
+
+  /**
+   * @brief Whether the value a handle was created for still exists.
+   */
+  bool isValid(const Handle& handle) const {
+    return indexOf(handle.id) != -1 &&
+           generations_[handle.id] == handle.generation;
+  }
+
+  /**
+   * @brief Value of a handle, nullptr if it was removed since the handle was
+   * created.
+   */
+  T* get(const Handle& handle) {
+    return isValid(handle) ? &values_[indices_[handle.id]].second : nullptr;
+  }
+
+  //! @overload
+  const T* get(const Handle& handle) const {
+    return const_cast<SlotMap&>(*this).get(handle);
+  }
+
+  iterator begin() { return values_.begin(); }
+  iterator end() { return values_.end(); }
+  const_iterator begin() const { return values_.begin(); }
+  const_iterator end() const { return values_.end(); }
+
+ private:
+  //! Index of the value with given id in values_, -1 if there is none
+  int indexOf(int id) const {
+    return id < 0 || std::size_t(id) >= indices_.size() ? -1 : indices_[id];
+  }
+
+  //! Values with their ids, densely packed
+  std::vector<value_type> values_;
+  //! Index into values_ for every id, -1 for ids without a value
+  std::vector<int> indices_;
+  //! Generation of every id, bumped on removal
+  std::vector<std::uint32_t> generations_;
+};
+
+}  // namespace core
+}  // namespace esp
+
+#endif  // ESP_CORE_SLOTMAP_H_
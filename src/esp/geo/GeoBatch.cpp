@@ -0,0 +1,384 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "GeoBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace esp {
+namespace geo {
+
+namespace {
+
+// Minimal wrapper of the widest float vectors available, so each kernel below
+// is written once. Masks are vectors with all bits of a lane set where true.
+#if defined(__AVX__)
+struct Lanes {
+  static constexpr std::size_t Size = 8;
+  __m256 v;
+};
+inline Lanes load(const float* p) {
+  return {_mm256_loadu_ps(p)};
+}
+inline void store(float* p, Lanes a) {
+  _mm256_storeu_ps(p, a.v);
+}
+inline Lanes broadcast(float f) {
+  return {_mm256_set1_ps(f)};
+}
+inline Lanes operator+(Lanes a, Lanes b) {
+  return {_mm256_add_ps(a.v, b.v)};
+}
+inline Lanes operator-(Lanes a, Lanes b) {
+  return {_mm256_sub_ps(a.v, b.v)};
+}
+inline Lanes operator*(Lanes a, Lanes b) {
+  return {_mm256_mul_ps(a.v, b.v)};
+}
+inline Lanes min(Lanes a, Lanes b) {
+  return {_mm256_min_ps(a.v, b.v)};
+}
+inline Lanes max(Lanes a, Lanes b) {
+  return {_mm256_max_ps(a.v, b.v)};
+}
+inline Lanes sqrt(Lanes a) {
+  return {_mm256_sqrt_ps(a.v)};
+}
+inline Lanes abs(Lanes a) {
+  return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)};
+}
+inline Lanes lessEqual(Lanes a, Lanes b) {
+  return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)};
+}
+inline Lanes maskAnd(Lanes a, Lanes b) {
+  return {_mm256_and_ps(a.v, b.v)};
+}
+//! Zero the lanes of @p a where @p mask is set
+inline Lanes zeroWhere(Lanes mask, Lanes a) {
+  return {_mm256_andnot_ps(mask.v, a.v)};
+}
+inline int maskBits(Lanes mask) {
+  return _mm256_movemask_ps(mask.v);
+}
+#elif defined(__SSE2__)
+struct Lanes {
+  static constexpr std::size_t Size = 4;
+  __m128 v;
+};
+inline Lanes load(const float* p) {
+  return {_mm_loadu_ps(p)};
+}
+inline void store(float* p, Lanes a) {
+  _mm_storeu_ps(p, a.v);
+}
+inline Lanes broadcast(float f) {
+  return {_mm_set1_ps(f)};
+}
+inline Lanes operator+(Lanes a, Lanes b) {
+  return {_mm_add_ps(a.v, b.v)};
+}
+inline Lanes operator-(Lanes a, Lanes b) {
+  return {_mm_sub_ps(a.v, b.v)};
+}
+inline Lanes operator*(Lanes a, Lanes b) {
+  return {_mm_mul_ps(a.v, b.v)};
+}
+inline Lanes min(Lanes a, Lanes b) {
+  return {_mm_min_ps(a.v, b.v)};
+}
+inline Lanes max(Lanes a, Lanes b) {
+  return {_mm_max_ps(a.v, b.v)};
+}
+inline Lanes sqrt(Lanes a) {
+  return {_mm_sqrt_ps(a.v)};
+}
+inline Lanes abs(Lanes a) {
+  return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+}
+inline Lanes lessEqual(Lanes a, Lanes b) {
+  return {_mm_cmple_ps(a.v, b.v)};
+}
+inline Lanes maskAnd(Lanes a, Lanes b) {
+  return {_mm_and_ps(a.v, b.v)};
+}
+//! Zero the lanes of @p a where @p mask is set
+inline Lanes zeroWhere(Lanes mask, Lanes a) {
+  return {_mm_andnot_ps(mask.v, a.v)};
+}
+inline int maskBits(Lanes mask) {
+  return _mm_movemask_ps(mask.v);
+}
+#else
+struct Lanes {
+  static constexpr std::size_t Size = 1;
+  float v;
+};
+inline Lanes load(const float* p) {
+  return {*p};
+}
+inline void store(float* p, Lanes a) {
+  *p = a.v;
+}
+inline Lanes broadcast(float f) {
+  return {f};
+}
+inline Lanes operator+(Lanes a, Lanes b) {
+  return {a.v + b.v};
+}
+inline Lanes operator-(Lanes a, Lanes b) {
+  return {a.v - b.v};
+}
+inline Lanes operator*(Lanes a, Lanes b) {
+  return {a.v * b.v};
+}
+inline Lanes min(Lanes a, Lanes b) {
+  return {std::min(a.v, b.v)};
+}
+inline Lanes max(Lanes a, Lanes b) {
+  return {std::max(a.v, b.v)};
+}
+inline Lanes sqrt(Lanes a) {
+  return {std::sqrt(a.v)};
+}
+inline Lanes abs(Lanes a) {
+  return {std::abs(a.v)};
+}
+// masks are 1 where true, 0 otherwise
+inline Lanes lessEqual(Lanes a, Lanes b) {
+  return {a.v <= b.v ? 1.0f : 0.0f};
+}
+inline Lanes maskAnd(Lanes a, Lanes b) {
+  return {a.v * b.v};
+}
+//! Zero the lanes of @p a where @p mask is set
+inline Lanes zeroWhere(Lanes mask, Lanes a) {
+  return {mask.v != 0.0f ? 0.0f : a.v};
+}
+inline int maskBits(Lanes mask) {
+  return mask.v != 0.0f ? 1 : 0;
+}
+#endif
+
+//! Store the first @p count lanes of @p a
+inline void storeFirst(float* p, Lanes a, std::size_t count) {
+  if (count == Lanes::Size) {
+    store(p, a);
+  } else {
+    float tmp[Lanes::Size];
+    store(tmp, a);
+    std::memcpy(p, tmp, count * sizeof(float));
+  }
+}
+
+}  // namespace
+
+OBBBatch::OBBBatch(const std::vector<OBB>& boxes) {
+  for (const OBB& obb : boxes) {
+    add(obb);
+  }
+}
+
+void OBBBatch::add(const OBB& obb) {
+  static_assert(Padding % Lanes::Size == 0,
+                "OBBBatch padding has to be a multiple of the vector width");
+  if (size_ == components_[0].size()) {
+    for (auto& component : components_) {
+      component.resize(size_ + Padding, 0.0f);
+    }
+  }
+  ++size_;
+  set(size_ - 1, obb);
+}
+
+void OBBBatch::set(std::size_t index, const OBB& obb) {
+  ASSERT(index < size_);
+  const vec3f center = obb.center();
+  const vec3f halfExtents = obb.halfExtents();
+  const mat3f R = obb.rotation().matrix();
+  for (int i = 0; i < 3; ++i) {
+    components_[CenterX + i][index] = center[i];
+    components_[HalfExtentX + i][index] = halfExtents[i];
+    components_[InvHalfExtentX + i][index] = 1.0f / halfExtents[i];
+    for (int c = 0; c < 3; ++c) {
+      components_[Axis0X + 3 * i + c][index] = R(c, i);
+    }
+  }
+}
+
+void OBBBatch::clear() {
+  size_ = 0;
+  for (auto& component : components_) {
+    component.clear();
+  }
+}
+
+template <class Kernel>
+void OBBBatch::forEachBoxVector(const float* x,
+                                const float* y,
+                                const float* z,
+                                std::size_t numPoints,
+                                Kernel&& kernel) const {
+  const float* c[NumComponents];
+  for (int comp = 0; comp < NumComponents; ++comp) {
+    c[comp] = components_[comp].data();
+  }
+  constexpr std::size_t numLanes = Lanes::Size;
+  for (std::size_t i = 0; i < numPoints; ++i) {
+    const Lanes px = broadcast(x[i]);
+    const Lanes py = broadcast(y[i]);
+    const Lanes pz = broadcast(z[i]);
+    for (std::size_t j = 0; j < size_; j += numLanes) {
+      const Lanes dx = px - load(c[CenterX] + j);
+      const Lanes dy = py - load(c[CenterY] + j);
+      const Lanes dz = pz - load(c[CenterZ] + j);
+      // the point's coordinates along each box axis, relative to the center
+      Lanes local[3];
+      for (int axis = 0; axis < 3; ++axis) {
+        const float* const* a = c + Axis0X + 3 * axis;
+        local[axis] = load(a[0] + j) * dx + load(a[1] + j) * dy +
+                      load(a[2] + j) * dz;
+      }
+      kernel(c, local, j, i * size_ + j, std::min(numLanes, size_ - j));
+    }
+  }
+}  // OBBBatch::forEachBoxVector
+
+void OBBBatch::contains(const float* x,
+                        const float* y,
+                        const float* z,
+                        std::size_t numPoints,
+                        std::uint8_t* results,
+                        float epsilon) const {
+  const Lanes bound = broadcast(1.0f + epsilon);
+  forEachBoxVector(
+      x, y, z, numPoints,
+      [&](const float* const* c, const Lanes* local, std::size_t j,
+          std::size_t resultIndex, std::size_t count) {
+        Lanes inside = lessEqual(abs(local[0] * load(c[InvHalfExtentX] + j)),
+                                 bound);
+        inside = maskAnd(
+            inside,
+            lessEqual(abs(local[1] * load(c[InvHalfExtentY] + j)), bound));
+        inside = maskAnd(
+            inside,
+            lessEqual(abs(local[2] * load(c[InvHalfExtentZ] + j)), bound));
+        const int bits = maskBits(inside);
+        for (std::size_t k = 0; k < count; ++k) {
+          results[resultIndex + k] = (bits >> k) & 1;
+        }
+      });
+}  // OBBBatch::contains
+
+void OBBBatch::distance(const float* x,
+                        const float* y,
+                        const float* z,
+                        std::size_t numPoints,
+                        float* results) const {
+  // OBB::distance() is 0 for points within OBB::contains()' default epsilon
+  const Lanes bound = broadcast(1.0f + 1e-6f);
+  const Lanes zero = broadcast(0.0f);
+  forEachBoxVector(
+      x, y, z, numPoints,
+      [&](const float* const* c, const Lanes* local, std::size_t j,
+          std::size_t resultIndex, std::size_t count) {
+        Lanes inside = lessEqual(zero, zero);
+        Lanes squaredDistance = zero;
+        for (int axis = 0; axis < 3; ++axis) {
+          const Lanes halfExtent = load(c[HalfExtentX + axis] + j);
+          inside = maskAnd(
+              inside,
+              lessEqual(abs(local[axis] * load(c[InvHalfExtentX + axis] + j)),
+                        bound));
+          // distance to the box along this axis, 0 if within its extent
+          const Lanes clamped =
+              min(max(local[axis], zero - halfExtent), halfExtent);
+          const Lanes outside = local[axis] - clamped;
+          squaredDistance = squaredDistance + outside * outside;
+        }
+        storeFirst(results + resultIndex,
+                   zeroWhere(inside, sqrt(squaredDistance)), count);
+      });
+}  // OBBBatch::distance
+
+void OBBBatch::closestPoint(const float* x,
+                            const float* y,
+                            const float* z,
+                            std::size_t numPoints,
+                            float* resultsX,
+                            float* resultsY,
+                            float* resultsZ) const {
+  const Lanes zero = broadcast(0.0f);
+  forEachBoxVector(
+      x, y, z, numPoints,
+      [&](const float* const* c, const Lanes* local, std::size_t j,
+          std::size_t resultIndex, std::size_t count) {
+        Lanes closest[3]{load(c[CenterX] + j), load(c[CenterY] + j),
+                         load(c[CenterZ] + j)};
+        for (int axis = 0; axis < 3; ++axis) {
+          const Lanes halfExtent = load(c[HalfExtentX + axis] + j);
+          const Lanes clamped =
+              min(max(local[axis], zero - halfExtent), halfExtent);
+          const float* const* a = c + Axis0X + 3 * axis;
+          for (int coord = 0; coord < 3; ++coord) {
+            closest[coord] = closest[coord] + clamped * load(a[coord] + j);
+          }
+        }
+        storeFirst(resultsX + resultIndex, closest[0], count);
+        storeFirst(resultsY + resultIndex, closest[1], count);
+        storeFirst(resultsZ + resultIndex, closest[2], count);
+      });
+}  // OBBBatch::closestPoint
+
+void getTransformedBBs(const Mn::Range3D* ranges,
+                       const Mn::Matrix4* xforms,
+                       std::size_t count,
+                       Mn::Range3D* results) {
+#if defined(__SSE2__)
+  // same as getTransformedBB(), with each matrix column in one register
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+  float newMin[4];
+  float newMax[4];
+  for (std::size_t i = 0; i < count; ++i) {
+    const float* m = xforms[i].data();
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+    const Mn::Vector3 center = ranges[i].center();
+    const Mn::Vector3 extent = ranges[i].size() / 2.0;
+
+    // compute Rc0 + t
+    const __m128 newCenter = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(center.x())),
+                   _mm_mul_ps(col1, _mm_set1_ps(center.y()))),
+        _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(center.z())), col3));
+    // compute max{Ry0} with the absolute value of the rotationScaling part
+    const __m128 newExtent = _mm_add_ps(
+        _mm_add_ps(
+            _mm_mul_ps(_mm_andnot_ps(signMask, col0),
+                       _mm_set1_ps(extent.x())),
+            _mm_mul_ps(_mm_andnot_ps(signMask, col1),
+                       _mm_set1_ps(extent.y()))),
+        _mm_mul_ps(_mm_andnot_ps(signMask, col2), _mm_set1_ps(extent.z())));
+
+    _mm_storeu_ps(newMin, _mm_sub_ps(newCenter, newExtent));
+    _mm_storeu_ps(newMax, _mm_add_ps(newCenter, newExtent));
+    results[i] = Mn::Range3D{Mn::Vector3::from(newMin),
+                             Mn::Vector3::from(newMax)};
+  }
+#else
+  for (std::size_t i = 0; i < count; ++i) {
+    results[i] = getTransformedBB(ranges[i], xforms[i]);
+  }
+#endif
+}  // getTransformedBBs
+
+}  // namespace geo
+}  // namespace esp
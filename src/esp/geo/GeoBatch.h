@@ -0,0 +1,157 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GEO_GEOBATCH_H_
+#define ESP_GEO_GEOBATCH_H_
+
+/** @file
+ * @brief Class @ref esp::geo::OBBBatch, function
+ * @ref esp::geo::getTransformedBBs
+ */
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "esp/core/esp.h"
+#include "esp/geo/OBB.h"
+#include "esp/geo/geo.h"
+
+namespace esp {
+namespace geo {
+
+/**
+ * @brief Oriented bounding boxes stored in structure-of-arrays layout, for
+ * querying many points against many boxes at once.
+ *
+ * Counterpart of @ref OBB::contains, @ref OBB::distance and
+ * @ref OBB::closestPoint. Every box component (center coordinates, rotation
+ * axis coordinates, half-extents) is stored in its own array, so the queries
+ * process 8 boxes per instruction with AVX, 4 with SSE, or 1 otherwise,
+ * depending on what the library got compiled for.
+ *
+ * Points are passed as separate x, y and z arrays. Results for point @f$ i @f$
+ * and box @f$ j @f$ are written to index @f$ i \cdot size() + j @f$ of
+ * caller-provided arrays holding at least @f$ numPoints \cdot size() @f$
+ * elements.
+ */
+class OBBBatch {
+ public:
+  OBBBatch() = default;
+
+  /** @brief Construct a batch holding copies of @p boxes */
+  explicit OBBBatch(const std::vector<OBB>& boxes);
+
+  /** @brief Number of boxes */
+  std::size_t size() const { return size_; }
+
+  /** @brief Append a box */
+  void add(const OBB& obb);
+
+  /** @brief Replace the box at @p index, e.g. after its object moved */
+  void set(std::size_t index, const OBB& obb);
+
+  /** @brief Remove all boxes */
+  void clear();
+
+  /**
+   * @brief Whether each point is contained in each box within threshold
+   * distance epsilon, see @ref OBB::contains.
+   * @param[out] results 1 if contained, 0 otherwise
+   */
+  void contains(const float* x,
+                const float* y,
+                const float* z,
+                std::size_t numPoints,
+                std::uint8_t* results,
+                float epsilon = 1e-6f) const;
+
+  /**
+   * @brief Distance from each point to each box, 0 for points inside, see
+   * @ref OBB::distance.
+   */
+  void distance(const float* x,
+                const float* y,
+                const float* z,
+                std::size_t numPoints,
+                float* results) const;
+
+  /**
+   * @brief Closest point within each box to each point, see
+   * @ref OBB::closestPoint.
+   */
+  void closestPoint(const float* x,
+                    const float* y,
+                    const float* z,
+                    std::size_t numPoints,
+                    float* resultsX,
+                    float* resultsY,
+                    float* resultsZ) const;
+
+  ESP_SMART_POINTERS(OBBBatch)
+
+ private:
+  //! Index of each box component in @ref components_. Axis<i><c> is
+  //! coordinate c of the box's local axis i, i.e. of column i of its rotation
+  //! matrix.
+  enum Component {
+    CenterX,
+    CenterY,
+    CenterZ,
+    Axis0X,
+    Axis0Y,
+    Axis0Z,
+    Axis1X,
+    Axis1Y,
+    Axis1Z,
+    Axis2X,
+    Axis2Y,
+    Axis2Z,
+    HalfExtentX,
+    HalfExtentY,
+    HalfExtentZ,
+    InvHalfExtentX,
+    InvHalfExtentY,
+    InvHalfExtentZ,
+    NumComponents
+  };
+
+  /**
+   * @brief Call @p kernel for each point and each vector of boxes, with the
+   * point's coordinates in the local frame of those boxes
+   */
+  template <class Kernel>
+  void forEachBoxVector(const float* x,
+                        const float* y,
+                        const float* z,
+                        std::size_t numPoints,
+                        Kernel&& kernel) const;
+
+  //! Each component array is zero-padded to a multiple of this, so kernels
+  //! never load past the end of it
+  static constexpr std::size_t Padding = 8;
+
+  std::size_t size_ = 0;
+  std::array<std::vector<float>, NumComponents> components_;
+};
+
+/**
+ * @brief Batched @ref getTransformedBB, computing the axis-aligned bounding box
+ * of each of @p ranges transformed by the matching one of @p xforms.
+ *
+ * Uses SSE when the library got compiled for it.
+ * @param ranges The initial axis-aligned bounding boxes.
+ * @param xforms The transforms to apply, one per box.
+ * @param count Number of boxes and transforms.
+ * @param[out] results The transformed bounding boxes, @p count of them.
+ */
+void getTransformedBBs(const Magnum::Range3D* ranges,
+                       const Magnum::Matrix4* xforms,
+                       std::size_t count,
+                       Magnum::Range3D* results);
+
+}  // namespace geo
+}  // namespace esp
+
+#endif  // ESP_GEO_GEOBATCH_H_
@@ -17,6 +17,7 @@ class SceneNode;
 namespace gfx {
 
 class DrawableGroup;
+class TextureResidencyManager;
 
 /**
  * @brief Drawable for use with @ref DrawableGroup.
@@ -87,6 +88,14 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
    */
   virtual Magnum::GL::Mesh& getVisualizerMesh() { return mesh_; }
 
+  /**
+   * @brief Set the manager to notify about textures bound for drawing, so
+   * that it can keep them resident. nullptr (the default) disables it.
+   */
+  void setTextureResidencyManager(TextureResidencyManager* manager) {
+    textureResidency_ = manager;
+  }
+
  protected:
   /**
    * @brief Draw the object using given camera
@@ -105,6 +114,9 @@ class Drawable : public Magnum::SceneGraph::Drawable3D {
 
   scene::SceneNode& node_;
   Magnum::GL::Mesh& mesh_;
+
+  //! See @ref setTextureResidencyManager, not owned
+  TextureResidencyManager* textureResidency_ = nullptr;
 };
 
 CORRADE_ENUMSET_OPERATORS(Drawable::Flags)
@@ -9,6 +9,7 @@
 #include <Magnum/Math/Color.h>
 #include <Magnum/Math/Matrix3.h>
 
+#include "TextureResidencyManager.h"
 #include "esp/scene/SceneNode.h"
 
 namespace Mn = Magnum;
@@ -27,7 +28,8 @@ GenericDrawable::GenericDrawable(scene::SceneNode& node,
       shaderManager_{shaderManager},
       lightSetup_{shaderManager.get<LightSetup>(lightSetupKey)},
       materialData_{
-          shaderManager.get<MaterialData, PhongMaterialData>(materialDataKey)} {
+          shaderManager.get<MaterialData, PhongMaterialData>(materialDataKey)},
+      meshAttributeFlags_{meshAttributeFlags} {
   flags_ = Mn::Shaders::Phong::Flag::ObjectId;
   if (materialData_->textureMatrix != Mn::Matrix3{}) {
     flags_ |= Mn::Shaders::Phong::Flag::TextureTransformation;
@@ -73,6 +75,13 @@ void GenericDrawable::setLightSetup(const Mn::ResourceKey& resourceKey) {
 void GenericDrawable::updateShaderLightingParameters(
     const Mn::Matrix4& transformationMatrix,
     Mn::SceneGraph::Camera3D& camera) {
+  updateShaderLightingParameters(transformationMatrix, camera, *shader_);
+}
+
+void GenericDrawable::updateShaderLightingParameters(
+    const Mn::Matrix4& transformationMatrix,
+    Mn::SceneGraph::Camera3D& camera,
+    Mn::Shaders::Phong& shader) {
   const Mn::Matrix4 cameraMatrix = camera.cameraMatrix();
 
   std::vector<Mn::Vector4> lightPositions;
@@ -101,7 +110,7 @@ void GenericDrawable::updateShaderLightingParameters(
   }
 
   // See documentation in src/deps/magnum/src/Magnum/Shaders/Phong.h
-  (*shader_)
+  shader
       .setAmbientColor(materialData_->ambientColor * ambientLightColor)
       .setDiffuseColor(materialData_->diffuseColor)
       .setSpecularColor(materialData_->specularColor)
@@ -134,42 +143,124 @@ void GenericDrawable::draw(const Mn::Matrix4& transformationMatrix,
     shader_->setTextureMatrix(materialData_->textureMatrix);
   }
 
+  bindTextures(*shader_);
+
+  shader_->draw(mesh_);
+}
+
+bool GenericDrawable::isInstanceable() {
+  if (!instancedMesh_ || materialData_->perVertexObjectId ||
+      (meshAttributeFlags_ & Drawable::Flag::HasSeparateBitangent)) {
+    return false;
+  }
+  // lights relative to the object would need per-instance light positions
+  for (const LightInfo& light : *lightSetup_) {
+    if (light.model == LightPositionModel::OBJECT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+GenericDrawable::InstanceBatchKey GenericDrawable::getInstanceBatchKey() {
+  return InstanceBatchKey{
+      &mesh_, materialData_.operator->(), lightSetup_.operator->(),
+      static_cast<Mn::Shaders::Phong::Flags::UnderlyingType>(flags_)};
+}
+
+void GenericDrawable::drawInstances(
+    const std::vector<std::pair<GenericDrawable*, Mn::Matrix4>>& instances,
+    Mn::SceneGraph::Camera3D& camera) {
+  if (instances.empty()) {
+    return;
+  }
+  // all instances share mesh, material and lights, so the first one stands
+  // in for all of them
+  GenericDrawable& first = *instances.front().first;
+  first.updateShader(first.flags_ |
+                         Mn::Shaders::Phong::Flag::InstancedTransformation |
+                         Mn::Shaders::Phong::Flag::InstancedObjectId,
+                     first.instancedShader_);
+  Mn::Shaders::Phong& shader = *first.instancedShader_;
+
+  const bool useDrawableIds =
+      static_cast<RenderCamera&>(camera).useDrawableIds();
+  std::vector<InstancedMesh::Instance> instanceData;
+  instanceData.reserve(instances.size());
+  for (const auto& instance : instances) {
+    instanceData.push_back(InstancedMesh::Instance{
+        instance.second, instance.second.normalMatrix(),
+        useDrawableIds ? instance.first->drawableId_
+                       : instance.first->node_.getSemanticId()});
+  }
+
+  // the light positions don't depend on the object transformation, see
+  // isInstanceable(), and the per-instance matrices get multiplied with the
+  // (identity) uniform ones
+  first.updateShaderLightingParameters(Mn::Matrix4{}, camera, shader);
+  shader.setObjectId(0)
+      .setTransformationMatrix(Mn::Matrix4{})
+      .setProjectionMatrix(camera.projectionMatrix())
+      .setNormalMatrix(Mn::Matrix3x3{});
+  if ((first.flags_ & Mn::Shaders::Phong::Flag::TextureTransformation) &&
+      first.materialData_->textureMatrix != Mn::Matrix3{}) {
+    shader.setTextureMatrix(first.materialData_->textureMatrix);
+  }
+  first.bindTextures(shader);
+
+  first.instancedMesh_->draw(shader, instanceData);
+}  // GenericDrawable::drawInstances
+
+void GenericDrawable::bindTextures(Mn::Shaders::Phong& shader) {
+  // make textures resident before any of them gets bound, promoting one may
+  // recreate another
+  if (textureResidency_) {
+    textureResidency_->touch(materialData_->ambientTexture);
+    textureResidency_->touch(materialData_->diffuseTexture);
+    textureResidency_->touch(materialData_->specularTexture);
+    textureResidency_->touch(materialData_->normalTexture);
+  }
+
   if (flags_ & Mn::Shaders::Phong::Flag::AmbientTexture) {
-    shader_->bindAmbientTexture(*(materialData_->ambientTexture));
+    shader.bindAmbientTexture(*(materialData_->ambientTexture));
   }
   if (flags_ & Mn::Shaders::Phong::Flag::DiffuseTexture) {
-    shader_->bindDiffuseTexture(*(materialData_->diffuseTexture));
+    shader.bindDiffuseTexture(*(materialData_->diffuseTexture));
   }
   if (flags_ & Mn::Shaders::Phong::Flag::SpecularTexture) {
-    shader_->bindSpecularTexture(*(materialData_->specularTexture));
+    shader.bindSpecularTexture(*(materialData_->specularTexture));
   }
   if (flags_ & Mn::Shaders::Phong::Flag::NormalTexture) {
-    shader_->bindNormalTexture(*(materialData_->normalTexture));
+    shader.bindNormalTexture(*(materialData_->normalTexture));
   }
-
-  shader_->draw(mesh_);
 }
 
 void GenericDrawable::updateShader() {
+  updateShader(flags_, shader_);
+}
+
+void GenericDrawable::updateShader(
+    Mn::Shaders::Phong::Flags flags,
+    Mn::Resource<Mn::GL::AbstractShaderProgram, Mn::Shaders::Phong>& shader) {
   Mn::UnsignedInt lightCount = lightSetup_->size();
 
-  if (!shader_ || shader_->lightCount() != lightCount ||
-      shader_->flags() != flags_) {
+  if (!shader || shader->lightCount() != lightCount ||
+      shader->flags() != flags) {
     // if the number of lights or flags have changed, we need to fetch a
     // compatible shader
-    shader_ =
+    shader =
         shaderManager_.get<Mn::GL::AbstractShaderProgram, Mn::Shaders::Phong>(
-            getShaderKey(lightCount, flags_));
+            getShaderKey(lightCount, flags));
 
     // if no shader with desired number of lights and flags exists, create one
-    if (!shader_) {
+    if (!shader) {
       shaderManager_.set<Mn::GL::AbstractShaderProgram>(
-          shader_.key(), new Mn::Shaders::Phong{flags_, lightCount},
+          shader.key(), new Mn::Shaders::Phong{flags, lightCount},
           Mn::ResourceDataState::Final, Mn::ResourcePolicy::ReferenceCounted);
     }
 
-    CORRADE_INTERNAL_ASSERT(shader_ && shader_->lightCount() == lightCount &&
-                            shader_->flags() == flags_);
+    CORRADE_INTERNAL_ASSERT(shader && shader->lightCount() == lightCount &&
+                            shader->flags() == flags);
   }
 }
 
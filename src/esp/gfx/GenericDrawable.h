@@ -5,9 +5,15 @@
 #ifndef ESP_GFX_GENERICDRAWABLE_H_
 #define ESP_GFX_GENERICDRAWABLE_H_
 
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Magnum/GL/GL.h>
 #include <Magnum/Shaders/Phong.h>
 
 #include "esp/gfx/Drawable.h"
+#include "esp/gfx/InstancedMesh.h"
 #include "esp/gfx/ShaderManager.h"
 
 namespace esp {
@@ -29,6 +35,52 @@ class GenericDrawable : public Drawable {
   void setLightSetup(const Magnum::ResourceKey& lightSetupKey) override;
   static constexpr const char* SHADER_KEY_TEMPLATE = "Phong-lights={}-flags={}";
 
+  /**
+   * @brief What drawables have to share to be drawn together in one instanced
+   * draw call: mesh, material, light setup and shader flags.
+   */
+  typedef std::tuple<Magnum::GL::Mesh*,
+                     const MaterialData*,
+                     const LightSetup*,
+                     Magnum::Shaders::Phong::Flags::UnderlyingType>
+      InstanceBatchKey;
+
+  /**
+   * @brief Set the instanced variant of the mesh, see @ref drawInstances.
+   * nullptr, the default, disables instanced drawing of this drawable.
+   * @param instancedMesh Instanced variant of the mesh, not owned
+   */
+  void setInstancedMesh(InstancedMesh* instancedMesh) {
+    instancedMesh_ = instancedMesh;
+  }
+
+  /**
+   * @brief Whether this drawable can be drawn as an instance, see @ref
+   * drawInstances. Not possible without an instanced mesh, see @ref
+   * setInstancedMesh, with per-vertex object ids, with lights positioned
+   * relative to the object, or for meshes with separate bitangents, which
+   * occupy the instanced object id attribute location.
+   */
+  bool isInstanceable();
+
+  /**
+   * @brief Key grouping drawables which can be drawn in one instanced draw
+   * call.
+   */
+  InstanceBatchKey getInstanceBatchKey();
+
+  /**
+   * @brief Draw several drawables sharing the same @ref InstanceBatchKey with
+   * a single instanced draw call.
+   * @param instances Drawables with their transformation relative to the
+   * camera. All must be instanceable and share the same key.
+   * @param camera Camera to draw from.
+   */
+  static void drawInstances(
+      const std::vector<std::pair<GenericDrawable*, Magnum::Matrix4>>&
+          instances,
+      Magnum::SceneGraph::Camera3D& camera);
+
  protected:
   virtual void draw(const Magnum::Matrix4& transformationMatrix,
                     Magnum::SceneGraph::Camera3D& camera) override;
@@ -38,6 +90,28 @@ class GenericDrawable : public Drawable {
       const Magnum::Matrix4& transformationMatrix,
       Magnum::SceneGraph::Camera3D& camera);
 
+  /**
+   * @brief Fetch, or create, the shader for the given flags and the current
+   * light count into @p shader.
+   */
+  void updateShader(
+      Magnum::Shaders::Phong::Flags flags,
+      Magnum::Resource<Magnum::GL::AbstractShaderProgram,
+                       Magnum::Shaders::Phong>& shader);
+
+  /**
+   * @brief Set the material and light uniforms of a shader.
+   */
+  void updateShaderLightingParameters(
+      const Magnum::Matrix4& transformationMatrix,
+      Magnum::SceneGraph::Camera3D& camera,
+      Magnum::Shaders::Phong& shader);
+
+  /**
+   * @brief Bind the material textures to a shader.
+   */
+  void bindTextures(Magnum::Shaders::Phong& shader);
+
   Magnum::ResourceKey getShaderKey(Magnum::UnsignedInt lightCount,
                                    Magnum::Shaders::Phong::Flags flags) const;
 
@@ -45,10 +119,17 @@ class GenericDrawable : public Drawable {
   ShaderManager& shaderManager_;
   Magnum::Resource<Magnum::GL::AbstractShaderProgram, Magnum::Shaders::Phong>
       shader_;
+  //! Variant of @ref shader_ with instanced transformation and object id
+  Magnum::Resource<Magnum::GL::AbstractShaderProgram, Magnum::Shaders::Phong>
+      instancedShader_;
   Magnum::Resource<MaterialData, PhongMaterialData> materialData_;
   Magnum::Resource<LightSetup> lightSetup_;
 
   Magnum::Shaders::Phong::Flags flags_;
+  Drawable::Flags meshAttributeFlags_;
+
+  //! See @ref setInstancedMesh, not owned
+  InstancedMesh* instancedMesh_ = nullptr;
 };
 
 }  // namespace gfx
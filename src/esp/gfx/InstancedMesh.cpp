@@ -0,0 +1,35 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "InstancedMesh.h"
+
+#include <utility>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+InstancedMesh::InstancedMesh(std::function<Mn::GL::Mesh()> compileMesh)
+    : compileMesh_{std::move(compileMesh)} {}
+
+void InstancedMesh::draw(
+    Mn::Shaders::Phong& shader,
+    Corrade::Containers::ArrayView<const Instance> instances) {
+  if (compileMesh_) {
+    instanceBuffer_ = Mn::GL::Buffer{};
+    mesh_ = compileMesh_();
+    mesh_.addVertexBufferInstanced(instanceBuffer_, 1, 0,
+                                   Mn::Shaders::Phong::TransformationMatrix{},
+                                   Mn::Shaders::Phong::NormalMatrix{},
+                                   Mn::Shaders::Phong::ObjectId{});
+    compileMesh_ = nullptr;
+  }
+  instanceBuffer_.setData(instances, Mn::GL::BufferUsage::StreamDraw);
+  mesh_.setInstanceCount(instances.size());
+  shader.draw(mesh_);
+}  // InstancedMesh::draw
+
+}  // namespace gfx
+}  // namespace esp
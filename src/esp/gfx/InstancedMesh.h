@@ -0,0 +1,76 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_INSTANCEDMESH_H_
+#define ESP_GFX_INSTANCEDMESH_H_
+
+/** @file
+ * @brief Class @ref esp::gfx::InstancedMesh
+ */
+
+#include <functional>
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Shaders/Phong.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Variant of a mesh for drawing many instances of it with @ref
+ * GenericDrawable::drawInstances.
+ *
+ * Shares the vertex and index buffers of the regular mesh and adds
+ * per-instance transformations and object ids from a buffer of its own. The
+ * GL mesh and instance buffer are only created on the first @ref draw, so
+ * meshes never drawn instanced cost nothing on the GPU. The instanced
+ * attributes are bound once, on creation, and never end up on the regular
+ * mesh other drawables draw with.
+ */
+class InstancedMesh {
+ public:
+  /** @brief Per-instance data, matching the instanced attributes of Phong */
+  struct Instance {
+    Magnum::Matrix4 transformationMatrix;
+    Magnum::Matrix3x3 normalMatrix;
+    Magnum::UnsignedInt objectId;
+  };
+
+  /**
+   * @brief Constructor. Creates no GL objects.
+   * @param compileMesh Function returning a mesh referencing the vertex and
+   * index buffers of the regular mesh, e.g. compiled with @ref
+   * Magnum::MeshTools::compile from the same buffers. Called on the first
+   * @ref draw, the mesh then gets the instanced attributes added.
+   */
+  explicit InstancedMesh(std::function<Magnum::GL::Mesh()> compileMesh);
+
+  /**
+   * @brief Upload the instances and draw them with @p shader, which must have
+   * instanced transformations and object ids enabled. Requires a current GL
+   * context supporting instancing.
+   */
+  void draw(Magnum::Shaders::Phong& shader,
+            Corrade::Containers::ArrayView<const Instance> instances);
+
+  ESP_SMART_POINTERS(InstancedMesh)
+
+ private:
+  //! See the constructor, reset once the mesh is created
+  std::function<Magnum::GL::Mesh()> compileMesh_;
+  // the mesh references the buffer, so it goes first and is destroyed last
+  Magnum::GL::Buffer instanceBuffer_{Magnum::NoCreate};
+  Magnum::GL::Mesh mesh_{Magnum::NoCreate};
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_INSTANCEDMESH_H_
@@ -8,6 +8,8 @@
 #include <Corrade/Utility/FormatStl.h>
 #include <Magnum/GL/Renderer.h>
 
+#include "TextureResidencyManager.h"
+
 namespace Mn = Magnum;
 
 namespace esp {
@@ -112,6 +114,16 @@ void PbrDrawable::draw(const Mn::Matrix4& transformationMatrix,
       .setMetallic(materialData_->metallic)
       .setEmissiveColor(materialData_->emissiveColor);
 
+  // make textures resident before any of them gets bound, promoting one may
+  // recreate another
+  if (textureResidency_) {
+    textureResidency_->touch(materialData_->baseColorTexture);
+    textureResidency_->touch(materialData_->roughnessTexture);
+    textureResidency_->touch(materialData_->metallicTexture);
+    textureResidency_->touch(materialData_->normalTexture);
+    textureResidency_->touch(materialData_->emissiveTexture);
+  }
+
   if ((flags_ & PbrShader::Flag::BaseColorTexture) &&
       materialData_->baseColorTexture) {
     shader_->bindBaseColorTexture(*materialData_->baseColorTexture);
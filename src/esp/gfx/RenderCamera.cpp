@@ -4,13 +4,19 @@
 
 #include "RenderCamera.h"
 
+#include <map>
+
 #include <Magnum/EigenIntegration/Integration.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
 #include <Magnum/SceneGraph/Drawable.h>
 #include "esp/gfx/Drawable.h"
 #include "esp/gfx/DrawableGroup.h"
+#include "esp/gfx/GenericDrawable.h"
+#include "esp/gfx/TextureResidencyManager.h"
 #include "esp/scene/SceneGraph.h"
 
 namespace Mn = Magnum;
@@ -157,8 +163,89 @@ size_t RenderCamera::removeNonObjects(
   return (newEndIter - drawableTransforms.begin());
 }
 
+bool RenderCamera::isInstancingSupported() {
+  static Cr::Containers::Optional<bool> supported;
+  if (supported) {
+    return *supported;
+  }
+  if (!Mn::GL::Context::hasCurrent()) {
+    return false;
+  }
+  Mn::GL::Context& context = Mn::GL::Context::current();
+#ifdef MAGNUM_TARGET_GLES2
+  supported = false;
+#elif defined(MAGNUM_TARGET_GLES)
+  supported = true;
+#else
+  supported =
+      context.isExtensionSupported<
+          Mn::GL::Extensions::ARB::instanced_arrays>() &&
+      context.isExtensionSupported<Mn::GL::Extensions::ARB::draw_instanced>() &&
+      context.isExtensionSupported<
+          Mn::GL::Extensions::ARB::vertex_array_object>();
+#endif
+  // software rasterizers gain nothing from fewer draw calls
+  const std::string renderer = context.rendererString();
+  for (const char* softwareRenderer : {"llvmpipe", "softpipe", "SwiftShader"}) {
+    if (renderer.find(softwareRenderer) != std::string::npos) {
+      supported = false;
+    }
+  }
+  if (!*supported) {
+    LOG(INFO) << "Instanced rendering not supported by " << renderer
+              << ", drawing every drawable separately";
+  }
+  return *supported;
+}
+
+void RenderCamera::drawInstanced(
+    std::vector<std::pair<std::reference_wrapper<Mn::SceneGraph::Drawable3D>,
+                          Mn::Matrix4>>& drawableTransforms) {
+  // std::map so batches get drawn in the same order every frame
+  std::map<GenericDrawable::InstanceBatchKey, std::vector<size_t>> batches;
+  for (size_t i = 0; i < drawableTransforms.size(); ++i) {
+    auto* drawable =
+        dynamic_cast<GenericDrawable*>(&drawableTransforms[i].first.get());
+    if (drawable && drawable->isInstanceable()) {
+      batches[drawable->getInstanceBatchKey()].push_back(i);
+    }
+  }
+
+  std::vector<bool> isDrawn(drawableTransforms.size(), false);
+  std::vector<std::pair<GenericDrawable*, Mn::Matrix4>> instances;
+  for (const auto& batch : batches) {
+    // a single instance is cheaper to draw the usual way
+    if (batch.second.size() < 2) {
+      continue;
+    }
+    instances.clear();
+    for (size_t i : batch.second) {
+      instances.emplace_back(
+          static_cast<GenericDrawable*>(&drawableTransforms[i].first.get()),
+          drawableTransforms[i].second);
+      isDrawn[i] = true;
+    }
+    GenericDrawable::drawInstances(instances, *this);
+    ++previousNumInstancedBatches_;
+  }
+
+  // keep the rest, in order, for the regular draw
+  size_t numRemaining = 0;
+  for (size_t i = 0; i < drawableTransforms.size(); ++i) {
+    if (!isDrawn[i]) {
+      drawableTransforms[numRemaining++] = drawableTransforms[i];
+    }
+  }
+  drawableTransforms.erase(drawableTransforms.begin() + numRemaining,
+                           drawableTransforms.end());
+}  // RenderCamera::drawInstanced
+
 uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables, Flags flags) {
   previousNumVisibleDrawables_ = drawables.size();
+  previousNumInstancedBatches_ = 0;
+  if (textureResidency_) {
+    textureResidency_->beginFrame();
+  }
   if (flags == Flags()) {  // empty set
     MagnumCamera::draw(drawables);
     return drawables.size();
@@ -188,13 +275,18 @@ uint32_t RenderCamera::draw(MagnumDrawableGroup& drawables, Flags flags) {
         drawableTransforms.end());
   }
 
+  const size_t numDrawn = drawableTransforms.size();
+  if ((flags & Flag::Instancing) && isInstancingSupported()) {
+    drawInstanced(drawableTransforms);
+  }
+
   MagnumCamera::draw(drawableTransforms);
 
   // reset
   if (useDrawableIds_) {
     useDrawableIds_ = false;
   }
-  return drawableTransforms.size();
+  return numDrawn;
 }
 
 esp::geo::Ray RenderCamera::unproject(const Mn::Vector2i& viewportPosition) {
@@ -5,6 +5,8 @@
 #ifndef ESP_GFX_RENDERCAMERA_H_
 #define ESP_GFX_RENDERCAMERA_H_
 
+#include <Corrade/Containers/Optional.h>
+
 #include "magnum.h"
 
 #include "esp/core/esp.h"
@@ -14,6 +16,8 @@
 namespace esp {
 namespace gfx {
 
+class TextureResidencyManager;
+
 class RenderCamera : public MagnumCamera {
  public:
   /**
@@ -38,6 +42,13 @@ class RenderCamera : public MagnumCamera {
      * object id" is not set)
      */
     UseDrawableIdAsObjectId = 1 << 2,
+
+    /**
+     * Draw drawables sharing the same mesh, material and lights with a single
+     * instanced draw call, see @ref GenericDrawable::drawInstances. Ignored
+     * if instancing is not supported, see @ref isInstancingSupported.
+     */
+    Instancing = 1 << 3,
   };
 
   typedef Corrade::Containers::EnumSet<Flag> Flags;
@@ -205,9 +216,47 @@ class RenderCamera : public MagnumCamera {
     return previousNumVisibleDrawables_;
   }
 
+  /**
+   * @brief Query the number of instanced draw calls issued in the most recent
+   * render pass, see @ref Flag::Instancing.
+   */
+  size_t getPreviousNumInstancedBatches() const {
+    return previousNumInstancedBatches_;
+  }
+
+  /**
+   * @brief Whether the current GL context supports instanced drawing. False
+   * on WebGL 1 / GLES 2 without the needed extensions and for software
+   * renderers, where instancing is slower than separate draw calls.
+   */
+  static bool isInstancingSupported();
+
+  /**
+   * @brief Set the manager to start a new frame on each @ref draw, so the
+   * textures of the drawables drawn together stay resident. nullptr (the
+   * default) disables it.
+   */
+  void setTextureResidencyManager(TextureResidencyManager* manager) {
+    textureResidency_ = manager;
+  }
+
  protected:
+  /**
+   * @brief Draw drawables sharing mesh, material and lights in one instanced
+   * draw call each and remove them from the list.
+   * @param drawableTransforms, a vector of pairs of Drawable3D object and its
+   * transformation relative to this camera
+   */
+  void drawInstanced(
+      std::vector<
+          std::pair<std::reference_wrapper<Magnum::SceneGraph::Drawable3D>,
+                    Magnum::Matrix4>>& drawableTransforms);
+
   size_t previousNumVisibleDrawables_ = 0;
+  size_t previousNumInstancedBatches_ = 0;
   bool useDrawableIds_ = false;
+  //! See @ref setTextureResidencyManager, not owned
+  TextureResidencyManager* textureResidency_ = nullptr;
   ESP_SMART_POINTERS(RenderCamera)
 };
 
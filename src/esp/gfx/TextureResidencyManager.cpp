@@ -0,0 +1,213 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "TextureResidencyManager.h"
+
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/Math/Functions.h>
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+
+namespace {
+//! Index of the largest mip level not exceeding the resolution
+int baseLevelForResolution(const std::vector<Mn::Trade::ImageData2D>& levels,
+                           int resolution) {
+  int level = 0;
+  if (resolution <= 0) {
+    return level;
+  }
+  while (level + 1 < static_cast<int>(levels.size()) &&
+         levels[level].size().max() > resolution) {
+    ++level;
+  }
+  return level;
+}
+}  // namespace
+
+TextureResidencyManager::TextureResidencyManager(std::size_t memoryBudget,
+                                                 int maxResolution)
+    : memoryBudget_(memoryBudget), maxResolution_(maxResolution) {}
+
+void TextureResidencyManager::setMemoryBudget(std::size_t memoryBudget) {
+  memoryBudget_ = memoryBudget;
+  demoteToBudget(nullptr);
+}
+
+void TextureResidencyManager::addTexture(
+    Mn::GL::Texture2D& texture,
+    std::vector<Mn::Trade::ImageData2D>&& levels,
+    const SamplerState& sampler) {
+  CORRADE_INTERNAL_ASSERT(!levels.empty());
+  CORRADE_INTERNAL_ASSERT(records_.count(&texture) == 0);
+
+  Record& record = records_[&texture];
+  record.texture = &texture;
+  record.levels = std::move(levels);
+  record.sampler = sampler;
+  record.isManaged = true;
+  const Mn::Trade::ImageData2D& first = record.levels.front();
+  record.format = first.isCompressed()
+                      ? Mn::GL::textureFormat(first.compressedFormat())
+                      : Mn::GL::textureFormat(first.format());
+  record.fullBaseLevel = baseLevelForResolution(record.levels, maxResolution_);
+  record.demotedBaseLevel =
+      Mn::Math::max(record.fullBaseLevel,
+                    baseLevelForResolution(record.levels, DEMOTED_RESOLUTION));
+
+  stats_.skippedBytes +=
+      byteSizeFrom(record, 0) - byteSizeFrom(record, record.fullBaseLevel);
+  stats_.fullyResidentBytes += byteSizeFrom(record, record.fullBaseLevel);
+
+  upload(record, record.fullBaseLevel);
+  lru_.push_back(&record);
+  record.lruPosition = std::prev(lru_.end());
+
+  demoteToBudget(&record);
+}
+
+void TextureResidencyManager::addUnmanagedTexture(
+    const Mn::GL::Texture2D& texture,
+    std::size_t byteSize) {
+  CORRADE_INTERNAL_ASSERT(records_.count(&texture) == 0);
+  Record& record = records_[&texture];
+  record.residentBytes = byteSize;
+  residentBytes_ += byteSize;
+  stats_.fullyResidentBytes += byteSize;
+}
+
+void TextureResidencyManager::removeTexture(const Mn::GL::Texture2D& texture) {
+  auto it = records_.find(&texture);
+  if (it == records_.end()) {
+    return;
+  }
+  Record& record = it->second;
+  residentBytes_ -= record.residentBytes;
+  if (record.isManaged) {
+    stats_.fullyResidentBytes -= byteSizeFrom(record, record.fullBaseLevel);
+    if (record.residentBaseLevel == record.fullBaseLevel) {
+      lru_.erase(record.lruPosition);
+    }
+  } else {
+    stats_.fullyResidentBytes -= record.residentBytes;
+  }
+  records_.erase(it);
+}
+
+std::size_t TextureResidencyManager::getTextureByteSize(
+    const Mn::GL::Texture2D& texture) const {
+  auto it = records_.find(&texture);
+  return it == records_.end() ? 0 : it->second.residentBytes;
+}
+
+void TextureResidencyManager::touch(const Mn::GL::Texture2D* texture) {
+  if (texture == nullptr) {
+    return;
+  }
+  auto it = records_.find(texture);
+  if (it == records_.end() || !it->second.isManaged) {
+    return;
+  }
+  Record& record = it->second;
+  record.touchedFrame = frame_;
+  if (record.residentBaseLevel == record.fullBaseLevel) {
+    // mark as most recently drawn, and catch up on demotions skipped while
+    // the textures of a previous frame exceeded the budget
+    lru_.splice(lru_.end(), lru_, record.lruPosition);
+    if (residentBytes_ > memoryBudget_) {
+      demoteToBudget(&record);
+    }
+    return;
+  }
+
+  // demoted, promote before it gets drawn
+  upload(record, record.fullBaseLevel);
+  lru_.push_back(&record);
+  record.lruPosition = std::prev(lru_.end());
+  ++stats_.promotions;
+
+  demoteToBudget(&record);
+}
+
+TextureResidencyManager::Stats TextureResidencyManager::getStats() const {
+  Stats stats = stats_;
+  stats.numTextures = records_.size();
+  stats.numManagedTextures = 0;
+  stats.numDemotedTextures = 0;
+  for (const auto& it : records_) {
+    if (it.second.isManaged) {
+      ++stats.numManagedTextures;
+      if (it.second.residentBaseLevel != it.second.fullBaseLevel) {
+        ++stats.numDemotedTextures;
+      }
+    }
+  }
+  stats.residentBytes = residentBytes_;
+  return stats;
+}
+
+void TextureResidencyManager::upload(Record& record, int baseLevel) {
+  // a texture with immutable storage can't be reallocated, so create a new
+  // one and move it over the old one, keeping its address
+  Mn::GL::Texture2D texture;
+  texture.setMagnificationFilter(record.sampler.magnificationFilter)
+      .setMinificationFilter(record.sampler.minificationFilter,
+                             record.sampler.mipmapFilter)
+      .setWrapping(record.sampler.wrapping);
+
+  const int levelCount = static_cast<int>(record.levels.size()) - baseLevel;
+  texture.setStorage(levelCount, record.format,
+                     record.levels[baseLevel].size());
+  for (int level = 0; level != levelCount; ++level) {
+    const Mn::Trade::ImageData2D& image = record.levels[baseLevel + level];
+    if (image.isCompressed())
+      texture.setCompressedSubImage(level, {}, image);
+    else
+      texture.setSubImage(level, {}, image);
+  }
+  *record.texture = std::move(texture);
+
+  residentBytes_ -= record.residentBytes;
+  record.residentBytes = byteSizeFrom(record, baseLevel);
+  residentBytes_ += record.residentBytes;
+  record.residentBaseLevel = baseLevel;
+}
+
+std::size_t TextureResidencyManager::byteSizeFrom(const Record& record,
+                                                  int baseLevel) {
+  std::size_t byteSize = 0;
+  for (std::size_t level = baseLevel; level < record.levels.size(); ++level) {
+    byteSize += record.levels[level].data().size();
+  }
+  return byteSize;
+}
+
+void TextureResidencyManager::demoteToBudget(const Record* keep) {
+  if (memoryBudget_ == 0) {
+    return;
+  }
+  auto it = lru_.begin();
+  while (residentBytes_ > memoryBudget_ && it != lru_.end()) {
+    Record& record = **it;
+    if (&record == keep || record.touchedFrame == frame_ ||
+        record.demotedBaseLevel == record.fullBaseLevel) {
+      // needed for the current frame, or nothing to gain from demoting it
+      ++it;
+      continue;
+    }
+    it = lru_.erase(it);
+    upload(record, record.demotedBaseLevel);
+    ++stats_.demotions;
+  }
+  if (residentBytes_ > memoryBudget_ && overBudgetFrame_ != frame_) {
+    overBudgetFrame_ = frame_;
+    ++stats_.overBudgetFrames;
+  }
+}
+
+}  // namespace gfx
+}  // namespace esp
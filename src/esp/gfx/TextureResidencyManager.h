@@ -0,0 +1,238 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_TEXTURERESIDENCYMANAGER_H_
+#define ESP_GFX_TEXTURERESIDENCYMANAGER_H_
+
+/** @file
+ * @brief Class @ref esp::gfx::TextureResidencyManager
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/Math/Vector2.h>
+#include <Magnum/Sampler.h>
+#include <Magnum/Trade/ImageData.h>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace gfx {
+
+/**
+ * @brief Tracks the GPU memory used by textures and keeps it under a budget.
+ *
+ * Textures registered with their full CPU-side mip chain (see @ref
+ * addTexture) are uploaded starting from the largest mip level not exceeding
+ * the maximum resolution (see @ref setMaxResolution), so e.g. 4K textures are
+ * never fully uploaded for 256x256 sensors. Drawables report the textures they
+ * bind with @ref touch, and the render camera starts a new frame with @ref
+ * beginFrame before drawing. When the resident size exceeds the memory
+ * budget, the least recently drawn textures are demoted to their smallest mip
+ * levels (see @ref DEMOTED_RESOLUTION). A demoted texture is promoted back to
+ * its full resolution as soon as it is drawn again, before the draw happens,
+ * and textures drawn in the current frame are never demoted, so rendered
+ * observations never see demoted textures. If the textures of a single frame
+ * don't fit in the budget, the budget is exceeded instead, see
+ * @ref Stats::overBudgetFrames.
+ *
+ * Demotion and promotion recreate the GL texture in place, so raw pointers to
+ * the @ref Magnum::GL::Texture2D (e.g. in @ref MaterialData) stay valid.
+ *
+ * Textures with a single mip level (mips generated on the GPU) cannot be
+ * streamed; they are only accounted for, see @ref addUnmanagedTexture.
+ */
+class TextureResidencyManager {
+ public:
+  /**
+   * @brief Resolution (largest dimension) below which mip levels of demoted
+   * textures stay resident.
+   */
+  static constexpr int DEMOTED_RESOLUTION = 64;
+
+  /**
+   * @brief Sampler state of a managed texture, reapplied whenever the texture
+   * is recreated.
+   */
+  struct SamplerState {
+    Magnum::SamplerFilter magnificationFilter = Magnum::SamplerFilter::Linear;
+    Magnum::SamplerFilter minificationFilter = Magnum::SamplerFilter::Linear;
+    Magnum::SamplerMipmap mipmapFilter = Magnum::SamplerMipmap::Linear;
+    Magnum::Math::Vector2<Magnum::SamplerWrapping> wrapping{
+        Magnum::SamplerWrapping::Repeat};
+  };
+
+  /**
+   * @brief Residency statistics.
+   */
+  struct Stats {
+    /** @brief Number of textures accounted for, managed or not */
+    std::size_t numTextures = 0;
+    /** @brief Number of textures with a streamable mip chain */
+    std::size_t numManagedTextures = 0;
+    /** @brief Number of managed textures currently demoted */
+    std::size_t numDemotedTextures = 0;
+    /** @brief Bytes of texture data currently on the GPU */
+    std::size_t residentBytes = 0;
+    /** @brief Bytes on the GPU if no managed texture was demoted */
+    std::size_t fullyResidentBytes = 0;
+    /** @brief Bytes of mip levels skipped due to the maximum resolution */
+    std::size_t skippedBytes = 0;
+    /** @brief Number of demotions done to satisfy the budget */
+    std::size_t demotions = 0;
+    /** @brief Number of promotions of demoted textures on draw */
+    std::size_t promotions = 0;
+    /**
+     * @brief Number of frames in which the budget was exceeded, e.g. because
+     * the textures drawn in the frame didn't fit in it
+     */
+    std::size_t overBudgetFrames = 0;
+  };
+
+  /**
+   * @brief Constructor
+   * @param memoryBudget Budget in bytes for resident texture data, 0 for no
+   * limit.
+   * @param maxResolution Largest texture dimension uploaded, 0 for no limit.
+   */
+  explicit TextureResidencyManager(std::size_t memoryBudget = 0,
+                                   int maxResolution = 0);
+
+  /**
+   * @brief Set the budget in bytes for resident texture data, 0 for no limit.
+   * Demotes textures immediately if needed.
+   */
+  void setMemoryBudget(std::size_t memoryBudget);
+
+  /**
+   * @brief Get the budget in bytes for resident texture data.
+   */
+  std::size_t getMemoryBudget() const { return memoryBudget_; }
+
+  /**
+   * @brief Set the largest texture dimension uploaded, 0 for no limit. Only
+   * affects textures added afterwards.
+   */
+  void setMaxResolution(int maxResolution) { maxResolution_ = maxResolution; }
+
+  /**
+   * @brief Get the largest texture dimension uploaded, 0 for no limit.
+   */
+  int getMaxResolution() const { return maxResolution_; }
+
+  /**
+   * @brief Take ownership of the CPU-side mip chain of a texture and upload
+   * the levels allowed by the maximum resolution to it.
+   * @param texture The texture to manage. Must not have storage allocated yet
+   * and must outlive this manager or be removed with @ref removeTexture.
+   * @param levels All mip levels of the texture, largest first. Must all be
+   * either compressed or uncompressed, with the same format.
+   * @param sampler Sampler state to apply to the texture.
+   */
+  void addTexture(Magnum::GL::Texture2D& texture,
+                  std::vector<Magnum::Trade::ImageData2D>&& levels,
+                  const SamplerState& sampler);
+
+  /**
+   * @brief Account for the memory of a texture uploaded by the caller, which
+   * is never demoted.
+   * @param texture The texture.
+   * @param byteSize Size of the texture data on the GPU.
+   */
+  void addUnmanagedTexture(const Magnum::GL::Texture2D& texture,
+                           std::size_t byteSize);
+
+  /**
+   * @brief Stop tracking a texture, e.g. before destroying it.
+   */
+  void removeTexture(const Magnum::GL::Texture2D& texture);
+
+  /**
+   * @brief Size in bytes of the data of a texture currently on the GPU, 0 if
+   * the texture is unknown.
+   */
+  std::size_t getTextureByteSize(const Magnum::GL::Texture2D& texture) const;
+
+  /**
+   * @brief Start a new frame. Textures touched in previous frames may be
+   * demoted again.
+   */
+  void beginFrame() { ++frame_; }
+
+  /**
+   * @brief Report that a texture is about to be drawn in the current frame.
+   * Promotes it if it was demoted, then demotes textures not drawn in the
+   * current frame if over budget. Unknown textures are ignored.
+   */
+  void touch(const Magnum::GL::Texture2D* texture);
+
+  /**
+   * @brief Get a copy of the current statistics.
+   */
+  Stats getStats() const;
+
+  ESP_SMART_POINTERS(TextureResidencyManager)
+
+ private:
+  struct Record {
+    Magnum::GL::Texture2D* texture = nullptr;
+    std::vector<Magnum::Trade::ImageData2D> levels;
+    SamplerState sampler;
+    Magnum::GL::TextureFormat format{};
+    //! Largest level uploaded when fully resident
+    int fullBaseLevel = 0;
+    //! Largest level uploaded when demoted
+    int demotedBaseLevel = 0;
+    //! Largest level currently uploaded
+    int residentBaseLevel = 0;
+    std::size_t residentBytes = 0;
+    //! Position in lru_, only valid when fully resident
+    std::list<Record*>::iterator lruPosition;
+    //! Frame in which the texture was last touched, 0 if never
+    std::uint64_t touchedFrame = 0;
+    bool isManaged = false;
+  };
+
+  /**
+   * @brief Recreate the texture of a record with the levels starting at
+   * baseLevel.
+   */
+  void upload(Record& record, int baseLevel);
+
+  /**
+   * @brief Size in bytes of the levels of a record starting at baseLevel.
+   */
+  static std::size_t byteSizeFrom(const Record& record, int baseLevel);
+
+  /**
+   * @brief Demote least recently drawn textures, except the given one and
+   * those drawn in the current frame, until within budget.
+   */
+  void demoteToBudget(const Record* keep);
+
+  std::unordered_map<const Magnum::GL::Texture2D*, Record> records_;
+
+  //! Fully resident managed textures, least recently drawn first.
+  std::list<Record*> lru_;
+
+  std::size_t memoryBudget_;
+  int maxResolution_;
+  std::size_t residentBytes_ = 0;
+  //! Current frame, see @ref beginFrame
+  std::uint64_t frame_ = 1;
+  //! Last frame counted in Stats::overBudgetFrames
+  std::uint64_t overBudgetFrame_ = 0;
+  Stats stats_;
+};
+
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_TEXTURERESIDENCYMANAGER_H_
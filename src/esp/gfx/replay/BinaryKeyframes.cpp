@@ -0,0 +1,633 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BinaryKeyframes.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <Magnum/Math/Packing.h>
+
+#include "esp/io/JsonAllTypes.h"
+#include "esp/io/json.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+namespace {
+
+// bump whenever the layout below changes
+constexpr std::uint32_t BinaryFileVersion = 1;
+constexpr char BinaryFileMagic[4] = {'E', 'R', 'P', 'L'};
+constexpr char IndexMagic[4] = {'E', 'I', 'D', 'X'};
+
+/* File layout:
+
+   FileHeader
+   for each keyframe:
+     std::uint32_t size of the record following this field
+     std::uint32_t number of strings first used by this keyframe, followed by
+                   the strings, each as std::uint32_t size and characters
+     loads, creations, deletions, state updates and user transforms, each as
+                   std::uint32_t count and the items, see writeKeyframe()
+   index, written by close():
+     std::uint32_t IndexMarker in place of a record size
+     std::uint64_t keyframe count, followed by the keyframe offsets
+     std::uint32_t string count, followed by the strings
+   IndexTrailer */
+
+struct FileHeader {
+  char magic[4];
+  std::uint32_t version;
+  //! Value of BinaryTransformPrecision
+  std::uint32_t precision;
+  std::uint32_t reserved;
+};
+
+struct IndexTrailer {
+  std::uint64_t indexOffset;
+  char magic[4];
+  std::uint32_t reserved;
+};
+
+constexpr std::uint32_t IndexMarker = 0xffffffffu;
+
+template <class T>
+void append(std::vector<char>& buffer, const T& value) {
+  const std::size_t size = buffer.size();
+  buffer.resize(size + sizeof(T));
+  std::memcpy(buffer.data() + size, &value, sizeof(T));
+}
+
+void appendString(std::vector<char>& buffer, const std::string& string) {
+  append(buffer, std::uint32_t(string.size()));
+  buffer.insert(buffer.end(), string.begin(), string.end());
+}
+
+void appendVector3(std::vector<char>& buffer, const float* data) {
+  for (int i = 0; i < 3; ++i) {
+    append(buffer, data[i]);
+  }
+}
+
+//! Bounds-checked reading from a record, a failed read fails all later ones
+class RecordReader {
+ public:
+  RecordReader(const char* data, std::size_t size)
+      : data_(data), size_(size) {}
+
+  template <class T>
+  bool read(T& value) {
+    if (failed_ || size_ - pos_ < sizeof(T)) {
+      failed_ = true;
+      return false;
+    }
+    std::memcpy(&value, data_ + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool readString(std::string& string) {
+    std::uint32_t size = 0;
+    if (!read(size) || size_ - pos_ < size) {
+      failed_ = true;
+      return false;
+    }
+    string.assign(data_ + pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool readVector3(float* data) {
+    return read(data[0]) && read(data[1]) && read(data[2]);
+  }
+
+  bool failed() const { return failed_; }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+  bool failed_ = false;
+};
+
+bool readStringId(RecordReader& reader,
+                  const std::vector<std::string>& strings,
+                  std::string& string) {
+  std::uint32_t id = 0;
+  if (!reader.read(id) || id >= strings.size()) {
+    return false;
+  }
+  string = strings[id];
+  return true;
+}
+
+bool readTransform(RecordReader& reader,
+                   BinaryTransformPrecision precision,
+                   Transform& transform) {
+  reader.readVector3(transform.translation.data());
+  if (precision == BinaryTransformPrecision::Float16Rotations) {
+    Mn::Vector4us packed;
+    for (int i = 0; i < 4; ++i) {
+      reader.read(packed[i]);
+    }
+    const Mn::Vector4 unpacked = Mn::Math::unpackHalf(packed);
+    transform.rotation =
+        Mn::Quaternion{unpacked.xyz(), unpacked.w()}.normalized();
+  } else {
+    Mn::Vector3 vector;
+    float scalar = 1.0f;
+    reader.readVector3(vector.data());
+    reader.read(scalar);
+    transform.rotation = Mn::Quaternion{vector, scalar};
+  }
+  return !reader.failed();
+}
+
+//! Skips the strings introduced by the record, the caller knows them already
+bool readKeyframeBody(RecordReader& reader,
+                      const std::vector<std::string>& strings,
+                      BinaryTransformPrecision precision,
+                      Keyframe& keyframe) {
+  keyframe = Keyframe{};
+
+  std::uint32_t count = 0;
+  std::string newString;
+  reader.read(count);
+  for (std::uint32_t i = 0; i < count && !reader.failed(); ++i) {
+    reader.readString(newString);
+  }
+
+  reader.read(count);
+  for (std::uint32_t i = 0; i < count && !reader.failed(); ++i) {
+    esp::assets::AssetInfo info;
+    std::uint32_t type = 0;
+    vec3f up, front, origin;
+    std::uint8_t requiresLighting = 0;
+    std::uint8_t splitInstanceMesh = 0;
+    if (!reader.read(type) || !readStringId(reader, strings, info.filepath) ||
+        !reader.readVector3(up.data()) || !reader.readVector3(front.data()) ||
+        !reader.readVector3(origin.data()) ||
+        !reader.read(info.virtualUnitToMeters) ||
+        !reader.read(requiresLighting) || !reader.read(splitInstanceMesh)) {
+      return false;
+    }
+    info.type = esp::assets::AssetType(type);
+    info.frame = geo::CoordinateFrame(up, front, origin);
+    info.requiresLighting = requiresLighting;
+    info.splitInstanceMesh = splitInstanceMesh;
+    keyframe.loads.push_back(std::move(info));
+  }
+
+  using CreationInfo = esp::assets::RenderAssetInstanceCreationInfo;
+  reader.read(count);
+  for (std::uint32_t i = 0; i < count && !reader.failed(); ++i) {
+    RenderAssetInstanceKey key = ID_UNDEFINED;
+    CreationInfo creation;
+    std::uint8_t hasScale = 0;
+    std::uint32_t flags = 0;
+    if (!reader.read(key) ||
+        !readStringId(reader, strings, creation.filepath) ||
+        !reader.read(hasScale)) {
+      return false;
+    }
+    if (hasScale) {
+      Mn::Vector3 scale;
+      reader.readVector3(scale.data());
+      creation.scale = scale;
+    }
+    if (!reader.read(flags) ||
+        !readStringId(reader, strings, creation.lightSetupKey)) {
+      return false;
+    }
+    creation.flags = CreationInfo::Flags{CreationInfo::Flag(flags)};
+    keyframe.creations.emplace_back(key, std::move(creation));
+  }
+
+  reader.read(count);
+  for (std::uint32_t i = 0; i < count && !reader.failed(); ++i) {
+    RenderAssetInstanceKey key = ID_UNDEFINED;
+    reader.read(key);
+    keyframe.deletions.push_back(key);
+  }
+
+  reader.read(count);
+  for (std::uint32_t i = 0; i < count && !reader.failed(); ++i) {
+    RenderAssetInstanceKey key = ID_UNDEFINED;
+    RenderAssetInstanceState state;
+    std::int32_t semanticId = ID_UNDEFINED;
+    if (!reader.read(key) ||
+        !readTransform(reader, precision, state.absTransform) ||
+        !reader.read(semanticId)) {
+      return false;
+    }
+    state.semanticId = semanticId;
+    keyframe.stateUpdates.emplace_back(key, state);
+  }
+
+  reader.read(count);
+  for (std::uint32_t i = 0; i < count && !reader.failed(); ++i) {
+    std::string name;
+    Transform transform;
+    if (!readStringId(reader, strings, name) ||
+        !readTransform(reader, precision, transform)) {
+      return false;
+    }
+    keyframe.userTransforms[name] = transform;
+  }
+
+  return !reader.failed();
+}  // readKeyframeBody
+
+}  // namespace
+
+BinaryKeyframeWriter::~BinaryKeyframeWriter() {
+  close();
+}
+
+bool BinaryKeyframeWriter::open(const std::string& filepath,
+                                BinaryTransformPrecision precision) {
+  close();
+
+  file_.open(filepath, std::ios::binary | std::ios::trunc);
+  if (!file_.good()) {
+    LOG(ERROR) << "BinaryKeyframeWriter::open: can't create " << filepath;
+    file_.close();
+    return false;
+  }
+  filepath_ = filepath;
+  precision_ = precision;
+  keyframeOffsets_.clear();
+  stringIds_.clear();
+  strings_.clear();
+
+  FileHeader header{};
+  std::copy(BinaryFileMagic, BinaryFileMagic + 4, header.magic);
+  header.version = BinaryFileVersion;
+  header.precision = std::uint32_t(precision);
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  offset_ = sizeof(header);
+  return true;
+}
+
+std::uint32_t BinaryKeyframeWriter::internString(const std::string& string) {
+  auto it = stringIds_.find(string);
+  if (it != stringIds_.end()) {
+    return it->second;
+  }
+  const std::uint32_t id = strings_.size();
+  stringIds_.emplace(string, id);
+  strings_.push_back(string);
+  newStrings_.push_back(string);
+  return id;
+}
+
+void BinaryKeyframeWriter::writeTransform(const Transform& transform,
+                                          std::vector<char>& buffer) {
+  appendVector3(buffer, transform.translation.data());
+  if (precision_ == BinaryTransformPrecision::Float16Rotations) {
+    const Mn::Vector4us packed = Mn::Math::packHalf(
+        Mn::Vector4{transform.rotation.vector(), transform.rotation.scalar()});
+    for (int i = 0; i < 4; ++i) {
+      append(buffer, packed[i]);
+    }
+  } else {
+    appendVector3(buffer, transform.rotation.vector().data());
+    append(buffer, transform.rotation.scalar());
+  }
+}
+
+void BinaryKeyframeWriter::writeKeyframe(const Keyframe& keyframe) {
+  if (!isOpen()) {
+    LOG(ERROR) << "BinaryKeyframeWriter::writeKeyframe: no file open";
+    return;
+  }
+
+  // everything but the new strings, which are known only at the end
+  std::vector<char>& buffer = buffer_;
+  buffer.clear();
+  newStrings_.clear();
+
+  append(buffer, std::uint32_t(keyframe.loads.size()));
+  for (const auto& info : keyframe.loads) {
+    append(buffer, std::uint32_t(info.type));
+    append(buffer, internString(info.filepath));
+    appendVector3(buffer, info.frame.up().data());
+    appendVector3(buffer, info.frame.front().data());
+    appendVector3(buffer, info.frame.origin().data());
+    append(buffer, info.virtualUnitToMeters);
+    append(buffer, std::uint8_t(info.requiresLighting));
+    append(buffer, std::uint8_t(info.splitInstanceMesh));
+  }
+
+  append(buffer, std::uint32_t(keyframe.creations.size()));
+  for (const auto& pair : keyframe.creations) {
+    const auto& creation = pair.second;
+    append(buffer, std::int32_t(pair.first));
+    append(buffer, internString(creation.filepath));
+    append(buffer, std::uint8_t(bool(creation.scale)));
+    if (creation.scale) {
+      appendVector3(buffer, creation.scale->data());
+    }
+    append(buffer, std::uint32_t(creation.flags));
+    append(buffer, internString(creation.lightSetupKey));
+  }
+
+  append(buffer, std::uint32_t(keyframe.deletions.size()));
+  for (const auto key : keyframe.deletions) {
+    append(buffer, std::int32_t(key));
+  }
+
+  append(buffer, std::uint32_t(keyframe.stateUpdates.size()));
+  for (const auto& pair : keyframe.stateUpdates) {
+    append(buffer, std::int32_t(pair.first));
+    writeTransform(pair.second.absTransform, buffer);
+    append(buffer, std::int32_t(pair.second.semanticId));
+  }
+
+  append(buffer, std::uint32_t(keyframe.userTransforms.size()));
+  for (const auto& pair : keyframe.userTransforms) {
+    append(buffer, internString(pair.first));
+    writeTransform(pair.second, buffer);
+  }
+
+  std::vector<char> stringsBuffer;
+  append(stringsBuffer, std::uint32_t(newStrings_.size()));
+  for (const auto& string : newStrings_) {
+    appendString(stringsBuffer, string);
+  }
+
+  const std::uint32_t recordSize = stringsBuffer.size() + buffer.size();
+  file_.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+  file_.write(stringsBuffer.data(), stringsBuffer.size());
+  file_.write(buffer.data(), buffer.size());
+  file_.flush();
+  if (!file_.good()) {
+    LOG(ERROR) << "BinaryKeyframeWriter::writeKeyframe: failed to write to "
+               << filepath_;
+    return;
+  }
+
+  keyframeOffsets_.push_back(offset_);
+  offset_ += sizeof(recordSize) + recordSize;
+}  // BinaryKeyframeWriter::writeKeyframe
+
+void BinaryKeyframeWriter::close() {
+  if (!isOpen()) {
+    return;
+  }
+
+  std::vector<char> buffer;
+  append(buffer, IndexMarker);
+  append(buffer, std::uint64_t(keyframeOffsets_.size()));
+  for (const auto offset : keyframeOffsets_) {
+    append(buffer, offset);
+  }
+  append(buffer, std::uint32_t(strings_.size()));
+  for (const auto& string : strings_) {
+    appendString(buffer, string);
+  }
+
+  IndexTrailer trailer{};
+  trailer.indexOffset = offset_;
+  std::copy(IndexMagic, IndexMagic + 4, trailer.magic);
+  append(buffer, trailer);
+
+  file_.write(buffer.data(), buffer.size());
+  file_.close();
+  if (file_.fail()) {
+    LOG(ERROR) << "BinaryKeyframeWriter::close: failed to write the index to "
+               << filepath_;
+  }
+  file_.clear();
+}
+
+bool BinaryKeyframeReader::open(const std::string& filepath) {
+  file_.close();
+  file_.clear();
+  filepath_ = filepath;
+  keyframeOffsets_.clear();
+  strings_.clear();
+
+  file_.open(filepath, std::ios::binary | std::ios::ate);
+  if (!file_.good()) {
+    LOG(ERROR) << "BinaryKeyframeReader::open: can't open " << filepath;
+    return false;
+  }
+  const std::uint64_t fileSize = file_.tellg();
+  fileSize_ = fileSize;
+  file_.seekg(0);
+
+  FileHeader header{};
+  if (!file_.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      !std::equal(header.magic, header.magic + 4, BinaryFileMagic) ||
+      header.version != BinaryFileVersion) {
+    LOG(ERROR) << "BinaryKeyframeReader::open: " << filepath
+               << " is not a binary replay file of version "
+               << BinaryFileVersion;
+    file_.close();
+    return false;
+  }
+  if (header.precision > std::uint32_t(
+                             BinaryTransformPrecision::Float16Rotations)) {
+    LOG(ERROR) << "BinaryKeyframeReader::open: unknown transform precision "
+               << header.precision << " in " << filepath;
+    file_.close();
+    return false;
+  }
+  precision_ = BinaryTransformPrecision(header.precision);
+
+  if (!readIndex(fileSize)) {
+    LOG(WARNING) << "BinaryKeyframeReader::open: " << filepath
+                 << " has no index, probably because its recording got "
+                    "interrupted. Scanning it for keyframes.";
+    if (!scanKeyframes(fileSize)) {
+      file_.close();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BinaryKeyframeReader::readIndex(std::uint64_t fileSize) {
+  if (fileSize < sizeof(FileHeader) + sizeof(IndexTrailer)) {
+    return false;
+  }
+  IndexTrailer trailer{};
+  file_.seekg(fileSize - sizeof(IndexTrailer));
+  if (!file_.read(reinterpret_cast<char*>(&trailer), sizeof(trailer)) ||
+      !std::equal(trailer.magic, trailer.magic + 4, IndexMagic) ||
+      trailer.indexOffset < sizeof(FileHeader) ||
+      trailer.indexOffset > fileSize - sizeof(IndexTrailer)) {
+    file_.clear();
+    return false;
+  }
+
+  buffer_.resize(fileSize - sizeof(IndexTrailer) - trailer.indexOffset);
+  file_.seekg(trailer.indexOffset);
+  if (!file_.read(buffer_.data(), buffer_.size())) {
+    file_.clear();
+    return false;
+  }
+
+  RecordReader reader{buffer_.data(), buffer_.size()};
+  std::uint32_t marker = 0;
+  std::uint64_t numKeyframes = 0;
+  if (!reader.read(marker) || marker != IndexMarker ||
+      !reader.read(numKeyframes) ||
+      numKeyframes > buffer_.size() / sizeof(std::uint64_t)) {
+    return false;
+  }
+  keyframeOffsets_.resize(numKeyframes);
+  for (auto& offset : keyframeOffsets_) {
+    reader.read(offset);
+    // each keyframe record starts with its size, before the index
+    if (offset < sizeof(FileHeader) ||
+        offset > trailer.indexOffset - sizeof(std::uint32_t)) {
+      keyframeOffsets_.clear();
+      return false;
+    }
+  }
+  std::uint32_t numStrings = 0;
+  reader.read(numStrings);
+  for (std::uint32_t i = 0; i < numStrings && !reader.failed(); ++i) {
+    strings_.emplace_back();
+    reader.readString(strings_.back());
+  }
+  if (reader.failed()) {
+    keyframeOffsets_.clear();
+    strings_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool BinaryKeyframeReader::scanKeyframes(std::uint64_t fileSize) {
+  std::uint64_t offset = sizeof(FileHeader);
+  file_.seekg(offset);
+  std::uint32_t recordSize = 0;
+  while (file_.read(reinterpret_cast<char*>(&recordSize),
+                    sizeof(recordSize)) &&
+         recordSize != IndexMarker &&
+         recordSize <= fileSize - offset - sizeof(recordSize)) {
+    buffer_.resize(recordSize);
+    if (!file_.read(buffer_.data(), buffer_.size())) {
+      break;
+    }
+    RecordReader reader{buffer_.data(), buffer_.size()};
+    std::uint32_t numNewStrings = 0;
+    reader.read(numNewStrings);
+    for (std::uint32_t i = 0; i < numNewStrings && !reader.failed(); ++i) {
+      strings_.emplace_back();
+      reader.readString(strings_.back());
+    }
+    if (reader.failed()) {
+      break;
+    }
+    keyframeOffsets_.push_back(offset);
+    offset += sizeof(recordSize) + recordSize;
+  }
+  file_.clear();
+  return true;
+}
+
+bool BinaryKeyframeReader::readKeyframe(int index, Keyframe& keyframe) {
+  if (index < 0 || index >= getNumKeyframes()) {
+    LOG(ERROR) << "BinaryKeyframeReader::readKeyframe: index " << index
+               << " out of range for " << getNumKeyframes() << " keyframes";
+    return false;
+  }
+
+  std::uint32_t recordSize = 0;
+  const std::uint64_t offset = keyframeOffsets_[index];
+  file_.seekg(offset);
+  if (!file_.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize))) {
+    file_.clear();
+    return false;
+  }
+  if (recordSize > fileSize_ - offset - sizeof(recordSize)) {
+    LOG(ERROR) << "BinaryKeyframeReader::readKeyframe: keyframe " << index
+               << " of " << filepath_ << " extends past the end of the file";
+    return false;
+  }
+  buffer_.resize(recordSize);
+  if (!file_.read(buffer_.data(), buffer_.size())) {
+    file_.clear();
+    return false;
+  }
+
+  RecordReader reader{buffer_.data(), buffer_.size()};
+  if (!readKeyframeBody(reader, strings_, precision_, keyframe)) {
+    LOG(ERROR) << "BinaryKeyframeReader::readKeyframe: keyframe " << index
+               << " of " << filepath_ << " is corrupted";
+    return false;
+  }
+  return true;
+}
+
+bool BinaryKeyframeReader::readAllKeyframes(std::vector<Keyframe>& keyframes) {
+  keyframes.clear();
+  keyframes.resize(getNumKeyframes());
+  for (int i = 0; i < getNumKeyframes(); ++i) {
+    if (!readKeyframe(i, keyframes[i])) {
+      keyframes.resize(i);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool isBinaryKeyframeFile(const std::string& filepath) {
+  std::ifstream file(filepath, std::ios::binary);
+  char magic[4]{};
+  return file.read(magic, 4) &&
+         std::equal(magic, magic + 4, BinaryFileMagic);
+}
+
+bool convertJsonKeyframesToBinary(const std::string& jsonFilepath,
+                                  const std::string& binaryFilepath,
+                                  BinaryTransformPrecision precision) {
+  std::vector<Keyframe> keyframes;
+  try {
+    auto document = esp::io::parseJsonFile(jsonFilepath);
+    esp::io::readMember(document, "keyframes", keyframes);
+  } catch (...) {
+    LOG(ERROR) << "convertJsonKeyframesToBinary: failed to parse keyframes "
+                  "from "
+               << jsonFilepath;
+    return false;
+  }
+
+  BinaryKeyframeWriter writer;
+  if (!writer.open(binaryFilepath, precision)) {
+    return false;
+  }
+  for (const auto& keyframe : keyframes) {
+    writer.writeKeyframe(keyframe);
+  }
+  const bool success = writer.getNumKeyframes() == int(keyframes.size());
+  writer.close();
+  return success;
+}
+
+bool convertBinaryKeyframesToJson(const std::string& binaryFilepath,
+                                  const std::string& jsonFilepath) {
+  BinaryKeyframeReader reader;
+  std::vector<Keyframe> keyframes;
+  if (!reader.open(binaryFilepath) || !reader.readAllKeyframes(keyframes)) {
+    return false;
+  }
+
+  rapidjson::Document document(rapidjson::kObjectType);
+  esp::io::addMember(document, "keyframes", keyframes,
+                     document.GetAllocator());
+  return esp::io::writeJsonToFile(document, jsonFilepath);
+}
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
@@ -0,0 +1,182 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_GFX_REPLAY_BINARYKEYFRAMES_H_
+#define ESP_GFX_REPLAY_BINARYKEYFRAMES_H_
+
+/** @file
+ * @brief Class @ref esp::gfx::replay::BinaryKeyframeWriter, class
+ * @ref esp::gfx::replay::BinaryKeyframeReader, enum
+ * @ref esp::gfx::replay::BinaryTransformPrecision
+ */
+
+#include "Keyframe.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace esp {
+namespace gfx {
+namespace replay {
+
+/**
+ * @brief How @ref BinaryKeyframeWriter stores transforms
+ */
+enum class BinaryTransformPrecision : std::uint32_t {
+  //! Translations and rotations as 32-bit floats, lossless
+  Float32 = 0,
+
+  //! Rotations as 16-bit floats, translations as 32-bit floats. Rotations
+  //! are unit quaternions, which half floats store to about 1e-3, while
+  //! half float translations would be off by centimeters a few meters away
+  //! from the origin.
+  Float16Rotations = 1,
+};
+
+/**
+ * @brief Append-only writer of binary replay files.
+ *
+ * Binary counterpart of @ref Recorder::writeSavedKeyframesToFile, with
+ * keyframes written one by one instead of all at once. Each keyframe is
+ * flushed to disk as it's written, so a long recording doesn't need to keep
+ * its keyframes in memory, and a recording that got interrupted can still be
+ * read up to its last complete keyframe.
+ *
+ * Strings, e.g. asset filepaths and light setup keys, are stored once, the
+ * first time a keyframe uses them, and referred to by index afterwards.
+ * @ref close appends an index of the keyframe offsets and a table of all
+ * strings, so @ref BinaryKeyframeReader can read any keyframe without
+ * reading the ones before it.
+ */
+class BinaryKeyframeWriter {
+ public:
+  BinaryKeyframeWriter() = default;
+
+  /** @brief Calls @ref close */
+  ~BinaryKeyframeWriter();
+
+  BinaryKeyframeWriter(const BinaryKeyframeWriter&) = delete;
+  BinaryKeyframeWriter& operator=(const BinaryKeyframeWriter&) = delete;
+
+  /**
+   * @brief Create a file and write the header. An already open file gets
+   * closed first.
+   * @return Whether the file could be created.
+   */
+  bool open(const std::string& filepath,
+            BinaryTransformPrecision precision =
+                BinaryTransformPrecision::Float32);
+
+  /** @brief Whether a file is open */
+  bool isOpen() const { return file_.is_open(); }
+
+  /** @brief Append a keyframe and flush it to disk */
+  void writeKeyframe(const Keyframe& keyframe);
+
+  /** @brief Number of keyframes written since @ref open */
+  int getNumKeyframes() const { return keyframeOffsets_.size(); }
+
+  /**
+   * @brief Write the index and close the file. Does nothing if no file is
+   * open.
+   */
+  void close();
+
+  ESP_SMART_POINTERS(BinaryKeyframeWriter)
+
+ private:
+  std::uint32_t internString(const std::string& string);
+  void writeTransform(const Transform& transform, std::vector<char>& buffer);
+
+  std::ofstream file_;
+  std::string filepath_;
+  BinaryTransformPrecision precision_ = BinaryTransformPrecision::Float32;
+  std::uint64_t offset_ = 0;
+  std::vector<std::uint64_t> keyframeOffsets_;
+  std::unordered_map<std::string, std::uint32_t> stringIds_;
+  std::vector<std::string> strings_;
+  std::vector<std::string> newStrings_;
+  //! Kept across keyframes to avoid reallocating it every keyframe
+  std::vector<char> buffer_;
+};
+
+/**
+ * @brief Reader of files written by @ref BinaryKeyframeWriter.
+ *
+ * Files that weren't closed properly, e.g. because the recording process
+ * crashed, have no index; their keyframes get found by scanning the file on
+ * @ref open, up to the last complete one.
+ */
+class BinaryKeyframeReader {
+ public:
+  /**
+   * @brief Open a file and read its index.
+   * @return Whether the file is a valid binary replay file.
+   */
+  bool open(const std::string& filepath);
+
+  /** @brief Number of keyframes in the opened file */
+  int getNumKeyframes() const { return keyframeOffsets_.size(); }
+
+  /** @brief Precision the opened file stores transforms with */
+  BinaryTransformPrecision getPrecision() const { return precision_; }
+
+  /**
+   * @brief Read a single keyframe.
+   * @return Whether the keyframe could be read.
+   */
+  bool readKeyframe(int index, Keyframe& keyframe);
+
+  /**
+   * @brief Read all keyframes, replacing the content of @p keyframes.
+   * @return Whether all keyframes could be read.
+   */
+  bool readAllKeyframes(std::vector<Keyframe>& keyframes);
+
+  ESP_SMART_POINTERS(BinaryKeyframeReader)
+
+ private:
+  bool readIndex(std::uint64_t fileSize);
+  bool scanKeyframes(std::uint64_t fileSize);
+
+  std::ifstream file_;
+  std::string filepath_;
+  std::uint64_t fileSize_ = 0;
+  BinaryTransformPrecision precision_ = BinaryTransformPrecision::Float32;
+  std::vector<std::uint64_t> keyframeOffsets_;
+  std::vector<std::string> strings_;
+  std::vector<char> buffer_;
+};
+
+/**
+ * @brief Whether a file starts like a file written by
+ * @ref BinaryKeyframeWriter
+ */
+bool isBinaryKeyframeFile(const std::string& filepath);
+
+/**
+ * @brief Convert a JSON replay file, as written by
+ * @ref Recorder::writeSavedKeyframesToFile, to the binary format.
+ * @return Whether the conversion succeeded.
+ */
+bool convertJsonKeyframesToBinary(const std::string& jsonFilepath,
+                                  const std::string& binaryFilepath,
+                                  BinaryTransformPrecision precision =
+                                      BinaryTransformPrecision::Float32);
+
+/**
+ * @brief Convert a binary replay file to JSON.
+ * @return Whether the conversion succeeded.
+ */
+bool convertBinaryKeyframesToJson(const std::string& binaryFilepath,
+                                  const std::string& jsonFilepath);
+
+}  // namespace replay
+}  // namespace gfx
+}  // namespace esp
+
+#endif  // ESP_GFX_REPLAY_BINARYKEYFRAMES_H_
@@ -10,6 +10,8 @@
 
 #include <rapidjson/document.h>
 
+#include <unordered_set>
+
 namespace esp {
 namespace gfx {
 namespace replay {
@@ -19,58 +21,160 @@ void Player::readKeyframesFromJsonDocument(const rapidjson::Document& d) {
   esp::io::readMember(d, "keyframes", keyframes_);
 }
 
+const Keyframe& Player::getKeyframe(int frameIndex) {
+  if (!lazyReader_) {
+    return keyframes_[frameIndex];
+  }
+  if (lazyKeyframeIndex_ != frameIndex) {
+    if (!lazyReader_->readKeyframe(frameIndex, lazyKeyframe_)) {
+      // logged by the reader already, continue with an empty keyframe
+      lazyKeyframe_ = Keyframe{};
+    }
+    lazyKeyframeIndex_ = frameIndex;
+  }
+  return lazyKeyframe_;
+}
+
 Player::Player(const LoadAndCreateRenderAssetInstanceCallback& callback)
     : loadAndCreateRenderAssetInstanceCallback(callback) {}
 
 void Player::readKeyframesFromFile(const std::string& filepath) {
   clearFrame();
   keyframes_.clear();
+  lazyReader_ = nullptr;
+  lazyKeyframeIndex_ = -1;
+  fullStateKeyframes_.clear();
 
   if (!Corrade::Utility::Directory::exists(filepath)) {
     LOG(ERROR) << "Player::readKeyframesFromFile: file " << filepath
                << " not found.";
     return;
   }
-  try {
-    auto newDoc = esp::io::parseJsonFile(filepath);
-    readKeyframesFromJsonDocument(newDoc);
-  } catch (...) {
-    LOG(ERROR)
-        << "Player::readKeyframesFromFile: failed to parse keyframes from "
-        << filepath << ".";
+  if (isBinaryKeyframeFile(filepath)) {
+    // keyframes get read from the file as they're needed
+    lazyReader_ = std::make_unique<BinaryKeyframeReader>();
+    if (!lazyReader_->open(filepath)) {
+      LOG(ERROR) << "Player::readKeyframesFromFile: failed to read keyframes "
+                    "from "
+                 << filepath << ".";
+      lazyReader_ = nullptr;
+      return;
+    }
+  } else {
+    try {
+      auto newDoc = esp::io::parseJsonFile(filepath);
+      readKeyframesFromJsonDocument(newDoc);
+    } catch (...) {
+      LOG(ERROR)
+          << "Player::readKeyframesFromFile: failed to parse keyframes from "
+          << filepath << ".";
+      keyframes_.clear();
+      return;
+    }
   }
+  buildFullStateKeyframes();
 }
 
+void Player::setFullStateKeyframeInterval(int interval) {
+  if (interval <= 0) {
+    LOG(ERROR) << "Player::setFullStateKeyframeInterval: interval must be "
+                  "positive, got "
+               << interval << ". Ignoring.";
+    return;
+  }
+  fullStateKeyframeInterval_ = interval;
+  buildFullStateKeyframes();
+}
+
+void Player::buildFullStateKeyframes() {
+  fullStateKeyframes_.clear();
+
+  // consolidate keyframes the same way applyKeyframe() applies them
+  std::map<std::string, esp::assets::AssetInfo> loads;
+  std::map<RenderAssetInstanceKey,
+           esp::assets::RenderAssetInstanceCreationInfo>
+      creations;
+  std::map<RenderAssetInstanceKey, RenderAssetInstanceState> states;
+  for (int i = 0; i < getNumKeyframes(); ++i) {
+    const Keyframe& keyframe = getKeyframe(i);
+    for (const auto& assetInfo : keyframe.loads) {
+      loads[assetInfo.filepath] = assetInfo;
+    }
+    for (const auto& pair : keyframe.creations) {
+      creations[pair.first] = pair.second;
+    }
+    for (const auto& deletionInstanceKey : keyframe.deletions) {
+      creations.erase(deletionInstanceKey);
+      states.erase(deletionInstanceKey);
+    }
+    for (const auto& pair : keyframe.stateUpdates) {
+      if (creations.count(pair.first)) {
+        states[pair.first] = pair.second;
+      }
+    }
+
+    if ((i + 1) % fullStateKeyframeInterval_ != 0) {
+      continue;
+    }
+    Keyframe& fullState = fullStateKeyframes_[i];
+    for (const auto& pair : loads) {
+      fullState.loads.push_back(pair.second);
+    }
+    fullState.creations.assign(creations.begin(), creations.end());
+    fullState.stateUpdates.assign(states.begin(), states.end());
+    fullState.userTransforms = keyframe.userTransforms;
+  }
+}  // Player::buildFullStateKeyframes
+
 int Player::getKeyframeIndex() const {
   return frameIndex_;
 }
 
 int Player::getNumKeyframes() const {
-  return keyframes_.size();
+  return lazyReader_ ? lazyReader_->getNumKeyframes() : keyframes_.size();
 }
 
 void Player::setKeyframeIndex(int frameIndex) {
   ASSERT(frameIndex == -1 ||
          (frameIndex >= 0 && frameIndex < getNumKeyframes()));
 
-  if (frameIndex < frameIndex_) {
+  if (frameIndex == -1) {
+    clearFrame();
+    return;
+  }
+
+  // start from the closest full-state keyframe if applying the keyframes
+  // since the current one can't be done or takes longer
+  auto fullState = fullStateKeyframes_.upper_bound(frameIndex);
+  if (fullState != fullStateKeyframes_.begin()) {
+    --fullState;
+    if (frameIndex < frameIndex_ || fullState->first > frameIndex_) {
+      applyFullStateKeyframe(fullState->second);
+      frameIndex_ = fullState->first;
+    }
+  } else if (frameIndex < frameIndex_) {
     clearFrame();
   }
 
   while (frameIndex_ < frameIndex) {
-    applyKeyframe(keyframes_[++frameIndex_]);
+    applyKeyframe(getKeyframe(++frameIndex_));
   }
 }
 
+void Player::applyNextKeyframe(const Keyframe& keyframe) {
+  applyKeyframe(keyframe);
+  ++frameIndex_;
+}
+
 bool Player::getUserTransform(const std::string& name,
                               Magnum::Vector3* translation,
                               Magnum::Quaternion* rotation) const {
-  ASSERT(frameIndex_ >= 0 && frameIndex_ < getNumKeyframes());
+  // frameIndex_ may be past the stored keyframes after applyNextKeyframe()
+  ASSERT(frameIndex_ >= 0);
   ASSERT(translation);
   ASSERT(rotation);
-  const auto& keyframe = keyframes_[frameIndex_];
-  const auto& it = keyframe.userTransforms.find(name);
-  if (it != keyframe.userTransforms.end()) {
+  const auto& it = userTransforms_.find(name);
+  if (it != userTransforms_.end()) {
     *translation = it->second.translation;
     *rotation = it->second.rotation;
     return true;
@@ -85,10 +189,46 @@ void Player::clearFrame() {
   }
   createdInstances_.clear();
   assetInfos_.clear();
+  userTransforms_.clear();
   frameIndex_ = -1;
 }
 
+void Player::applyFullStateKeyframe(const Keyframe& keyframe) {
+  // Instance keys are unique within a recording, so an instance that exists
+  // already was created the same way and can be kept. Instances without a
+  // state yet get recreated to reset their transformation.
+  std::unordered_set<RenderAssetInstanceKey> instanceKeys;
+  for (const auto& pair : keyframe.stateUpdates) {
+    instanceKeys.insert(pair.first);
+  }
+  for (auto it = createdInstances_.begin(); it != createdInstances_.end();) {
+    if (instanceKeys.count(it->first)) {
+      ++it;
+    } else {
+      delete it->second;
+      it = createdInstances_.erase(it);
+    }
+  }
+
+  Keyframe remaining;
+  remaining.loads = keyframe.loads;
+  for (const auto& pair : keyframe.creations) {
+    if (!createdInstances_.count(pair.first)) {
+      remaining.creations.push_back(pair);
+    }
+  }
+  // the kept instances need their state set too
+  remaining.stateUpdates = keyframe.stateUpdates;
+  remaining.userTransforms = keyframe.userTransforms;
+
+  assetInfos_.clear();
+  applyKeyframe(remaining);
+}
+
 void Player::applyKeyframe(const Keyframe& keyframe) {
+  ++numKeyframesApplied_;
+  userTransforms_ = keyframe.userTransforms;
+
   for (const auto& assetInfo : keyframe.loads) {
     ASSERT(assetInfos_.count(assetInfo.filepath) == 0);
     if (failedFilepaths_.count(assetInfo.filepath)) {
@@ -5,6 +5,7 @@
 #ifndef ESP_GFX_REPLAY_PLAYER_H_
 #define ESP_GFX_REPLAY_PLAYER_H_
 
+#include "BinaryKeyframes.h"
 #include "Keyframe.h"
 
 #include "esp/assets/Asset.h"
@@ -13,8 +14,10 @@
 #include <rapidjson/document.h>
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace esp {
@@ -37,6 +40,13 @@ namespace replay {
  * rendered. Render assets are loaded as needed. See also @ref Recorder. See
  * examples/replay_tutorial.py for usage of this class through bindings (coming
  * soon).
+ *
+ * Keyframes only hold the changes since the previous one, so after reading
+ * the keyframes the player consolidates them into a full-state keyframe every
+ * @ref getFullStateKeyframeInterval keyframes. Setting a keyframe then starts
+ * from the closest full-state keyframe before it instead of from the first
+ * keyframe, keeping the instances that exist in both. Keyframes of binary
+ * files are read from disk as they're needed instead of being kept in memory.
  */
 class Player {
  public:
@@ -53,7 +63,8 @@ class Player {
 
   /**
    * @brief Read keyframes. See also @ref Recorder::writeSavedKeyframesToFile.
-   * After calling this, use @ref setKeyframeIndex to set a keyframe.
+   * Files written by @ref BinaryKeyframeWriter are recognized by their
+   * header. After calling this, use @ref setKeyframeIndex to set a keyframe.
    * @param filepath
    */
   void readKeyframesFromFile(const std::string& filepath);
@@ -74,6 +85,36 @@ class Player {
    */
   void setKeyframeIndex(int frameIndex);
 
+  /**
+   * @brief Number of keyframes between full-state keyframes. Defaults to
+   * @ref DefaultFullStateKeyframeInterval.
+   */
+  int getFullStateKeyframeInterval() const {
+    return fullStateKeyframeInterval_;
+  }
+
+  /**
+   * @brief Set the number of keyframes between full-state keyframes and
+   * rebuild them. Smaller intervals make setting an arbitrary keyframe
+   * faster at the cost of memory. Non-positive intervals are ignored with an
+   * error.
+   */
+  void setFullStateKeyframeInterval(int interval);
+
+  /**
+   * @brief Number of keyframes applied to the scene since the player got
+   * constructed, full-state keyframes included
+   */
+  int getNumKeyframesApplied() const { return numKeyframesApplied_; }
+
+  /**
+   * @brief Apply a keyframe following the currently-set one, for playing back
+   * keyframes decoded elsewhere, e.g. on another thread, without reading them
+   * into the player. The keyframe index advances by one but the keyframe
+   * isn't kept, so it can't be set again with @ref setKeyframeIndex.
+   */
+  void applyNextKeyframe(const Keyframe& keyframe);
+
   /**
    * @brief Get a user transform. See @ref Recorder::addUserTransformToKeyframe
    * for usage tips.
@@ -86,13 +127,20 @@ class Player {
    * @brief Reserved for unit-testing.
    */
   void debugSetKeyframes(std::vector<Keyframe>&& keyframes) {
+    lazyReader_ = nullptr;
     keyframes_ = std::move(keyframes);
+    buildFullStateKeyframes();
   }
 
+  static constexpr int DefaultFullStateKeyframeInterval = 64;
+
  private:
   void readKeyframesFromJsonDocument(const rapidjson::Document& d);
+  const Keyframe& getKeyframe(int frameIndex);
+  void buildFullStateKeyframes();
   void clearFrame();
   void applyKeyframe(const Keyframe& keyframe);
+  void applyFullStateKeyframe(const Keyframe& keyframe);
   static void setSemanticIdForSubtree(esp::scene::SceneNode* rootNode,
                                       int semanticId);
 
@@ -100,6 +148,15 @@ class Player {
       loadAndCreateRenderAssetInstanceCallback;
   int frameIndex_ = -1;
   std::vector<Keyframe> keyframes_;
+  //! Set for binary files, which then don't fill keyframes_
+  std::unique_ptr<BinaryKeyframeReader> lazyReader_;
+  Keyframe lazyKeyframe_;
+  int lazyKeyframeIndex_ = -1;
+  int fullStateKeyframeInterval_ = DefaultFullStateKeyframeInterval;
+  //! Full state after applying the keyframe of the same index
+  std::map<int, Keyframe> fullStateKeyframes_;
+  std::unordered_map<std::string, Transform> userTransforms_;
+  int numKeyframesApplied_ = 0;
   std::map<std::string, esp::assets::AssetInfo> assetInfos_;
   std::map<RenderAssetInstanceKey, scene::SceneNode*> createdInstances_;
   std::set<std::string> failedFilepaths_;
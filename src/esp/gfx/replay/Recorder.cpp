@@ -54,15 +54,17 @@ void Recorder::onCreateRenderAssetInstance(
 
   RenderAssetInstanceKey instanceKey = getNewInstanceKey();
 
-  getKeyframe().creations.emplace_back(std::make_pair(instanceKey, creation));
+  addCreation(&currKeyframe_, &currCreationIndices_,
+              std::make_pair(instanceKey, creation));
 
   // Constructing NodeDeletionHelper here is equivalent to calling
   // node->addFeature. We keep a pointer to deletionHelper so we can delete it
   // manually later if necessary.
   NodeDeletionHelper* deletionHelper = new NodeDeletionHelper{*node, this};
 
+  instanceIndices_.emplace(node, instanceRecords_.size());
   instanceRecords_.emplace_back(InstanceRecord{
-      node, instanceKey, Corrade::Containers::NullOpt, deletionHelper});
+      node, instanceKey, Corrade::Containers::NullOpt, deletionHelper, 0});
 }
 
 void Recorder::saveKeyframe() {
@@ -76,30 +78,60 @@ void Recorder::addUserTransformToKeyframe(const std::string& name,
   getKeyframe().userTransforms[name] = Transform{translation, rotation};
 }
 
-void Recorder::addLoadsCreationsDeletions(KeyframeIterator begin,
-                                          KeyframeIterator end,
-                                          Keyframe* dest) {
-  ASSERT(dest);
+void Recorder::addLoadsCreationsDeletions(
+    KeyframeIterator begin,
+    KeyframeIterator end,
+    Keyframe* dest,
+    CreationIndices* destCreationIndices) {
   for (KeyframeIterator curr = begin; curr != end; curr++) {
-    const auto& keyframe = *curr;
-    dest->loads.insert(dest->loads.end(), keyframe.loads.begin(),
-                       keyframe.loads.end());
-    dest->creations.insert(dest->creations.end(), keyframe.creations.begin(),
-                           keyframe.creations.end());
-    for (const auto& deletionInstanceKey : keyframe.deletions) {
-      checkAndAddDeletion(dest, deletionInstanceKey);
-    }
+    addLoadsCreationsDeletions(*curr, dest, destCreationIndices);
+  }
+}
+
+void Recorder::addLoadsCreationsDeletions(
+    const Keyframe& keyframe,
+    Keyframe* dest,
+    CreationIndices* destCreationIndices) {
+  ASSERT(dest);
+  dest->loads.insert(dest->loads.end(), keyframe.loads.begin(),
+                     keyframe.loads.end());
+  for (const auto& creation : keyframe.creations) {
+    addCreation(dest, destCreationIndices, creation);
+  }
+  for (const auto& deletionInstanceKey : keyframe.deletions) {
+    checkAndAddDeletion(dest, destCreationIndices, deletionInstanceKey);
   }
 }
 
+void Recorder::addCreation(
+    Keyframe* keyframe,
+    CreationIndices* creationIndices,
+    const std::pair<RenderAssetInstanceKey,
+                    esp::assets::RenderAssetInstanceCreationInfo>& creation) {
+  ASSERT(keyframe);
+  ASSERT(creationIndices);
+  creationIndices->emplace(creation.first, keyframe->creations.size());
+  keyframe->creations.push_back(creation);
+}
+
 void Recorder::checkAndAddDeletion(Keyframe* keyframe,
+                                   CreationIndices* creationIndices,
                                    RenderAssetInstanceKey instanceKey) {
-  auto it =
-      std::find_if(keyframe->creations.begin(), keyframe->creations.end(),
-                   [&](const auto& pair) { return pair.first == instanceKey; });
-  if (it != keyframe->creations.end()) {
-    // this deletion just cancels out with an earlier creation
-    keyframe->creations.erase(it);
+  ASSERT(keyframe);
+  ASSERT(creationIndices);
+  auto it = creationIndices->find(instanceKey);
+  if (it != creationIndices->end()) {
+    // This deletion just cancels out with an earlier creation. The order of
+    // creations doesn't matter, so move the last one in its place instead of
+    // shifting all following ones.
+    auto& creations = keyframe->creations;
+    const std::size_t index = it->second;
+    creationIndices->erase(it);
+    if (index != creations.size() - 1) {
+      creations[index] = std::move(creations.back());
+      (*creationIndices)[creations[index].first] = index;
+    }
+    creations.pop_back();
   } else {
     // This deletion has no matching creation so it can't be canceled out.
     // Include it in the keyframe.
@@ -113,9 +145,16 @@ void Recorder::onDeleteRenderAssetInstance(const scene::SceneNode* node) {
 
   auto instanceKey = instanceRecords_[index].instanceKey;
 
-  checkAndAddDeletion(&getKeyframe(), instanceKey);
+  checkAndAddDeletion(&currKeyframe_, &currCreationIndices_, instanceKey);
 
-  instanceRecords_.erase(instanceRecords_.begin() + index);
+  // keyframes don't depend on the order of records, so move the last one in
+  // its place instead of shifting all following ones
+  instanceIndices_.erase(node);
+  if (index != int(instanceRecords_.size()) - 1) {
+    instanceRecords_[index] = instanceRecords_.back();
+    instanceIndices_[instanceRecords_[index].node] = index;
+  }
+  instanceRecords_.pop_back();
 }
 
 Keyframe& Recorder::getKeyframe() {
@@ -127,18 +166,12 @@ RenderAssetInstanceKey Recorder::getNewInstanceKey() {
 }
 
 int Recorder::findInstance(const scene::SceneNode* queryNode) {
-  auto it = std::find_if(instanceRecords_.begin(), instanceRecords_.end(),
-                         [&queryNode](const InstanceRecord& record) {
-                           return record.node == queryNode;
-                         });
-
-  return it == instanceRecords_.end() ? ID_UNDEFINED
-                                      : int(it - instanceRecords_.begin());
+  auto it = instanceIndices_.find(queryNode);
+  return it == instanceIndices_.end() ? ID_UNDEFINED : int(it->second);
 }
 
-RenderAssetInstanceState Recorder::getInstanceState(
-    const scene::SceneNode* node) {
-  const auto absTransformMat = node->absoluteTransformation();
+RenderAssetInstanceState Recorder::getInstanceState(scene::SceneNode* node) {
+  const Magnum::Matrix4& absTransformMat = node->cachedAbsoluteTransformation();
   Transform absTransform{
       absTransformMat.translation(),
       Magnum::Quaternion::fromMatrix(absTransformMat.rotationShear())};
@@ -147,8 +180,20 @@ RenderAssetInstanceState Recorder::getInstanceState(
 }
 
 void Recorder::updateInstanceStates() {
+  numInstanceStatesRead_ = 0;
   for (auto& instanceRecord : instanceRecords_) {
+    const scene::SceneNode& node = *instanceRecord.node;
+    // neither the node nor its parents were transformed since the last read
+    if (instanceRecord.recentState && !node.isDirty() &&
+        node.getAbsoluteTransformationVersion() ==
+            instanceRecord.transformationVersion &&
+        node.getSemanticId() == instanceRecord.recentState->semanticId) {
+      continue;
+    }
     auto state = getInstanceState(instanceRecord.node);
+    instanceRecord.transformationVersion =
+        node.getAbsoluteTransformationVersion();
+    ++numInstanceStatesRead_;
     if (!instanceRecord.recentState || state != instanceRecord.recentState) {
       getKeyframe().stateUpdates.push_back(
           std::make_pair(instanceRecord.instanceKey, state));
@@ -158,8 +203,16 @@ void Recorder::updateInstanceStates() {
 }
 
 void Recorder::advanceKeyframe() {
-  savedKeyframes_.emplace_back(std::move(currKeyframe_));
+  if (binaryWriter_.isOpen()) {
+    binaryWriter_.writeKeyframe(currKeyframe_);
+    addLoadsCreationsDeletions(currKeyframe_,
+                               &streamedLoadsCreationsDeletions_,
+                               &streamedCreationIndices_);
+  } else {
+    savedKeyframes_.emplace_back(std::move(currKeyframe_));
+  }
   currKeyframe_ = Keyframe{};
+  currCreationIndices_.clear();
 }
 
 void Recorder::writeSavedKeyframesToFile(const std::string& filepath) {
@@ -177,16 +230,74 @@ std::string Recorder::writeSavedKeyframesToString() {
   return esp::io::jsonToString(document);
 }
 
+bool Recorder::writeSavedKeyframesToBinaryFile(
+    const std::string& filepath,
+    BinaryTransformPrecision precision) {
+  if (savedKeyframes_.empty()) {
+    LOG(WARNING) << "Recorder::writeSavedKeyframesToBinaryFile: no saved "
+                    "keyframes to write";
+    return false;
+  }
+
+  BinaryKeyframeWriter writer;
+  if (!writer.open(filepath, precision)) {
+    return false;
+  }
+  for (const auto& keyframe : savedKeyframes_) {
+    writer.writeKeyframe(keyframe);
+  }
+  const bool success = writer.getNumKeyframes() == int(savedKeyframes_.size());
+  writer.close();
+
+  consolidateSavedKeyframes();
+  return success;
+}
+
+bool Recorder::startBinaryKeyframeStream(const std::string& filepath,
+                                         BinaryTransformPrecision precision) {
+  stopBinaryKeyframeStream();
+  if (!binaryWriter_.open(filepath, precision)) {
+    return false;
+  }
+  for (const auto& keyframe : savedKeyframes_) {
+    binaryWriter_.writeKeyframe(keyframe);
+  }
+  addLoadsCreationsDeletions(savedKeyframes_.begin(), savedKeyframes_.end(),
+                             &streamedLoadsCreationsDeletions_,
+                             &streamedCreationIndices_);
+  savedKeyframes_.clear();
+  return true;
+}
+
+void Recorder::stopBinaryKeyframeStream() {
+  if (!binaryWriter_.isOpen()) {
+    return;
+  }
+  binaryWriter_.close();
+
+  // same as consolidateSavedKeyframes(), with the streamed keyframes in place
+  // of the saved ones
+  addLoadsCreationsDeletions(streamedLoadsCreationsDeletions_, &currKeyframe_,
+                             &currCreationIndices_);
+  streamedLoadsCreationsDeletions_ = Keyframe{};
+  streamedCreationIndices_.clear();
+  resetRecentStates();
+}
+
 void Recorder::consolidateSavedKeyframes() {
   // consolidate saved keyframes into current keyframe
   addLoadsCreationsDeletions(savedKeyframes_.begin(), savedKeyframes_.end(),
-                             &getKeyframe());
+                             &currKeyframe_, &currCreationIndices_);
+  resetRecentStates();
+  savedKeyframes_.clear();
+}
+
+void Recorder::resetRecentStates() {
   // clear instanceRecord.recentState to ensure updates get included in the next
   // saved keyframe.
   for (auto& instanceRecord : instanceRecords_) {
     instanceRecord.recentState = Corrade::Containers::NullOpt;
   }
-  savedKeyframes_.clear();
 }
 
 rapidjson::Document Recorder::writeKeyframesToJsonDocument() {
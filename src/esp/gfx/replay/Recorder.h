@@ -5,11 +5,14 @@
 #ifndef ESP_GFX_REPLAY_RECORDER_H_
 #define ESP_GFX_REPLAY_RECORDER_H_
 
+#include "BinaryKeyframes.h"
 #include "Keyframe.h"
 
 #include <rapidjson/document.h>
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 
 namespace esp {
 namespace assets {
@@ -100,6 +103,39 @@ class Recorder {
    */
   std::string writeSavedKeyframesToString();
 
+  /**
+   * @brief Write saved keyframes to a binary file, see @ref
+   * BinaryKeyframeWriter. Like @ref writeSavedKeyframesToFile, the keyframes
+   * get discarded afterwards.
+   * @return Whether the file could be written.
+   */
+  bool writeSavedKeyframesToBinaryFile(
+      const std::string& filepath,
+      BinaryTransformPrecision precision = BinaryTransformPrecision::Float32);
+
+  /**
+   * @brief Write each keyframe to a binary file as soon as it's saved,
+   * instead of keeping it in memory.
+   *
+   * Keyframes saved earlier get written to the file first. Until @ref
+   * stopBinaryKeyframeStream, no keyframes are kept, so there's nothing for
+   * @ref writeSavedKeyframesToFile to write.
+   * @return Whether the file could be created.
+   */
+  bool startBinaryKeyframeStream(
+      const std::string& filepath,
+      BinaryTransformPrecision precision = BinaryTransformPrecision::Float32);
+
+  /**
+   * @brief Close the file opened by @ref startBinaryKeyframeStream. Later
+   * keyframes get kept in memory again, starting with one that recreates
+   * all instances still alive.
+   */
+  void stopBinaryKeyframeStream();
+
+  /** @brief Whether @ref startBinaryKeyframeStream is in effect */
+  bool isStreamingBinaryKeyframes() const { return binaryWriter_.isOpen(); }
+
   /**
    * @brief Reserved for unit-testing.
    */
@@ -107,6 +143,15 @@ class Recorder {
     return savedKeyframes_;
   }
 
+  /**
+   * @brief Number of instance states the last @ref saveKeyframe read from
+   * their nodes. Instances whose node wasn't transformed since the previous
+   * keyframe are skipped, e.g. those of sleeping physics objects.
+   */
+  int getNumInstanceStatesReadLastKeyframe() const {
+    return numInstanceStatesRead_;
+  }
+
  private:
   // NodeDeletionHelper calls onDeleteRenderAssetInstance
   friend class NodeDeletionHelper;
@@ -117,29 +162,57 @@ class Recorder {
     RenderAssetInstanceKey instanceKey = ID_UNDEFINED;
     Corrade::Containers::Optional<RenderAssetInstanceState> recentState;
     NodeDeletionHelper* deletionHelper = nullptr;
+    //! @ref scene::SceneNode::getAbsoluteTransformationVersion of the node
+    //! when recentState was read
+    std::uint64_t transformationVersion = 0;
   };
 
   using KeyframeIterator = std::vector<Keyframe>::const_iterator;
 
+  //! Index of each instance key in the creations of a keyframe, for
+  //! canceling out a deletion with an earlier creation in constant time
+  using CreationIndices =
+      std::unordered_map<RenderAssetInstanceKey, std::size_t>;
+
   rapidjson::Document writeKeyframesToJsonDocument();
   void onDeleteRenderAssetInstance(const scene::SceneNode* node);
   Keyframe& getKeyframe();
   void advanceKeyframe();
   RenderAssetInstanceKey getNewInstanceKey();
   int findInstance(const scene::SceneNode* queryNode);
-  RenderAssetInstanceState getInstanceState(const scene::SceneNode* node);
+  RenderAssetInstanceState getInstanceState(scene::SceneNode* node);
   void updateInstanceStates();
-  void checkAndAddDeletion(Keyframe* keyframe,
-                           RenderAssetInstanceKey instanceKey);
-  void addLoadsCreationsDeletions(KeyframeIterator begin,
-                                  KeyframeIterator end,
-                                  Keyframe* dest);
+  static void addCreation(
+      Keyframe* keyframe,
+      CreationIndices* creationIndices,
+      const std::pair<RenderAssetInstanceKey,
+                      esp::assets::RenderAssetInstanceCreationInfo>& creation);
+  static void checkAndAddDeletion(Keyframe* keyframe,
+                                  CreationIndices* creationIndices,
+                                  RenderAssetInstanceKey instanceKey);
+  static void addLoadsCreationsDeletions(KeyframeIterator begin,
+                                         KeyframeIterator end,
+                                         Keyframe* dest,
+                                         CreationIndices* destCreationIndices);
+  static void addLoadsCreationsDeletions(const Keyframe& keyframe,
+                                         Keyframe* dest,
+                                         CreationIndices* destCreationIndices);
+  void resetRecentStates();
   void consolidateSavedKeyframes();
 
   std::vector<InstanceRecord> instanceRecords_;
+  //! Index of each recorded node in instanceRecords_
+  std::unordered_map<const scene::SceneNode*, std::size_t> instanceIndices_;
   Keyframe currKeyframe_;
+  CreationIndices currCreationIndices_;
   std::vector<Keyframe> savedKeyframes_;
   RenderAssetInstanceKey nextInstanceKey_ = 0;
+  int numInstanceStatesRead_ = 0;
+  BinaryKeyframeWriter binaryWriter_;
+  //! Loads, creations and deletions of all keyframes streamed by
+  //! binaryWriter_, consolidated like savedKeyframes_ would be
+  Keyframe streamedLoadsCreationsDeletions_;
+  CreationIndices streamedCreationIndices_;
 };
 
 }  // namespace replay
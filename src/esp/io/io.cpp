@@ -3,8 +3,19 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "io.h"
+#include <sys/stat.h>
+#include <atomic>
 #include <fstream>
+#include <random>
 #include <set>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 
 namespace esp {
 namespace io {
@@ -44,6 +55,21 @@ size_t fileSize(const std::string& filename) {
   return (size <= 0 ? 0 : size);
 }
 
+std::int64_t fileModificationTime(const std::string& filename) {
+  struct stat info {};
+  if (stat(filename.c_str(), &info) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return std::int64_t(info.st_mtimespec.tv_sec) * 1000000000 +
+         info.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+  return std::int64_t(info.st_mtime) * 1000000000;
+#else
+  return std::int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+}
+
 // TODO:
 // a corner case it will fail to match the replace_extension in c++17:
 // filename = "foo"
@@ -84,6 +110,32 @@ std::string removeExtension(const std::string& filename) {
   return changeExtension(filename, "");
 }
 
+std::string getTemporaryFilename(const std::string& filename) {
+  // the counter keeps names unique within a process even if random_device
+  // is deterministic, as it's allowed to be
+  static std::atomic<std::uint64_t> counter{std::random_device{}()};
+  std::ostringstream name;
+  name << filename << "." << getpid() << "." << std::hex << counter++
+       << ".tmp";
+  return name.str();
+}
+
+std::uint64_t hashBytes(const void* data,
+                        std::size_t size,
+                        std::uint64_t hash /* = HashOffsetBasis */) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (std::size_t i = 0; i != size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::uint64_t hashString(const std::string& string,
+                         std::uint64_t hash /* = HashOffsetBasis */) {
+  return hashBytes(string.data(), string.size(), hash);
+}
+
 /* The following implementation requires the support of C++17
 
 // #include <filesystem>
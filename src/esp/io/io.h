@@ -5,6 +5,8 @@
 #ifndef ESP_IO_IO_H_
 #define ESP_IO_IO_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -15,10 +17,44 @@ bool exists(const std::string& file);
 
 size_t fileSize(const std::string& file);
 
+/**
+ * @brief Last modification time of a file in nanoseconds since the epoch, 0 if
+ * the file does not exist. The resolution depends on the filesystem.
+ */
+std::int64_t fileModificationTime(const std::string& file);
+
 std::string removeExtension(const std::string& file);
 
 std::string changeExtension(const std::string& file, const std::string& ext);
 
+/**
+ * @brief Unique name for a temporary file in the directory of @p file, to
+ * write the contents of @p file to before renaming it over @p file.
+ *
+ * The name holds the process ID and a random number, so concurrent writers of
+ * the same file, in this or other processes, never write to or truncate each
+ * other's temporary file, nor the file a reader has opened after a rename.
+ */
+std::string getTemporaryFilename(const std::string& file);
+
+//! Offset basis of the 64-bit FNV-1a hash, the hash of no data
+constexpr std::uint64_t HashOffsetBasis = 14695981039346656037ull;
+
+/**
+ * @brief 64-bit FNV-1a hash of @p size bytes at @p data.
+ *
+ * Unlike std::hash, the hash is the same across platforms, compilers and runs,
+ * so it can identify data stored in files.
+ * @param hash Hash of preceding data, to hash several ranges as one
+ */
+std::uint64_t hashBytes(const void* data,
+                        std::size_t size,
+                        std::uint64_t hash = HashOffsetBasis);
+
+/** @brief FNV-1a hash of the characters of @p string, see @ref hashBytes */
+std::uint64_t hashString(const std::string& string,
+                         std::uint64_t hash = HashOffsetBasis);
+
 /** @brief Tokenize input string by any delimiter char in delimiterCharList.
  *
  * @param delimiterCharList string containing all delimiter chars
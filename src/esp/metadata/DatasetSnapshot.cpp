@@ -0,0 +1,388 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "DatasetSnapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Utility/Configuration.h>
+#include <Corrade/Utility/Directory.h>
+
+#include "esp/io/io.h"
+
+namespace Cr = Corrade;
+
+namespace esp {
+namespace metadata {
+
+using Cr::Utility::ConfigurationGroup;
+
+namespace {
+
+// bump whenever the layout below or the meaning of any attributes value
+// changes, so that older snapshots get rebuilt from the configs
+constexpr std::uint32_t SnapshotVersion = 1;
+constexpr char SnapshotMagic[4] = {'E', 'M', 'D', 'S'};
+
+/* File layout:
+
+   SnapshotHeader
+   for each source file or directory:
+     std::uint64_t size, 0 for directories
+     std::int64_t modification time
+     std::uint32_t path size, followed by the path
+   std::uint64_t payload size
+   payload, a Corrade::Utility::Configuration holding a group per manager,
+     see saveManager(), and the navmesh and semantic scene descriptor maps
+
+   The sources come first so a stale snapshot is rejected without parsing the
+   payload. */
+
+struct SnapshotHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t sourceCount;
+  std::uint32_t reserved;
+};
+
+struct SnapshotSource {
+  std::string path;
+  std::uint64_t size;
+  std::int64_t modificationTime;
+};
+
+SnapshotSource describeSource(const std::string& path) {
+  const bool isDirectory = Cr::Utility::Directory::isDirectory(path);
+  return {path, isDirectory ? 0 : std::uint64_t(io::fileSize(path)),
+          io::fileModificationTime(path)};
+}
+
+template <class T>
+void append(std::string& buffer, const T& value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool read(const char*& data, const char* end, T& value) {
+  if (std::size_t(end - data) < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&value, data, sizeof(T));
+  data += sizeof(T);
+  return true;
+}
+
+//! Attributes values go into a "values" subgroup, so nested attributes and
+//! per-attributes snapshot data can live next to them
+void saveValues(const attributes::AbstractAttributes& attribs,
+                ConfigurationGroup& group) {
+  group.addGroup("values", new ConfigurationGroup{attribs.getConfigGroup()});
+}
+
+void saveAttributes(const attributes::AbstractAttributes& attribs,
+                    ConfigurationGroup& group) {
+  saveValues(attribs, group);
+}
+
+void saveAttributes(const attributes::SceneAttributes& attribs,
+                    ConfigurationGroup& group) {
+  saveValues(attribs, group);
+  if (const auto stageInstance = attribs.getStageInstance()) {
+    saveValues(*stageInstance, *group.addGroup("stage_instance"));
+  }
+  for (const auto& objectInstance : attribs.getObjectInstances()) {
+    saveValues(*objectInstance, *group.addGroup("object_instance"));
+  }
+}
+
+void saveAttributes(const attributes::LightLayoutAttributes& attribs,
+                    ConfigurationGroup& group) {
+  saveValues(attribs, group);
+  for (const auto& lightInstance : attribs.getLightInstances()) {
+    saveValues(*lightInstance.second, *group.addGroup("light_instance"));
+  }
+}
+
+template <class T>
+std::shared_ptr<T> restoreValues(const ConfigurationGroup& group) {
+  const ConfigurationGroup* values = group.group("values");
+  if (values == nullptr) {
+    return nullptr;
+  }
+  auto attribs = T::create("");
+  attribs->setConfigGroup(*values);
+  return attribs;
+}
+
+template <class T>
+std::shared_ptr<T> restoreAttributes(const ConfigurationGroup& group) {
+  return restoreValues<T>(group);
+}
+
+template <>
+std::shared_ptr<attributes::SceneAttributes> restoreAttributes(
+    const ConfigurationGroup& group) {
+  using attributes::SceneObjectInstanceAttributes;
+  auto attribs = restoreValues<attributes::SceneAttributes>(group);
+  if (attribs == nullptr) {
+    return nullptr;
+  }
+  if (const ConfigurationGroup* stageGroup = group.group("stage_instance")) {
+    auto stageInstance =
+        restoreValues<SceneObjectInstanceAttributes>(*stageGroup);
+    if (stageInstance == nullptr) {
+      return nullptr;
+    }
+    attribs->setStageInstance(stageInstance);
+  }
+  for (const ConfigurationGroup* objectGroup :
+       group.groups("object_instance")) {
+    auto objectInstance =
+        restoreValues<SceneObjectInstanceAttributes>(*objectGroup);
+    if (objectInstance == nullptr) {
+      return nullptr;
+    }
+    attribs->addObjectInstance(objectInstance);
+  }
+  return attribs;
+}
+
+template <>
+std::shared_ptr<attributes::LightLayoutAttributes> restoreAttributes(
+    const ConfigurationGroup& group) {
+  auto attribs = restoreValues<attributes::LightLayoutAttributes>(group);
+  if (attribs == nullptr) {
+    return nullptr;
+  }
+  for (const ConfigurationGroup* lightGroup : group.groups("light_instance")) {
+    auto lightInstance =
+        restoreValues<attributes::LightInstanceAttributes>(*lightGroup);
+    if (lightInstance == nullptr) {
+      return nullptr;
+    }
+    attribs->addLightInstance(lightInstance);
+  }
+  return attribs;
+}
+
+/* A manager's group holds an optional "default" group with the default
+   attributes, and an "attributes" group per registered attributes in ID
+   order, so restoring them in order reproduces the IDs. */
+template <class Mgr>
+void saveManager(const Mgr& mgr, ConfigurationGroup& group) {
+  if (const auto defaultObject = mgr.getDefaultObject()) {
+    saveAttributes(*defaultObject, *group.addGroup("default"));
+  }
+  const std::vector<std::string> undeletable =
+      mgr.getUndeletableObjectHandles();
+  const std::set<std::string> undeletableSet{undeletable.begin(),
+                                             undeletable.end()};
+  for (const std::string& handle : mgr.getObjectHandlesBySubstring()) {
+    ConfigurationGroup& attribsGroup = *group.addGroup("attributes");
+    saveAttributes(*mgr.getObjectByHandle(handle), attribsGroup);
+    attribsGroup.setValue("undeletable", undeletableSet.count(handle) > 0);
+  }
+}
+
+template <class Mgr>
+bool restoreManager(const ConfigurationGroup& group, Mgr& mgr) {
+  using T = typename Mgr::AttribsPtr::element_type;
+  if (const ConfigurationGroup* defaultGroup = group.group("default")) {
+    auto defaultObject = restoreAttributes<T>(*defaultGroup);
+    if (defaultObject == nullptr) {
+      return false;
+    }
+    mgr.setDefaultObject(defaultObject);
+  }
+  for (const ConfigurationGroup* attribsGroup : group.groups("attributes")) {
+    auto attribs = restoreAttributes<T>(*attribsGroup);
+    const bool undeletable = attribsGroup->value<bool>("undeletable");
+    if (attribs == nullptr ||
+        mgr.registerSnapshotObject(attribs, undeletable) == ID_UNDEFINED) {
+      LOG(ERROR) << "readDatasetSnapshot : Failed to restore "
+                 << mgr.getObjectType() << " attributes.";
+      return false;
+    }
+  }
+  return true;
+}
+
+void saveMap(const std::map<std::string, std::string>& map,
+             ConfigurationGroup& group) {
+  for (const auto& entry : map) {
+    ConfigurationGroup& entryGroup = *group.addGroup("entry");
+    entryGroup.setValue("key", entry.first);
+    entryGroup.setValue("value", entry.second);
+  }
+}
+
+void restoreMap(const ConfigurationGroup& group,
+                std::map<std::string, std::string>& map) {
+  for (const ConfigurationGroup* entryGroup : group.groups("entry")) {
+    map[entryGroup->value("key")] = entryGroup->value("value");
+  }
+}
+
+}  // namespace
+
+bool writeDatasetSnapshot(const attributes::SceneDatasetAttributes& dataset,
+                          const std::string& datasetConfigFilepath,
+                          const std::string& filepath) {
+  std::vector<std::string> sourcePaths{datasetConfigFilepath};
+  for (const auto* paths :
+       {&dataset.getStageAttributesManager()->getConfigSourcePaths(),
+        &dataset.getObjectAttributesManager()->getConfigSourcePaths(),
+        &dataset.getLightLayoutAttributesManager()->getConfigSourcePaths(),
+        &dataset.getSceneAttributesManager()->getConfigSourcePaths()}) {
+    sourcePaths.insert(sourcePaths.end(), paths->begin(), paths->end());
+  }
+
+  Cr::Utility::Configuration payload;
+  saveManager(*dataset.getStageAttributesManager(),
+              *payload.addGroup("stages"));
+  saveManager(*dataset.getObjectAttributesManager(),
+              *payload.addGroup("objects"));
+  saveManager(*dataset.getLightLayoutAttributesManager(),
+              *payload.addGroup("light_setups"));
+  saveManager(*dataset.getSceneAttributesManager(),
+              *payload.addGroup("scene_instances"));
+  saveMap(dataset.getNavmeshMap(), *payload.addGroup("navmesh_instances"));
+  saveMap(dataset.getSemanticSceneDescrMap(),
+          *payload.addGroup("semantic_scene_descriptor_instances"));
+  std::ostringstream payloadText;
+  payload.save(payloadText);
+  const std::string payloadString = payloadText.str();
+
+  std::string buffer;
+  SnapshotHeader header{};
+  std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+  header.version = SnapshotVersion;
+  header.sourceCount = sourcePaths.size();
+  append(buffer, header);
+  for (const std::string& path : sourcePaths) {
+    const SnapshotSource source = describeSource(path);
+    append(buffer, source.size);
+    append(buffer, source.modificationTime);
+    append(buffer, std::uint32_t(source.path.size()));
+    buffer += source.path;
+  }
+  append(buffer, std::uint64_t(payloadString.size()));
+  buffer += payloadString;
+
+  // a unique temporary file, so concurrent writers never truncate a file
+  // another one renamed into place while readers have it mapped
+  const std::string tmpFilepath = io::getTemporaryFilename(filepath);
+  {
+    std::ofstream file(tmpFilepath, std::ios::binary | std::ios::trunc);
+    if (!file.write(buffer.data(), buffer.size())) {
+      LOG(ERROR) << "writeDatasetSnapshot : Failed to write " << tmpFilepath;
+      file.close();
+      Cr::Utility::Directory::rm(tmpFilepath);
+      return false;
+    }
+  }
+  if (std::rename(tmpFilepath.c_str(), filepath.c_str()) != 0) {
+    LOG(ERROR) << "writeDatasetSnapshot : Failed to move " << tmpFilepath
+               << " to " << filepath;
+    Cr::Utility::Directory::rm(tmpFilepath);
+    return false;
+  }
+  LOG(INFO) << "writeDatasetSnapshot : Wrote snapshot of "
+            << dataset.getHandle() << " with " << sourcePaths.size()
+            << " sources to " << filepath;
+  return true;
+}  // writeDatasetSnapshot
+
+bool readDatasetSnapshot(const std::string& filepath,
+                         attributes::SceneDatasetAttributes& dataset) {
+  if (!Cr::Utility::Directory::exists(filepath)) {
+    return false;
+  }
+#ifdef CORRADE_TARGET_UNIX
+  const auto data = Cr::Utility::Directory::mapRead(filepath);
+#else
+  const auto data = Cr::Utility::Directory::read(filepath);
+#endif
+  const char* pos = data.data();
+  const char* const end = data.data() + data.size();
+
+  SnapshotHeader header{};
+  if (!read(pos, end, header) ||
+      std::memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0) {
+    LOG(WARNING) << "readDatasetSnapshot : " << filepath
+                 << " is not a dataset snapshot.";
+    return false;
+  }
+  if (header.version != SnapshotVersion) {
+    LOG(INFO) << "readDatasetSnapshot : " << filepath << " has version "
+              << header.version << ", expected " << SnapshotVersion
+              << ", ignoring it.";
+    return false;
+  }
+
+  for (std::uint32_t i = 0; i < header.sourceCount; ++i) {
+    SnapshotSource source;
+    std::uint32_t pathSize = 0;
+    if (!read(pos, end, source.size) ||
+        !read(pos, end, source.modificationTime) ||
+        !read(pos, end, pathSize) || std::size_t(end - pos) < pathSize) {
+      LOG(WARNING) << "readDatasetSnapshot : " << filepath << " is truncated.";
+      return false;
+    }
+    source.path.assign(pos, pathSize);
+    pos += pathSize;
+    const SnapshotSource current = describeSource(source.path);
+    if (current.size != source.size ||
+        current.modificationTime != source.modificationTime) {
+      LOG(INFO) << "readDatasetSnapshot : " << source.path
+                << " changed since " << filepath
+                << " was written, ignoring it.";
+      return false;
+    }
+  }
+
+  std::uint64_t payloadSize = 0;
+  if (!read(pos, end, payloadSize) || std::uint64_t(end - pos) < payloadSize) {
+    LOG(WARNING) << "readDatasetSnapshot : " << filepath << " is truncated.";
+    return false;
+  }
+  std::istringstream payloadText{std::string(pos, std::size_t(payloadSize))};
+  const Cr::Utility::Configuration payload{payloadText};
+  const ConfigurationGroup* stages = payload.group("stages");
+  const ConfigurationGroup* objects = payload.group("objects");
+  const ConfigurationGroup* lightSetups = payload.group("light_setups");
+  const ConfigurationGroup* sceneInstances = payload.group("scene_instances");
+  const ConfigurationGroup* navmeshes = payload.group("navmesh_instances");
+  const ConfigurationGroup* semanticSceneDescrs =
+      payload.group("semantic_scene_descriptor_instances");
+  if (!payload.isValid() || !stages || !objects || !lightSetups ||
+      !sceneInstances || !navmeshes || !semanticSceneDescrs) {
+    LOG(WARNING) << "readDatasetSnapshot : " << filepath
+                 << " has an invalid payload.";
+    return false;
+  }
+
+  // stages and objects first, as scene instances refer to them
+  if (!restoreManager(*stages, *dataset.getStageAttributesManager()) ||
+      !restoreManager(*objects, *dataset.getObjectAttributesManager()) ||
+      !restoreManager(*lightSetups,
+                      *dataset.getLightLayoutAttributesManager()) ||
+      !restoreManager(*sceneInstances, *dataset.getSceneAttributesManager())) {
+    return false;
+  }
+  restoreMap(*navmeshes, dataset.editNavmeshMap());
+  restoreMap(*semanticSceneDescrs, dataset.editSemanticSceneDescrMap());
+  LOG(INFO) << "readDatasetSnapshot : Restored " << dataset.getHandle()
+            << " from " << filepath;
+  return true;
+}  // readDatasetSnapshot
+
+}  // namespace metadata
+}  // namespace esp
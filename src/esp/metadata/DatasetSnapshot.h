@@ -0,0 +1,60 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_METADATA_DATASETSNAPSHOT_H_
+#define ESP_METADATA_DATASETSNAPSHOT_H_
+
+/** @file
+ * @brief Functions @ref esp::metadata::writeDatasetSnapshot,
+ * @ref esp::metadata::readDatasetSnapshot
+ */
+
+#include <string>
+
+#include "esp/metadata/attributes/SceneDatasetAttributes.h"
+
+namespace esp {
+namespace metadata {
+
+/**
+ * @brief Save all attributes a dataset has registered, along with its navmesh
+ * and semantic scene descriptor maps, to a single file.
+ *
+ * The snapshot covers the stage, object, light setup and scene instance
+ * attributes, including the default attributes of each manager, and records
+ * the modification time and size of the dataset config and of every config
+ * file and directory the managers loaded from. @ref readDatasetSnapshot only
+ * uses the snapshot while all of these are unchanged.
+ *
+ * The file is written next to @p filepath and moved into place once complete,
+ * so processes reading the snapshot concurrently never see a partial one.
+ * @param dataset The dataset to save.
+ * @param datasetConfigFilepath The dataset config the dataset was built from.
+ * @param filepath The snapshot file to write.
+ * @return Whether the snapshot could be written.
+ */
+bool writeDatasetSnapshot(const attributes::SceneDatasetAttributes& dataset,
+                          const std::string& datasetConfigFilepath,
+                          const std::string& filepath);
+
+/**
+ * @brief Restore the attributes of a dataset from a file written by @ref
+ * writeDatasetSnapshot, instead of parsing the dataset config and all the
+ * configs it refers to.
+ *
+ * Fails without touching @p dataset if the file isn't a snapshot of the
+ * current format version or if any of the config files and directories it
+ * was built from have changed since. If restoring the attributes fails
+ * afterwards, @p dataset is left partially filled and should be discarded.
+ * @param filepath The snapshot file to read.
+ * @param dataset A newly created dataset to register the attributes in.
+ * @return Whether the snapshot was valid and the attributes got restored.
+ */
+bool readDatasetSnapshot(const std::string& filepath,
+                         attributes::SceneDatasetAttributes& dataset);
+
+}  // namespace metadata
+}  // namespace esp
+
+#endif  // ESP_METADATA_DATASETSNAPSHOT_H_
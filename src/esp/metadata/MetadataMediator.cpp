@@ -4,6 +4,14 @@
 
 #include "MetadataMediator.h"
 
+#include <iomanip>
+#include <sstream>
+
+#include <Corrade/Utility/Directory.h>
+
+#include "DatasetSnapshot.h"
+#include "esp/io/io.h"
+
 namespace esp {
 namespace metadata {
 
@@ -34,6 +42,19 @@ bool MetadataMediator::createDataset(const std::string& sceneDatasetName,
     sceneDatasetAttributesManager_->setLock(sceneDatasetName, false);
   }
   // by here dataset either does not exist or exists but is unlocked.
+  const std::string datasetConfigFilepath =
+      sceneDatasetAttributesManager_->getFormattedJSONFileName(
+          sceneDatasetName);
+  const bool useSnapshot =
+      !datasetSnapshotDirectory_.empty() &&
+      Corrade::Utility::Directory::exists(datasetConfigFilepath);
+  lastDatasetFromSnapshot_ =
+      useSnapshot && createDatasetFromSnapshot(datasetConfigFilepath);
+  if (lastDatasetFromSnapshot_) {
+    LOG(INFO) << "MetadataMediator::createDataset : Dataset "
+              << sceneDatasetName << " successfully created from snapshot.";
+    return true;
+  }
   auto datasetAttribs =
       sceneDatasetAttributesManager_->createObject(sceneDatasetName, true);
   if (nullptr == datasetAttribs) {
@@ -43,12 +64,44 @@ bool MetadataMediator::createDataset(const std::string& sceneDatasetName,
                  << " does not exist and is not able to be created.  Aborting.";
     return false;
   }
+  if (useSnapshot) {
+    // a failure to write only costs the next process the speedup
+    Corrade::Utility::Directory::mkpath(datasetSnapshotDirectory_);
+    writeDatasetSnapshot(*datasetAttribs, datasetConfigFilepath,
+                         getDatasetSnapshotFilepath(datasetConfigFilepath));
+  }
   // if not null then successfully created
   LOG(INFO) << "MetadataMediator::createDataset : Dataset " << sceneDatasetName
             << " successfully created.";
   return true;
 }  // MetadataMediator::createDataset
 
+std::string MetadataMediator::getDatasetSnapshotFilepath(
+    const std::string& datasetConfigFilepath) const {
+  namespace Dir = Corrade::Utility::Directory;
+  // datasets in different directories may share a config filename
+  std::ostringstream name;
+  name << Dir::filename(datasetConfigFilepath) << "." << std::hex
+       << std::setw(16) << std::setfill('0')
+       << io::hashString(datasetConfigFilepath) << ".snapshot";
+  return Dir::join(datasetSnapshotDirectory_, name.str());
+}  // MetadataMediator::getDatasetSnapshotFilepath
+
+bool MetadataMediator::createDatasetFromSnapshot(
+    const std::string& datasetConfigFilepath) {
+  // an unregistered dataset with the managers in their initial state, as the
+  // config parsing would start from
+  auto datasetAttribs = sceneDatasetAttributesManager_->createDefaultObject(
+      datasetConfigFilepath, false);
+  if (nullptr == datasetAttribs ||
+      !readDatasetSnapshot(getDatasetSnapshotFilepath(datasetConfigFilepath),
+                           *datasetAttribs)) {
+    return false;
+  }
+  return sceneDatasetAttributesManager_->registerObject(datasetAttribs) !=
+         ID_UNDEFINED;
+}  // MetadataMediator::createDatasetFromSnapshot
+
 bool MetadataMediator::setActiveSceneDatasetName(
     const std::string& sceneDatasetName) {
   // first check if dataset exists, if so then set default
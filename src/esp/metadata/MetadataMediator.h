@@ -59,6 +59,29 @@ class MetadataMediator {
    * @return whether successful or not
    */
   bool setActiveSceneDatasetName(const std::string& sceneDatasetName);
+
+  /**
+   * @brief Set a directory to cache the metadata of datasets in. If set, @ref
+   * createDataset restores a dataset from its snapshot in this directory when
+   * none of its config files have changed since the snapshot got written, and
+   * otherwise builds it from the configs and writes a new snapshot. See @ref
+   * esp::metadata::writeDatasetSnapshot. Empty, the default, disables
+   * snapshots.
+   * @param snapshotDirectory The directory to read and write snapshots in.
+   */
+  void setDatasetSnapshotDirectory(const std::string& snapshotDirectory) {
+    datasetSnapshotDirectory_ = snapshotDirectory;
+  }
+  std::string getDatasetSnapshotDirectory() const {
+    return datasetSnapshotDirectory_;
+  }
+
+  /**
+   * @brief Whether the dataset most recently created by @ref createDataset
+   * got restored from its snapshot instead of being built from its configs.
+   */
+  bool getLastDatasetFromSnapshot() const { return lastDatasetFromSnapshot_; }
+
   /**
    * @brief Returns the name of the current default dataset
    */
@@ -192,6 +215,26 @@ class MetadataMediator {
    * @brief String name of current, default dataset.
    */
   std::string activeSceneDataset_;
+
+  /**
+   * @brief Snapshot file of the dataset with the given config in @ref
+   * datasetSnapshotDirectory_.
+   */
+  std::string getDatasetSnapshotFilepath(
+      const std::string& datasetConfigFilepath) const;
+
+  /**
+   * @brief Create and register a dataset from its snapshot, if there's an up
+   * to date one.
+   * @return Whether the dataset got created.
+   */
+  bool createDatasetFromSnapshot(const std::string& datasetConfigFilepath);
+
+  //! Directory holding dataset snapshots, empty if disabled
+  std::string datasetSnapshotDirectory_;
+
+  //! Whether the dataset last created got restored from its snapshot
+  bool lastDatasetFromSnapshot_ = false;
   /**
    * @brief Manages all construction and access to asset attributes.
    */
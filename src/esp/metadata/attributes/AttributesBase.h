@@ -33,9 +33,7 @@ class AbstractAttributes : public esp::core::AbstractManagedObject,
    * @brief Get this attributes' class.  Should only be set from constructor.
    * Used as key in constructor function pointer maps in AttributesManagers.
    */
-  std::string getClassKey() const override {
-    return getString("attributesClassKey");
-  }
+  std::string getClassKey() const override { return classKey_; }
 
   /**
    * @brief Set this attributes name/origin.  Some attributes derive their own
@@ -44,9 +42,9 @@ class AbstractAttributes : public esp::core::AbstractManagedObject,
    * @param handle the handle to set.
    */
   virtual void setHandle(const std::string& handle) override {
-    setString("handle", handle);
+    setTypedValue("handle", handle, handle_);
   }
-  std::string getHandle() const override { return getString("handle"); }
+  std::string getHandle() const override { return handle_; }
 
   /**
    * @brief This will return a simplified version of the attributes handle. Note
@@ -76,8 +74,8 @@ class AbstractAttributes : public esp::core::AbstractManagedObject,
   /**
    *  @brief Unique ID referencing attributes
    */
-  void setID(int ID) override { setInt("ID", ID); }
-  int getID() const override { return getInt("ID"); }
+  void setID(int ID) override { setTypedValue("ID", ID, ID_); }
+  int getID() const override { return ID_; }
 
   /**
    * @brief Returns configuration to be used with PrimitiveImporter to
@@ -91,6 +89,15 @@ class AbstractAttributes : public esp::core::AbstractManagedObject,
     return cfg;
   }
 
+  /**
+   * @brief Replace all values of this attributes object, e.g. with ones
+   * previously saved from @ref getConfigGroup.
+   */
+  void setConfigGroup(const Corrade::Utility::ConfigurationGroup& group) {
+    cfg = group;
+    valueChanged("");
+  }
+
  protected:
   /**
    * @brief Set this attributes' class.  Should only be set from constructor.
@@ -99,9 +106,21 @@ class AbstractAttributes : public esp::core::AbstractManagedObject,
    * constructors used to make copies of this object in copy constructor map.
    */
   void setClassKey(const std::string& attributesClassKey) override {
-    setString("attributesClassKey", attributesClassKey);
+    setTypedValue("attributesClassKey", attributesClassKey, classKey_);
+  }
+
+  void valueChanged(const std::string& key) override {
+    syncTypedValue(key, "attributesClassKey", classKey_);
+    syncTypedValue(key, "handle", handle_);
+    syncTypedValue(key, "ID", ID_);
   }
 
+  // Typed copies of frequently read values, kept in sync with the
+  // string-keyed values by the setters and valueChanged()
+  std::string classKey_;
+  std::string handle_;
+  int ID_ = 0;
+
  public:
   ESP_SMART_POINTERS(AbstractAttributes)
 };  // class AbstractAttributes
@@ -40,6 +40,24 @@ AbstractObjectAttributes::AbstractObjectAttributes(
   setCollisionAssetHandle("");
 }  // AbstractObjectAttributes ctor
 
+void AbstractObjectAttributes::valueChanged(const std::string& key) {
+  AbstractAttributes::valueChanged(key);
+  syncTypedValue(key, "scale", scale_);
+  syncTypedValue(key, "margin", margin_);
+  syncTypedValue(key, "is_collidable", isCollidable_);
+  syncTypedValue(key, "orient_up", orientUp_);
+  syncTypedValue(key, "orient_front", orientFront_);
+  syncTypedValue(key, "units_to_meters", unitsToMeters_);
+  syncTypedValue(key, "friction_coefficient", frictionCoefficient_);
+  syncTypedValue(key, "restitution_coefficient", restitutionCoefficient_);
+  syncTypedValue(key, "render_asset", renderAssetHandle_);
+  syncTypedValue(key, "renderAssetIsPrimitive", renderAssetIsPrimitive_);
+  syncTypedValue(key, "collision_asset", collisionAssetHandle_);
+  syncTypedValue(key, "collisionAssetIsPrimitive", collisionAssetIsPrimitive_);
+  syncTypedValue(key, "useMeshCollision", useMeshCollision_);
+  syncTypedValue(key, "requires_lighting", requiresLighting_);
+}  // AbstractObjectAttributes::valueChanged
+
 ObjectAttributes::ObjectAttributes(const std::string& handle)
     : AbstractObjectAttributes("ObjectAttributes", handle) {
   // fill necessary attribute defaults
@@ -58,6 +76,20 @@ ObjectAttributes::ObjectAttributes(const std::string& handle)
   setSemanticId(0);
 }  // ObjectAttributes ctor
 
+void ObjectAttributes::valueChanged(const std::string& key) {
+  AbstractObjectAttributes::valueChanged(key);
+  syncTypedValue(key, "COM", COM_);
+  syncTypedValue(key, "computeCOMFromShape", computeCOMFromShape_);
+  syncTypedValue(key, "mass", mass_);
+  syncTypedValue(key, "inertia", inertia_);
+  syncTypedValue(key, "linear_damping", linearDamping_);
+  syncTypedValue(key, "angular_damping", angularDamping_);
+  syncTypedValue(key, "use_bounding_box_for_collision", boundingBoxCollisions_);
+  syncTypedValue(key, "join_collision_meshes", joinCollisionMeshes_);
+  syncTypedValue(key, "isVisible", isVisible_);
+  syncTypedValue(key, "semantic_id", semanticId_);
+}  // ObjectAttributes::valueChanged
+
 StageAttributes::StageAttributes(const std::string& handle)
     : AbstractObjectAttributes("StageAttributes", handle) {
   setGravity({0, -9.8, 0});
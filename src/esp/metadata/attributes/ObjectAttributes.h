@@ -35,72 +35,72 @@ class AbstractObjectAttributes : public AbstractAttributes {
   /**
    * @brief Scale of the ojbect
    */
-  void setScale(const Magnum::Vector3& scale) { setVec3("scale", scale); }
-  Magnum::Vector3 getScale() const { return getVec3("scale"); }
+  void setScale(const Magnum::Vector3& scale) {
+    setTypedValue("scale", scale, scale_);
+  }
+  Magnum::Vector3 getScale() const { return scale_; }
 
   /**
    * @brief collision shape inflation margin
    */
-  void setMargin(double margin) { setDouble("margin", margin); }
-  double getMargin() const { return getDouble("margin"); }
+  void setMargin(double margin) { setTypedValue("margin", margin, margin_); }
+  double getMargin() const { return margin_; }
 
   // if object should be checked for collisions - if other objects can collide
   // with this object
   void setIsCollidable(bool isCollidable) {
-    setBool("is_collidable", isCollidable);
+    setTypedValue("is_collidable", isCollidable, isCollidable_);
   }
-  bool getIsCollidable() const { return getBool("is_collidable"); }
+  bool getIsCollidable() const { return isCollidable_; }
 
   /**
    * @brief set default up orientation for object/stage mesh
    */
   void setOrientUp(const Magnum::Vector3& orientUp) {
-    setVec3("orient_up", orientUp);
+    setTypedValue("orient_up", orientUp, orientUp_);
   }
   /**
    * @brief get default up orientation for object/stage mesh
    */
-  Magnum::Vector3 getOrientUp() const { return getVec3("orient_up"); }
+  Magnum::Vector3 getOrientUp() const { return orientUp_; }
   /**
    * @brief set default forwardd orientation for object/stage mesh
    */
   void setOrientFront(const Magnum::Vector3& orientFront) {
-    setVec3("orient_front", orientFront);
+    setTypedValue("orient_front", orientFront, orientFront_);
   }
   /**
    * @brief get default forwardd orientation for object/stage mesh
    */
-  Magnum::Vector3 getOrientFront() const { return getVec3("orient_front"); }
+  Magnum::Vector3 getOrientFront() const { return orientFront_; }
 
   // units to meters mapping
   void setUnitsToMeters(double unitsToMeters) {
-    setDouble("units_to_meters", unitsToMeters);
+    setTypedValue("units_to_meters", unitsToMeters, unitsToMeters_);
   }
-  double getUnitsToMeters() const { return getDouble("units_to_meters"); }
+  double getUnitsToMeters() const { return unitsToMeters_; }
 
   void setFrictionCoefficient(double frictionCoefficient) {
-    setDouble("friction_coefficient", frictionCoefficient);
-  }
-  double getFrictionCoefficient() const {
-    return getDouble("friction_coefficient");
+    setTypedValue("friction_coefficient", frictionCoefficient,
+                  frictionCoefficient_);
   }
+  double getFrictionCoefficient() const { return frictionCoefficient_; }
 
   void setRestitutionCoefficient(double restitutionCoefficient) {
-    setDouble("restitution_coefficient", restitutionCoefficient);
-  }
-  double getRestitutionCoefficient() const {
-    return getDouble("restitution_coefficient");
+    setTypedValue("restitution_coefficient", restitutionCoefficient,
+                  restitutionCoefficient_);
   }
+  double getRestitutionCoefficient() const { return restitutionCoefficient_; }
   void setRenderAssetType(int renderAssetType) {
     setInt("render_asset_type", renderAssetType);
   }
   int getRenderAssetType() { return getInt("render_asset_type"); }
 
   void setRenderAssetHandle(const std::string& renderAssetHandle) {
-    setString("render_asset", renderAssetHandle);
+    setTypedValue("render_asset", renderAssetHandle, renderAssetHandle_);
     setIsDirty();
   }
-  std::string getRenderAssetHandle() const { return getString("render_asset"); }
+  std::string getRenderAssetHandle() const { return renderAssetHandle_; }
 
   /**
    * @brief Sets whether this object uses file-based mesh render object or
@@ -109,20 +109,18 @@ class AbstractObjectAttributes : public AbstractAttributes {
    * primitive or not
    */
   void setRenderAssetIsPrimitive(bool renderAssetIsPrimitive) {
-    setBool("renderAssetIsPrimitive", renderAssetIsPrimitive);
+    setTypedValue("renderAssetIsPrimitive", renderAssetIsPrimitive,
+                  renderAssetIsPrimitive_);
   }
 
-  bool getRenderAssetIsPrimitive() const {
-    return getBool("renderAssetIsPrimitive");
-  }
+  bool getRenderAssetIsPrimitive() const { return renderAssetIsPrimitive_; }
 
   void setCollisionAssetHandle(const std::string& collisionAssetHandle) {
-    setString("collision_asset", collisionAssetHandle);
+    setTypedValue("collision_asset", collisionAssetHandle,
+                  collisionAssetHandle_);
     setIsDirty();
   }
-  std::string getCollisionAssetHandle() const {
-    return getString("collision_asset");
-  }
+  std::string getCollisionAssetHandle() const { return collisionAssetHandle_; }
 
   void setCollisionAssetType(int collisionAssetType) {
     setInt("collision_asset_type", collisionAssetType);
@@ -143,11 +141,12 @@ class AbstractObjectAttributes : public AbstractAttributes {
    * primitive (implicitly calculated) or a mesh
    */
   void setCollisionAssetIsPrimitive(bool collisionAssetIsPrimitive) {
-    setBool("collisionAssetIsPrimitive", collisionAssetIsPrimitive);
+    setTypedValue("collisionAssetIsPrimitive", collisionAssetIsPrimitive,
+                  collisionAssetIsPrimitive_);
   }
 
   bool getCollisionAssetIsPrimitive() const {
-    return getBool("collisionAssetIsPrimitive");
+    return collisionAssetIsPrimitive_;
   }
 
   /**
@@ -155,16 +154,16 @@ class AbstractObjectAttributes : public AbstractAttributes {
    * collision calculation.
    */
   void setUseMeshCollision(bool useMeshCollision) {
-    setBool("useMeshCollision", useMeshCollision);
+    setTypedValue("useMeshCollision", useMeshCollision, useMeshCollision_);
   }
 
-  bool getUseMeshCollision() const { return getBool("useMeshCollision"); }
+  bool getUseMeshCollision() const { return useMeshCollision_; }
 
   // if true use phong illumination model instead of flat shading
   void setRequiresLighting(bool requiresLighting) {
-    setBool("requires_lighting", requiresLighting);
+    setTypedValue("requires_lighting", requiresLighting, requiresLighting_);
   }
-  bool getRequiresLighting() const { return getBool("requires_lighting"); }
+  bool getRequiresLighting() const { return requiresLighting_; }
 
   bool getIsDirty() const { return getBool("__isDirty"); }
   void setIsClean() { setBool("__isDirty", false); }
@@ -172,6 +171,23 @@ class AbstractObjectAttributes : public AbstractAttributes {
  protected:
   void setIsDirty() { setBool("__isDirty", true); }
 
+  void valueChanged(const std::string& key) override;
+
+  Magnum::Vector3 scale_;
+  double margin_ = 0.0;
+  bool isCollidable_ = false;
+  Magnum::Vector3 orientUp_;
+  Magnum::Vector3 orientFront_;
+  double unitsToMeters_ = 0.0;
+  double frictionCoefficient_ = 0.0;
+  double restitutionCoefficient_ = 0.0;
+  std::string renderAssetHandle_;
+  bool renderAssetIsPrimitive_ = false;
+  std::string collisionAssetHandle_;
+  bool collisionAssetIsPrimitive_ = false;
+  bool useMeshCollision_ = false;
+  bool requiresLighting_ = false;
+
  public:
   ESP_SMART_POINTERS(AbstractObjectAttributes)
 
@@ -185,62 +201,79 @@ class ObjectAttributes : public AbstractObjectAttributes {
  public:
   ObjectAttributes(const std::string& handle = "");
   // center of mass (COM)
-  void setCOM(const Magnum::Vector3& com) { setVec3("COM", com); }
-  Magnum::Vector3 getCOM() const { return getVec3("COM"); }
+  void setCOM(const Magnum::Vector3& com) { setTypedValue("COM", com, COM_); }
+  Magnum::Vector3 getCOM() const { return COM_; }
 
   // whether com is provided or not
   void setComputeCOMFromShape(bool computeCOMFromShape) {
-    setBool("computeCOMFromShape", computeCOMFromShape);
+    setTypedValue("computeCOMFromShape", computeCOMFromShape,
+                  computeCOMFromShape_);
   }
-  bool getComputeCOMFromShape() const { return getBool("computeCOMFromShape"); }
+  bool getComputeCOMFromShape() const { return computeCOMFromShape_; }
 
-  void setMass(double mass) { setDouble("mass", mass); }
-  double getMass() const { return getDouble("mass"); }
+  void setMass(double mass) { setTypedValue("mass", mass, mass_); }
+  double getMass() const { return mass_; }
 
   // inertia diagonal
   void setInertia(const Magnum::Vector3& inertia) {
-    setVec3("inertia", inertia);
+    setTypedValue("inertia", inertia, inertia_);
   }
-  Magnum::Vector3 getInertia() const { return getVec3("inertia"); }
+  Magnum::Vector3 getInertia() const { return inertia_; }
 
   void setLinearDamping(double linearDamping) {
-    setDouble("linear_damping", linearDamping);
+    setTypedValue("linear_damping", linearDamping, linearDamping_);
   }
-  double getLinearDamping() const { return getDouble("linear_damping"); }
+  double getLinearDamping() const { return linearDamping_; }
 
   void setAngularDamping(double angularDamping) {
-    setDouble("angular_damping", angularDamping);
+    setTypedValue("angular_damping", angularDamping, angularDamping_);
   }
-  double getAngularDamping() const { return getDouble("angular_damping"); }
+  double getAngularDamping() const { return angularDamping_; }
 
   // if true override other settings and use render mesh bounding box as
   // collision object
   void setBoundingBoxCollisions(bool useBoundingBoxForCollision) {
-    setBool("use_bounding_box_for_collision", useBoundingBoxForCollision);
-  }
-  bool getBoundingBoxCollisions() const {
-    return getBool("use_bounding_box_for_collision");
+    setTypedValue("use_bounding_box_for_collision", useBoundingBoxForCollision,
+                  boundingBoxCollisions_);
   }
+  bool getBoundingBoxCollisions() const { return boundingBoxCollisions_; }
 
   // if true join all mesh components of an asset into a unified collision
   // object
   void setJoinCollisionMeshes(bool joinCollisionMeshes) {
-    setBool("join_collision_meshes", joinCollisionMeshes);
-  }
-  bool getJoinCollisionMeshes() const {
-    return getBool("join_collision_meshes");
+    setTypedValue("join_collision_meshes", joinCollisionMeshes,
+                  joinCollisionMeshes_);
   }
+  bool getJoinCollisionMeshes() const { return joinCollisionMeshes_; }
 
   /**
    * @brief If not visible can add dynamic non-rendered object into a scene
    * object.  If is not visible then should not add object to drawables.
    */
-  void setIsVisible(bool isVisible) { setBool("isVisible", isVisible); }
-  bool getIsVisible() const { return getBool("isVisible"); }
+  void setIsVisible(bool isVisible) {
+    setTypedValue("isVisible", isVisible, isVisible_);
+  }
+  bool getIsVisible() const { return isVisible_; }
 
-  void setSemanticId(uint32_t semanticId) { setInt("semantic_id", semanticId); }
+  void setSemanticId(uint32_t semanticId) {
+    setTypedValue("semantic_id", int(semanticId), semanticId_);
+  }
+
+  uint32_t getSemanticId() const { return semanticId_; }
 
-  uint32_t getSemanticId() const { return getInt("semantic_id"); }
+ protected:
+  void valueChanged(const std::string& key) override;
+
+  Magnum::Vector3 COM_;
+  bool computeCOMFromShape_ = false;
+  double mass_ = 0.0;
+  Magnum::Vector3 inertia_;
+  double linearDamping_ = 0.0;
+  double angularDamping_ = 0.0;
+  bool boundingBoxCollisions_ = false;
+  bool joinCollisionMeshes_ = false;
+  bool isVisible_ = false;
+  int semanticId_ = 0;
 
  public:
   ESP_SMART_POINTERS(ObjectAttributes)
@@ -13,8 +13,19 @@ PhysicsManagerAttributes::PhysicsManagerAttributes(const std::string& handle)
   setSimulator("none");
   setTimestep(0.01);
   setMaxSubsteps(10);
+  setUseStageBvhCache(false);
 }  // PhysicsManagerAttributes ctor
 
+void PhysicsManagerAttributes::valueChanged(const std::string& key) {
+  AbstractAttributes::valueChanged(key);
+  syncTypedValue(key, "physics_simulator", simulator_);
+  syncTypedValue(key, "timestep", timestep_);
+  syncTypedValue(key, "max_substeps", maxSubsteps_);
+  syncTypedValue(key, "gravity", gravity_);
+  syncTypedValue(key, "friction_coefficient", frictionCoefficient_);
+  syncTypedValue(key, "restitution_coefficient", restitutionCoefficient_);
+}  // PhysicsManagerAttributes::valueChanged
+
 }  // namespace attributes
 }  // namespace metadata
 }  // namespace esp
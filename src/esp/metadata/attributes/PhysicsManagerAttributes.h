@@ -17,34 +17,56 @@ class PhysicsManagerAttributes : public AbstractAttributes {
   PhysicsManagerAttributes(const std::string& handle = "");
 
   void setSimulator(const std::string& simulator) {
-    setString("physics_simulator", simulator);
+    setTypedValue("physics_simulator", simulator, simulator_);
   }
-  std::string getSimulator() const { return getString("physics_simulator"); }
+  std::string getSimulator() const { return simulator_; }
 
-  void setTimestep(double timestep) { setDouble("timestep", timestep); }
-  double getTimestep() const { return getDouble("timestep"); }
+  void setTimestep(double timestep) {
+    setTypedValue("timestep", timestep, timestep_);
+  }
+  double getTimestep() const { return timestep_; }
 
-  void setMaxSubsteps(int maxSubsteps) { setInt("max_substeps", maxSubsteps); }
-  int getMaxSubsteps() const { return getInt("max_substeps"); }
+  void setMaxSubsteps(int maxSubsteps) {
+    setTypedValue("max_substeps", maxSubsteps, maxSubsteps_);
+  }
+  int getMaxSubsteps() const { return maxSubsteps_; }
 
   void setGravity(const Magnum::Vector3& gravity) {
-    setVec3("gravity", gravity);
+    setTypedValue("gravity", gravity, gravity_);
   }
-  Magnum::Vector3 getGravity() const { return getVec3("gravity"); }
+  Magnum::Vector3 getGravity() const { return gravity_; }
 
   void setFrictionCoefficient(double frictionCoefficient) {
-    setDouble("friction_coefficient", frictionCoefficient);
-  }
-  double getFrictionCoefficient() const {
-    return getDouble("friction_coefficient");
+    setTypedValue("friction_coefficient", frictionCoefficient,
+                  frictionCoefficient_);
   }
+  double getFrictionCoefficient() const { return frictionCoefficient_; }
 
   void setRestitutionCoefficient(double restitutionCoefficient) {
-    setDouble("restitution_coefficient", restitutionCoefficient);
+    setTypedValue("restitution_coefficient", restitutionCoefficient,
+                  restitutionCoefficient_);
   }
-  double getRestitutionCoefficient() const {
-    return getDouble("restitution_coefficient");
+  double getRestitutionCoefficient() const { return restitutionCoefficient_; }
+
+  /**
+   * @brief Whether to cache the BVHs of static stage collision meshes in
+   * files next to the collision assets, to skip building them when loading
+   * the stage again.
+   */
+  void setUseStageBvhCache(bool useStageBvhCache) {
+    setBool("use_stage_bvh_cache", useStageBvhCache);
   }
+  bool getUseStageBvhCache() const { return getBool("use_stage_bvh_cache"); }
+
+ protected:
+  void valueChanged(const std::string& key) override;
+
+  std::string simulator_;
+  double timestep_ = 0.0;
+  int maxSubsteps_ = 0;
+  Magnum::Vector3 gravity_;
+  double frictionCoefficient_ = 0.0;
+  double restitutionCoefficient_ = 0.0;
 
  public:
   ESP_SMART_POINTERS(PhysicsManagerAttributes)
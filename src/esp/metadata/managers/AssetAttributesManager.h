@@ -181,8 +181,7 @@ class AssetAttributesManager
       return {};
     }
     std::string subStr = PrimitiveNames3DMap.at(primType);
-    return this->getObjectHandlesBySubStringPerType(this->objectLibKeyByID_,
-                                                    subStr, contains);
+    return this->getObjectHandlesBySubstring(subStr, contains);
   }  // AssetAttributeManager::getTemplateHandlesByPrimType
 
   /**
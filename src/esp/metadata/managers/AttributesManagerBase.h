@@ -9,6 +9,10 @@
  * @brief Class Template @ref esp::metadata::managers::AttributesManager
  */
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "esp/metadata/attributes/AttributesBase.h"
 
 #include "esp/core/ManagedContainer.h"
@@ -49,7 +53,10 @@ class AttributesManager : public esp::core::ManagedContainer<T> {
    * locations.
    *
    * This will take the list of file names specified and load the referenced
-   * templates.  It is assumed these files are JSON files currently.
+   * templates.  It is assumed these files are JSON files currently. The files
+   * are read and parsed concurrently, see @ref setNumConfigLoadThreads, while
+   * the templates are built and registered in the order of @p tmpltFilenames,
+   * so IDs don't depend on which file finished parsing first.
    * @param tmpltFilenames list of file names of templates
    * @param saveAsDefaults Set these templates as un-deletable from library.
    * @return vector holding IDs of templates that have been added
@@ -89,6 +96,51 @@ class AttributesManager : public esp::core::ManagedContainer<T> {
   void buildCfgPathsFromJSONAndLoad(const std::string& configDir,
                                     const io::JsonGenericValue& jsonPaths);
 
+  /**
+   * @brief Files and directories this manager has loaded configs from, in
+   * load order. Used to check whether a dataset snapshot is still up to date,
+   * see @ref esp::metadata::writeDatasetSnapshot.
+   */
+  const std::vector<std::string>& getConfigSourcePaths() const {
+    return configSourcePaths_;
+  }
+
+  /**
+   * @brief Register an attributes restored from a dataset snapshot under its
+   * own handle, see @ref esp::metadata::readDatasetSnapshot.
+   * @param attribs The attributes to register.
+   * @param undeletable Whether to make the attributes undeletable, as
+   * attributes loaded with saveAsDefaults in @ref loadAllFileBasedTemplates
+   * are.
+   * @return The ID of the registered attributes, or ID_UNDEFINED if failed.
+   */
+  int registerSnapshotObject(AttribsPtr attribs, bool undeletable) {
+    const std::string handle = attribs->getHandle();
+    const int ID = this->registerObject(attribs, handle);
+    if (undeletable && ID != ID_UNDEFINED) {
+      this->undeletableObjectNames_.insert(handle);
+    }
+    return ID;
+  }
+
+  /**
+   * @brief Number of threads reading and parsing config files in @ref
+   * loadAllFileBasedTemplates, including the calling one.
+   */
+  int getNumConfigLoadThreads() const { return numConfigLoadThreads_; }
+
+  /**
+   * @brief Set the number of threads reading and parsing config files in
+   * @ref loadAllFileBasedTemplates, including the calling one. 0 for the
+   * hardware concurrency, 1 to parse on the calling thread only.
+   */
+  void setNumConfigLoadThreads(int numThreads) {
+    numConfigLoadThreads_ =
+        numThreads > 0 ? numThreads
+                       : std::max(1, static_cast<int>(
+                                         std::thread::hardware_concurrency()));
+  }
+
   /**
    * @brief Check if currently configured primitive asset template library has
    * passed handle.
@@ -162,6 +214,19 @@ class AttributesManager : public esp::core::ManagedContainer<T> {
    */
   const std::string JSONTypeExt_;
 
+  /**
+   * @brief Number of threads parsing config files in @ref
+   * loadAllFileBasedTemplates, see @ref setNumConfigLoadThreads
+   */
+  int numConfigLoadThreads_ =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+  /**
+   * @brief Files and directories configs were loaded from, see @ref
+   * getConfigSourcePaths
+   */
+  std::vector<std::string> configSourcePaths_;
+
  public:
   ESP_SMART_POINTERS(AttributesManager<AttribsPtr>)
 
@@ -179,12 +244,50 @@ std::vector<int> AttributesManager<T>::loadAllFileBasedTemplates(
     LOG(INFO) << "AttributesManager::loadAllFileBasedTemplates : Loading "
               << paths.size() << " " << this->objectType_
               << " templates found in " << dir;
+    // Reading and parsing the files dominates, and only touches the document
+    // of each file, so it is spread over worker threads. Building and
+    // registering the templates modifies the library and happens afterwards,
+    // in the order of the paths.
+    std::vector<io::JsonDocument> docs(paths.size());
+    std::vector<char> parsed(paths.size(), 0);
+    std::atomic<std::size_t> nextPath{0};
+    auto parseDocs = [&]() {
+      for (std::size_t i = nextPath++; i < paths.size(); i = nextPath++) {
+        parsed[i] = this->verifyLoadDocument(paths[i], docs[i]);
+      }
+    };
+    const int numThreads =
+        std::min(numConfigLoadThreads_, static_cast<int>(paths.size()));
+    std::vector<std::thread> workers;
+    for (int i = 1; i < numThreads; ++i) {
+      workers.emplace_back(parseDocs);
+    }
+    parseDocs();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    configSourcePaths_.insert(configSourcePaths_.end(), paths.begin(),
+                              paths.end());
     for (int i = 0; i < paths.size(); ++i) {
       auto attributesFilename = paths[i];
       LOG(INFO) << "AttributesManager::loadAllFileBasedTemplates : Load "
                 << this->objectType_ << " template: "
                 << Cr::Utility::Directory::filename(attributesFilename);
-      auto tmplt = this->createObjectFromJSONFile(attributesFilename, true);
+      if (!parsed[i]) {
+        LOG(ERROR) << "AttributesManager::loadAllFileBasedTemplates ("
+                   << this->objectType_
+                   << ") : Failure reading document as JSON : "
+                   << attributesFilename << ". Skipping.";
+        continue;
+      }
+      auto tmplt =
+          this->createObjectFromJSONDoc(attributesFilename, docs[i], true);
+      // free the document right away, large datasets have many of them
+      docs[i] = io::JsonDocument{};
+      if (!tmplt) {
+        continue;
+      }
 
       // save handles in list of defaults, so they are not removed, if desired.
       if (saveAsDefaults) {
@@ -213,6 +316,8 @@ std::vector<int> AttributesManager<T>::loadAllConfigsFromPath(
   if (dirExists) {
     LOG(INFO) << "AttributesManager::loadAllConfigsFromPath : Parsing "
               << this->objectType_ << " library directory: " + path;
+    // files added to or removed from the directory change its mtime
+    configSourcePaths_.push_back(path);
     for (auto& file : Dir::list(path, Dir::Flag::SortAscending)) {
       std::string absoluteSubfilePath = Dir::join(path, file);
       if (Cr::Utility::String::endsWith(absoluteSubfilePath,
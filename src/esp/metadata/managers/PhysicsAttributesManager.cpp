@@ -62,6 +62,12 @@ void PhysicsAttributesManager::setValsFromJSONDoc(
       std::bind(&PhysicsManagerAttributes::setRestitutionCoefficient,
                 physicsManagerAttributes, _1));
 
+  // load whether to cache stage BVHs
+  io::jsonIntoSetter<bool>(
+      jsonConfig, "use_stage_bvh_cache",
+      std::bind(&PhysicsManagerAttributes::setUseStageBvhCache,
+                physicsManagerAttributes, _1));
+
   // load world gravity
   io::jsonIntoConstSetter<Magnum::Vector3>(
       jsonConfig, "gravity",
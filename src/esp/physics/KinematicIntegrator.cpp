@@ -0,0 +1,92 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "KinematicIntegrator.h"
+
+#include "RigidObject.h"
+
+namespace Mn = Magnum;
+
+namespace esp {
+namespace physics {
+
+void KinematicIntegrator::clear() {
+  translations_.clear();
+  rotations_.clear();
+  linVels_.clear();
+  angVels_.clear();
+  flags_.clear();
+}
+
+std::size_t KinematicIntegrator::add(const VelocityControl& velControl,
+                                     const core::RigidState& rigidState) {
+  std::uint8_t flags = 0;
+  if (velControl.controllingLinVel) {
+    flags |= ControllingLinVel;
+    if (velControl.linVelIsLocal) {
+      flags |= LinVelIsLocal;
+    }
+  }
+  // a zero angular velocity leaves the rotation untouched, not even
+  // normalized, same as in VelocityControl::integrateTransform
+  if (velControl.controllingAngVel && velControl.angVel != Mn::Vector3{0.0}) {
+    flags |= ControllingAngVel;
+    if (velControl.angVelIsLocal) {
+      flags |= AngVelIsLocal;
+    }
+  }
+
+  translations_.push_back(rigidState.translation);
+  rotations_.push_back(rigidState.rotation);
+  linVels_.push_back(velControl.linVel);
+  angVels_.push_back(velControl.angVel);
+  flags_.push_back(flags);
+  return translations_.size() - 1;
+}
+
+void KinematicIntegrator::integrate(const float dt, const int numSteps) {
+  const std::size_t count = translations_.size();
+
+  stepRotations_.resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if ((flags_[i] & (ControllingAngVel | AngVelIsLocal)) ==
+        ControllingAngVel) {
+      stepRotations_[i] = Mn::Quaternion::rotation(
+          Mn::Rad{(angVels_[i] * dt).length()}, angVels_[i].normalized());
+    }
+  }
+
+  for (int step = 0; step < numSteps; ++step) {
+    // linear first
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!(flags_[i] & ControllingLinVel)) {
+        continue;
+      }
+      if (flags_[i] & LinVelIsLocal) {
+        translations_[i] += rotations_[i].transformVector(linVels_[i] * dt);
+      } else {
+        translations_[i] += linVels_[i] * dt;
+      }
+    }
+
+    // then angular
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!(flags_[i] & ControllingAngVel)) {
+        continue;
+      }
+      if (flags_[i] & AngVelIsLocal) {
+        const Mn::Vector3 globalAngVel =
+            rotations_[i].transformVector(angVels_[i]);
+        const Mn::Quaternion q = Mn::Quaternion::rotation(
+            Mn::Rad{(globalAngVel * dt).length()}, globalAngVel.normalized());
+        rotations_[i] = (q * rotations_[i]).normalized();
+      } else {
+        rotations_[i] = (stepRotations_[i] * rotations_[i]).normalized();
+      }
+    }
+  }
+}  // KinematicIntegrator::integrate
+
+}  // namespace physics
+}  // namespace esp
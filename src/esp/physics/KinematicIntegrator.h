@@ -0,0 +1,91 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_KINEMATICINTEGRATOR_H_
+#define ESP_PHYSICS_KINEMATICINTEGRATOR_H_
+
+/** @file
+ * @brief Class @ref esp::physics::KinematicIntegrator
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <Magnum/Math/Quaternion.h>
+#include <Magnum/Math/Vector3.h>
+
+#include "esp/core/RigidState.h"
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace physics {
+
+struct VelocityControl;
+
+/**
+ * @brief Applies @ref VelocityControl to many rigid states at once.
+ *
+ * Gives the same result as calling @ref VelocityControl::integrateTransform
+ * for each state and step, but keeps states and velocities in contiguous
+ * arrays and integrates them in tight loops over all of them, one loop for
+ * the linear and one for the angular part. World-space angular velocities
+ * don't depend on the state, so their rotation per step is computed only
+ * once.
+ *
+ * Usage: @ref clear, @ref add the states, @ref integrate, then read the
+ * results back with @ref getRigidState in the order they were added. The
+ * arrays are kept across uses to avoid reallocating them every step.
+ */
+class KinematicIntegrator {
+ public:
+  /** @brief Remove all states, keeping the allocated memory */
+  void clear();
+
+  /**
+   * @brief Add a state to integrate with a velocity control.
+   * @return Index of the state, see @ref getRigidState.
+   */
+  std::size_t add(const VelocityControl& velControl,
+                  const core::RigidState& rigidState);
+
+  /** @brief Number of added states */
+  std::size_t size() const { return translations_.size(); }
+
+  /**
+   * @brief Integrate all states.
+   * @param dt Timestep of a single integration step.
+   * @param numSteps Number of steps of @p dt to take.
+   */
+  void integrate(float dt, int numSteps = 1);
+
+  /** @brief Current value of a state added with @ref add */
+  core::RigidState getRigidState(std::size_t index) const {
+    return core::RigidState(rotations_[index], translations_[index]);
+  }
+
+  ESP_SMART_POINTERS(KinematicIntegrator)
+
+ private:
+  enum : std::uint8_t {
+    ControllingLinVel = 1 << 0,
+    LinVelIsLocal = 1 << 1,
+    ControllingAngVel = 1 << 2,
+    AngVelIsLocal = 1 << 3,
+  };
+
+  std::vector<Magnum::Vector3> translations_;
+  std::vector<Magnum::Quaternion> rotations_;
+  std::vector<Magnum::Vector3> linVels_;
+  std::vector<Magnum::Vector3> angVels_;
+  std::vector<std::uint8_t> flags_;
+
+  //! Per state rotation over one step for world-space angular velocities,
+  //! computed at the start of @ref integrate
+  std::vector<Magnum::Quaternion> stepRotations_;
+};
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_KINEMATICINTEGRATOR_H_
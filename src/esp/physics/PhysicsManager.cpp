@@ -3,13 +3,63 @@
 // LICENSE file in the root directory of this source tree.
 
 #include "PhysicsManager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_set>
+
 #include "esp/assets/CollisionMeshData.h"
+#include "esp/io/io.h"
 
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Magnum/Math/Range.h>
 
 namespace esp {
 namespace physics {
 
+namespace {
+
+// bump whenever the layout below changes
+constexpr std::uint32_t StateSnapshotVersion = 2;
+constexpr char StateSnapshotMagic[4] = {'E', 'P', 'S', 'S'};
+
+struct StateSnapshotHeader {
+  char magic[4];
+  std::uint32_t version;
+  double worldTime;
+  std::uint32_t objectCount;
+  std::uint32_t reserved;
+};
+
+//! Bits of StateSnapshotObject::velControlFlags
+enum : std::uint16_t {
+  ControllingLinVel = 1 << 0,
+  LinVelIsLocal = 1 << 1,
+  ControllingAngVel = 1 << 2,
+  AngVelIsLocal = 1 << 3,
+};
+
+struct StateSnapshotObject {
+  std::int32_t objectId;
+  std::int8_t motionType;
+  std::uint8_t isSleeping;
+  //! VelocityControl booleans
+  std::uint16_t velControlFlags;
+  //! Catches an ID reused by an object of another template
+  std::uint64_t templateHash;
+  float state[PhysicsManager::RIGID_STATE_WITH_VELOCITIES_SIZE];
+  float velControlLinVel[3];
+  float velControlAngVel[3];
+};
+
+std::uint64_t templateHash(const RigidObject& object) {
+  const auto attributes = object.getInitializationAttributes();
+  return io::hashString(attributes ? attributes->getHandle() : std::string{});
+}
+
+}  // namespace
+
 bool PhysicsManager::initPhysics(scene::SceneNode* node) {
   physicsNode_ = node;
 
@@ -213,19 +263,47 @@ void PhysicsManager::stepPhysics(double dt) {
 
   // handle in-between step times? Ideally dt is a multiple of
   // sceneMetaData_.timestep
+  updatedObjectIDs_.clear();
   double targetTime = worldTime_ + dt;
+  int numSteps = 0;
   while (worldTime_ < targetTime) {
     // per fixed-step operations can be added here
+    ++numSteps;
+    worldTime_ += fixedTimeStep_;
+  }
+  if (numSteps == 0) {
+    return;
+  }
 
-    // kinematic velocity control intergration
-    for (auto& object : existingObjects_) {
-      VelocityControl::ptr velControl = object.second->getVelocityControl();
-      if (velControl->controllingAngVel || velControl->controllingLinVel) {
-        object.second->setRigidState(velControl->integrateTransform(
-            fixedTimeStep_, object.second->getRigidState()));
-      }
+  // kinematic velocity control intergration, all steps at once
+  gatherKinematicIntegration(false);
+  kinematicIntegrator_.integrate(fixedTimeStep_, numSteps);
+  scatterKinematicIntegration();
+  updatedObjectIDs_ = kinematicIntegrationIDs_;
+}
+
+void PhysicsManager::gatherKinematicIntegration(bool onlyKinematic) {
+  kinematicIntegrator_.clear();
+  kinematicIntegrationObjects_.clear();
+  kinematicIntegrationIDs_.clear();
+  for (auto& objectItr : existingObjects_) {
+    RigidObject& object = *objectItr.second;
+    if (onlyKinematic && object.getMotionType() != MotionType::KINEMATIC) {
+      continue;
     }
-    worldTime_ += fixedTimeStep_;
+    const VelocityControl& velControl = *object.getVelocityControl();
+    if (velControl.controllingAngVel || velControl.controllingLinVel) {
+      kinematicIntegrator_.add(velControl, object.getRigidState());
+      kinematicIntegrationObjects_.push_back(&object);
+      kinematicIntegrationIDs_.push_back(objectItr.first);
+    }
+  }
+}
+
+void PhysicsManager::scatterKinematicIntegration() {
+  for (std::size_t i = 0; i != kinematicIntegrationObjects_.size(); ++i) {
+    kinematicIntegrationObjects_[i]->setRigidState(
+        kinematicIntegrator_.getRigidState(i));
   }
 }
 
@@ -374,6 +452,184 @@ esp::core::RigidState PhysicsManager::getRigidState(
   return existingObjects_.at(physObjectID)->getRigidState();
 }
 
+void PhysicsManager::getRigidStates(const std::vector<int>& physObjectIDs,
+                                    Corrade::Containers::ArrayView<float> states,
+                                    bool includeVelocities) const {
+  const std::size_t stride =
+      includeVelocities ? std::size_t{RIGID_STATE_WITH_VELOCITIES_SIZE}
+                        : std::size_t{RIGID_STATE_SIZE};
+  CHECK_EQ(states.size(), physObjectIDs.size() * stride);
+  float* state = states.data();
+  for (const int physObjectID : physObjectIDs) {
+    assertIDValidity(physObjectID);
+    RigidObject& object = *existingObjects_.at(physObjectID);
+    const Magnum::Vector3 translation = object.node().translation();
+    const Magnum::Quaternion rotation = object.node().rotation();
+    std::copy(translation.data(), translation.data() + 3, state);
+    std::copy(rotation.vector().data(), rotation.vector().data() + 3,
+              state + 3);
+    state[6] = rotation.scalar();
+    if (includeVelocities) {
+      const Magnum::Vector3 linVel = object.getLinearVelocity();
+      const Magnum::Vector3 angVel = object.getAngularVelocity();
+      std::copy(linVel.data(), linVel.data() + 3, state + 7);
+      std::copy(angVel.data(), angVel.data() + 3, state + 10);
+    }
+    state += stride;
+  }
+}
+
+void PhysicsManager::setRigidStates(
+    const std::vector<int>& physObjectIDs,
+    Corrade::Containers::ArrayView<const float> states,
+    bool includeVelocities) {
+  const std::size_t stride =
+      includeVelocities ? std::size_t{RIGID_STATE_WITH_VELOCITIES_SIZE}
+                        : std::size_t{RIGID_STATE_SIZE};
+  CHECK_EQ(states.size(), physObjectIDs.size() * stride);
+  const float* state = states.data();
+  for (const int physObjectID : physObjectIDs) {
+    assertIDValidity(physObjectID);
+    RigidObject& object = *existingObjects_.at(physObjectID);
+    object.setRigidState(core::RigidState{
+        Magnum::Quaternion{Magnum::Vector3::from(state + 3), state[6]},
+        Magnum::Vector3::from(state)});
+    if (includeVelocities) {
+      object.setLinearVelocity(Magnum::Vector3::from(state + 7));
+      object.setAngularVelocity(Magnum::Vector3::from(state + 10));
+    }
+    state += stride;
+  }
+}
+
+std::vector<char> PhysicsManager::saveState() const {
+  StateSnapshotHeader header{};
+  std::copy(StateSnapshotMagic, StateSnapshotMagic + 4, header.magic);
+  header.version = StateSnapshotVersion;
+  header.worldTime = worldTime_;
+  header.objectCount = existingObjects_.size();
+
+  std::vector<char> snapshot(sizeof(StateSnapshotHeader) +
+                             existingObjects_.size() *
+                                 sizeof(StateSnapshotObject));
+  std::memcpy(snapshot.data(), &header, sizeof(header));
+
+  std::vector<int> physObjectIDs;
+  physObjectIDs.reserve(existingObjects_.size());
+  for (const auto& it : existingObjects_) {
+    physObjectIDs.push_back(it.first);
+  }
+  constexpr std::size_t stride = RIGID_STATE_WITH_VELOCITIES_SIZE;
+  std::vector<float> states(physObjectIDs.size() * stride);
+  getRigidStates(physObjectIDs, states, true);
+
+  char* data = snapshot.data() + sizeof(header);
+  for (std::size_t i = 0; i != physObjectIDs.size(); ++i) {
+    RigidObject& object = *existingObjects_.at(physObjectIDs[i]);
+    StateSnapshotObject record{};
+    record.objectId = physObjectIDs[i];
+    record.motionType = static_cast<std::int8_t>(object.getMotionType());
+    // without a physics engine nothing is active, but nothing sleeps either
+    record.isSleeping = activePhysSimLib_ != NONE && !object.isActive();
+    record.templateHash = templateHash(object);
+    std::copy(states.begin() + i * stride, states.begin() + (i + 1) * stride,
+              record.state);
+    const VelocityControl& velControl = *object.getVelocityControl();
+    record.velControlFlags =
+        (velControl.controllingLinVel ? ControllingLinVel : 0) |
+        (velControl.linVelIsLocal ? LinVelIsLocal : 0) |
+        (velControl.controllingAngVel ? ControllingAngVel : 0) |
+        (velControl.angVelIsLocal ? AngVelIsLocal : 0);
+    std::copy(velControl.linVel.data(), velControl.linVel.data() + 3,
+              record.velControlLinVel);
+    std::copy(velControl.angVel.data(), velControl.angVel.data() + 3,
+              record.velControlAngVel);
+    std::memcpy(data, &record, sizeof(record));
+    data += sizeof(record);
+  }
+  return snapshot;
+}  // PhysicsManager::saveState
+
+bool PhysicsManager::restoreState(const std::vector<char>& snapshot) {
+  StateSnapshotHeader header{};
+  if (snapshot.size() < sizeof(header)) {
+    LOG(ERROR) << "PhysicsManager::restoreState : snapshot too short";
+    return false;
+  }
+  std::memcpy(&header, snapshot.data(), sizeof(header));
+  if (!std::equal(header.magic, header.magic + 4, StateSnapshotMagic) ||
+      header.version != StateSnapshotVersion ||
+      snapshot.size() != sizeof(header) + std::size_t(header.objectCount) *
+                                              sizeof(StateSnapshotObject)) {
+    LOG(ERROR) << "PhysicsManager::restoreState : invalid snapshot";
+    return false;
+  }
+
+  std::vector<StateSnapshotObject> records(header.objectCount);
+  std::memcpy(records.data(), snapshot.data() + sizeof(header),
+              records.size() * sizeof(StateSnapshotObject));
+
+  // validate everything before touching the world
+  std::unordered_set<int> snapshotIDs;
+  for (const StateSnapshotObject& record : records) {
+    const RigidObject::uptr* object = existingObjects_.find(record.objectId);
+    if (!object || templateHash(**object) != record.templateHash) {
+      LOG(ERROR) << "PhysicsManager::restoreState : object "
+                 << record.objectId
+                 << " of the snapshot no longer exists, can't restore";
+      return false;
+    }
+    if (record.motionType < static_cast<std::int8_t>(MotionType::STATIC) ||
+        record.motionType > static_cast<std::int8_t>(MotionType::DYNAMIC)) {
+      LOG(ERROR) << "PhysicsManager::restoreState : object "
+                 << record.objectId << " has invalid motion type "
+                 << int(record.motionType) << ", can't restore";
+      return false;
+    }
+    if (!snapshotIDs.insert(record.objectId).second) {
+      LOG(ERROR) << "PhysicsManager::restoreState : object "
+                 << record.objectId
+                 << " appears more than once in the snapshot, can't restore";
+      return false;
+    }
+  }
+
+  for (const int physObjectID : getExistingObjectIDs()) {
+    if (snapshotIDs.count(physObjectID) == 0) {
+      removeObject(physObjectID);
+    }
+  }
+
+  constexpr std::size_t stride = RIGID_STATE_WITH_VELOCITIES_SIZE;
+  std::vector<int> physObjectIDs;
+  physObjectIDs.reserve(records.size());
+  std::vector<float> states;
+  states.reserve(records.size() * stride);
+  for (const StateSnapshotObject& record : records) {
+    RigidObject& object = *existingObjects_.at(record.objectId);
+    const MotionType motionType = static_cast<MotionType>(record.motionType);
+    if (object.getMotionType() != motionType) {
+      object.setMotionType(motionType);
+    }
+    VelocityControl& velControl = *object.getVelocityControl();
+    velControl.controllingLinVel = record.velControlFlags & ControllingLinVel;
+    velControl.linVelIsLocal = record.velControlFlags & LinVelIsLocal;
+    velControl.controllingAngVel = record.velControlFlags & ControllingAngVel;
+    velControl.angVelIsLocal = record.velControlFlags & AngVelIsLocal;
+    velControl.linVel = Magnum::Vector3::from(record.velControlLinVel);
+    velControl.angVel = Magnum::Vector3::from(record.velControlAngVel);
+    physObjectIDs.push_back(record.objectId);
+    states.insert(states.end(), record.state, record.state + stride);
+  }
+  setRigidStates(physObjectIDs, states, true);
+  // setting velocities wakes objects up, so this goes last
+  for (const StateSnapshotObject& record : records) {
+    existingObjects_.at(record.objectId)->setSleeping(record.isSleeping);
+  }
+  worldTime_ = header.worldTime;
+  return true;
+}  // PhysicsManager::restoreState
+
 Magnum::Vector3 PhysicsManager::getTranslation(const int physObjectID) const {
   assertIDValidity(physObjectID);
   return existingObjects_.at(physObjectID)->node().translation();
@@ -518,7 +774,7 @@ void PhysicsManager::setObjectBBDraw(int physObjectID,
     existingObjects_.at(physObjectID)->BBNode_->MagnumObject::setScaling(scale);
     existingObjects_.at(physObjectID)
         ->BBNode_->MagnumObject::setTranslation(
-            existingObjects_[physObjectID]
+            existingObjects_.at(physObjectID)
                 ->visualNode_->getCumulativeBB()
                 .center());
     resourceManager_.addPrimitiveToDrawables(
@@ -557,5 +813,26 @@ void PhysicsManager::setSemanticId(const int physObjectID,
   existingObjects_.at(physObjectID)->setSemanticId(semanticId);
 }
 
+void PhysicsManager::castRays(const std::vector<esp::geo::Ray>& rays,
+                              BatchRaycastResults& results,
+                              double maxDistance,
+                              bool closestOnly) {
+  results.reset(rays.size(), rays.size());
+  for (const esp::geo::Ray& ray : rays) {
+    RaycastResults rayResults = castRay(ray, maxDistance);
+    const std::size_t numHits =
+        closestOnly ? std::min<std::size_t>(rayResults.hits.size(), 1)
+                    : rayResults.hits.size();
+    for (std::size_t i = 0; i < numHits; ++i) {
+      const RayHitInfo& hit = rayResults.hits[i];
+      results.objectIds.push_back(hit.objectId);
+      results.points.push_back(hit.point);
+      results.normals.push_back(hit.normal);
+      results.rayDistances.push_back(hit.rayDistance);
+    }
+    results.rayHitOffsets.push_back(results.getNumHits());
+  }
+}
+
 }  // namespace physics
 }  // namespace esp
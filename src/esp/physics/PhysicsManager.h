@@ -10,13 +10,18 @@
  * esp::physics::PhysicsManager::PhysicsSimulationLibrary
  */
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <Corrade/Containers/ArrayView.h>
+
 /* Bullet Physics Integration */
 
+#include "KinematicIntegrator.h"
 #include "RigidObject.h"
 #include "RigidStage.h"
 #include "esp/assets/Asset.h"
@@ -26,6 +31,7 @@
 #include "esp/assets/MeshData.h"
 #include "esp/assets/MeshMetaData.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/core/SlotMap.h"
 #include "esp/gfx/DrawableGroup.h"
 #include "esp/scene/SceneNode.h"
 
@@ -65,6 +71,82 @@ struct RaycastResults {
   ESP_SMART_POINTERS(RaycastResults)
 };
 
+/**
+ * @brief Holds the hits of a batch of rays cast with @ref
+ * PhysicsManager::castRays, as flat per-hit arrays.
+ *
+ * The hits of ray i are at indices [rayHitOffsets[i], rayHitOffsets[i + 1])
+ * of the per-hit arrays, sorted by distance. Reusing the same instance for
+ * subsequent batches reuses its allocations.
+ */
+struct BatchRaycastResults {
+  //! Offsets into the per-hit arrays, one per ray plus the total hit count.
+  std::vector<int> rayHitOffsets;
+  //! The id of the object hit. Stage hits are -1.
+  std::vector<int> objectIds;
+  //! The impact points in world space.
+  std::vector<Magnum::Vector3> points;
+  //! The collision object normals at the points of impact.
+  std::vector<Magnum::Vector3> normals;
+  //! Distances along the ray directions from the ray origins (in units of ray
+  //! length).
+  std::vector<double> rayDistances;
+
+  //! Number of rays in the batch.
+  int getNumRays() const {
+    return rayHitOffsets.empty() ? 0 : int(rayHitOffsets.size()) - 1;
+  }
+
+  //! Total number of hits of all rays.
+  int getNumHits() const { return int(objectIds.size()); }
+
+  //! Number of hits of one ray.
+  int getNumHits(int rayIndex) const {
+    return rayHitOffsets[rayIndex + 1] - rayHitOffsets[rayIndex];
+  }
+
+  //! Empty all arrays and reserve space for the given number of rays and
+  //! hits.
+  void reset(std::size_t numRays, std::size_t numHits) {
+    rayHitOffsets.assign(1, 0);
+    rayHitOffsets.reserve(numRays + 1);
+    objectIds.clear();
+    objectIds.reserve(numHits);
+    points.clear();
+    points.reserve(numHits);
+    normals.clear();
+    normals.reserve(numHits);
+    rayDistances.clear();
+    rayDistances.reserve(numHits);
+  }
+
+  ESP_SMART_POINTERS(BatchRaycastResults)
+};
+
+/**
+ * @brief Holds the results of testing candidate poses of an object with @ref
+ * PhysicsManager::testPlacements, one entry per pose.
+ */
+struct PlacementTestResults {
+  //! Whether the object would be in contact with the collision world, 0 or 1.
+  //! Not a std::vector<bool>, so poses can be written from several threads.
+  std::vector<std::uint8_t> collisions;
+  //! The deepest penetration of the object into the collision world. 0 if
+  //! not colliding or just touching.
+  std::vector<double> penetrationDepths;
+
+  //! Number of poses tested.
+  int getNumPoses() const { return int(collisions.size()); }
+
+  //! Reset all poses to not colliding.
+  void reset(std::size_t numPoses) {
+    collisions.assign(numPoses, 0);
+    penetrationDepths.assign(numPoses, 0.0);
+  }
+
+  ESP_SMART_POINTERS(PlacementTestResults)
+};
+
 // TODO: repurpose to manage multiple physical worlds. Currently represents
 // exactly one world.
 
@@ -227,9 +309,12 @@ class PhysicsManager {
    */
   std::vector<int> getExistingObjectIDs() const {
     std::vector<int> v;
+    v.reserve(existingObjects_.size());
     for (auto& bro : existingObjects_) {
       v.push_back(bro.first);
     }
+    // storage order changes on removal, keep returning ascending IDs
+    std::sort(v.begin(), v.end());
     return v;
   };
 
@@ -289,6 +374,20 @@ class PhysicsManager {
    */
   virtual double getWorldTime() const { return worldTime_; };
 
+  /** @brief Get the IDs of the objects moved by the last call to @ref
+   * stepPhysics.
+   *
+   * Sleeping and static objects are skipped, so only the @ref
+   * scene::SceneNode of the listed objects were transformed by the step.
+   * Consumers syncing object poses elsewhere (renderer, replay recording)
+   * can restrict themselves to these. Objects transformed directly through
+   * the API in between steps are not listed.
+   * @return The object IDs, in no particular order.
+   */
+  const std::vector<int>& getUpdatedObjectIDs() const {
+    return updatedObjectIDs_;
+  };
+
   /** @brief Get the current gravity in the physical world. By default returns
    * [0,0,0] since their is no notion of force in a kinematic world.
    * @return The current gravity vector in the physical world.
@@ -486,6 +585,73 @@ class PhysicsManager {
    */
   esp::core::RigidState getRigidState(const int objectID) const;
 
+  /** @brief Number of floats per object in the arrays of @ref getRigidStates
+   * and @ref setRigidStates: translation (x, y, z) and rotation quaternion
+   * (x, y, z, w).
+   */
+  static constexpr int RIGID_STATE_SIZE = 7;
+
+  /** @brief Number of floats per object in the arrays of @ref getRigidStates
+   * and @ref setRigidStates with velocities: @ref RIGID_STATE_SIZE floats
+   * followed by the linear and angular velocity.
+   */
+  static constexpr int RIGID_STATE_WITH_VELOCITIES_SIZE = 13;
+
+  /** @brief Get the current @ref esp::core::RigidState of several objects at
+   * once, packed into a flat array.
+   * @param physObjectIDs The object IDs and keys identifying the objects in
+   * @ref PhysicsManager::existingObjects_.
+   * @param[out] states Receives the states in the order of the IDs, @ref
+   * RIGID_STATE_SIZE or @ref RIGID_STATE_WITH_VELOCITIES_SIZE floats per
+   * object.
+   * @param includeVelocities Whether to also get the linear and angular
+   * velocities.
+   */
+  void getRigidStates(const std::vector<int>& physObjectIDs,
+                      Corrade::Containers::ArrayView<float> states,
+                      bool includeVelocities = false) const;
+
+  /** @brief Set the @ref esp::core::RigidState of several objects at once
+   * kinematically, from a flat array laid out as in @ref getRigidStates.
+   * Calling this during simulation of @ref MotionType::DYNAMIC objects is not
+   * recommended.
+   * @param physObjectIDs The object IDs and keys identifying the objects in
+   * @ref PhysicsManager::existingObjects_.
+   * @param states The states in the order of the IDs.
+   * @param includeVelocities Whether the array also contains the linear and
+   * angular velocities to set.
+   */
+  void setRigidStates(const std::vector<int>& physObjectIDs,
+                      Corrade::Containers::ArrayView<const float> states,
+                      bool includeVelocities = false);
+
+  /** @brief Save the state of the physical world into a compact binary
+   * snapshot, for cheap episode resets or rolling out several futures from
+   * the same state with @ref restoreState.
+   *
+   * The snapshot holds the @ref worldTime_ and, for every object in @ref
+   * PhysicsManager::existingObjects_, its ID, a hash of its template handle,
+   * its @ref MotionType, pose, linear and angular velocity, its @ref
+   * VelocityControl and whether it is sleeping. The static stage and the
+   * object templates are not included.
+   * @return The snapshot.
+   */
+  std::vector<char> saveState() const;
+
+  /** @brief Restore the state of the physical world from a snapshot created
+   * with @ref saveState.
+   *
+   * Objects added since the snapshot was taken are removed. All objects of
+   * the snapshot must still exist with the same IDs and templates; their
+   * state is then set in place, without recreating their simulation
+   * counterparts. Only objects whose @ref MotionType changed since are
+   * rebuilt.
+   * @param snapshot The snapshot.
+   * @return false, leaving the world unchanged, if the snapshot is invalid or
+   * one of its objects no longer exists, true otherwise.
+   */
+  bool restoreState(const std::vector<char>& snapshot);
+
   /** @brief Get the current 3D position of an object.
    * @param  physObjectID The object ID and key identifying the object in @ref
    * PhysicsManager::existingObjects_.
@@ -939,6 +1105,60 @@ class PhysicsManager {
     return results;
   }
 
+  /**
+   * @brief Cast a batch of rays into the collision world.
+   *
+   * The default implementation calls @ref castRay for every ray.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param[out] results Receives the hits of all rays. Previous contents are
+   * discarded.
+   * @param maxDistance The maximum distance along the ray directions to
+   * search. In units of ray length.
+   * @param closestOnly Whether to return only the closest hit of each ray,
+   * which is cheaper than collecting and sorting all of them.
+   */
+  virtual void castRays(const std::vector<esp::geo::Ray>& rays,
+                        BatchRaycastResults& results,
+                        double maxDistance = 100.0,
+                        bool closestOnly = false);
+
+  /**
+   * @brief Test whether an object would collide with the collision world at
+   * each of a batch of candidate poses, without adding it.
+   *
+   * Not implemented for default @ref PhysicsManager, which reports no
+   * collisions. See @ref BulletPhysicsManager.
+   *
+   * @param objectTemplateHandle The handle of the object template to test.
+   * @param poses The candidate poses, as would be set with @ref
+   * setRigidState on an object added without attachment node.
+   * @param[out] results Receives one result per pose. Previous contents are
+   * discarded.
+   * @return Whether the object template could be instantiated.
+   */
+  virtual bool testPlacements(
+      CORRADE_UNUSED const std::string& objectTemplateHandle,
+      const std::vector<core::RigidState>& poses,
+      PlacementTestResults& results) {
+    results.reset(poses.size());
+    return true;
+  }
+
+  /**
+   * @brief Prepare @ref testPlacements for an object template, e.g. by
+   * instantiating it. Done by testPlacements itself otherwise; doing it
+   * beforehand lets the tests run without modifying this physics manager.
+   *
+   * @param objectTemplateHandle The handle of the object template to test.
+   * @return Whether the object template could be instantiated.
+   */
+  virtual bool ensurePlacementProbe(
+      CORRADE_UNUSED const std::string& objectTemplateHandle) {
+    return true;
+  }
+
   virtual int getNumActiveContactPoints() { return -1; }
 
  protected:
@@ -975,6 +1195,18 @@ class PhysicsManager {
    */
   int deallocateObjectID(int physObjectID);
 
+  /** @brief Gather the objects with active velocity control into @ref
+   * kinematicIntegrator_ to integrate them all at once.
+   * @param onlyKinematic Whether to skip objects not of @ref
+   * MotionType::KINEMATIC, e.g. because the simulator applies the velocity
+   * control of dynamic objects itself.
+   */
+  void gatherKinematicIntegration(bool onlyKinematic);
+
+  /** @brief Write the states integrated by @ref kinematicIntegrator_ back to
+   * the objects gathered by @ref gatherKinematicIntegration. */
+  void scatterKinematicIntegration();
+
   /**
    * @brief Finalize physics initialization. Setup staticStageObject_ and
    * initialize any other physics-related values for physics-based scenes.
@@ -1042,9 +1274,10 @@ class PhysicsManager {
   //! ==== Rigid object memory management ====
 
   /** @brief Maps object IDs to all existing physical object instances in the
-   * world.
+   * world. Flat storage indexed by ID, as every per-object call looks up its
+   * object here.
    */
-  std::map<int, physics::RigidObject::uptr> existingObjects_;
+  core::SlotMap<physics::RigidObject::uptr> existingObjects_;
 
   /** @brief A counter of unique object ID's allocated thus far. Used to
    * allocate new IDs when  @ref recycledObjectIDs_ is empty without needing to
@@ -1072,6 +1305,20 @@ class PhysicsManager {
    * simulated with @ref stepPhysics up to this point. */
   double worldTime_ = 0.0;
 
+  /** @brief The objects moved by the last @ref stepPhysics. See @ref
+   * getUpdatedObjectIDs. */
+  std::vector<int> updatedObjectIDs_;
+
+  /** @brief Integrates the velocity control of the objects gathered by @ref
+   * gatherKinematicIntegration, reused across steps. */
+  KinematicIntegrator kinematicIntegrator_;
+
+  /** @brief The objects added to @ref kinematicIntegrator_, in order. */
+  std::vector<RigidObject*> kinematicIntegrationObjects_;
+
+  /** @brief The IDs of the objects in @ref kinematicIntegrationObjects_. */
+  std::vector<int> kinematicIntegrationIDs_;
+
   ESP_SMART_POINTERS(PhysicsManager)
 };
 
@@ -164,6 +164,13 @@ class RigidBase : public Magnum::SceneGraph::AbstractFeature3D {
    */
   virtual void setActive() {}
 
+  /**
+   * @brief Put an object to sleep or wake it up, e.g. when restoring a saved
+   * state. Does nothing without a physics engine, where no object is active.
+   * @param sleeping Whether the object should be sleeping.
+   */
+  virtual void setSleeping(CORRADE_UNUSED bool sleeping) {}
+
   /**
    * @brief Get the @ref MotionType of the object. See @ref setMotionType.
    * @return The object's current @ref MotionType.
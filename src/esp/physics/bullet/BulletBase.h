@@ -63,10 +63,8 @@ struct SimulationContactResultCallback
 
 class BulletBase {
  public:
-  BulletBase(std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-             std::shared_ptr<std::map<const btCollisionObject*, int>>
-                 collisionObjToObjIds)
-      : bWorld_(bWorld), collisionObjToObjIds_(collisionObjToObjIds) {}
+  explicit BulletBase(std::shared_ptr<btMultiBodyDynamicsWorld> bWorld)
+      : bWorld_(std::move(bWorld)) {}
 
   /**
    * @brief Destructor cleans up simulation structures for the object.
@@ -102,11 +100,6 @@ class BulletBase {
    */
   std::vector<std::unique_ptr<btRigidBody>> bStaticCollisionObjects_;
 
-  //! keep a map of collision objects to object ids for quick lookups from
-  //! Bullet collision checking.
-  std::shared_ptr<std::map<const btCollisionObject*, int>>
-      collisionObjToObjIds_;
-
  public:
   ESP_SMART_POINTERS(BulletBase)
 };  // class BulletBase
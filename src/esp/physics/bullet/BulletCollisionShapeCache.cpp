@@ -0,0 +1,119 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "BulletCollisionShapeCache.h"
+
+#include <sstream>
+#include <utility>
+
+#include <Magnum/BulletIntegration/Integration.h>
+
+#include "BulletCollision/CollisionShapes/btConvexHullShape.h"
+#include "BulletCollision/CollisionShapes/btShapeHull.h"
+
+namespace esp {
+namespace physics {
+
+namespace {
+
+//! Approximate a hull by its support points, if that makes it smaller
+std::unique_ptr<btConvexHullShape> simplifyHull(
+    const btConvexHullShape& hull) {
+  btShapeHull shapeHull{&hull};
+  if (!shapeHull.buildHull(0.0) ||
+      shapeHull.numVertices() >= hull.getNumPoints()) {
+    return nullptr;
+  }
+  return std::make_unique<btConvexHullShape>(
+      &shapeHull.getVertexPointer()->getX(), shapeHull.numVertices());
+}
+
+}  // namespace
+
+std::shared_ptr<const BulletCollisionShapeCache::Hulls>
+BulletCollisionShapeCache::getHulls(
+    const metadata::attributes::ObjectAttributes& attributes,
+    const assets::ResourceManager& resMgr,
+    const Magnum::Vector3& scale) {
+  const std::string collisionAssetHandle =
+      attributes.getCollisionAssetHandle();
+  const bool join = attributes.getJoinCollisionMeshes();
+  const Magnum::Vector3 collisionAssetSize = attributes.getCollisionAssetSize();
+
+  std::ostringstream key;
+  key << collisionAssetHandle << "|" << join << "|" << simplifyHulls_;
+  for (const float value : {collisionAssetSize.x(), collisionAssetSize.y(),
+                            collisionAssetSize.z(), scale.x(), scale.y(),
+                            scale.z()}) {
+    key << "|" << value;
+  }
+  auto found = entries_.find(key.str());
+  if (found != entries_.end()) {
+    return found->second;
+  }
+
+  const std::vector<assets::CollisionMeshData>& meshGroup =
+      resMgr.getCollisionMesh(collisionAssetHandle);
+  const assets::MeshMetaData& metaData =
+      resMgr.getMeshMetaData(collisionAssetHandle);
+  auto hulls = std::make_shared<Hulls>();
+  constructHullsFromMeshes(Magnum::Matrix4{}, meshGroup, metaData.root, join,
+                           *hulls);
+
+  for (std::unique_ptr<btConvexHullShape>& hull : *hulls) {
+    // Remove local convex margin in favor of margin on the containing
+    // compound
+    hull->setMargin(0.0);
+    if (simplifyHulls_) {
+      // before scaling and with zero margin, which btShapeHull would both
+      // bake in
+      if (std::unique_ptr<btConvexHullShape> simplified = simplifyHull(*hull)) {
+        hull = std::move(simplified);
+        hull->setMargin(0.0);
+      }
+    }
+    // collision asset size only applies to joined meshes
+    hull->setLocalScaling(
+        btVector3{join ? collisionAssetSize * scale : scale});
+    hull->recalcLocalAabb();
+  }
+
+  entries_.emplace(key.str(), hulls);
+  return hulls;
+}  // BulletCollisionShapeCache::getHulls
+
+// recursively create the convex mesh shapes in a flat manner by accumulating
+// transformations down the tree
+void BulletCollisionShapeCache::constructHullsFromMeshes(
+    const Magnum::Matrix4& transformFromParentToWorld,
+    const std::vector<assets::CollisionMeshData>& meshGroup,
+    const assets::MeshTransformNode& node,
+    bool join,
+    Hulls& hulls) {
+  Magnum::Matrix4 transformFromLocalToWorld =
+      transformFromParentToWorld * node.transformFromLocalToParent;
+  if (node.meshIDLocal != ID_UNDEFINED) {
+    const assets::CollisionMeshData& mesh = meshGroup[node.meshIDLocal];
+
+    // when joining, add all points to a single convex instead of compounding
+    // (more stable)
+    if (!join || hulls.empty()) {
+      hulls.emplace_back(std::make_unique<btConvexHullShape>());
+    }
+    // transform points into world space, including any scale/shear in
+    // transformFromLocalToWorld.
+    for (auto& v : mesh.positions) {
+      hulls.back()->addPoint(
+          btVector3(transformFromLocalToWorld.transformPoint(v)), false);
+    }
+  }
+
+  for (auto& child : node.children) {
+    constructHullsFromMeshes(transformFromLocalToWorld, meshGroup, child, join,
+                             hulls);
+  }
+}  // constructHullsFromMeshes
+
+}  // namespace physics
+}  // namespace esp
@@ -0,0 +1,110 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_BULLETCOLLISIONSHAPECACHE_H_
+#define ESP_PHYSICS_BULLET_BULLETCOLLISIONSHAPECACHE_H_
+
+/** @file
+ * @brief Class @ref esp::physics::BulletCollisionShapeCache
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <btBulletDynamicsCommon.h>
+
+#include "esp/assets/ResourceManager.h"
+#include "esp/core/esp.h"
+#include "esp/metadata/attributes/ObjectAttributes.h"
+
+namespace esp {
+namespace physics {
+
+/**
+ * @brief Convex hulls of object collision meshes, shared by all objects with
+ * the same collision setup.
+ *
+ * Building the hulls copies every collision mesh vertex, so building them
+ * once per object template rather than once per object instance saves both
+ * time and memory when adding many copies of an object. Entries are keyed by
+ * everything the hulls depend on (collision asset, joining of sub-meshes,
+ * collision asset size and baked-in scale), so a template re-registered with
+ * a different collision setup doesn't get stale hulls.
+ *
+ * Bullet only reads the hulls while simulating. Objects must not modify
+ * them; see @ref BulletRigidObject::setMargin.
+ */
+class BulletCollisionShapeCache {
+ public:
+  //! Convex hulls making up the collision shape of an object, all in the
+  //! object's local space
+  typedef std::vector<std::unique_ptr<btConvexHullShape>> Hulls;
+
+  /**
+   * @brief Get the convex hulls for an object template, constructing them on
+   * first use.
+   * @param attributes The object template. Must use mesh collision.
+   * @param resMgr Resource manager holding the collision mesh.
+   * @param scale Scale baked into the hulls. Pass (1, 1, 1) to get hulls to
+   * scale at instance level, e.g. with btUniformScalingShape.
+   * @return The hulls. Objects keep them alive, also past @ref clear.
+   */
+  std::shared_ptr<const Hulls> getHulls(
+      const metadata::attributes::ObjectAttributes& attributes,
+      const assets::ResourceManager& resMgr,
+      const Magnum::Vector3& scale);
+
+  /**
+   * @brief Whether hulls get simplified.
+   *
+   * Simplified hulls are approximated by their support points in a fixed set
+   * of directions (see @ref btShapeHull), which caps their vertex count and
+   * speeds up collision detection for detailed collision meshes. They are
+   * cached separately from the exact hulls. Only affects objects added
+   * afterwards.
+   */
+  bool getSimplifyHulls() const { return simplifyHulls_; }
+
+  /** @brief Set whether hulls get simplified, see @ref getSimplifyHulls */
+  void setSimplifyHulls(bool simplifyHulls) { simplifyHulls_ = simplifyHulls; }
+
+  /** @brief Number of cached hull sets */
+  std::size_t getNumEntries() const { return entries_.size(); }
+
+  /** @brief Drop all cached hulls not referenced by an object anymore */
+  void clear() { entries_.clear(); }
+
+  ESP_SMART_POINTERS(BulletCollisionShapeCache)
+
+ private:
+  /**
+   * @brief Recursively construct a @ref btConvexHullShape for each
+   * sub-component, transformed to object-local space, or a single one for all
+   * of them if joining.
+   * @param transformFromParentToWorld The cumulative parent-to-world
+   * transformation matrix constructed by composition down the @ref
+   * MeshTransformNode tree to the current node.
+   * @param meshGroup Access structure for collision mesh data.
+   * @param node The current @ref MeshTransformNode in the recursion.
+   * @param join Whether or not to join sub-meshes into a single convex
+   * shape, rather than creating individual convexes.
+   * @param[out] hulls Receives the hulls.
+   */
+  static void constructHullsFromMeshes(
+      const Magnum::Matrix4& transformFromParentToWorld,
+      const std::vector<assets::CollisionMeshData>& meshGroup,
+      const assets::MeshTransformNode& node,
+      bool join,
+      Hulls& hulls);
+
+  std::map<std::string, std::shared_ptr<const Hulls>> entries_;
+  bool simplifyHulls_ = false;
+};
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_BULLETCOLLISIONSHAPECACHE_H_
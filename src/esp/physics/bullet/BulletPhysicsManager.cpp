@@ -6,16 +6,158 @@
 //#include "BulletCollision/Gimpact/btGImpactShape.h"
 
 #include "BulletPhysicsManager.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+#include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
+#include "BulletCollision/CollisionDispatch/btManifoldResult.h"
+
 #include "BulletRigidObject.h"
+#include "WorkerPool.h"
 #include "esp/assets/ResourceManager.h"
 
 namespace esp {
 namespace physics {
 
+namespace {
+
+//! Fewer rays per thread aren't worth the thread startup
+constexpr std::size_t MinRaysPerThread = 64;
+
+/**
+ * @brief Tests a ray against every collision object whose broadphase AABB it
+ * crosses, the same way btCollisionWorld::rayTest does. The btDbvt traversal
+ * uses a local stack, while btDbvtBroadphase::rayTest shares one stack among
+ * all callers and can't be used from several threads at once.
+ */
+struct RayTestCollider : btDbvt::ICollide {
+  RayTestCollider(const btVector3& from,
+                  const btVector3& to,
+                  btCollisionWorld::RayResultCallback& callback)
+      : callback(callback) {
+    fromTransform.setIdentity();
+    fromTransform.setOrigin(from);
+    toTransform.setIdentity();
+    toTransform.setOrigin(to);
+  }
+
+  void Process(const btDbvtNode* leaf) override {
+    // an earlier object was hit right at the ray origin
+    if (callback.m_closestHitFraction == btScalar(0)) {
+      return;
+    }
+    auto* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+    auto* collisionObject =
+        static_cast<btCollisionObject*>(proxy->m_clientObject);
+    if (callback.needsCollision(collisionObject->getBroadphaseHandle())) {
+      btCollisionWorld::rayTestSingle(fromTransform, toTransform,
+                                      collisionObject,
+                                      collisionObject->getCollisionShape(),
+                                      collisionObject->getWorldTransform(),
+                                      callback);
+    }
+  }
+
+  btTransform fromTransform;
+  btTransform toTransform;
+  btCollisionWorld::RayResultCallback& callback;
+};
+
+//! Fewer candidate poses per thread aren't worth the thread startup
+constexpr std::size_t MinPosesPerThread = 16;
+
+/**
+ * @brief Collects the contact points of a placement test. Any contact point
+ * counts as a collision, same as for SimulationContactResultCallback.
+ */
+struct PlacementContactResult : btManifoldResult {
+  PlacementContactResult(const btCollisionObjectWrapper* probeWrap,
+                         const btCollisionObjectWrapper* otherWrap)
+      : btManifoldResult(probeWrap, otherWrap) {}
+
+  void addContactPoint(CORRADE_UNUSED const btVector3& normalOnBInWorld,
+                       CORRADE_UNUSED const btVector3& pointInWorld,
+                       btScalar depth) override {
+    collision = true;
+    // negative distances are penetrations
+    penetrationDepth = std::max(penetrationDepth, double(-depth));
+  }
+
+  bool collision = false;
+  double penetrationDepth = 0.0;
+};
+
+/**
+ * @brief Tests a placement candidate against every collision object whose
+ * broadphase AABB overlaps its AABB, the same way btCollisionWorld::
+ * contactTest does. The btDbvt traversal uses a local stack and the
+ * collision algorithms come from a dispatcher owned by the caller, so
+ * several threads can test candidates at once.
+ */
+struct PlacementTestCollider : btDbvt::ICollide {
+  PlacementTestCollider(const btCollisionObject& probe,
+                        const btTransform& transform,
+                        btCollisionDispatcher& dispatcher,
+                        const btDispatcherInfo& dispatchInfo)
+      : probeWrap(nullptr,
+                  probe.getCollisionShape(),
+                  &probe,
+                  transform,
+                  -1,
+                  -1),
+        dispatcher(dispatcher),
+        dispatchInfo(dispatchInfo) {}
+
+  void Process(const btDbvtNode* leaf) override {
+    auto* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+    // same filtering as for a default contact test callback
+    if (!(proxy->m_collisionFilterMask & btBroadphaseProxy::DefaultFilter)) {
+      return;
+    }
+    auto* other = static_cast<btCollisionObject*>(proxy->m_clientObject);
+    btCollisionObjectWrapper otherWrap(nullptr, other->getCollisionShape(),
+                                       other, other->getWorldTransform(), -1,
+                                       -1);
+    btCollisionAlgorithm* algorithm = dispatcher.findAlgorithm(
+        &probeWrap, &otherWrap, nullptr, BT_CLOSEST_POINT_ALGORITHMS);
+    if (!algorithm) {
+      return;
+    }
+    PlacementContactResult contactResult(&probeWrap, &otherWrap);
+    algorithm->processCollision(&probeWrap, &otherWrap, dispatchInfo,
+                                &contactResult);
+    algorithm->~btCollisionAlgorithm();
+    dispatcher.freeCollisionAlgorithm(algorithm);
+
+    collision = collision || contactResult.collision;
+    penetrationDepth =
+        std::max(penetrationDepth, contactResult.penetrationDepth);
+  }
+
+  btCollisionObjectWrapper probeWrap;
+  btCollisionDispatcher& dispatcher;
+  const btDispatcherInfo& dispatchInfo;
+  bool collision = false;
+  double penetrationDepth = 0.0;
+};
+
+}  // namespace
+
 BulletPhysicsManager::~BulletPhysicsManager() {
   LOG(INFO) << "Deconstructing BulletPhysicsManager";
 
   existingObjects_.clear();
+  // the probes' visual nodes are gone already, but their object nodes are
+  // still attached under the physics node. Same as in removeObject, the probe
+  // goes first as it's a feature of its node.
+  for (auto& probe : placementProbes_) {
+    scene::SceneNode* objectNode = &probe.second->node();
+    probe.second.reset();
+    delete objectNode;
+  }
+  placementProbes_.clear();
   staticStageObject_.reset(nullptr);
 }
 
@@ -38,9 +180,10 @@ bool BulletPhysicsManager::initPhysicsFinalize() {
 
   Corrade::Utility::Debug() << "creating staticStageObject_";
   //! Create new scene node
-  staticStageObject_ = physics::BulletRigidStage::create_unique(
-      &physicsNode_->createChild(), resourceManager_, bWorld_,
-      collisionObjToObjIds_);
+  auto stage = physics::BulletRigidStage::create_unique(
+      &physicsNode_->createChild(), resourceManager_, bWorld_);
+  stage->setUseBvhCache(physicsManagerAttributes_->getUseStageBvhCache());
+  staticStageObject_ = std::move(stage);
   Corrade::Utility::Debug() << "creating staticStageObject_ .. done";
 
   return true;
@@ -60,7 +203,7 @@ bool BulletPhysicsManager::makeAndAddRigidObject(int newObjectID,
                                                  scene::SceneNode* objectNode) {
   auto ptr = physics::BulletRigidObject::create_unique(
       objectNode, newObjectID, resourceManager_, bWorld_,
-      collisionObjToObjIds_);
+      collisionShapeCache_);
   bool objSuccess = ptr->initialize(handle);
   if (objSuccess) {
     existingObjects_.emplace(newObjectID, std::move(ptr));
@@ -105,10 +248,8 @@ bool BulletPhysicsManager::isMeshPrimitiveValid(
 void BulletPhysicsManager::setGravity(const Magnum::Vector3& gravity) {
   bWorld_->setGravity(btVector3(gravity));
   // After gravity change, need to reactive all bullet objects
-  for (std::map<int, physics::RigidObject::uptr>::iterator it =
-           existingObjects_.begin();
-       it != existingObjects_.end(); ++it) {
-    it->second->setActive();
+  for (auto& object : existingObjects_) {
+    object.second->setActive();
   }
 }
 
@@ -125,34 +266,36 @@ void BulletPhysicsManager::stepPhysics(double dt) {
     dt = fixedTimeStep_;
   }
 
+  // kinematic velocity control intergration, all objects at once
+  gatherKinematicIntegration(true);
+  kinematicIntegrator_.integrate(dt);
+  scatterKinematicIntegration();
+  for (RigidObject* object : kinematicIntegrationObjects_) {
+    object->setActive();
+  }
+
   // set specified control velocities
   for (auto& objectItr : existingObjects_) {
-    VelocityControl::ptr velControl = objectItr.second->getVelocityControl();
-    if (objectItr.second->getMotionType() == MotionType::KINEMATIC) {
-      // kinematic velocity control intergration
-      if (velControl->controllingAngVel || velControl->controllingLinVel) {
-        objectItr.second->setRigidState(velControl->integrateTransform(
-            dt, objectItr.second->getRigidState()));
-        objectItr.second->setActive();
-      }
-    } else if (objectItr.second->getMotionType() == MotionType::DYNAMIC) {
+    RigidObject& object = *objectItr.second;
+    const VelocityControl::ptr& velControl = object.getVelocityControl();
+    const MotionType motionType = object.getMotionType();
+    if (motionType == MotionType::DYNAMIC) {
+      // set directly on the object, the ID lookups of setLinearVelocity() and
+      // setAngularVelocity() are redundant here
       if (velControl->controllingLinVel) {
         if (velControl->linVelIsLocal) {
-          setLinearVelocity(objectItr.first,
-                            objectItr.second->node().rotation().transformVector(
-                                velControl->linVel));
+          object.setLinearVelocity(
+              object.node().rotation().transformVector(velControl->linVel));
         } else {
-          setLinearVelocity(objectItr.first, velControl->linVel);
+          object.setLinearVelocity(velControl->linVel);
         }
       }
       if (velControl->controllingAngVel) {
         if (velControl->angVelIsLocal) {
-          setAngularVelocity(
-              objectItr.first,
-              objectItr.second->node().rotation().transformVector(
-                  velControl->angVel));
+          object.setAngularVelocity(
+              object.node().rotation().transformVector(velControl->angVel));
         } else {
-          setAngularVelocity(objectItr.first, velControl->angVel);
+          object.setAngularVelocity(velControl->angVel);
         }
       }
     }
@@ -163,6 +306,17 @@ void BulletPhysicsManager::stepPhysics(double dt) {
   int numSubStepsTaken =
       bWorld_->stepSimulation(dt, /*maxSubSteps*/ 10000, fixedTimeStep_);
   worldTime_ += numSubStepsTaken * fixedTimeStep_;
+
+  // Bullet only synchronizes the motion states of active bodies, so sleeping
+  // objects didn't touch their SceneNode. Kinematic objects were moved by the
+  // velocity control above.
+  updatedObjectIDs_ = kinematicIntegrationIDs_;
+  for (auto& objectItr : existingObjects_) {
+    RigidObject& object = *objectItr.second;
+    if (object.getMotionType() == MotionType::DYNAMIC && object.isActive()) {
+      updatedObjectIDs_.push_back(objectItr.first);
+    }
+  }
 }
 
 void BulletPhysicsManager::setMargin(const int physObjectID,
@@ -210,6 +364,19 @@ const Magnum::Range3D BulletPhysicsManager::getStageCollisionShapeAabb() const {
       ->getCollisionShapeAabb();
 }
 
+bool BulletPhysicsManager::getStageLoadedBvhCache() const {
+  return static_cast<BulletRigidStage*>(staticStageObject_.get())
+      ->getLoadedBvhCache();
+}
+
+void BulletPhysicsManager::shareStageCollisionShapes(
+    const BulletPhysicsManager& other) {
+  static_cast<BulletRigidStage*>(staticStageObject_.get())
+      ->setSharedCollisionShapes(
+          static_cast<const BulletRigidStage*>(other.staticStageObject_.get())
+              ->getCollisionShapes());
+}
+
 void BulletPhysicsManager::debugDraw(const Magnum::Matrix4& projTrans) const {
   debugDrawer_.setTransformationProjectionMatrix(projTrans);
   bWorld_->debugDrawWorld();
@@ -246,19 +413,259 @@ RaycastResults BulletPhysicsManager::castRay(const esp::geo::Ray& ray,
     hit.normal = Magnum::Vector3{allResults.m_hitNormalWorld[i]};
     hit.point = Magnum::Vector3{allResults.m_hitPointWorld[i]};
     hit.rayDistance = (allResults.m_hitFractions[i] * maxDistance) / rayLength;
-    // default to -1 for "scene collision" if we don't know which object was
-    // involved
-    hit.objectId = -1;
-    if (collisionObjToObjIds_->count(allResults.m_collisionObjects[i]) > 0) {
-      hit.objectId =
-          collisionObjToObjIds_->at(allResults.m_collisionObjects[i]);
-    }
+    // the user index of collision objects is the object id, or -1 for
+    // "scene collision"
+    hit.objectId = allResults.m_collisionObjects[i]->getUserIndex();
     results.hits.push_back(hit);
   }
   results.sortByDistance();
   return results;
 }
 
+void BulletPhysicsManager::castRays(const std::vector<esp::geo::Ray>& rays,
+                                    BatchRaycastResults& results,
+                                    double maxDistance,
+                                    bool closestOnly) {
+  std::size_t threadCount = raycastThreadCount_ > 0
+                                ? std::size_t(raycastThreadCount_)
+                                : std::thread::hardware_concurrency();
+  threadCount = std::max<std::size_t>(
+      std::min(threadCount, rays.size() / MinRaysPerThread), 1);
+
+  if (threadCount == 1) {
+    results.reset(rays.size(), closestOnly ? rays.size() : 0);
+    castRayRange(rays, 0, rays.size(), maxDistance, closestOnly, results);
+    return;
+  }
+
+  // every thread casts a contiguous range of rays into its own buffers, kept
+  // between calls, which then get concatenated in order
+  std::vector<BatchRaycastResults>& threadResults = raycastThreadResults_;
+  if (threadResults.size() < threadCount) {
+    threadResults.resize(threadCount);
+  }
+  const std::size_t raysPerThread =
+      (rays.size() + threadCount - 1) / threadCount;
+  getWorkerPool(threadCount).run(threadCount, [&](int i) {
+    const std::size_t begin = std::min(i * raysPerThread, rays.size());
+    const std::size_t end = std::min(begin + raysPerThread, rays.size());
+    BatchRaycastResults& range = threadResults[i];
+    range.reset(end - begin, closestOnly ? end - begin : 0);
+    castRayRange(rays, begin, end, maxDistance, closestOnly, range);
+  });
+
+  const std::size_t numHits = std::accumulate(
+      threadResults.begin(), threadResults.end(), std::size_t{0},
+      [](std::size_t sum, const BatchRaycastResults& range) {
+        return sum + range.getNumHits();
+      });
+  results.reset(rays.size(), numHits);
+  for (const BatchRaycastResults& range : threadResults) {
+    const int hitOffset = results.getNumHits();
+    for (std::size_t i = 1; i < range.rayHitOffsets.size(); ++i) {
+      results.rayHitOffsets.push_back(hitOffset + range.rayHitOffsets[i]);
+    }
+    results.objectIds.insert(results.objectIds.end(), range.objectIds.begin(),
+                             range.objectIds.end());
+    results.points.insert(results.points.end(), range.points.begin(),
+                          range.points.end());
+    results.normals.insert(results.normals.end(), range.normals.begin(),
+                           range.normals.end());
+    results.rayDistances.insert(results.rayDistances.end(),
+                                range.rayDistances.begin(),
+                                range.rayDistances.end());
+  }
+}  // BulletPhysicsManager::castRays
+
+void BulletPhysicsManager::castRayRange(const std::vector<esp::geo::Ray>& rays,
+                                        std::size_t begin,
+                                        std::size_t end,
+                                        double maxDistance,
+                                        bool closestOnly,
+                                        BatchRaycastResults& results) const {
+  const btDbvt* trees = bBroadphase_.m_sets;
+  auto addHit = [&](const btCollisionObject* collisionObject,
+                    const btVector3& point, const btVector3& normal,
+                    double rayDistance) {
+    // the user index of collision objects is the object id, or -1 for
+    // "scene collision"
+    results.objectIds.push_back(collisionObject->getUserIndex());
+    results.points.emplace_back(point);
+    results.normals.emplace_back(normal);
+    results.rayDistances.push_back(rayDistance);
+  };
+
+  std::vector<int> hitOrder;
+  for (std::size_t rayIndex = begin; rayIndex != end; ++rayIndex) {
+    const esp::geo::Ray& ray = rays[rayIndex];
+    const double rayLength = ray.direction.length();
+    // zero-length rays have no hits
+    if (rayLength == 0) {
+      results.rayHitOffsets.push_back(results.getNumHits());
+      continue;
+    }
+    const btVector3 from(ray.origin);
+    const btVector3 to(ray.origin + ray.direction * maxDistance);
+
+    if (closestOnly) {
+      // the closest hit fraction found so far prunes the following shape
+      // tests, and there is nothing to sort
+      btCollisionWorld::ClosestRayResultCallback closest(from, to);
+      RayTestCollider collider(from, to, closest);
+      // the static and the dynamic tree
+      for (int tree = 0; tree != 2; ++tree) {
+        btDbvt::rayTest(trees[tree].m_root, from, to, collider);
+      }
+      if (closest.hasHit()) {
+        addHit(closest.m_collisionObject, closest.m_hitPointWorld,
+               closest.m_hitNormalWorld,
+               (closest.m_closestHitFraction * maxDistance) / rayLength);
+      }
+    } else {
+      btCollisionWorld::AllHitsRayResultCallback allResults(from, to);
+      RayTestCollider collider(from, to, allResults);
+      for (int tree = 0; tree != 2; ++tree) {
+        btDbvt::rayTest(trees[tree].m_root, from, to, collider);
+      }
+      hitOrder.resize(allResults.m_hitFractions.size());
+      std::iota(hitOrder.begin(), hitOrder.end(), 0);
+      std::sort(hitOrder.begin(), hitOrder.end(), [&](int a, int b) {
+        return allResults.m_hitFractions[a] < allResults.m_hitFractions[b];
+      });
+      for (int i : hitOrder) {
+        addHit(allResults.m_collisionObjects[i],
+               allResults.m_hitPointWorld[i], allResults.m_hitNormalWorld[i],
+               (allResults.m_hitFractions[i] * maxDistance) / rayLength);
+      }
+    }
+    results.rayHitOffsets.push_back(results.getNumHits());
+  }
+}  // BulletPhysicsManager::castRayRange
+
+bool BulletPhysicsManager::testPlacements(
+    const std::string& objectTemplateHandle,
+    const std::vector<core::RigidState>& poses,
+    PlacementTestResults& results) {
+  results.reset(poses.size());
+  BulletRigidObject* probe = getPlacementProbe(objectTemplateHandle);
+  if (!probe) {
+    LOG(ERROR) << "BulletPhysicsManager::testPlacements : Unable to "
+                  "instantiate object template "
+               << objectTemplateHandle;
+    return false;
+  }
+  if (!probe->getCollidable()) {
+    // never collides
+    return true;
+  }
+  const btCollisionObject& probeObject = probe->getCollisionObject();
+  // objects may have moved since the broadphase was last updated
+  bWorld_->updateAabbs();
+
+  std::size_t threadCount = placementTestThreadCount_ > 0
+                                ? std::size_t(placementTestThreadCount_)
+                                : std::thread::hardware_concurrency();
+  threadCount = std::max<std::size_t>(
+      std::min(threadCount, poses.size() / MinPosesPerThread), 1);
+
+  if (threadCount == 1) {
+    testPlacementRange(probeObject, poses, 0, poses.size(), bDispatcher_,
+                       results);
+    return true;
+  }
+
+  // every thread tests a contiguous range of poses with its own dispatcher,
+  // as the collision algorithms allocate from the dispatcher's pools
+  while (placementTestDispatchers_.size() < threadCount) {
+    placementTestDispatchers_.push_back(
+        std::make_unique<PlacementTestDispatcher>());
+  }
+  const std::size_t posesPerThread =
+      (poses.size() + threadCount - 1) / threadCount;
+  getWorkerPool(threadCount).run(threadCount, [&](int i) {
+    const std::size_t begin = std::min(i * posesPerThread, poses.size());
+    const std::size_t end = std::min(begin + posesPerThread, poses.size());
+    testPlacementRange(probeObject, poses, begin, end,
+                       placementTestDispatchers_[i]->dispatcher, results);
+  });
+  return true;
+}  // BulletPhysicsManager::testPlacements
+
+WorkerPool& BulletPhysicsManager::getWorkerPool(std::size_t threadCount) {
+  // the calling thread works too
+  if (!workerPool_ || workerPool_->getNumWorkers() + 1 < threadCount) {
+    workerPool_.reset();
+    workerPool_ = std::make_unique<WorkerPool>(threadCount - 1);
+  }
+  return *workerPool_;
+}  // BulletPhysicsManager::getWorkerPool
+
+BulletRigidObject* BulletPhysicsManager::getPlacementProbe(
+    const std::string& objectTemplateHandle) {
+  auto found = placementProbes_.find(objectTemplateHandle);
+  if (found != placementProbes_.end()) {
+    return static_cast<BulletRigidObject*>(found->second.get());
+  }
+
+  // Add an object the usual way, so its collision shape and origin shift
+  // match the ones of objects added later. The visuals are needed for
+  // computing the bounding box, but not after, so they get removed right
+  // away; a replay recorder sees their creation and deletion cancel out.
+  if (!resourceManager_.getObjectAttributesManager()->getObjectLibHasHandle(
+          objectTemplateHandle)) {
+    return nullptr;
+  }
+  gfx::DrawableGroup probeDrawables;
+  const int probeID = addObject(objectTemplateHandle, &probeDrawables);
+  if (probeID == ID_UNDEFINED) {
+    return nullptr;
+  }
+  RigidObject::uptr probe = std::move(existingObjects_.at(probeID));
+  existingObjects_.erase(probeID);
+  deallocateObjectID(probeID);
+  delete probe->visualNode_;
+  probe->visualNode_ = nullptr;
+  probe->visualNodes_.clear();
+
+  auto* bulletProbe = static_cast<BulletRigidObject*>(probe.get());
+  bulletProbe->removeFromWorld();
+  placementProbes_.emplace(objectTemplateHandle, std::move(probe));
+  return bulletProbe;
+}  // BulletPhysicsManager::getPlacementProbe
+
+void BulletPhysicsManager::testPlacementRange(
+    const btCollisionObject& probe,
+    const std::vector<core::RigidState>& poses,
+    std::size_t begin,
+    std::size_t end,
+    btCollisionDispatcher& dispatcher,
+    PlacementTestResults& results) const {
+  const btDbvt* trees = bBroadphase_.m_sets;
+  const btCollisionShape* shape = probe.getCollisionShape();
+  // objects added without attachment node are children of the stage node
+  const Magnum::Matrix4 parentTransform =
+      staticStageObject_->node().absoluteTransformationMatrix();
+
+  for (std::size_t poseIndex = begin; poseIndex != end; ++poseIndex) {
+    const core::RigidState& pose = poses[poseIndex];
+    const btTransform transform{
+        parentTransform * Magnum::Matrix4::from(pose.rotation.toMatrix(),
+                                                pose.translation)};
+    btVector3 aabbMin, aabbMax;
+    shape->getAabb(transform, aabbMin, aabbMax);
+    const btDbvtVolume bounds = btDbvtVolume::FromMM(aabbMin, aabbMax);
+
+    PlacementTestCollider collider(probe, transform, dispatcher,
+                                   bWorld_->getDispatchInfo());
+    // the static and the dynamic tree
+    for (int tree = 0; tree != 2; ++tree) {
+      trees[tree].collideTV(trees[tree].m_root, bounds, collider);
+    }
+    results.collisions[poseIndex] = collider.collision;
+    results.penetrationDepths[poseIndex] = collider.penetrationDepth;
+  }
+}  // BulletPhysicsManager::testPlacementRange
+
 int BulletPhysicsManager::getNumActiveContactPoints() {
   int pointCount = 0;
   auto* dispatcher = bWorld_->getDispatcher();
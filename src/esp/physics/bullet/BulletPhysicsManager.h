@@ -26,6 +26,8 @@
 namespace esp {
 namespace physics {
 
+class WorkerPool;
+
 /**
 @brief Dynamic stage and object manager interfacing with Bullet physics
 engine: https://github.com/bulletphysics/bullet3.
@@ -53,10 +55,7 @@ class BulletPhysicsManager : public PhysicsManager {
       assets::ResourceManager& _resourceManager,
       const metadata::attributes::PhysicsManagerAttributes::cptr
           _physicsManagerAttributes)
-      : PhysicsManager(_resourceManager, _physicsManagerAttributes) {
-    collisionObjToObjIds_ =
-        std::make_shared<std::map<const btCollisionObject*, int>>();
-  };
+      : PhysicsManager(_resourceManager, _physicsManagerAttributes){};
 
   /** @brief Destructor which destructs necessary Bullet physics structures.*/
   virtual ~BulletPhysicsManager();
@@ -152,6 +151,39 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   const Magnum::Range3D getStageCollisionShapeAabb() const;
 
+  /**
+   * @brief Whether the BVHs of the static stage got loaded from the cache
+   * file. See @ref BulletRigidStage::getLoadedBvhCache.
+   */
+  bool getStageLoadedBvhCache() const;
+
+  /**
+   * @brief Reuse the stage collision shapes of another manager with the same
+   * stage instead of constructing them again. See @ref
+   * BulletRigidStage::setSharedCollisionShapes. Call between @ref initPhysics
+   * and @ref addStage.
+   * @param other Manager whose stage has been added already.
+   */
+  void shareStageCollisionShapes(const BulletPhysicsManager& other);
+
+  /**
+   * @brief Get the cache of object collision shapes, shared by objects of the
+   * same template. See @ref BulletCollisionShapeCache.
+   */
+  std::shared_ptr<BulletCollisionShapeCache> getCollisionShapeCache() const {
+    return collisionShapeCache_;
+  }
+
+  /**
+   * @brief Set the cache of object collision shapes, e.g. to share it with
+   * another manager loading the same objects. Only affects objects added
+   * afterwards.
+   */
+  void setCollisionShapeCache(
+      std::shared_ptr<BulletCollisionShapeCache> collisionShapeCache) {
+    collisionShapeCache_ = std::move(collisionShapeCache);
+  }
+
   /** @brief Render the debugging visualizations provided by @ref
    * Magnum::BulletIntegration::DebugDraw. This draws wireframes for all
    * collision objects.
@@ -184,6 +216,80 @@ class BulletPhysicsManager : public PhysicsManager {
   virtual RaycastResults castRay(const esp::geo::Ray& ray,
                                  double maxDistance = 100.0) override;
 
+  /**
+   * @brief Cast a batch of rays into the collision world, splitting the batch
+   * across threads.
+   *
+   * The collision world is only read, so it must not be modified (e.g. by
+   * stepping the simulation) while this runs. Unlike @ref castRay, the
+   * broadphase is traversed with a per-thread stack, so rays can be tested
+   * concurrently.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param[out] results Receives the hits of all rays. Previous contents are
+   * discarded.
+   * @param maxDistance The maximum distance along the ray directions to
+   * search. In units of ray length.
+   * @param closestOnly Whether to return only the closest hit of each ray,
+   * which is cheaper than collecting and sorting all of them.
+   */
+  void castRays(const std::vector<esp::geo::Ray>& rays,
+                BatchRaycastResults& results,
+                double maxDistance = 100.0,
+                bool closestOnly = false) override;
+
+  /**
+   * @brief Set the number of threads used by @ref castRays. 0 (the default)
+   * for one per CPU core.
+   */
+  void setRaycastThreadCount(int threadCount) {
+    raycastThreadCount_ = threadCount;
+  }
+
+  /**
+   * @brief Test whether an object would collide with the collision world at
+   * each of a batch of candidate poses, splitting the batch across threads.
+   *
+   * Each pose is tested like @ref contactTest would test an object added at
+   * that pose, but without adding one: a single instance of the template is
+   * built on first use and kept out of the world, with its collision shape
+   * shared by all tests of that template. Only the collision objects whose
+   * broadphase AABB overlaps the one of the candidate are tested further.
+   *
+   * The collision world is only read, so it must not be modified (e.g. by
+   * stepping the simulation) while this runs.
+   *
+   * @param objectTemplateHandle The handle of the object template to test.
+   * Changes to the template after the first test of it are not picked up.
+   * @param poses The candidate poses, as would be set with @ref
+   * setRigidState on an object added without attachment node.
+   * @param[out] results Receives one result per pose. Previous contents are
+   * discarded.
+   * @return Whether the object template could be instantiated.
+   */
+  bool testPlacements(const std::string& objectTemplateHandle,
+                      const std::vector<core::RigidState>& poses,
+                      PlacementTestResults& results) override;
+
+  /**
+   * @brief Instantiate the object template tested by @ref testPlacements, if
+   * not done yet. This adds and removes an object, and so must not run
+   * concurrently with anything else using this physics manager.
+   * @return Whether the object template could be instantiated.
+   */
+  bool ensurePlacementProbe(const std::string& objectTemplateHandle) override {
+    return getPlacementProbe(objectTemplateHandle) != nullptr;
+  }
+
+  /**
+   * @brief Set the number of threads used by @ref testPlacements. 0 (the
+   * default) for one per CPU core.
+   */
+  void setPlacementTestThreadCount(int threadCount) {
+    placementTestThreadCount_ = threadCount;
+  }
+
   // The number of contact points that were active during the last step. An
   // object resting on another object will involve several active contact
   // points. Once both objects are asleep, the contact points are inactive. This
@@ -236,10 +342,39 @@ class BulletPhysicsManager : public PhysicsManager {
 
   mutable Magnum::BulletIntegration::DebugDraw debugDrawer_;
 
-  //! keep a map of collision objects to object ids for quick lookups from
-  //! Bullet collision checking.
-  std::shared_ptr<std::map<const btCollisionObject*, int>>
-      collisionObjToObjIds_;
+  //! Number of threads used by castRays(), 0 for one per CPU core
+  int raycastThreadCount_ = 0;
+
+  //! Number of threads used by testPlacements(), 0 for one per CPU core
+  int placementTestThreadCount_ = 0;
+
+  //! Instances of the object templates tested with testPlacements(), kept
+  //! out of the world and of @ref existingObjects_
+  std::map<std::string, RigidObject::uptr> placementProbes_;
+
+  //! Collision dispatcher of a testPlacements() thread, with the collision
+  //! configuration whose pools it allocates from
+  struct PlacementTestDispatcher {
+    btDefaultCollisionConfiguration collisionConfig;
+    btCollisionDispatcher dispatcher{&collisionConfig};
+  };
+
+  //! Dispatchers of the testPlacements() threads, by thread index, kept
+  //! between calls
+  std::vector<std::unique_ptr<PlacementTestDispatcher>>
+      placementTestDispatchers_;
+
+  //! Hits of the castRays() threads, by thread index, kept between calls to
+  //! reuse their allocations
+  std::vector<BatchRaycastResults> raycastThreadResults_;
+
+  //! Threads of castRays() and testPlacements(), see @ref getWorkerPool
+  std::unique_ptr<WorkerPool> workerPool_;
+
+  //! Convex hulls of object collision meshes, shared by objects of the same
+  //! template
+  std::shared_ptr<BulletCollisionShapeCache> collisionShapeCache_ =
+      BulletCollisionShapeCache::create();
 
  private:
   /** @brief Check if a particular mesh can be used as a collision mesh for
@@ -251,6 +386,43 @@ class BulletPhysicsManager : public PhysicsManager {
    */
   bool isMeshPrimitiveValid(const assets::CollisionMeshData& meshData) override;
 
+  /**
+   * @brief Cast a range of rays of a batch, appending their hits to results.
+   * Only reads the collision world, so may run concurrently.
+   */
+  void castRayRange(const std::vector<esp::geo::Ray>& rays,
+                    std::size_t begin,
+                    std::size_t end,
+                    double maxDistance,
+                    bool closestOnly,
+                    BatchRaycastResults& results) const;
+
+  /**
+   * @brief Get the threads used by @ref castRays and @ref testPlacements,
+   * starting them on first use or if fewer than @p threadCount, including
+   * the calling thread.
+   */
+  WorkerPool& getWorkerPool(std::size_t threadCount);
+
+  /**
+   * @brief Get the instance of an object template used by @ref
+   * testPlacements, creating it on first use.
+   * @return The instance, or nullptr if it can't be created.
+   */
+  BulletRigidObject* getPlacementProbe(const std::string& objectTemplateHandle);
+
+  /**
+   * @brief Test a range of poses of a batch, using the given dispatcher to
+   * find the collision algorithms. Only reads the collision world, so may
+   * run concurrently with a dispatcher per thread.
+   */
+  void testPlacementRange(const btCollisionObject& probe,
+                          const std::vector<core::RigidState>& poses,
+                          std::size_t begin,
+                          std::size_t end,
+                          btCollisionDispatcher& dispatcher,
+                          PlacementTestResults& results) const;
+
   ESP_SMART_POINTERS(BulletPhysicsManager)
 
 };  // end class BulletPhysicsManager
@@ -4,6 +4,7 @@
 
 #include <Magnum/BulletIntegration/DebugDraw.h>
 #include <Magnum/BulletIntegration/Integration.h>
+#include <Magnum/Math/Functions.h>
 
 #include <Corrade/Utility/Assert.h>
 
@@ -12,6 +13,7 @@
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
 #include "BulletCollision/CollisionShapes/btConvexHullShape.h"
 #include "BulletCollision/CollisionShapes/btConvexTriangleMeshShape.h"
+#include "BulletCollision/CollisionShapes/btUniformScalingShape.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletRigidObject.h"
@@ -37,11 +39,12 @@ BulletRigidObject::BulletRigidObject(
     int objectId,
     const assets::ResourceManager& resMgr,
     std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-    std::shared_ptr<std::map<const btCollisionObject*, int> >
-        collisionObjToObjIds)
-    : BulletBase(std::move(bWorld), std::move(collisionObjToObjIds)),
+    std::shared_ptr<BulletCollisionShapeCache> shapeCache)
+    : BulletBase(std::move(bWorld)),
       RigidObject(rigidBodyNode, objectId, resMgr),
-      MotionState(*rigidBodyNode) {}
+      MotionState(*rigidBodyNode),
+      shapeCache_(shapeCache ? std::move(shapeCache)
+                             : BulletCollisionShapeCache::create()) {}
 
 BulletRigidObject::~BulletRigidObject() {
   if (!isActive()) {
@@ -53,8 +56,6 @@ BulletRigidObject::~BulletRigidObject() {
   // remove rigid body from the world
   bWorld_->removeRigidBody(bObjectRigidBody_.get());
 
-  collisionObjToObjIds_->erase(bObjectRigidBody_.get());
-
 }  //~BulletRigidObject
 
 bool BulletRigidObject::initialization_LibSpecific() {
@@ -82,7 +83,7 @@ bool BulletRigidObject::constructCollisionShape() {
 
   //! Physical parameters
   double margin = tmpAttr->getMargin();
-  bool joinCollisionMeshes = tmpAttr->getJoinCollisionMeshes();
+  const Magnum::Vector3 scale = tmpAttr->getScale();
   usingBBCollisionShape_ = tmpAttr->getBoundingBoxCollisions();
 
   // TODO(alexanderwclegg): should provide the option for joinCollisionMeshes
@@ -114,34 +115,34 @@ bool BulletRigidObject::constructCollisionShape() {
     bGenericShapes_.emplace_back(std::move(primObjPtr));
     bObjectShape_->addChildShape(btTransform::getIdentity(),
                                  bGenericShapes_.back().get());
-    bObjectShape_->recalculateLocalAabb();
-  } else {
-    // mesh collider
-    const std::vector<assets::CollisionMeshData>& meshGroup =
-        resMgr_.getCollisionMesh(collisionAssetHandle);
-    const assets::MeshMetaData& metaData =
-        resMgr_.getMeshMetaData(collisionAssetHandle);
-
-    if (!usingBBCollisionShape_) {
-      constructBulletCompoundFromMeshes(Magnum::Matrix4{}, meshGroup,
-                                        metaData.root, joinCollisionMeshes);
-
-      // add the final object after joining meshes
-      if (joinCollisionMeshes) {
-        bObjectConvexShapes_.back()->setLocalScaling(
-            btVector3(tmpAttr->getCollisionAssetSize()));
-        bObjectConvexShapes_.back()->setMargin(0.0);
-        bObjectConvexShapes_.back()->recalcLocalAabb();
-        bObjectShape_->addChildShape(btTransform::getIdentity(),
-                                     bObjectConvexShapes_.back().get());
+    bObjectShape_->setLocalScaling(btVector3{scale});
+  } else if (!usingBBCollisionShape_) {
+    // mesh collider. The compound's local scaling would propagate to the
+    // shared hulls, so the scale is applied per child instead. Bullet only
+    // uses the magnitude of convex scaling.
+    const Magnum::Vector3 absScale = Magnum::Math::abs(scale);
+    const bool uniformScale = absScale.x() > 0.0f &&
+                              absScale.y() == absScale.x() &&
+                              absScale.z() == absScale.x();
+    bSharedConvexShapes_ = shapeCache_->getHulls(
+        *tmpAttr, resMgr_, uniformScale ? Magnum::Vector3{1.0f} : absScale);
+    for (const std::unique_ptr<btConvexHullShape>& hull :
+         *bSharedConvexShapes_) {
+      btConvexShape* child = hull.get();
+      if (uniformScale && absScale.x() != 1.0f) {
+        bScaledConvexShapes_.emplace_back(
+            std::make_unique<btUniformScalingShape>(hull.get(), absScale.x()));
+        child = bScaledConvexShapes_.back().get();
       }
+      bObjectShape_->addChildShape(btTransform::getIdentity(), child);
     }
+  } else {
+    // bounding box collider, added once the bounding box is known
+    bObjectShape_->setLocalScaling(btVector3{scale});
   }  // if using prim collider else use mesh collider
 
   //! Set properties
   bObjectShape_->setMargin(margin);
-
-  bObjectShape_->setLocalScaling(btVector3{tmpAttr->getScale()});
   bObjectShape_->recalculateLocalAabb();
 
   if (!originShift_.isZero()) {
@@ -219,61 +220,6 @@ BulletRigidObject::buildPrimitiveCollisionObject(int primTypeVal,
   return obj;
 }  // buildPrimitiveCollisionObject
 
-// recursively create the convex mesh shapes and add them to the compound in a
-// flat manner by accumulating transformations down the tree
-void BulletRigidObject::constructBulletCompoundFromMeshes(
-    const Magnum::Matrix4& transformFromParentToWorld,
-    const std::vector<assets::CollisionMeshData>& meshGroup,
-    const assets::MeshTransformNode& node,
-    bool join) {
-  Magnum::Matrix4 transformFromLocalToWorld =
-      transformFromParentToWorld * node.transformFromLocalToParent;
-  if (node.meshIDLocal != ID_UNDEFINED) {
-    // This node has a mesh, so add it to the compound
-
-    const assets::CollisionMeshData& mesh = meshGroup[node.meshIDLocal];
-
-    if (join) {
-      // add all points to a single convex instead of compounding (more
-      // stable)
-      if (bObjectConvexShapes_.empty()) {
-        // create the convex if it does not exist
-        bObjectConvexShapes_.emplace_back(
-            std::make_unique<btConvexHullShape>());
-      }
-
-      // add points
-      for (auto& v : mesh.positions) {
-        bObjectConvexShapes_.back()->addPoint(
-            btVector3(transformFromLocalToWorld.transformPoint(v)), false);
-      }
-
-    } else {
-      bObjectConvexShapes_.emplace_back(std::make_unique<btConvexHullShape>());
-      // transform points into world space, including any scale/shear in
-      // transformFromLocalToWorld.
-      for (auto& v : mesh.positions) {
-        bObjectConvexShapes_.back()->addPoint(
-            btVector3(transformFromLocalToWorld.transformPoint(v)), false);
-      }
-      // bObjectConvexShapes_.back()->optimizeConvexHull();
-      // bObjectConvexShapes_.back()->initializePolyhedralFeatures();
-      // Remove local convex margin in favor of margin on the containing
-      // compound
-      bObjectConvexShapes_.back()->setMargin(0.0);
-      bObjectConvexShapes_.back()->recalcLocalAabb();
-      //! Add to compound shape stucture
-      bObjectShape_->addChildShape(btTransform::getIdentity(),
-                                   bObjectConvexShapes_.back().get());
-    }
-  }
-
-  for (auto& child : node.children) {
-    constructBulletCompoundFromMeshes(transformFromLocalToWorld, meshGroup,
-                                      child, join);
-  }
-}  // constructBulletCompoundFromMeshes
-
 void BulletRigidObject::setCollisionFromBB() {
   btVector3 dim(node().getCumulativeBB().size() / 2.0);
 
@@ -306,6 +252,45 @@ void BulletRigidObject::setCollisionFromBB() {
   }
 }  // setCollisionFromBB
 
+void BulletRigidObject::setMargin(const double margin) {
+  makeConvexShapesUnique();
+  for (std::size_t i = 0; i < bObjectConvexShapes_.size(); i++) {
+    bObjectConvexShapes_[i]->setMargin(margin);
+  }
+  bObjectShape_->setMargin(margin);
+}  // setMargin
+
+void BulletRigidObject::makeConvexShapesUnique() {
+  if (!bSharedConvexShapes_) {
+    return;
+  }
+  // removing a child moves the last one into its place, so walk backwards to
+  // only ever see shared children at the current index
+  for (int i = bObjectShape_->getNumChildShapes() - 1; i >= 0; --i) {
+    const btCollisionShape* child = bObjectShape_->getChildShape(i);
+    btScalar scalingFactor = 1.0;
+    if (child->getShapeType() == UNIFORM_SCALING_SHAPE_PROXYTYPE) {
+      const auto* scaled = static_cast<const btUniformScalingShape*>(child);
+      scalingFactor = scaled->getUniformScalingFactor();
+      child = scaled->getChildShape();
+    }
+    const auto* hull = static_cast<const btConvexHullShape*>(child);
+    bObjectConvexShapes_.emplace_back(std::make_unique<btConvexHullShape>(
+        &hull->getUnscaledPoints()->getX(), hull->getNumPoints()));
+    bObjectConvexShapes_.back()->setLocalScaling(hull->getLocalScaling() *
+                                                 scalingFactor);
+    bObjectConvexShapes_.back()->setMargin(hull->getMargin());
+    bObjectConvexShapes_.back()->recalcLocalAabb();
+
+    const btTransform childTransform = bObjectShape_->getChildTransform(i);
+    bObjectShape_->removeChildShapeByIndex(i);
+    bObjectShape_->addChildShape(childTransform,
+                                 bObjectConvexShapes_.back().get());
+  }
+  bScaledConvexShapes_.clear();
+  bSharedConvexShapes_.reset();
+}  // makeConvexShapesUnique
+
 bool BulletRigidObject::setMotionType(MotionType mt) {
   if (mt == MotionType::UNDEFINED) {
     return false;
@@ -425,11 +410,9 @@ void BulletRigidObject::constructAndAddRigidBody(MotionType mt) {
   }
 
   //! Create rigid body
-  if (collisionObjToObjIds_->count(bObjectRigidBody_.get())) {
-    collisionObjToObjIds_->erase(bObjectRigidBody_.get());
-  }
   bObjectRigidBody_ = std::make_unique<btRigidBody>(info);
-  collisionObjToObjIds_->emplace(bObjectRigidBody_.get(), objectId_);
+  // identifies the object in ray and contact queries without a lookup table
+  bObjectRigidBody_->setUserIndex(objectId_);
 
   if (mt == MotionType::KINEMATIC) {
     bObjectRigidBody_->setCollisionFlags(
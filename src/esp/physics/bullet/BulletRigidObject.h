@@ -22,6 +22,7 @@
 
 #include "esp/physics/RigidObject.h"
 #include "esp/physics/bullet/BulletBase.h"
+#include "esp/physics/bullet/BulletCollisionShapeCache.h"
 
 namespace esp {
 namespace physics {
@@ -46,15 +47,19 @@ class BulletRigidObject : public BulletBase,
    * @param resMgr Reference to resource manager, to access relevant components
    * pertaining to the scene object
    * @param bWorld The Bullet world to which this object will belong.
-   * @param collisionObjToObjIds The global map of btCollisionObjects to Habitat
-   * object IDs for contact query identification.
+   * @param shapeCache Cache providing the convex hulls of mesh collision
+   * shapes, shared with other objects of the same template. If nullptr, the
+   * object builds its own.
+   *
+   * The object ID is stored as the user index of the btRigidBody (see @ref
+   * btCollisionObject::getUserIndex) for contact query identification.
    */
-  BulletRigidObject(scene::SceneNode* rigidBodyNode,
-                    int objectId,
-                    const assets::ResourceManager& resMgr,
-                    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-                    std::shared_ptr<std::map<const btCollisionObject*, int>>
-                        collisionObjToObjIds);
+  BulletRigidObject(
+      scene::SceneNode* rigidBodyNode,
+      int objectId,
+      const assets::ResourceManager& resMgr,
+      std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
+      std::shared_ptr<BulletCollisionShapeCache> shapeCache = nullptr);
 
   /**
    * @brief Destructor cleans up simulation structures for the object.
@@ -80,27 +85,14 @@ class BulletRigidObject : public BulletBase,
       double halfLength);
   // const assets::AbstractPrimitiveAttributes& primAttributes);
 
-  /**
-   * @brief Recursively construct a @ref btCompoundShape for collision from
-   * loaded mesh assets. A @ref btConvexHullShape is constructed for each
-   * sub-component, transformed to object-local space and added to the compound
-   * in a flat manner for efficiency.
-   * @param transformFromParentToWorld The cumulative parent-to-world
-   * transformation matrix constructed by composition down the @ref
-   * MeshTransformNode tree to the current node.
-   * @param meshGroup Access structure for collision mesh data.
-   * @param node The current @ref MeshTransformNode in the recursion.
-   * @param join Whether or not to join sub-meshes into a single con convex
-   * shape, rather than creating individual convexes under the compound.
-   */
-  void constructBulletCompoundFromMeshes(
-      const Magnum::Matrix4& transformFromParentToWorld,
-      const std::vector<assets::CollisionMeshData>& meshGroup,
-      const assets::MeshTransformNode& node,
-      bool join);
-
   /**
    * @brief Construct the @ref bObjectShape_ for this object.
+   *
+   * Mesh collision shapes reference the convex hulls of the shape cache
+   * rather than owning copies. A uniform positive object scale is applied
+   * through a @ref btUniformScalingShape around each hull, so objects of one
+   * template share hulls at any such scale. Other scales are baked into the
+   * hulls.
    * @return Whether or not construction was successful.
    */
   bool constructCollisionShape();
@@ -118,6 +110,20 @@ class BulletRigidObject : public BulletBase,
    */
   void setActive() override { bObjectRigidBody_->activate(true); }
 
+  /**
+   * @brief Put an object to sleep or wake it up. A sleeping object stays
+   * asleep until something activates its collision island. See @ref
+   * btCollisionObject::setActivationState.
+   * @param sleeping Whether the object should be sleeping.
+   */
+  void setSleeping(bool sleeping) override {
+    if (sleeping) {
+      bObjectRigidBody_->setActivationState(ISLAND_SLEEPING);
+    } else {
+      bObjectRigidBody_->activate(true);
+    }
+  }
+
   /**
    * @brief Set the @ref MotionType of the object. The object can be set to @ref
    * MotionType::STATIC, @ref MotionType::KINEMATIC or @ref MotionType::DYNAMIC.
@@ -399,15 +405,11 @@ class BulletRigidObject : public BulletBase,
   }
 
   /** @brief Set the scalar collision margin of an object. See @ref
-   * btCompoundShape::setMargin.
+   * btCompoundShape::setMargin. Replaces shared convex hulls with copies
+   * owned by this object first.
    * @param margin The new scalar collision margin of the object.
    */
-  void setMargin(const double margin) override {
-    for (std::size_t i = 0; i < bObjectConvexShapes_.size(); i++) {
-      bObjectConvexShapes_[i]->setMargin(margin);
-    }
-    bObjectShape_->setMargin(margin);
-  }
+  void setMargin(const double margin) override;
 
   /** @brief Sets the object's collision shape to its bounding box.
    * Since the bounding hierarchy is not constructed when the object is
@@ -439,6 +441,20 @@ class BulletRigidObject : public BulletBase,
    */
   const Magnum::Range3D getCollisionShapeAabb() const override;
 
+  /**
+   * @brief The collision object of this object, e.g. to share its collision
+   * shape with queries done outside of the collision world.
+   */
+  const btCollisionObject& getCollisionObject() const {
+    return *bObjectRigidBody_;
+  }
+
+  /**
+   * @brief Remove the object from the collision world for good, keeping it
+   * only as a template of its collision shape. See @ref getCollisionObject.
+   */
+  void removeFromWorld() { bWorld_->removeRigidBody(bObjectRigidBody_.get()); }
+
  private:
   /**
    * @brief Finalize initialization of this @ref BulletRigidObject as a @ref
@@ -473,6 +489,13 @@ class BulletRigidObject : public BulletBase,
    */
   void activateCollisionIsland();
 
+  /**
+   * @brief Replace the shared convex hulls in the @ref bObjectShape_ with
+   * copies in @ref bObjectConvexShapes_, with any scaling baked in, so they
+   * can be modified.
+   */
+  void makeConvexShapesUnique();
+
  private:
   // === Physical object ===
   //! If true, the object's bounding box will be used for collision once
@@ -483,9 +506,19 @@ class BulletRigidObject : public BulletBase,
   //! deffered construction of collision shape
   Mn::Vector3 originShift_;
 
-  //! Object data: Composite convex collision shape
+  //! Provides the convex hulls of mesh collision shapes
+  std::shared_ptr<BulletCollisionShapeCache> shapeCache_;
+
+  //! Object data: Composite convex collision shape, if owned by the object
   std::vector<std::unique_ptr<btConvexHullShape>> bObjectConvexShapes_;
 
+  //! Object data: Composite convex collision shape, if shared with other
+  //! objects through the @ref shapeCache_
+  std::shared_ptr<const BulletCollisionShapeCache::Hulls> bSharedConvexShapes_;
+
+  //! Uniformly scaled instances of the @ref bSharedConvexShapes_
+  std::vector<std::unique_ptr<btUniformScalingShape>> bScaledConvexShapes_;
+
   //! list of @ref btCollisionShape for storing arbitrary collision shapes
   //! referenced within the @ref bObjectShape_.
   std::vector<std::unique_ptr<btCollisionShape>> bGenericShapes_;
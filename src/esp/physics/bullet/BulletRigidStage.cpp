@@ -5,32 +5,198 @@
 #include <Magnum/BulletIntegration/DebugDraw.h>
 #include <Magnum/BulletIntegration/Integration.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <utility>
 
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
 #include "BulletCollision/CollisionShapes/btConvexHullShape.h"
 #include "BulletCollision/CollisionShapes/btConvexTriangleMeshShape.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletRigidStage.h"
+#include "esp/io/io.h"
 
 namespace esp {
 namespace physics {
 
+namespace {
+
+// bump whenever the layout below changes
+constexpr std::uint32_t BvhCacheVersion = 1;
+constexpr char BvhCacheMagic[4] = {'E', 'B', 'V', 'H'};
+// btQuantizedBvh::deSerializeInPlace() needs 16-byte aligned data
+constexpr std::size_t BvhAlignment = 16;
+
+struct BvhCacheHeader {
+  char magic[4];
+  std::uint32_t version;
+  //! BT_BULLET_VERSION, the serialized layout is Bullet's own
+  std::uint32_t bulletVersion;
+  std::uint32_t shapeCount;
+};
+
+//! Followed by the serialized BVH, padded to BvhAlignment
+struct BvhCacheEntry {
+  std::uint64_t key;
+  std::uint64_t byteSize;
+};
+
+static_assert(sizeof(BvhCacheHeader) % BvhAlignment == 0 &&
+                  sizeof(BvhCacheEntry) % BvhAlignment == 0,
+              "BVH cache headers break the data alignment");
+
+std::size_t alignBvhSize(std::size_t size) {
+  return (size + BvhAlignment - 1) / BvhAlignment * BvhAlignment;
+}
+
+//! Aligned start of a buffer allocated BvhAlignment - 1 bytes larger
+char* alignBvhData(Corrade::Containers::Array<char>& data) {
+  const std::size_t misalignment =
+      reinterpret_cast<std::uintptr_t>(data.data()) % BvhAlignment;
+  return data.data() + (misalignment ? BvhAlignment - misalignment : 0);
+}
+
+std::string getBvhCacheFilename(const std::string& collisionAssetHandle) {
+  return collisionAssetHandle + ".bvhcache";
+}
+
+/**
+ * @brief Load the BVHs of all shapes from a cache file if it has a BVH for
+ * each of the given keys, without building any.
+ */
+bool loadBvhCache(const std::string& filename,
+                  const std::vector<std::uint64_t>& bvhKeys,
+                  BulletRigidStage::CollisionShapes& shapes) {
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file.good()) {
+    return false;
+  }
+  const std::size_t fileSize = file.tellg();
+  Corrade::Containers::Array<char> data{Corrade::Containers::NoInit,
+                                        fileSize + BvhAlignment - 1};
+  char* const begin = alignBvhData(data);
+  file.seekg(0);
+  BvhCacheHeader header{};
+  if (fileSize < sizeof(header) || !file.read(begin, fileSize)) {
+    LOG(WARNING) << "Ignoring unreadable BVH cache file " << filename;
+    return false;
+  }
+  std::memcpy(&header, begin, sizeof(header));
+  if (!std::equal(header.magic, header.magic + 4, BvhCacheMagic) ||
+      header.version != BvhCacheVersion ||
+      header.bulletVersion != BT_BULLET_VERSION) {
+    LOG(WARNING) << "Ignoring invalid BVH cache file " << filename;
+    return false;
+  }
+  if (header.shapeCount != bvhKeys.size()) {
+    LOG(WARNING) << "Ignoring outdated BVH cache file " << filename;
+    return false;
+  }
+
+  std::vector<btOptimizedBvh*> bvhs;
+  std::size_t offset = sizeof(header);
+  for (const std::uint64_t key : bvhKeys) {
+    BvhCacheEntry entry{};
+    if (offset + sizeof(entry) > fileSize) {
+      break;
+    }
+    std::memcpy(&entry, begin + offset, sizeof(entry));
+    offset += sizeof(entry);
+    if (entry.key != key) {
+      LOG(WARNING) << "Ignoring outdated BVH cache file " << filename;
+      return false;
+    }
+    if (offset + entry.byteSize > fileSize) {
+      break;
+    }
+    // deserializes a btQuantizedBvh, which btOptimizedBvh only adds building
+    // functions to. Bullet's own importers cast the same way.
+    btQuantizedBvh* bvh = btQuantizedBvh::deSerializeInPlace(
+        begin + offset, entry.byteSize, /*i_swapEndian*/ false);
+    if (!bvh) {
+      break;
+    }
+    bvhs.push_back(static_cast<btOptimizedBvh*>(bvh));
+    offset += alignBvhSize(entry.byteSize);
+  }
+  if (bvhs.size() != bvhKeys.size()) {
+    LOG(WARNING) << "Ignoring truncated BVH cache file " << filename;
+    return false;
+  }
+
+  for (std::size_t i = 0; i != bvhs.size(); ++i) {
+    // the BVHs were built for the current scaling, so it isn't rebuilt
+    shapes.shapes[i]->setOptimizedBvh(bvhs[i],
+                                      shapes.shapes[i]->getLocalScaling());
+  }
+  shapes.bvhData = std::move(data);
+  return true;
+}  // loadBvhCache
+
+bool saveBvhCache(const std::string& filename,
+                  const std::vector<std::uint64_t>& bvhKeys,
+                  const BulletRigidStage::CollisionShapes& shapes) {
+  // write to a temporary file first so concurrent readers never see a
+  // partially written one
+  const std::string tmpFilename = io::getTemporaryFilename(filename);
+  {
+    std::ofstream file(tmpFilename, std::ios::binary | std::ios::trunc);
+    BvhCacheHeader header{};
+    std::copy(BvhCacheMagic, BvhCacheMagic + 4, header.magic);
+    header.version = BvhCacheVersion;
+    header.bulletVersion = BT_BULLET_VERSION;
+    header.shapeCount = bvhKeys.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const char padding[BvhAlignment]{};
+    for (std::size_t i = 0; i != shapes.shapes.size(); ++i) {
+      const btOptimizedBvh* bvh = shapes.shapes[i]->getOptimizedBvh();
+      BvhCacheEntry entry{};
+      entry.key = bvhKeys[i];
+      entry.byteSize = bvh->calculateSerializeBufferSize();
+      file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+
+      Corrade::Containers::Array<char> data{
+          Corrade::Containers::ValueInit,
+          std::size_t(entry.byteSize) + BvhAlignment - 1};
+      char* const begin = alignBvhData(data);
+      bvh->serializeInPlace(begin, entry.byteSize, /*i_swapEndian*/ false);
+      file.write(begin, entry.byteSize);
+      file.write(padding, alignBvhSize(entry.byteSize) - entry.byteSize);
+    }
+    if (!file.good()) {
+      LOG(WARNING) << "Failed writing BVH cache file " << tmpFilename;
+      file.close();
+      std::remove(tmpFilename.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+    LOG(WARNING) << "Failed renaming " << tmpFilename << " to " << filename;
+    std::remove(tmpFilename.c_str());
+    return false;
+  }
+  return true;
+}  // saveBvhCache
+
+}  // namespace
+
 BulletRigidStage::BulletRigidStage(
     scene::SceneNode* rigidBodyNode,
     const assets::ResourceManager& resMgr,
-    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-    std::shared_ptr<std::map<const btCollisionObject*, int> >
-        collisionObjToObjIds)
-    : BulletBase(std::move(bWorld), std::move(collisionObjToObjIds)),
+    std::shared_ptr<btMultiBodyDynamicsWorld> bWorld)
+    : BulletBase(std::move(bWorld)),
       RigidStage{rigidBodyNode, resMgr} {}
 
 BulletRigidStage::~BulletRigidStage() {
   // remove collision objects from the world
   for (auto& co : bStaticCollisionObjects_) {
     bWorld_->removeRigidBody(co.get());
-    collisionObjToObjIds_->erase(co.get());
   }
 }
 bool BulletRigidStage::initialization_LibSpecific() {
@@ -70,19 +236,53 @@ void BulletRigidStage::constructAndAddCollisionObjects() {
     const auto collisionAssetHandle =
         initializationAttributes_->getCollisionAssetHandle();
 
-    const std::vector<assets::CollisionMeshData>& meshGroup =
-        resMgr_.getCollisionMesh(collisionAssetHandle);
+    if (!bStageShapes_) {
+      const std::vector<assets::CollisionMeshData>& meshGroup =
+          resMgr_.getCollisionMesh(collisionAssetHandle);
+
+      const assets::MeshMetaData& metaData =
+          resMgr_.getMeshMetaData(collisionAssetHandle);
 
-    const assets::MeshMetaData& metaData =
-        resMgr_.getMeshMetaData(collisionAssetHandle);
+      auto shapes = std::make_shared<CollisionShapes>();
+      std::vector<std::uint64_t> bvhKeys;
+      constructBulletSceneFromMeshes(Magnum::Matrix4{}, meshGroup,
+                                     metaData.root, *shapes, bvhKeys);
 
-    constructBulletSceneFromMeshes(Magnum::Matrix4{}, meshGroup, metaData.root);
+      const bool useBvhCache = useBvhCache_ && !shapes->shapes.empty();
+      const std::string bvhCacheFilename =
+          getBvhCacheFilename(collisionAssetHandle);
+      loadedBvhCache_ =
+          useBvhCache && loadBvhCache(bvhCacheFilename, bvhKeys, *shapes);
+      if (!loadedBvhCache_) {
+        for (auto& shape : shapes->shapes) {
+          shape->buildOptimizedBvh();
+        }
+        if (useBvhCache) {
+          saveBvhCache(bvhCacheFilename, bvhKeys, *shapes);
+        }
+      }
+      bStageShapes_ = std::move(shapes);
+    }
+
+    for (std::size_t i = 0; i != bStageShapes_->shapes.size(); ++i) {
+      // mass == 0 to indicate static. See isStaticObject assert below. See
+      // also examples/MultiThreadedDemo/CommonRigidBodyMTBase.h
+      btVector3 localInertia(0, 0, 0);
+      btRigidBody::btRigidBodyConstructionInfo cInfo(
+          /*mass*/ 0.0, nullptr, bStageShapes_->shapes[i].get(),
+          localInertia);
+      cInfo.m_startWorldTransform = bStageShapes_->transforms[i];
+      std::unique_ptr<btRigidBody> sceneCollisionObject =
+          std::make_unique<btRigidBody>(cInfo);
+      CORRADE_INTERNAL_ASSERT(sceneCollisionObject->isStaticObject());
+      bStaticCollisionObjects_.emplace_back(std::move(sceneCollisionObject));
+    }
 
     for (auto& object : bStaticCollisionObjects_) {
       object->setFriction(initializationAttributes_->getFrictionCoefficient());
       object->setRestitution(
           initializationAttributes_->getRestitutionCoefficient());
-      collisionObjToObjIds_->emplace(object.get(), objectId_);
+      object->setUserIndex(objectId_);
     }
   }
 
@@ -98,7 +298,9 @@ void BulletRigidStage::constructAndAddCollisionObjects() {
 void BulletRigidStage::constructBulletSceneFromMeshes(
     const Magnum::Matrix4& transformFromParentToWorld,
     const std::vector<assets::CollisionMeshData>& meshGroup,
-    const assets::MeshTransformNode& node) {
+    const assets::MeshTransformNode& node,
+    CollisionShapes& shapes,
+    std::vector<std::uint64_t>& bvhKeys) {
   Magnum::Matrix4 transformFromLocalToWorld =
       transformFromParentToWorld * node.transformFromLocalToParent;
   if (node.meshIDLocal != ID_UNDEFINED) {
@@ -125,38 +327,41 @@ void BulletRigidStage::constructBulletSceneFromMeshes(
     std::unique_ptr<btTriangleIndexVertexArray> indexedVertexArray =
         std::make_unique<btTriangleIndexVertexArray>();
     indexedVertexArray->addIndexedMesh(bulletMesh, PHY_INTEGER);  // exact shape
+    // scale is a property of the shape. Set on the mesh before creating the
+    // shape, as btBvhTriangleMeshShape::setLocalScaling() rebuilds the BVH.
+    const Magnum::Vector3 scaling = transformFromLocalToWorld.scaling();
+    indexedVertexArray->setScaling(btVector3{scaling});
 
     //! Embed 3D mesh into bullet shape
     //! btBvhTriangleMeshShape is the most generic/slow choice
-    //! which allows concavity if the object is static
+    //! which allows concavity if the object is static. The BVH gets built or
+    //! loaded from the cache once all shapes are constructed.
     std::unique_ptr<btBvhTriangleMeshShape> meshShape =
         std::make_unique<btBvhTriangleMeshShape>(indexedVertexArray.get(),
-                                                 true);
-    meshShape->setMargin(initializationAttributes_->getMargin());
-    meshShape->setLocalScaling(
-        btVector3{transformFromLocalToWorld
-                      .scaling()});  // scale is a property of the shape
-
-    // re-build the bvh after setting margin
-    meshShape->buildOptimizedBvh();
-    // mass == 0 to indicate static. See isStaticObject assert below. See also
-    // examples/MultiThreadedDemo/CommonRigidBodyMTBase.h
-    btVector3 localInertia(0, 0, 0);
-    btRigidBody::btRigidBodyConstructionInfo cInfo(
-        /*mass*/ 0.0, nullptr, meshShape.get(), localInertia);
-    cInfo.m_startWorldTransform =
-        btTransform{btMatrix3x3{transformFromLocalToWorld.rotation()},
-                    btVector3{transformFromLocalToWorld.translation()}};
-    std::unique_ptr<btRigidBody> sceneCollisionObject =
-        std::make_unique<btRigidBody>(cInfo);
-    CORRADE_INTERNAL_ASSERT(sceneCollisionObject->isStaticObject());
-    bStageArrays_.emplace_back(std::move(indexedVertexArray));
-    bStageShapes_.emplace_back(std::move(meshShape));
-    bStaticCollisionObjects_.emplace_back(std::move(sceneCollisionObject));
+                                                 /*useQuantizedAabbCompression*/
+                                                 true, /*buildBvh*/ false);
+    const float margin = initializationAttributes_->getMargin();
+    meshShape->setMargin(margin);
+
+    std::uint64_t bvhKey = io::hashBytes(
+        v_data.data(), v_data.size() * sizeof(Magnum::Vector3));
+    bvhKey = io::hashBytes(ui_data.data(),
+                           ui_data.size() * sizeof(Magnum::UnsignedInt),
+                           bvhKey);
+    bvhKey = io::hashBytes(scaling.data(), sizeof(scaling), bvhKey);
+    bvhKey = io::hashBytes(&margin, sizeof(margin), bvhKey);
+    bvhKeys.push_back(bvhKey);
+
+    shapes.arrays.emplace_back(std::move(indexedVertexArray));
+    shapes.shapes.emplace_back(std::move(meshShape));
+    shapes.transforms.emplace_back(
+        btMatrix3x3{transformFromLocalToWorld.rotation()},
+        btVector3{transformFromLocalToWorld.translation()});
   }
 
   for (auto& child : node.children) {
-    constructBulletSceneFromMeshes(transformFromLocalToWorld, meshGroup, child);
+    constructBulletSceneFromMeshes(transformFromLocalToWorld, meshGroup, child,
+                                   shapes, bvhKeys);
   }
 }  // constructBulletSceneFromMeshes
 
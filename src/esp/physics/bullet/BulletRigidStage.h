@@ -5,6 +5,10 @@
 #ifndef ESP_PHYSICS_BULLET_BULLETRIGIDSTAGE_H_
 #define ESP_PHYSICS_BULLET_BULLETRIGIDSTAGE_H_
 
+#include <cstdint>
+
+#include <Corrade/Containers/Array.h>
+
 #include "esp/physics/RigidStage.h"
 #include "esp/physics/bullet/BulletBase.h"
 
@@ -23,15 +27,71 @@ class BulletRigidStage : public BulletBase, public RigidStage {
  public:
   BulletRigidStage(scene::SceneNode* rigidBodyNode,
                    const assets::ResourceManager& resMgr,
-                   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld,
-                   std::shared_ptr<std::map<const btCollisionObject*, int>>
-                       collisionObjToObjIds);
+                   std::shared_ptr<btMultiBodyDynamicsWorld> bWorld);
 
   /**
    * @brief Destructor cleans up simulation structures for the stage object.
    */
   virtual ~BulletRigidStage();
 
+  /**
+   * @brief The Bullet collision shapes of a stage with their world
+   * transformations. Bullet only reads collision shapes while simulating, so
+   * stages of several worlds can share them.
+   */
+  struct CollisionShapes {
+    //! Bullet triangular mesh vertices
+    std::vector<std::unique_ptr<btTriangleIndexVertexArray>> arrays;
+    //! Deserialized BVHs of the shapes when loaded from a BVH cache file,
+    //! empty if the shapes own their BVHs
+    Corrade::Containers::Array<char> bvhData;
+    //! Bullet triangular mesh shapes
+    std::vector<std::unique_ptr<btBvhTriangleMeshShape>> shapes;
+    //! World transformation of each shape
+    std::vector<btTransform> transforms;
+  };
+
+  /**
+   * @brief Get the collision shapes of this stage, nullptr if they haven't
+   * been constructed, i.e. the stage was never collidable.
+   */
+  std::shared_ptr<const CollisionShapes> getCollisionShapes() const {
+    return bStageShapes_;
+  }
+
+  /**
+   * @brief Use the collision shapes of another stage of the same template
+   * instead of constructing them. Must be called before the stage gets
+   * initialized.
+   * @param shapes Shapes from @ref getCollisionShapes of the other stage.
+   */
+  void setSharedCollisionShapes(std::shared_ptr<const CollisionShapes> shapes) {
+    CORRADE_INTERNAL_ASSERT(bStaticCollisionObjects_.empty());
+    bStageShapes_ = std::move(shapes);
+  }
+
+  /**
+   * @brief Whether the BVHs of the collision shapes are cached in a file next
+   * to the collision asset.
+   *
+   * Building the BVH of a large stage takes seconds, loading it in place
+   * from the cache file takes about as long as reading the file. The cache is
+   * keyed by a hash of the collision meshes, their scaling and margin and is
+   * rewritten if any of them changed. Must be set before the stage gets
+   * initialized.
+   */
+  bool getUseBvhCache() const { return useBvhCache_; }
+
+  /** @brief Set whether to cache the BVHs, see @ref getUseBvhCache */
+  void setUseBvhCache(bool useBvhCache) { useBvhCache_ = useBvhCache; }
+
+  /**
+   * @brief Whether the BVHs of the collision shapes got loaded from the cache
+   * file instead of being built, see @ref getUseBvhCache. False for shapes
+   * shared from another stage.
+   */
+  bool getLoadedBvhCache() const { return loadedBvhCache_; }
+
  private:
   /**
    * @brief Finalize the initialization of this @ref RigidScene
@@ -43,18 +103,23 @@ class BulletRigidStage : public BulletBase, public RigidStage {
   bool initialization_LibSpecific() override;
 
   /**
-   * @brief Recursively construct the static collision mesh objects from
+   * @brief Recursively construct the static collision mesh shapes from
    * imported assets.
    * @param transformFromParentToWorld The cumulative parent-to-world
    * transformation matrix constructed by composition down the @ref
    * MeshTransformNode tree to the current node.
    * @param meshGroup Access structure for collision mesh data.
    * @param node The current @ref MeshTransformNode in the recursion.
+   * @param[out] shapes Receives the shapes, without BVHs.
+   * @param[out] bvhKeys Receives a key of each shape's BVH, identifying it in
+   * the BVH cache.
    */
   void constructBulletSceneFromMeshes(
       const Magnum::Matrix4& transformFromParentToWorld,
       const std::vector<assets::CollisionMeshData>& meshGroup,
-      const assets::MeshTransformNode& node);
+      const assets::MeshTransformNode& node,
+      CollisionShapes& shapes,
+      std::vector<std::uint64_t>& bvhKeys);
 
   /**
    * @brief Adds static stage collision objects to the simulation world after
@@ -105,11 +170,15 @@ class BulletRigidStage : public BulletBase, public RigidStage {
  private:
   // === Physical stage ===
 
-  //! Stage data: Bullet triangular mesh vertices
-  std::vector<std::unique_ptr<btTriangleIndexVertexArray>> bStageArrays_;
+  //! Stage data: Bullet triangular mesh shapes, possibly shared with stages
+  //! of other worlds
+  std::shared_ptr<const CollisionShapes> bStageShapes_;
+
+  //! Whether to cache the BVHs of the @ref bStageShapes_ in a file
+  bool useBvhCache_ = false;
 
-  //! Stage data: Bullet triangular mesh shape
-  std::vector<std::unique_ptr<btBvhTriangleMeshShape>> bStageShapes_;
+  //! Whether the BVHs were loaded from the cache file
+  bool loadedBvhCache_ = false;
 
  public:
   ESP_SMART_POINTERS(BulletRigidStage)
@@ -0,0 +1,132 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "PhysicsWorldBatch.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "WorkerPool.h"
+
+namespace esp {
+namespace physics {
+
+PhysicsWorldBatch::PhysicsWorldBatch(assets::ResourceManager& resourceManager,
+                                     const BulletPhysicsManager& stageSource,
+                                     int numWorlds,
+                                     int numThreads) {
+  CHECK_GT(numWorlds, 0);
+  const auto physicsManagerAttributes =
+      stageSource.getInitializationAttributes();
+  const auto stageAttributes = stageSource.getStageInitAttributes();
+  const std::vector<assets::CollisionMeshData>& meshGroup =
+      resourceManager.getCollisionMesh(
+          stageAttributes->getCollisionAssetHandle());
+
+  worlds_.resize(numWorlds);
+  for (World& world : worlds_) {
+    world.sceneGraph = std::make_unique<scene::SceneGraph>();
+    world.physicsManager = std::make_unique<BulletPhysicsManager>(
+        resourceManager, physicsManagerAttributes);
+    world.physicsManager->initPhysics(&world.sceneGraph->getRootNode());
+    world.physicsManager->shareStageCollisionShapes(stageSource);
+    world.physicsManager->setCollisionShapeCache(
+        stageSource.getCollisionShapeCache());
+    if (!world.physicsManager->addStage(stageAttributes->getHandle(),
+                                        meshGroup)) {
+      LOG(ERROR) << "PhysicsWorldBatch : adding stage "
+                 << stageAttributes->getHandle() << " failed";
+    }
+    world.physicsManager->setGravity(stageSource.getGravity());
+    world.physicsManager->setStageFrictionCoefficient(
+        stageSource.getStageFrictionCoefficient());
+    world.physicsManager->setStageRestitutionCoefficient(
+        stageSource.getStageRestitutionCoefficient());
+  }
+
+  std::size_t threadCount = numThreads > 0
+                                ? static_cast<std::size_t>(numThreads)
+                                : std::thread::hardware_concurrency();
+  threadCount = std::max(std::min(threadCount, worlds_.size()), std::size_t{1});
+  pool_ = std::make_unique<WorkerPool>(threadCount - 1);
+}
+
+PhysicsWorldBatch::~PhysicsWorldBatch() = default;
+
+int PhysicsWorldBatch::getNumThreads() const {
+  return pool_->getNumWorkers() + 1;
+}
+
+int PhysicsWorldBatch::addObject(const std::string& configFile) {
+  // the resource manager isn't thread-safe, so objects get added serially
+  int physObjectID = ID_UNDEFINED;
+  for (std::size_t i = 0; i != worlds_.size(); ++i) {
+    const int worldObjectID =
+        worlds_[i].physicsManager->addObject(configFile, nullptr);
+    // IDs are allocated the same way in every world
+    CORRADE_INTERNAL_ASSERT(i == 0 || worldObjectID == physObjectID);
+    if (worldObjectID == ID_UNDEFINED) {
+      // only the first world can fail, as all add the same object
+      return ID_UNDEFINED;
+    }
+    physObjectID = worldObjectID;
+  }
+  return physObjectID;
+}
+
+void PhysicsWorldBatch::removeObject(int physObjectID) {
+  for (World& world : worlds_) {
+    world.physicsManager->removeObject(physObjectID);
+  }
+}
+
+void PhysicsWorldBatch::stepPhysics(double dt) {
+  forEachWorld([&](int worldIndex) {
+    worlds_[worldIndex].physicsManager->stepPhysics(dt);
+  });
+}
+
+void PhysicsWorldBatch::getRigidStates(
+    const std::vector<int>& physObjectIDs,
+    Corrade::Containers::ArrayView<float> states,
+    bool includeVelocities) const {
+  const std::size_t stride =
+      includeVelocities
+          ? std::size_t{PhysicsManager::RIGID_STATE_WITH_VELOCITIES_SIZE}
+          : std::size_t{PhysicsManager::RIGID_STATE_SIZE};
+  const std::size_t worldSize = physObjectIDs.size() * stride;
+  CHECK_EQ(states.size(), worlds_.size() * worldSize);
+  forEachWorld([&](int worldIndex) {
+    worlds_[worldIndex].physicsManager->getRigidStates(
+        physObjectIDs,
+        states.slice(worldIndex * worldSize, (worldIndex + 1) * worldSize),
+        includeVelocities);
+  });
+}
+
+void PhysicsWorldBatch::setRigidStates(
+    const std::vector<int>& physObjectIDs,
+    Corrade::Containers::ArrayView<const float> states,
+    bool includeVelocities) {
+  const std::size_t stride =
+      includeVelocities
+          ? std::size_t{PhysicsManager::RIGID_STATE_WITH_VELOCITIES_SIZE}
+          : std::size_t{PhysicsManager::RIGID_STATE_SIZE};
+  const std::size_t worldSize = physObjectIDs.size() * stride;
+  CHECK_EQ(states.size(), worlds_.size() * worldSize);
+  forEachWorld([&](int worldIndex) {
+    worlds_[worldIndex].physicsManager->setRigidStates(
+        physObjectIDs,
+        states.slice(worldIndex * worldSize, (worldIndex + 1) * worldSize),
+        includeVelocities);
+  });
+}
+
+void PhysicsWorldBatch::forEachWorld(
+    const std::function<void(int)>& task) const {
+  pool_->run(worlds_.size(), task);
+}
+
+}  // namespace physics
+}  // namespace esp
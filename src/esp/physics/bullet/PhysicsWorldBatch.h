@@ -0,0 +1,149 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_PHYSICSWORLDBATCH_H_
+#define ESP_PHYSICS_BULLET_PHYSICSWORLDBATCH_H_
+
+/** @file
+ * @brief Class @ref esp::physics::PhysicsWorldBatch
+ */
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/ArrayView.h>
+
+#include "BulletPhysicsManager.h"
+#include "esp/scene/SceneGraph.h"
+
+namespace esp {
+namespace physics {
+
+class WorkerPool;
+
+/**
+@brief Independent Bullet physics worlds over the same stage, stepped
+concurrently.
+
+Meant for physics-only rollouts using all cores of a machine from a single
+process. Each world is a @ref BulletPhysicsManager with its own scene graph and
+no drawables. The stage collision shapes of a source manager are shared
+read-only by all worlds, so the stage is loaded and its BVH built only once.
+Likewise, the worlds use the object collision shape cache of the source
+manager. Objects are added to and removed from all worlds at once and have the
+same ID in each.
+
+@ref stepPhysics and the bulk state accessors spread the worlds over threads
+kept alive for the lifetime of the batch. Threads claim worlds one at a time
+from a shared counter, so a thread done with a cheap world takes over the
+remaining worlds instead of waiting on a busy one. Worlds must not be accessed
+through @ref getWorld while these run.
+*/
+class PhysicsWorldBatch {
+ public:
+  /**
+   * @brief Constructor
+   * @param resourceManager Holds the assets of the stage and of the objects
+   * to add. Must outlive the batch.
+   * @param stageSource Manager with the stage added, providing the stage, its
+   * collision shapes, the physics parameters and the gravity of all worlds.
+   * Must outlive the batch.
+   * @param numWorlds Number of worlds.
+   * @param numThreads Number of threads stepping the worlds, including the
+   * calling one. 0 for the hardware concurrency. Never more than the number
+   * of worlds.
+   */
+  PhysicsWorldBatch(assets::ResourceManager& resourceManager,
+                    const BulletPhysicsManager& stageSource,
+                    int numWorlds,
+                    int numThreads = 0);
+
+  ~PhysicsWorldBatch();
+
+  /** @brief Number of worlds */
+  int getNumWorlds() const { return worlds_.size(); }
+
+  /** @brief Number of threads stepping the worlds, including the calling one
+   */
+  int getNumThreads() const;
+
+  /**
+   * @brief One of the worlds, for everything not covered by the batch
+   * interface.
+   */
+  BulletPhysicsManager& getWorld(int worldIndex) {
+    return *worlds_[worldIndex].physicsManager;
+  }
+
+  //! @overload
+  const BulletPhysicsManager& getWorld(int worldIndex) const {
+    return *worlds_[worldIndex].physicsManager;
+  }
+
+  /**
+   * @brief Add an object to every world. See @ref
+   * PhysicsManager::addObject.
+   * @param configFile The handle of the object template.
+   * @return The object's ID, the same in every world, or @ref
+   * esp::ID_UNDEFINED if it couldn't be added. The object is then not added
+   * to any world.
+   */
+  int addObject(const std::string& configFile);
+
+  /**
+   * @brief Remove an object from every world. See @ref
+   * PhysicsManager::removeObject.
+   */
+  void removeObject(int physObjectID);
+
+  /**
+   * @brief Step all worlds forward in time concurrently. See @ref
+   * BulletPhysicsManager::stepPhysics.
+   */
+  void stepPhysics(double dt);
+
+  /**
+   * @brief Get the states of several objects in every world at once. See @ref
+   * PhysicsManager::getRigidStates.
+   * @param physObjectIDs The object IDs.
+   * @param[out] states Receives the states of the objects in the first world,
+   * followed by those in the second world etc.
+   * @param includeVelocities Whether to also get the linear and angular
+   * velocities.
+   */
+  void getRigidStates(const std::vector<int>& physObjectIDs,
+                      Corrade::Containers::ArrayView<float> states,
+                      bool includeVelocities = false) const;
+
+  /**
+   * @brief Set the states of several objects in every world at once, laid
+   * out as in @ref getRigidStates. See @ref PhysicsManager::setRigidStates.
+   */
+  void setRigidStates(const std::vector<int>& physObjectIDs,
+                      Corrade::Containers::ArrayView<const float> states,
+                      bool includeVelocities = false);
+
+  ESP_SMART_POINTERS(PhysicsWorldBatch)
+
+ private:
+  struct World {
+    std::unique_ptr<scene::SceneGraph> sceneGraph;
+    //! Declared after the scene graph holding its nodes, so destroyed first
+    std::unique_ptr<BulletPhysicsManager> physicsManager;
+  };
+
+  //! Run the task for every world index on the worker threads and the
+  //! calling thread, returning once all are done
+  void forEachWorld(const std::function<void(int)>& task) const;
+
+  std::vector<World> worlds_;
+  std::unique_ptr<WorkerPool> pool_;
+};
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_PHYSICSWORLDBATCH_H_
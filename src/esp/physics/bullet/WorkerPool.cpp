@@ -0,0 +1,79 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include "WorkerPool.h"
+
+namespace esp {
+namespace physics {
+
+WorkerPool::WorkerPool(std::size_t numWorkers) {
+  for (std::size_t i = 0; i != numWorkers; ++i) {
+    workers_.emplace_back([this] { workerLoop(); });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  taskReady_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void WorkerPool::run(int numTasks, const std::function<void(int)>& task) {
+  if (workers_.empty() || numTasks <= 1) {
+    for (int i = 0; i != numTasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    task_ = &task;
+    numTasks_ = numTasks;
+    nextTask_ = 0;
+    busyWorkers_ = workers_.size();
+    ++generation_;
+  }
+  taskReady_.notify_all();
+  runTasks();
+
+  std::unique_lock<std::mutex> lock{mutex_};
+  taskDone_.wait(lock, [this] { return busyWorkers_ == 0; });
+  task_ = nullptr;
+}  // WorkerPool::run
+
+void WorkerPool::runTasks() {
+  for (int i = nextTask_++; i < numTasks_; i = nextTask_++) {
+    (*task_)(i);
+  }
+}
+
+void WorkerPool::workerLoop() {
+  std::uint64_t seenGeneration = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      taskReady_.wait(
+          lock, [&] { return stopping_ || generation_ != seenGeneration; });
+      if (stopping_) {
+        return;
+      }
+      seenGeneration = generation_;
+    }
+    // task_ and numTasks_ don't change until all workers reported back
+    runTasks();
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      --busyWorkers_;
+    }
+    taskDone_.notify_one();
+  }
+}  // WorkerPool::workerLoop
+
+}  // namespace physics
+}  // namespace esp
@@ -0,0 +1,80 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_PHYSICS_BULLET_WORKERPOOL_H_
+#define ESP_PHYSICS_BULLET_WORKERPOOL_H_
+
+/** @file
+ * @brief Class @ref esp::physics::WorkerPool
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "esp/core/esp.h"
+
+namespace esp {
+namespace physics {
+
+/**
+ * @brief Threads running a task for a range of indices on request, kept alive
+ * between requests since stepping a world or casting a batch of rays takes
+ * less time than starting a thread.
+ *
+ * The calling thread works on the tasks too. Tasks are claimed one at a time
+ * from a shared counter, so a thread done with a cheap task takes over the
+ * remaining ones instead of waiting on a busy one. Not meant to be used from
+ * several threads at once.
+ */
+class WorkerPool {
+ public:
+  /**
+   * @brief Constructor
+   * @param numWorkers Number of threads to start in addition to the calling
+   * one.
+   */
+  explicit WorkerPool(std::size_t numWorkers);
+
+  /** @brief Destructor. Stops and joins the worker threads. */
+  ~WorkerPool();
+
+  /** @brief Number of threads started in addition to the calling one */
+  std::size_t getNumWorkers() const { return workers_.size(); }
+
+  /**
+   * @brief Run the task for every index in [0, numTasks) on the worker
+   * threads and the calling thread, returning once all are done.
+   */
+  void run(int numTasks, const std::function<void(int)>& task);
+
+  ESP_SMART_POINTERS(WorkerPool)
+
+ private:
+  //! Claim and run tasks until none are left
+  void runTasks();
+
+  void workerLoop();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable taskReady_;
+  std::condition_variable taskDone_;
+  const std::function<void(int)>* task_ = nullptr;
+  int numTasks_ = 0;
+  std::atomic<int> nextTask_{0};
+  std::size_t busyWorkers_ = 0;
+  std::uint64_t generation_ = 0;
+  bool stopping_ = false;
+};
+
+}  // namespace physics
+}  // namespace esp
+
+#endif  // ESP_PHYSICS_BULLET_WORKERPOOL_H_
@@ -10,6 +10,29 @@ namespace Mn = Magnum;
 namespace esp {
 namespace scene {
 
+/**
+ * @brief Gets the absolute transformation of its node whenever the node gets
+ * cleaned
+ */
+class SceneNode::AbsoluteTransformationCache
+    : public Mn::SceneGraph::AbstractFeature3D {
+ public:
+  explicit AbsoluteTransformationCache(SceneNode& node)
+      : Mn::SceneGraph::AbstractFeature3D{node},
+        absoluteTransformation{node.absoluteTransformationMatrix()} {
+    setCachedTransformations(Mn::SceneGraph::CachedTransformation::Absolute);
+  }
+
+  void clean(const Mn::Matrix4& absoluteTransformationMatrix) override {
+    absoluteTransformation = absoluteTransformationMatrix;
+    ++version;
+  }
+
+  Mn::Matrix4 absoluteTransformation;
+  //! 0 is reserved for nodes without cache
+  std::uint64_t version = 1;
+};
+
 SceneNode::SceneNode(SceneNode& parent) {
   setParent(&parent);
   setId(parent.getId());
@@ -26,6 +49,20 @@ SceneNode& SceneNode::createChild() {
   return *node;
 }
 
+const Mn::Matrix4& SceneNode::cachedAbsoluteTransformation() {
+  if (!absoluteTransformationCache_) {
+    absoluteTransformationCache_ = new AbsoluteTransformationCache{*this};
+  }
+  // no-op if clean
+  setClean();
+  return absoluteTransformationCache_->absoluteTransformation;
+}
+
+std::uint64_t SceneNode::getAbsoluteTransformationVersion() const {
+  return absoluteTransformationCache_ ? absoluteTransformationCache_->version
+                                      : 0;
+}
+
 //! @brief recursively compute the cumulative bounding box of this node's tree.
 const Mn::Range3D& SceneNode::computeCumulativeBB() {
   // first copy from your precomputed mesh bb
@@ -5,6 +5,7 @@
 #ifndef ESP_SCENE_SCENENODE_H_
 #define ESP_SCENE_SCENENODE_H_
 
+#include <cstdint>
 #include <stack>
 
 #include <Corrade/Containers/Containers.h>
@@ -73,6 +74,26 @@ class SceneNode : public MagnumObject {
     return this->absoluteTransformation().translation();
   }
 
+  /**
+   * @brief Absolute transformation, recomputed only if this node or one of
+   * its parents got transformed since the last call.
+   *
+   * Relies on Magnum's dirty flags, see @ref
+   * Magnum::SceneGraph::Object::setClean(), which also cleans the dirty
+   * parents. Reading many nodes after a few of them moved thus only touches
+   * the moved ones.
+   */
+  const Magnum::Matrix4& cachedAbsoluteTransformation();
+
+  /**
+   * @brief Number of times @ref cachedAbsoluteTransformation got recomputed.
+   *
+   * Other users of the dirty flags may clean the node too, so a clean node
+   * alone doesn't mean its absolute transformation is the same as when last
+   * read. Comparing this version does.
+   */
+  std::uint64_t getAbsoluteTransformationVersion() const;
+
   //! recursively compute the cumulative bounding box of the full scene graph
   //! tree for which this node is the root
   const Magnum::Range3D& computeCumulativeBB();
@@ -132,6 +153,13 @@ class SceneNode : public MagnumObject {
 
   //! the frustum plane in last frame that culls this node
   int frustumPlaneIndex = 0;
+
+ private:
+  class AbsoluteTransformationCache;
+
+  //! Feature keeping the cached absolute transformation, owned by this node
+  //! like any feature. Created on first use, as most nodes never need it.
+  AbsoluteTransformationCache* absoluteTransformationCache_ = nullptr;
 };
 
 // Traversal Helpers
@@ -149,6 +149,8 @@ bool CameraSensor::drawObservation(sim::Simulator& sim) {
   gfx::RenderCamera::Flags flags;
   if (sim.isFrustumCullingEnabled())
     flags |= gfx::RenderCamera::Flag::FrustumCulling;
+  if (sim.isInstancingEnabled())
+    flags |= gfx::RenderCamera::Flag::Instancing;
 
   gfx::Renderer::ptr renderer = sim.getRenderer();
   if (spec_->sensorType == SensorType::Semantic) {
@@ -4,6 +4,7 @@
 
 #include "Simulator.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -73,6 +74,7 @@ void Simulator::close() {
   config_ = SimulatorConfiguration{};
 
   frustumCulling_ = true;
+  instancing_ = false;
   requiresTextures_ = Cr::Containers::NullOpt;
 }
 
@@ -104,6 +106,7 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
   // otherwise set current configuration and initialize
   // TODO can optimize to do partial re-initialization instead of from-scratch
   config_ = cfg;
+  instancing_ = config_.enableInstancing;
 
   if (requiresTextures_ == Cr::Containers::NullOpt) {
     requiresTextures_ = config_.requiresTextures;
@@ -117,6 +120,18 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
                     "initialized with True.  Call close() to change this.";
   }
 
+  resourceManager_->setUseSharedAssetCache(config_.enableSharedAssetCache);
+  if (config_.enableSharedAssetCache) {
+    assets::AssetCache::instance().setMemoryBudget(
+        static_cast<std::size_t>(config_.sharedAssetCacheBudgetMB) << 20);
+  }
+  resourceManager_->setTextureResidency(
+      static_cast<std::size_t>(config_.textureMemoryBudgetMB) << 20,
+      config_.maxTextureResolution);
+  resourceManager_->setTranscodedTextureCacheDir(
+      config_.transcodedTextureCacheDir);
+  resourceManager_->setTextureLoadThreadCount(config_.textureLoadThreads);
+
   // use physics attributes manager to get physics manager attributes
   // described by config file - this always exists to configure scene
   // attributes
@@ -195,6 +210,8 @@ void Simulator::reconfigure(const SimulatorConfiguration& cfg) {
     auto& sceneGraph = sceneManager_->getSceneGraph(activeSceneID_);
     auto& rootNode = sceneGraph.getRootNode();
     // auto& drawables = sceneGraph.getDrawables();
+    sceneGraph.getDefaultRenderCamera().setTextureResidencyManager(
+        resourceManager_->getTextureResidencyManager());
 
     bool loadSuccess = false;
 
@@ -510,6 +527,52 @@ void Simulator::setRigidState(const esp::core::RigidState& rigidState,
   }
 }
 
+void Simulator::getRigidStates(const std::vector<int>& objectIDs,
+                               Cr::Containers::ArrayView<float> states,
+                               bool includeVelocities,
+                               const int sceneID) const {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->getRigidStates(objectIDs, states, includeVelocities);
+  } else {
+    // callers such as the python bindings pass uninitialized memory
+    std::fill(states.begin(), states.end(), 0.0f);
+  }
+}
+
+void Simulator::setRigidStates(const std::vector<int>& objectIDs,
+                               Cr::Containers::ArrayView<const float> states,
+                               bool includeVelocities,
+                               const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->setRigidStates(objectIDs, states, includeVelocities);
+  }
+}
+
+std::vector<char> Simulator::savePhysicsState(const int sceneID) const {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->saveState();
+  }
+  return {};
+}
+
+bool Simulator::restorePhysicsState(const std::vector<char>& snapshot,
+                                    const int sceneID) {
+  if (!sceneHasPhysics(sceneID) || !physicsManager_->restoreState(snapshot)) {
+    return false;
+  }
+  // objects added after the snapshot are gone now
+  const std::vector<int> objectIDs = physicsManager_->getExistingObjectIDs();
+  for (auto it = trajVisNameByID.begin(); it != trajVisNameByID.end();) {
+    if (std::binary_search(objectIDs.begin(), objectIDs.end(), it->first)) {
+      ++it;
+    } else {
+      trajVisIDByName.erase(it->second);
+      it = trajVisNameByID.erase(it);
+    }
+  }
+  return true;
+}
+
 // set object translation directly
 void Simulator::setTranslation(const Magnum::Vector3& translation,
                                const int objectID,
@@ -594,6 +657,49 @@ esp::physics::RaycastResults Simulator::castRay(const esp::geo::Ray& ray,
   return esp::physics::RaycastResults();
 }
 
+esp::physics::BatchRaycastResults Simulator::castRays(
+    const std::vector<esp::geo::Ray>& rays,
+    float maxDistance,
+    bool closestOnly,
+    const int sceneID) {
+  esp::physics::BatchRaycastResults results;
+  castRays(rays, results, maxDistance, closestOnly, sceneID);
+  return results;
+}
+
+void Simulator::castRays(const std::vector<esp::geo::Ray>& rays,
+                         esp::physics::BatchRaycastResults& results,
+                         float maxDistance,
+                         bool closestOnly,
+                         const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->castRays(rays, results, maxDistance, closestOnly);
+  } else {
+    // every ray without hits
+    results.reset(rays.size(), 0);
+    results.rayHitOffsets.resize(rays.size() + 1, 0);
+  }
+}
+
+esp::physics::PlacementTestResults Simulator::testPlacements(
+    const std::string& objectTemplateHandle,
+    const std::vector<esp::core::RigidState>& poses,
+    const int sceneID) {
+  esp::physics::PlacementTestResults results;
+  if (sceneHasPhysics(sceneID)) {
+    physicsManager_->testPlacements(objectTemplateHandle, poses, results);
+  } else {
+    results.reset(poses.size());
+  }
+  return results;
+}
+
+bool Simulator::ensurePlacementProbe(const std::string& objectTemplateHandle,
+                                     const int sceneID) {
+  return sceneHasPhysics(sceneID) &&
+         physicsManager_->ensurePlacementProbe(objectTemplateHandle);
+}
+
 void Simulator::setObjectBBDraw(bool drawBB,
                                 const int objectID,
                                 const int sceneID) {
@@ -627,6 +733,13 @@ double Simulator::getWorldTime() {
   return NO_TIME;
 }
 
+std::vector<int> Simulator::getUpdatedObjectIDs(const int sceneID) {
+  if (sceneHasPhysics(sceneID)) {
+    return physicsManager_->getUpdatedObjectIDs();
+  }
+  return std::vector<int>();
+}
+
 void Simulator::setGravity(const Magnum::Vector3& gravity, const int sceneID) {
   if (sceneHasPhysics(sceneID)) {
     physicsManager_->setGravity(gravity);
@@ -75,6 +75,15 @@ class Simulator {
     return gfxReplayMgr_;
   }
 
+  /**
+   * @brief Get the residency statistics of the textures loaded by this
+   * simulator. See @ref SimulatorConfiguration::textureMemoryBudgetMB.
+   */
+  gfx::TextureResidencyManager::Stats getTextureResidencyStats() const {
+    return resourceManager_ ? resourceManager_->getTextureResidencyStats()
+                            : gfx::TextureResidencyManager::Stats{};
+  }
+
   void saveFrame(const std::string& filename);
 
   /**
@@ -384,6 +393,60 @@ class Simulator {
                      int objectID,
                      int sceneID = 0);
 
+  /**
+   * @brief Get the current @ref esp::core::RigidState of several objects at
+   * once, packed into a flat array. See @ref
+   * esp::physics::PhysicsManager::getRigidStates.
+   * @param objectIDs The object IDs and keys identifying the objects in @ref
+   * esp::physics::PhysicsManager::existingObjects_.
+   * @param[out] states Receives the states in the order of the IDs, all
+   * zeros if the scene has no physics.
+   * @param includeVelocities Whether to also get the linear and angular
+   * velocities.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the objects.
+   */
+  void getRigidStates(const std::vector<int>& objectIDs,
+                      Corrade::Containers::ArrayView<float> states,
+                      bool includeVelocities = false,
+                      int sceneID = 0) const;
+
+  /**
+   * @brief Set the @ref esp::core::RigidState of several objects at once
+   * kinematically. See @ref esp::physics::PhysicsManager::setRigidStates.
+   * @param objectIDs The object IDs and keys identifying the objects in @ref
+   * esp::physics::PhysicsManager::existingObjects_.
+   * @param states The states in the order of the IDs.
+   * @param includeVelocities Whether the array also contains the linear and
+   * angular velocities to set.
+   * @param sceneID !! Not used currently !! Specifies which physical scene of
+   * the objects.
+   */
+  void setRigidStates(const std::vector<int>& objectIDs,
+                      Corrade::Containers::ArrayView<const float> states,
+                      bool includeVelocities = false,
+                      int sceneID = 0);
+
+  /**
+   * @brief Save the state of the physical world into a binary snapshot. See
+   * @ref esp::physics::PhysicsManager::saveState.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * save.
+   * @return The snapshot, empty if the scene has no physics.
+   */
+  std::vector<char> savePhysicsState(int sceneID = 0) const;
+
+  /**
+   * @brief Restore the state of the physical world from a snapshot taken with
+   * @ref savePhysicsState. See @ref
+   * esp::physics::PhysicsManager::restoreState.
+   * @param snapshot The snapshot.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * restore.
+   * @return Whether the state was restored.
+   */
+  bool restorePhysicsState(const std::vector<char>& snapshot, int sceneID = 0);
+
   /**
    * @brief Set the 3D position of an object kinematically.
    * See @ref esp::physics::PhysicsManager::setTranslation.
@@ -578,6 +641,77 @@ class Simulator {
                                        float maxDistance = 100.0,
                                        int sceneID = 0);
 
+  /**
+   * @brief Cast a batch of rays into the collision world, in parallel if
+   * supported by the physics implementation. See @ref
+   * esp::physics::PhysicsManager::castRays.
+   *
+   * @param rays The rays to cast. Need not be unit length, but returned hit
+   * distances will be in units of ray length.
+   * @param maxDistance The maximum distance along the ray directions to
+   * search. In units of ray length.
+   * @param closestOnly Whether to return only the closest hit of each ray.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * cast the rays in.
+   * @return The hits of all rays, sorted by distance per ray.
+   */
+  esp::physics::BatchRaycastResults castRays(
+      const std::vector<esp::geo::Ray>& rays,
+      float maxDistance = 100.0,
+      bool closestOnly = false,
+      int sceneID = 0);
+
+  /**
+   * @brief Cast a batch of rays into the collision world into caller-owned
+   * results, reusing their allocations. See @ref castRays(const
+   * std::vector<esp::geo::Ray>&, float, bool, int).
+   *
+   * @param rays The rays to cast.
+   * @param[out] results Receives the hits of all rays, sorted by distance per
+   * ray. Previous contents are discarded.
+   * @param maxDistance The maximum distance along the ray directions to
+   * search. In units of ray length.
+   * @param closestOnly Whether to return only the closest hit of each ray.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * cast the rays in.
+   */
+  void castRays(const std::vector<esp::geo::Ray>& rays,
+                esp::physics::BatchRaycastResults& results,
+                float maxDistance = 100.0,
+                bool closestOnly = false,
+                int sceneID = 0);
+
+  /**
+   * @brief Test whether an object would collide with the collision world at
+   * each of a batch of candidate poses, without adding it. See @ref
+   * esp::physics::PhysicsManager::testPlacements.
+   *
+   * @param objectTemplateHandle The handle of the object template to test.
+   * @param poses The candidate poses of the object.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * test in.
+   * @return One result per pose. No collisions if physics isn't enabled or
+   * the template can't be instantiated.
+   */
+  esp::physics::PlacementTestResults testPlacements(
+      const std::string& objectTemplateHandle,
+      const std::vector<esp::core::RigidState>& poses,
+      int sceneID = 0);
+
+  /**
+   * @brief Prepare @ref testPlacements for an object template, which then
+   * doesn't modify the simulator. See @ref
+   * esp::physics::PhysicsManager::ensurePlacementProbe.
+   *
+   * @param objectTemplateHandle The handle of the object template to test.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * test in.
+   * @return Whether physics is enabled and the template could be
+   * instantiated.
+   */
+  bool ensurePlacementProbe(const std::string& objectTemplateHandle,
+                            int sceneID = 0);
+
   /**
    * @brief the physical world has a notion of time which passes during
    * animation/simulation/action/etc... Step the physical world forward in time
@@ -600,6 +734,15 @@ class Simulator {
    */
   double getWorldTime();
 
+  /**
+   * @brief Get the IDs of the objects moved by the last @ref stepWorld,
+   * skipping sleeping and static objects. See @ref
+   * esp::physics::PhysicsManager::getUpdatedObjectIDs.
+   * @param sceneID !! Not used currently !! Specifies which physical scene to
+   * query.
+   */
+  std::vector<int> getUpdatedObjectIDs(int sceneID = 0);
+
   /**
    * @brief Set the gravity in a physical scene.
    */
@@ -778,6 +921,20 @@ class Simulator {
    */
   bool isFrustumCullingEnabled() { return frustumCulling_; }
 
+  /**
+   * @brief Enable or disable instanced rendering of drawables sharing mesh,
+   * material and lights (disabled by default), see @ref
+   * gfx::RenderCamera::Flag::Instancing
+   * @param val true = enable, false = disable
+   */
+  void setInstancingEnabled(bool val) { instancing_ = val; }
+
+  /**
+   * @brief Get status, whether instanced rendering is enabled or not
+   * @return true if enabled, otherwise false
+   */
+  bool isInstancingEnabled() { return instancing_; }
+
   /**
    * @brief Get a copy of an existing @ref gfx::LightSetup by its key.
    *
@@ -899,6 +1056,8 @@ class Simulator {
   // Currently, we need it defined here, because sensor., e.g., PinholeCamera
   // rquires it when drawing the observation
   bool frustumCulling_ = true;
+  // state indicating instanced rendering is enabled or not
+  bool instancing_ = false;
 
   //! NavMesh visualization variables
   int navMeshVisPrimID_ = esp::ID_UNDEFINED;
@@ -16,12 +16,19 @@ bool operator==(const SimulatorConfiguration& a,
          a.createRenderer == b.createRenderer &&
          a.allowSliding == b.allowSliding &&
          a.frustumCulling == b.frustumCulling &&
+         a.enableInstancing == b.enableInstancing &&
          a.enablePhysics == b.enablePhysics &&
          a.enableGfxReplaySave == b.enableGfxReplaySave &&
          a.loadSemanticMesh == b.loadSemanticMesh &&
          a.forceSeparateSemanticSceneGraph ==
              b.forceSeparateSemanticSceneGraph &&
          a.requiresTextures == b.requiresTextures &&
+         a.enableSharedAssetCache == b.enableSharedAssetCache &&
+         a.sharedAssetCacheBudgetMB == b.sharedAssetCacheBudgetMB &&
+         a.textureMemoryBudgetMB == b.textureMemoryBudgetMB &&
+         a.maxTextureResolution == b.maxTextureResolution &&
+         a.transcodedTextureCacheDir == b.transcodedTextureCacheDir &&
+         a.textureLoadThreads == b.textureLoadThreads &&
          a.sceneDatasetConfigFile.compare(b.sceneDatasetConfigFile) == 0 &&
          a.physicsConfigFile.compare(b.physicsConfigFile) == 0 &&
          a.overrideSceneLightDefaults == b.overrideSceneLightDefaults &&
@@ -28,6 +28,12 @@ struct SimulatorConfiguration {
   bool allowSliding = true;
   // enable or disable the frustum culling
   bool frustumCulling = true;
+  /**
+   * @brief Draw drawables sharing the same mesh, material and lights with a
+   * single instanced draw call. Has no effect if the GPU doesn't support
+   * instancing or rendering happens in software.
+   */
+  bool enableInstancing = false;
   /**
    * @brief This flags specifies whether or not dynamics is supported by the
    * simulation, if a suitable library (i.e. Bullet) has been installed.
@@ -53,6 +59,39 @@ struct SimulatorConfiguration {
    * for RGB rendering
    */
   bool requiresTextures = true;
+  /**
+   * @brief Whether to share loaded mesh, texture and material data with other
+   * simulators in this process through the process-wide asset cache.
+   */
+  bool enableSharedAssetCache = false;
+  /**
+   * @brief Memory budget of the process-wide asset cache in megabytes, 0 for
+   * no limit. Only used if @ref enableSharedAssetCache is set; applies to all
+   * simulators in this process.
+   */
+  int sharedAssetCacheBudgetMB = 0;
+  /**
+   * @brief Memory budget for resident texture data in megabytes, 0 for no
+   * limit. Over budget, the least recently drawn textures are demoted to low
+   * resolution mip levels until they are drawn again.
+   */
+  int textureMemoryBudgetMB = 0;
+  /**
+   * @brief Largest texture dimension uploaded to the GPU, 0 for no limit.
+   * Higher resolution mip levels of textures are not uploaded. Python sets
+   * -1 to the largest color sensor resolution.
+   */
+  int maxTextureResolution = 0;
+  /**
+   * @brief Directory of pre-transcoded texture images, as written by the
+   * datatool `pretranscode_textures` task. Empty to always import textures.
+   */
+  std::string transcodedTextureCacheDir;
+  /**
+   * @brief Number of threads importing and transcoding textures when loading
+   * an asset. 0 for one per CPU core, 1 to import on the calling thread only.
+   */
+  int textureLoadThreads = 1;
   std::string physicsConfigFile = ESP_DEFAULT_PHYSICS_CONFIG_REL_PATH;
 
   /**
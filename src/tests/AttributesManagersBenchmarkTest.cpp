@@ -0,0 +1,148 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Directory.h>
+#include <string>
+#include <vector>
+
+#include "esp/metadata/MetadataMediator.h"
+#include "esp/metadata/attributes/ObjectAttributes.h"
+#include "esp/metadata/managers/ObjectAttributesManager.h"
+
+#include "AttributesManagersTestUtils.h"
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Dir = Cr::Utility::Directory;
+
+using esp::metadata::MetadataMediator;
+using esp::metadata::attributes::ObjectAttributes;
+
+namespace Test {
+namespace {
+
+struct AttributesManagersBenchmarkTest : Cr::TestSuite::Tester {
+  explicit AttributesManagersBenchmarkTest();
+  ~AttributesManagersBenchmarkTest() override;
+  // benchmarks of loading a directory of many object configs
+  void loadObjectConfigsSerial();
+  void loadObjectConfigsParallel();
+  // benchmarks of reading the template values addObject reads, through the
+  // string-keyed interface, as before the values were typed members, and
+  // through the typed getters
+  void readObjectValuesStringKeyed();
+  void readObjectValuesTyped();
+
+  void loadObjectConfigs(int numThreads);
+
+  const std::string configDir_ =
+      Dir::join(DATA_DIR, "test_assets/benchmark_object_configs");
+  std::vector<std::string> configFilenames_;
+  bool configsWritten_ = false;
+  const int numConfigs_ = 2000;
+  // the batch size when running benchmarks
+  const unsigned int iterations_ = 1;
+
+  ObjectAttributes::ptr objectAttributes_ =
+      ObjectAttributes::create("benchmark_object");
+  // the batch size when running the read benchmarks
+  const unsigned int readIterations_ = 10000;
+};
+
+AttributesManagersBenchmarkTest::AttributesManagersBenchmarkTest() {
+  // clang-format off
+  addBenchmarks({&AttributesManagersBenchmarkTest::loadObjectConfigsSerial,
+                 &AttributesManagersBenchmarkTest::loadObjectConfigsParallel,
+                 &AttributesManagersBenchmarkTest::readObjectValuesStringKeyed,
+                 &AttributesManagersBenchmarkTest::readObjectValuesTyped},
+                5);
+  // clang-format on
+
+  const std::string renderAsset =
+      Dir::join(DATA_DIR, "test_assets/objects/transform_box.glb");
+  configsWritten_ = writeObjectConfigs(configDir_, renderAsset, numConfigs_,
+                                       -1, configFilenames_);
+
+  objectAttributes_->setRenderAssetHandle(renderAsset);
+  objectAttributes_->setCollisionAssetHandle(renderAsset);
+  objectAttributes_->setScale({1, 2, 3});
+  objectAttributes_->setMass(2.0);
+  objectAttributes_->setInertia({0.1, 0.2, 0.3});
+  objectAttributes_->setCOM({0, 0.5, 0});
+  objectAttributes_->setFrictionCoefficient(0.5);
+  objectAttributes_->setRestitutionCoefficient(0.1);
+  objectAttributes_->setLinearDamping(0.2);
+  objectAttributes_->setAngularDamping(0.3);
+  objectAttributes_->setMargin(0.04);
+}
+
+AttributesManagersBenchmarkTest::~AttributesManagersBenchmarkTest() {
+  for (const auto& filename : configFilenames_) {
+    Dir::rm(filename);
+  }
+  Dir::rm(configDir_);
+}
+
+void AttributesManagersBenchmarkTest::loadObjectConfigs(int numThreads) {
+  CORRADE_VERIFY(configsWritten_);
+  std::vector<int> ids;
+  CORRADE_BENCHMARK(iterations_) {
+    auto MM = MetadataMediator::create();
+    auto mgr = MM->getObjectAttributesManager();
+    mgr->setNumConfigLoadThreads(numThreads);
+    ids = mgr->loadAllConfigsFromPath(configDir_);
+  }
+  CORRADE_COMPARE(ids.size(), numConfigs_);
+}
+
+void AttributesManagersBenchmarkTest::loadObjectConfigsSerial() {
+  loadObjectConfigs(1);
+}
+
+void AttributesManagersBenchmarkTest::loadObjectConfigsParallel() {
+  loadObjectConfigs(8);
+}
+
+void AttributesManagersBenchmarkTest::readObjectValuesStringKeyed() {
+  const ObjectAttributes& attribs = *objectAttributes_;
+  std::size_t length = 0;
+  double sum = 0.0;
+  CORRADE_BENCHMARK(readIterations_) {
+    length += attribs.getString("handle").size() +
+              attribs.getString("render_asset").size() +
+              attribs.getString("collision_asset").size();
+    sum += attribs.getVec3("scale").x() + attribs.getDouble("mass") +
+           attribs.getVec3("inertia").y() + attribs.getVec3("COM").y() +
+           attribs.getDouble("friction_coefficient") +
+           attribs.getDouble("restitution_coefficient") +
+           attribs.getDouble("linear_damping") +
+           attribs.getDouble("angular_damping") + attribs.getDouble("margin");
+  }
+  CORRADE_VERIFY(length > 0);
+  CORRADE_VERIFY(sum > 0.0);
+}
+
+void AttributesManagersBenchmarkTest::readObjectValuesTyped() {
+  const ObjectAttributes& attribs = *objectAttributes_;
+  std::size_t length = 0;
+  double sum = 0.0;
+  CORRADE_BENCHMARK(readIterations_) {
+    length += attribs.getHandle().size() +
+              attribs.getRenderAssetHandle().size() +
+              attribs.getCollisionAssetHandle().size();
+    sum += attribs.getScale().x() + attribs.getMass() +
+           attribs.getInertia().y() + attribs.getCOM().y() +
+           attribs.getFrictionCoefficient() +
+           attribs.getRestitutionCoefficient() + attribs.getLinearDamping() +
+           attribs.getAngularDamping() + attribs.getMargin();
+  }
+  CORRADE_VERIFY(length > 0);
+  CORRADE_VERIFY(sum > 0.0);
+}
+
+}  // namespace
+}  // namespace Test
+
+CORRADE_TEST_MAIN(Test::AttributesManagersBenchmarkTest)
@@ -3,7 +3,9 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <string>
+#include <thread>
 
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/metadata/managers/AssetAttributesManager.h"
@@ -14,6 +16,7 @@
 
 #include "esp/physics/RigidBase.h"
 
+#include "AttributesManagersTestUtils.h"
 #include "configure.h"
 
 namespace Cr = Corrade;
@@ -895,3 +898,224 @@ TEST_F(AttributesManagersTest, PrimitiveAssetAttributesTest) {
         dfltUVSphereAttribs, "segments", legalModValWF, &illegalModValWF);
   }
 }  // AttributesManagersTest::AsssetAttributesManagerGetAndModify test
+
+/**
+ * @brief Load a generated directory of many object configs, parsing on a
+ * single thread and on several, and verify both register the same templates
+ * in the same order. See AttributesManagersBenchmarkTest for load times.
+ */
+TEST_F(AttributesManagersTest, ObjectAttributesParallelLoadFromPath) {
+  LOG(INFO) << "Starting "
+               "AttributesManagersTest::ObjectAttributesParallelLoadFromPath";
+  namespace Dir = Cr::Utility::Directory;
+  const std::string configDir =
+      Dir::join(DATA_DIR, "test_assets/generated_object_configs");
+  const std::string renderAsset =
+      Dir::join(DATA_DIR, "test_assets/objects/transform_box.glb");
+  constexpr int numConfigs = 2000;
+  constexpr int brokenConfig = 1234;
+  std::vector<std::string> configFilenames;
+  ASSERT_TRUE(writeObjectConfigs(configDir, renderAsset, numConfigs,
+                                 brokenConfig, configFilenames));
+
+  auto loadWithThreads = [&](int numThreads, std::vector<int>& ids) {
+    auto MM = MetadataMediator::create();
+    auto mgr = MM->getObjectAttributesManager();
+    mgr->setNumConfigLoadThreads(numThreads);
+    ids = mgr->loadAllConfigsFromPath(configDir);
+    std::vector<std::string> handles;
+    for (const int id : ids) {
+      handles.push_back(
+          id == ID_UNDEFINED ? "" : mgr->getObjectByID(id)->getHandle());
+    }
+    return handles;
+  };
+
+  std::vector<int> serialIds, parallelIds;
+  const auto serialHandles = loadWithThreads(1, serialIds);
+  const auto parallelHandles = loadWithThreads(8, parallelIds);
+
+  ASSERT_EQ(serialIds.size(), numConfigs);
+  EXPECT_EQ(serialIds, parallelIds);
+  EXPECT_EQ(serialHandles, parallelHandles);
+  for (int i = 0; i < numConfigs; ++i) {
+    if (i == brokenConfig) {
+      EXPECT_EQ(serialIds[i], ID_UNDEFINED);
+    } else {
+      // registered in the order of the sorted directory listing
+      EXPECT_EQ(serialHandles[i], configFilenames[i]);
+    }
+  }
+
+  for (const auto& filename : configFilenames) {
+    Dir::rm(filename);
+  }
+  Dir::rm(configDir);
+}  // AttributesManagersTest::ObjectAttributesParallelLoadFromPath
+
+/**
+ * @brief Verify typed getters and setters of hot attributes values stay in
+ * sync with the string-keyed interface. See AttributesManagersBenchmarkTest
+ * for how much faster typed reads are than string-keyed ones.
+ */
+TEST_F(AttributesManagersTest, AttributesTypedValues) {
+  LOG(INFO) << "Starting AttributesManagersTest::AttributesTypedValues";
+  auto objAttr = ObjectAttributes::create("typed_values_test");
+
+  // typed setters update the string-keyed values
+  objAttr->setMass(3.5);
+  objAttr->setScale({1, 2, 3});
+  objAttr->setRenderAssetHandle("typed.glb");
+  ASSERT_EQ(objAttr->getDouble("mass"), 3.5);
+  ASSERT_EQ(objAttr->getVec3("scale"), Magnum::Vector3(1, 2, 3));
+  ASSERT_EQ(objAttr->getString("render_asset"), "typed.glb");
+
+  // string-keyed setters update the typed values
+  objAttr->setDouble("mass", 7.0);
+  objAttr->setVec3("inertia", {4, 5, 6});
+  objAttr->setString("handle", "renamed");
+  objAttr->setInt("semantic_id", 9);
+  ASSERT_EQ(objAttr->getMass(), 7.0);
+  ASSERT_EQ(objAttr->getInertia(), Magnum::Vector3(4, 5, 6));
+  ASSERT_EQ(objAttr->getHandle(), "renamed");
+  ASSERT_EQ(objAttr->getSemanticId(), 9u);
+  objAttr->removeValue("mass");
+  ASSERT_EQ(objAttr->getMass(), 0.0);
+
+  // as do copies and replacing all values
+  auto copy = ObjectAttributes::create(*objAttr);
+  ASSERT_EQ(copy->getInertia(), Magnum::Vector3(4, 5, 6));
+  auto restored = ObjectAttributes::create();
+  restored->setConfigGroup(objAttr->getConfigGroup());
+  ASSERT_EQ(restored->getInertia(), Magnum::Vector3(4, 5, 6));
+  ASSERT_EQ(restored->getHandle(), "renamed");
+  ASSERT_EQ(restored->getScale(), Magnum::Vector3(1, 2, 3));
+}  // AttributesManagersTest::AttributesTypedValues
+
+/**
+ * @brief Read templates through snapshots from several threads while
+ * templates get registered and removed, and verify every snapshot is
+ * consistent and unaffected by later changes.
+ */
+TEST_F(AttributesManagersTest, ObjectAttributesConcurrentSnapshots) {
+  LOG(INFO)
+      << "Starting AttributesManagersTest::ObjectAttributesConcurrentSnapshots";
+  auto mgr = objectAttributesManager_;
+  const std::vector<std::string> origHandles =
+      mgr->getObjectHandlesBySubstring();
+  ASSERT_FALSE(origHandles.empty());
+  auto tmplt = mgr->getObjectCopyByHandle(origHandles[0]);
+  const auto before = mgr->getSnapshot();
+
+  const std::string prefix = "concurrent_snapshot_";
+  constexpr int numToAdd = 500;
+  std::atomic<bool> done{false};
+  std::atomic<int> numFailures{0};
+  std::atomic<int> numSnapshots{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        const auto snapshot = mgr->getSnapshot();
+        for (const std::string& handle : snapshot.getObjectHandles()) {
+          auto obj = snapshot.getObjectByHandle(handle);
+          if (obj == nullptr || obj->getHandle() != handle ||
+              snapshot.getObjectByID(obj->getID()) != obj) {
+            ++numFailures;
+          }
+        }
+        ++numSnapshots;
+      }
+    });
+  }
+
+  int numAdded = 0;
+  for (int i = 0; i < numToAdd; ++i) {
+    numAdded +=
+        mgr->registerObject(tmplt, prefix + std::to_string(i)) != -1 ? 1 : 0;
+  }
+  const auto afterAdding = mgr->getSnapshot();
+  const auto removed = mgr->removeObjectsBySubstring(prefix, true);
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  LOG(INFO) << "Readers went through " << numSnapshots << " snapshots";
+
+  EXPECT_EQ(numAdded, numToAdd);
+  EXPECT_EQ(removed.size(), std::size_t(numToAdd));
+  EXPECT_EQ(numFailures, 0);
+  // snapshots keep the library as it was when taken
+  EXPECT_EQ(before.getNumObjects(), int(origHandles.size()));
+  EXPECT_FALSE(before.getObjectLibHasHandle(prefix + "0"));
+  EXPECT_EQ(afterAdding.getNumObjects(), int(origHandles.size()) + numToAdd);
+  EXPECT_NE(afterAdding.getObjectByHandle(prefix + "0"), nullptr);
+  const auto afterRemoving = mgr->getSnapshot();
+  EXPECT_EQ(afterRemoving.getObjectHandles(), origHandles);
+}  // AttributesManagersTest::ObjectAttributesConcurrentSnapshots
+
+/**
+ * @brief Re-register a dirty template, as done before instantiating its
+ * assets, while snapshots of the library are read from several threads, and
+ * verify the instance held by those snapshots is never modified.
+ */
+TEST_F(AttributesManagersTest, ObjectAttributesReregisterDirtyConcurrently) {
+  LOG(INFO) << "Starting "
+               "AttributesManagersTest::"
+               "ObjectAttributesReregisterDirtyConcurrently";
+  auto mgr = objectAttributesManager_;
+  const std::vector<std::string> origHandles =
+      mgr->getObjectHandlesBySubstring();
+  ASSERT_FALSE(origHandles.empty());
+  const std::string handle = origHandles[0];
+
+  // dirty the library's instance before any snapshot reader starts
+  auto dirtyTmplt = mgr->getObjectByHandle(handle);
+  dirtyTmplt->setRenderAssetHandle(dirtyTmplt->getRenderAssetHandle());
+  ASSERT_TRUE(dirtyTmplt->getIsDirty());
+  const int origID = dirtyTmplt->getID();
+  const auto before = mgr->getSnapshot();
+
+  std::atomic<bool> done{false};
+  std::atomic<int> numFailures{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      while (!done) {
+        auto obj = mgr->getSnapshot().getObjectByHandle(handle);
+        if (obj == nullptr || obj->getHandle() != handle ||
+            obj->getID() != origID) {
+          ++numFailures;
+        }
+        // the dirty instance stays as it was
+        if (obj == dirtyTmplt && !obj->getIsDirty()) {
+          ++numFailures;
+        }
+      }
+    });
+  }
+
+  constexpr int numReregistrations = 200;
+  int numRegistered = 0;
+  for (int i = 0; i < numReregistrations; ++i) {
+    numRegistered += mgr->registerObject(mgr->getObjectByHandle(handle),
+                                         handle) == origID
+                         ? 1
+                         : 0;
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(numRegistered, numReregistrations);
+  EXPECT_EQ(numFailures, 0);
+  // the snapshot still holds the untouched dirty instance, the library a
+  // clean copy under the same handle and ID
+  EXPECT_EQ(before.getObjectByHandle(handle), dirtyTmplt);
+  EXPECT_TRUE(dirtyTmplt->getIsDirty());
+  auto registered = mgr->getObjectByHandle(handle);
+  EXPECT_NE(registered, dirtyTmplt);
+  EXPECT_FALSE(registered->getIsDirty());
+  EXPECT_EQ(registered->getID(), origID);
+}  // AttributesManagersTest::ObjectAttributesReregisterDirtyConcurrently
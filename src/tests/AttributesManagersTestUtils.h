@@ -0,0 +1,59 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_TESTS_ATTRIBUTESMANAGERSTESTUTILS_H_
+#define ESP_TESTS_ATTRIBUTESMANAGERSTESTUTILS_H_
+
+/** @file
+ * @brief Object configs shared by AttributesManagersTest and
+ * AttributesManagersBenchmarkTest
+ */
+
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/Directory.h>
+
+/**
+ * @brief Write @p numConfigs object configs referencing @p renderAsset into
+ * @p configDir, named so the directory listing keeps their order.
+ *
+ * @param brokenConfig Index of a config written as malformed JSON, or -1 for
+ * none.
+ * @param[out] filenames The written files, in order. Also holds the files
+ * written before a failure, so they can be removed.
+ * @return Whether the directory and all configs were written.
+ */
+inline bool writeObjectConfigs(const std::string& configDir,
+                               const std::string& renderAsset,
+                               int numConfigs,
+                               int brokenConfig,
+                               std::vector<std::string>& filenames) {
+  namespace Dir = Corrade::Utility::Directory;
+  if (!Dir::mkpath(configDir)) {
+    return false;
+  }
+  for (int i = 0; i < numConfigs; ++i) {
+    std::string name = std::to_string(i);
+    name = std::string(5 - name.size(), '0') + name;
+    const std::string filename =
+        Dir::join(configDir, "obj_" + name + ".object_config.json");
+    std::string json;
+    if (i == brokenConfig) {
+      json = "{ \"render_asset\": ";
+    } else {
+      json = "{\n  \"render_asset\": \"" + renderAsset +
+             "\",\n  \"mass\": " + std::to_string(i + 1) +
+             ",\n  \"scale\": [1, 1, 1],\n  \"friction_coefficient\": 0.5"
+             "\n}\n";
+    }
+    if (!Dir::writeString(filename, json)) {
+      return false;
+    }
+    filenames.push_back(filename);
+  }
+  return true;
+}
+
+#endif  // ESP_TESTS_ATTRIBUTESMANAGERSTESTUTILS_H_
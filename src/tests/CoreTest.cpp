@@ -3,11 +3,18 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Corrade/Utility/String.h>
 
 #include "esp/core/Configuration.h"
+#include "esp/core/HandleIndex.h"
 #include "esp/core/esp.h"
 
 using namespace esp::core;
+namespace Cr = Corrade;
 
 TEST(CoreTest, ConfigurationTest) {
   Configuration cfg;
@@ -18,3 +25,64 @@ TEST(CoreTest, ConfigurationTest) {
   EXPECT_EQ(cfg.get<int>("myInt"), 10);
   EXPECT_EQ(cfg.get<std::string>("myString"), "test");
 }
+
+namespace {
+// the matching rule of ManagedContainerBase::getObjectHandlesBySubstring,
+// applied to every handle
+std::vector<int> findByScanning(const std::map<int, std::string>& handles,
+                                const std::string& subStr,
+                                bool contains) {
+  std::vector<int> res;
+  const std::string strToLookFor = Cr::Utility::String::lowercase(subStr);
+  for (const auto& elem : handles) {
+    const std::string key = Cr::Utility::String::lowercase(elem.second);
+    if (subStr.empty()) {
+      res.push_back(elem.first);
+    } else if (key.length() >= strToLookFor.length() &&
+               (key.find(strToLookFor) != std::string::npos) == contains) {
+      res.push_back(elem.first);
+    }
+  }
+  return res;
+}
+}  // namespace
+
+TEST(CoreTest, HandleIndexTest) {
+  HandleIndex index;
+  std::map<int, std::string> handles;
+  const std::vector<std::string> words{"Chair", "table", "mug",  "LAMP",
+                                       "sofa",  "bowl",  "cube", "Sphere"};
+  for (int i = 0; i < 500; ++i) {
+    std::string handle = "data/objects/" + words[i % words.size()] + "_" +
+                         std::to_string(i) + ".object_config.json";
+    handles[i] = handle;
+    index.add(i, handle);
+  }
+  // remove some and reuse a few of the freed IDs with different handles
+  for (int i = 0; i < 500; i += 7) {
+    handles.erase(i);
+    index.remove(i);
+  }
+  for (int i = 0; i < 100; i += 21) {
+    handles[i] = "prim_" + words[i % words.size()];
+    index.add(i, handles[i]);
+  }
+  // replacing a handle under an existing ID
+  handles[1] = "renamed_MUG";
+  index.add(1, handles[1]);
+  EXPECT_EQ(index.size(), handles.size());
+
+  for (const std::string& subStr :
+       {"", "c", "mu", "CHAIR", "sofa_1", "object_config", "_12", "json",
+        "prim_", "not in any handle", "renamed", "data/objects/chair_8"}) {
+    for (bool contains : {true, false}) {
+      EXPECT_EQ(index.find(subStr, contains),
+                findByScanning(handles, subStr, contains))
+          << "subStr " << subStr << ", contains " << contains;
+    }
+  }
+
+  index.clear();
+  EXPECT_EQ(index.size(), 0u);
+  EXPECT_TRUE(index.find("chair", true).empty());
+}
@@ -2,17 +2,21 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 //
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Containers/Optional.h>
 #include <Corrade/TestSuite/Compare/Numeric.h>
 #include <Corrade/TestSuite/Tester.h>
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/GL/SampleQuery.h>
+#include <Magnum/ImageView.h>
 #include <Magnum/Math/Frustum.h>
 #include <Magnum/Math/Intersection.h>
 #include <Magnum/Math/Range.h>
+#include <Magnum/PixelFormat.h>
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/RenderCamera.h"
@@ -272,6 +276,40 @@ void CullingTest::frustumCulling() {
                       FrustumCulling} /* enable frustum culling */);
   target->renderExit();
   CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
+
+  // ============== Test 4 ==================
+  // instancing must not change what gets drawn
+  target->renderEnter();
+  numVisibleObjects = renderCamera.draw(
+      drawables, esp::gfx::RenderCamera::Flag::FrustumCulling |
+                     esp::gfx::RenderCamera::Flag::Instancing);
+  target->renderExit();
+  CORRADE_COMPARE(numVisibleObjects, numVisibleObjectsGroundTruth);
+  if (!esp::gfx::RenderCamera::isInstancingSupported()) {
+    CORRADE_COMPARE(renderCamera.getPreviousNumInstancedBatches(), 0);
+  }
+
+  // ============== Test 5 ==================
+  // instancing must not change the rendered object ids, neither the drawable
+  // ids nor the semantic ones
+  auto renderObjectIds = [&](esp::gfx::RenderCamera::Flags flags) {
+    std::vector<Mn::UnsignedInt> objectIds(frameBufferSize.product());
+    target->renderEnter();
+    renderCamera.draw(drawables, flags);
+    target->renderExit();
+    target->readFrameObjectId(Mn::MutableImageView2D{
+        Mn::PixelFormat::R32UI, frameBufferSize, objectIds});
+    return objectIds;
+  };
+  for (const esp::gfx::RenderCamera::Flags flags :
+       {esp::gfx::RenderCamera::Flags{},
+        esp::gfx::RenderCamera::Flags{
+            esp::gfx::RenderCamera::Flag::UseDrawableIdAsObjectId}}) {
+    const std::vector<Mn::UnsignedInt> regular = renderObjectIds(flags);
+    const std::vector<Mn::UnsignedInt> instanced =
+        renderObjectIds(flags | esp::gfx::RenderCamera::Flag::Instancing);
+    CORRADE_VERIFY(regular == instanced);
+  }
 }
 }  // namespace
 }  // namespace Test
@@ -10,6 +10,7 @@
 #include <Magnum/Math/FunctionsBatch.h>
 #include "esp/core/Utility.h"
 #include "esp/geo/CoordinateFrame.h"
+#include "esp/geo/GeoBatch.h"
 #include "esp/geo/OBB.h"
 #include "esp/geo/geo.h"
 
@@ -48,9 +49,14 @@ struct GeoTest : Cr::TestSuite::Tester {
   void obbConstruction();
   void obbFunctions();
   void coordinateFrame();
+  void obbBatch();
+  void transformedBBs();
   // benchmarks
   void getTransformedBB_standard();
   void getTransformedBB();
+  void getTransformedBBs();
+  void obbDistance();
+  void obbBatchDistance();
 
   std::vector<Mn::Matrix4> xforms_;
   // number of transformations
@@ -59,6 +65,12 @@ struct GeoTest : Cr::TestSuite::Tester {
   const unsigned int iterations_ = 10;
   Mn::Range3D box_{Mn::Vector3{-10.0f, -10.0f, -10.0f},
                    Mn::Vector3{10.0f, 10.0f, 10.0f}};
+
+  // random boxes and query points, e.g. objects and agent positions
+  std::vector<OBB> obbs_;
+  std::vector<float> pointsX_, pointsY_, pointsZ_;
+  const unsigned int numObbs_ = 1000;
+  const unsigned int numPoints_ = 64;
 };
 
 GeoTest::GeoTest() {
@@ -66,9 +78,14 @@ GeoTest::GeoTest() {
   addTests({&GeoTest::aabb,
             &GeoTest::obbConstruction,
             &GeoTest::obbFunctions,
-            &GeoTest::coordinateFrame});
+            &GeoTest::coordinateFrame,
+            &GeoTest::obbBatch,
+            &GeoTest::transformedBBs});
   addBenchmarks({&GeoTest::getTransformedBB_standard,
-                 &GeoTest::getTransformedBB}, 10);
+                 &GeoTest::getTransformedBB,
+                 &GeoTest::getTransformedBBs,
+                 &GeoTest::obbDistance,
+                 &GeoTest::obbBatchDistance}, 10);
   // clang-format on
 
   // Generate N transformations (random positions and orientations)
@@ -84,6 +101,26 @@ GeoTest::GeoTest() {
     xforms_.emplace_back(
         Mn::Matrix4::from(esp::core::randomRotation().toMatrix(), translation));
   }
+
+  // Generate boxes of random sizes and poses, and points around them
+  auto randomFloat = [](float min, float max) {
+    return min + (max - min) * (rand() % 10000) / 10000.0f;
+  };
+  obbs_.reserve(numObbs_);
+  for (unsigned int iObb = 0; iObb < numObbs_; ++iObb) {
+    const vec3f center{randomFloat(-20, 20), randomFloat(-20, 20),
+                       randomFloat(-20, 20)};
+    const vec3f dimensions{randomFloat(0.1f, 8), randomFloat(0.1f, 8),
+                           randomFloat(0.1f, 8)};
+    const Mn::Quaternion rotation = esp::core::randomRotation();
+    obbs_.emplace_back(center, dimensions,
+                       quatf{Eigen::Map<const quatf>(rotation.data())});
+  }
+  for (unsigned int iPoint = 0; iPoint < numPoints_; ++iPoint) {
+    pointsX_.push_back(randomFloat(-25, 25));
+    pointsY_.push_back(randomFloat(-25, 25));
+    pointsZ_.push_back(randomFloat(-25, 25));
+  }
 }
 
 void GeoTest::getTransformedBB_standard() {
@@ -100,6 +137,36 @@ void GeoTest::getTransformedBB() {
   }
 }
 
+void GeoTest::getTransformedBBs() {
+  const std::vector<Mn::Range3D> boxes(xforms_.size(), box_);
+  std::vector<Mn::Range3D> aabbs(xforms_.size());
+  CORRADE_BENCHMARK(iterations_) {
+    esp::geo::getTransformedBBs(boxes.data(), xforms_.data(), xforms_.size(),
+                                aabbs.data());
+  }
+}
+
+void GeoTest::obbDistance() {
+  std::vector<float> distances(numPoints_ * numObbs_);
+  CORRADE_BENCHMARK(iterations_) {
+    for (unsigned int iPoint = 0; iPoint < numPoints_; ++iPoint) {
+      const vec3f point{pointsX_[iPoint], pointsY_[iPoint], pointsZ_[iPoint]};
+      for (unsigned int iObb = 0; iObb < numObbs_; ++iObb) {
+        distances[iPoint * numObbs_ + iObb] = obbs_[iObb].distance(point);
+      }
+    }
+  }
+}
+
+void GeoTest::obbBatchDistance() {
+  const OBBBatch batch{obbs_};
+  std::vector<float> distances(numPoints_ * numObbs_);
+  CORRADE_BENCHMARK(iterations_) {
+    batch.distance(pointsX_.data(), pointsY_.data(), pointsZ_.data(),
+                   numPoints_, distances.data());
+  }
+}
+
 void GeoTest::aabb() {
   // compute aabb for each box using standard method and library method
   // respectively.
@@ -200,6 +267,82 @@ void GeoTest::coordinateFrame() {
   CORRADE_VERIFY(c3 == c4);
 }
 
+void GeoTest::obbBatch() {
+  // odd numbers of boxes, so the last vector of boxes is a partial one
+  for (std::size_t numObbs : {std::size_t{1}, std::size_t{5}, obbs_.size()}) {
+    OBBBatch batch{std::vector<OBB>(obbs_.begin(), obbs_.begin() + numObbs)};
+    CORRADE_COMPARE(batch.size(), numObbs);
+
+    const std::size_t numResults = numPoints_ * numObbs;
+    std::vector<std::uint8_t> contained(numResults);
+    std::vector<float> distances(numResults);
+    std::vector<float> closestX(numResults), closestY(numResults),
+        closestZ(numResults);
+    batch.contains(pointsX_.data(), pointsY_.data(), pointsZ_.data(),
+                   numPoints_, contained.data());
+    batch.distance(pointsX_.data(), pointsY_.data(), pointsZ_.data(),
+                   numPoints_, distances.data());
+    batch.closestPoint(pointsX_.data(), pointsY_.data(), pointsZ_.data(),
+                       numPoints_, closestX.data(), closestY.data(),
+                       closestZ.data());
+
+    for (unsigned int iPoint = 0; iPoint < numPoints_; ++iPoint) {
+      const vec3f point{pointsX_[iPoint], pointsY_[iPoint], pointsZ_[iPoint]};
+      for (std::size_t iObb = 0; iObb < numObbs; ++iObb) {
+        const std::size_t i = iPoint * numObbs + iObb;
+        const OBB& obb = obbs_[iObb];
+        CORRADE_COMPARE(bool(contained[i]), obb.contains(point));
+        CORRADE_COMPARE_WITH(distances[i], obb.distance(point),
+                             Cr::TestSuite::Compare::around(1e-4f));
+        CORRADE_COMPARE_WITH(
+            (Mn::Vector3{closestX[i], closestY[i], closestZ[i]}),
+            Mn::Vector3{obb.closestPoint(point)},
+            Cr::TestSuite::Compare::around(Mn::Vector3{1e-4f}));
+      }
+    }
+  }
+
+  // the known values of obbFunctions(), after replacing a box
+  OBBBatch batch{std::vector<OBB>(3, obbs_[0])};
+  batch.set(1, OBB{vec3f(0, 0, 0), vec3f(20, 2, 10),
+                   quatf::FromTwoVectors(vec3f::UnitY(), vec3f::UnitZ())});
+  const float x[]{0, -20, -10, 5};
+  const float y[]{0, 0, -5, 0};
+  const float z[]{0, 0, 2, 2};
+  float distances[4 * 3];
+  std::uint8_t contained[4 * 3];
+  batch.distance(x, y, z, 4, distances);
+  batch.contains(x, y, z, 4, contained);
+  CORRADE_COMPARE(distances[0 * 3 + 1], 0.0f);
+  CORRADE_COMPARE_AS(distances[1 * 3 + 1], 10, float);
+  CORRADE_COMPARE_AS(distances[2 * 3 + 1], 1, float);
+  CORRADE_VERIFY(contained[0 * 3 + 1]);
+  CORRADE_VERIFY(!contained[3 * 3 + 1]);
+
+  batch.clear();
+  CORRADE_COMPARE(batch.size(), std::size_t{0});
+}
+
+void GeoTest::transformedBBs() {
+  std::vector<Mn::Range3D> boxes;
+  boxes.reserve(xforms_.size());
+  for (std::size_t i = 0; i < xforms_.size(); ++i) {
+    const Mn::Vector3 min{-1.0f - i % 7, -2.0f, -3.0f + i % 5};
+    boxes.emplace_back(min, min + Mn::Vector3{1.0f + i % 3, 4.0f, 6.0f});
+  }
+  std::vector<Mn::Range3D> aabbs(xforms_.size());
+  esp::geo::getTransformedBBs(boxes.data(), xforms_.data(), xforms_.size(),
+                              aabbs.data());
+  for (std::size_t i = 0; i < xforms_.size(); ++i) {
+    const Mn::Range3D expected =
+        esp::geo::getTransformedBB(boxes[i], xforms_[i]);
+    CORRADE_COMPARE_WITH(aabbs[i].min(), expected.min(),
+                         Cr::TestSuite::Compare::around(Mn::Vector3{1e-3f}));
+    CORRADE_COMPARE_WITH(aabbs[i].max(), expected.max(),
+                         Cr::TestSuite::Compare::around(Mn::Vector3{1e-3f}));
+  }
+}
+
 }  // namespace Test
 
 CORRADE_TEST_MAIN(Test::GeoTest)
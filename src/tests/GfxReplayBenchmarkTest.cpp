@@ -0,0 +1,199 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Directory.h>
+#include <string>
+#include <vector>
+
+#include "esp/assets/RenderAssetInstanceCreationInfo.h"
+#include "esp/gfx/replay/BinaryKeyframes.h"
+#include "esp/gfx/replay/Player.h"
+#include "esp/gfx/replay/Recorder.h"
+#include "esp/io/JsonAllTypes.h"
+#include "esp/io/json.h"
+#include "esp/scene/SceneManager.h"
+
+#include "GfxReplayTestUtils.h"
+#include "configure.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::gfx::replay::BinaryKeyframeWriter;
+using esp::gfx::replay::Keyframe;
+using esp::gfx::replay::Recorder;
+using esp::scene::SceneManager;
+using esp::scene::SceneNode;
+
+namespace Test {
+namespace {
+
+struct GfxReplayBenchmarkTest : Cr::TestSuite::Tester {
+  explicit GfxReplayBenchmarkTest();
+  // benchmarks of the JSON and binary keyframe formats
+  void writeJsonKeyframes();
+  void writeBinaryKeyframes();
+  void readJsonKeyframes();
+  void readBinaryKeyframes();
+  // benchmarks of recording many instances, of which few move or get
+  // deleted per keyframe
+  void recordCreatedInstances();
+  void recordMovedInstances();
+  void recordDeletedInstances();
+
+  void writeJson(const std::string& filepath);
+  void writeBinary(const std::string& filepath);
+  std::vector<SceneNode*> createRecordedNodes(SceneManager& sceneManager,
+                                              Recorder& recorder);
+
+  const int numKeyframes_ = 500;
+  std::vector<Keyframe> keyframes_ = createTestKeyframes(numKeyframes_);
+  // the batch size when running benchmarks
+  const unsigned int iterations_ = 1;
+  const std::string jsonFilepath_ =
+      Cr::Utility::Directory::join(DATA_DIR, "./gfx_replay_benchmark.json");
+  const std::string binaryFilepath_ =
+      Cr::Utility::Directory::join(DATA_DIR, "./gfx_replay_benchmark.bin");
+
+  const esp::assets::RenderAssetInstanceCreationInfo recordedCreation_{
+      "box.glb", Cr::Containers::NullOpt,
+      esp::assets::RenderAssetInstanceCreationInfo::Flags{}, ""};
+  const int numRecordedInstances_ = 5000;
+  const int numRecordedKeyframes_ = 20;
+};
+
+GfxReplayBenchmarkTest::GfxReplayBenchmarkTest() {
+  // clang-format off
+  addBenchmarks({&GfxReplayBenchmarkTest::writeJsonKeyframes,
+                 &GfxReplayBenchmarkTest::writeBinaryKeyframes,
+                 &GfxReplayBenchmarkTest::readJsonKeyframes,
+                 &GfxReplayBenchmarkTest::readBinaryKeyframes,
+                 &GfxReplayBenchmarkTest::recordCreatedInstances,
+                 &GfxReplayBenchmarkTest::recordMovedInstances,
+                 &GfxReplayBenchmarkTest::recordDeletedInstances}, 5);
+  // clang-format on
+}
+
+void GfxReplayBenchmarkTest::writeJson(const std::string& filepath) {
+  rapidjson::Document document(rapidjson::kObjectType);
+  esp::io::addMember(document, "keyframes", keyframes_,
+                     document.GetAllocator());
+  CORRADE_VERIFY(esp::io::writeJsonToFile(document, filepath));
+}
+
+void GfxReplayBenchmarkTest::writeBinary(const std::string& filepath) {
+  BinaryKeyframeWriter writer;
+  CORRADE_VERIFY(writer.open(filepath));
+  for (const auto& keyframe : keyframes_) {
+    writer.writeKeyframe(keyframe);
+  }
+}
+
+void GfxReplayBenchmarkTest::writeJsonKeyframes() {
+  CORRADE_BENCHMARK(iterations_) { writeJson(jsonFilepath_); }
+  Cr::Utility::Directory::rm(jsonFilepath_);
+}
+
+void GfxReplayBenchmarkTest::writeBinaryKeyframes() {
+  CORRADE_BENCHMARK(iterations_) { writeBinary(binaryFilepath_); }
+  Cr::Utility::Directory::rm(binaryFilepath_);
+}
+
+void GfxReplayBenchmarkTest::readJsonKeyframes() {
+  writeJson(jsonFilepath_);
+  esp::gfx::replay::Player player(
+      [](const esp::assets::AssetInfo&,
+         const esp::assets::RenderAssetInstanceCreationInfo&) {
+        return nullptr;
+      });
+  CORRADE_BENCHMARK(iterations_) {
+    player.readKeyframesFromFile(jsonFilepath_);
+  }
+  CORRADE_COMPARE(player.getNumKeyframes(), numKeyframes_);
+  Cr::Utility::Directory::rm(jsonFilepath_);
+}
+
+void GfxReplayBenchmarkTest::readBinaryKeyframes() {
+  writeBinary(binaryFilepath_);
+  esp::gfx::replay::Player player(
+      [](const esp::assets::AssetInfo&,
+         const esp::assets::RenderAssetInstanceCreationInfo&) {
+        return nullptr;
+      });
+  CORRADE_BENCHMARK(iterations_) {
+    player.readKeyframesFromFile(binaryFilepath_);
+  }
+  CORRADE_COMPARE(player.getNumKeyframes(), numKeyframes_);
+  Cr::Utility::Directory::rm(binaryFilepath_);
+}
+
+std::vector<SceneNode*> GfxReplayBenchmarkTest::createRecordedNodes(
+    SceneManager& sceneManager,
+    Recorder& recorder) {
+  auto& rootNode =
+      sceneManager.getSceneGraph(sceneManager.initSceneGraph()).getRootNode();
+  std::vector<SceneNode*> nodes;
+  for (int i = 0; i < numRecordedInstances_; ++i) {
+    nodes.push_back(&rootNode.createChild());
+    recorder.onCreateRenderAssetInstance(nodes.back(), recordedCreation_);
+  }
+  recorder.saveKeyframe();
+  return nodes;
+}
+
+void GfxReplayBenchmarkTest::recordCreatedInstances() {
+  SceneManager sceneManager;
+  auto& rootNode =
+      sceneManager.getSceneGraph(sceneManager.initSceneGraph()).getRootNode();
+  Recorder recorder;
+  std::vector<SceneNode*> nodes;
+  for (int i = 0; i < numRecordedInstances_; ++i) {
+    nodes.push_back(&rootNode.createChild());
+  }
+  CORRADE_BENCHMARK(iterations_) {
+    for (SceneNode* node : nodes) {
+      recorder.onCreateRenderAssetInstance(node, recordedCreation_);
+    }
+    recorder.saveKeyframe();
+  }
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes().back().creations.size(),
+                  numRecordedInstances_);
+}
+
+void GfxReplayBenchmarkTest::recordMovedInstances() {
+  SceneManager sceneManager;
+  Recorder recorder;
+  std::vector<SceneNode*> nodes = createRecordedNodes(sceneManager, recorder);
+  CORRADE_BENCHMARK(iterations_) {
+    for (int k = 0; k < numRecordedKeyframes_; ++k) {
+      for (int i = k; i < numRecordedInstances_; i += 100) {
+        nodes[i]->setTranslation(Mn::Vector3(float(k), 0.f, 0.f));
+      }
+      recorder.saveKeyframe();
+    }
+  }
+  const auto& keyframes = recorder.debugGetSavedKeyframes();
+  CORRADE_VERIFY(!keyframes.back().stateUpdates.empty());
+}
+
+void GfxReplayBenchmarkTest::recordDeletedInstances() {
+  SceneManager sceneManager;
+  Recorder recorder;
+  std::vector<SceneNode*> nodes = createRecordedNodes(sceneManager, recorder);
+  CORRADE_BENCHMARK(iterations_) {
+    for (int i = 1; i < numRecordedInstances_; i += 2) {
+      delete nodes[i];
+    }
+    recorder.saveKeyframe();
+  }
+  CORRADE_COMPARE(recorder.debugGetSavedKeyframes().back().deletions.size(),
+                  numRecordedInstances_ / 2);
+}
+
+}  // namespace
+}  // namespace Test
+
+CORRADE_TEST_MAIN(Test::GfxReplayBenchmarkTest)
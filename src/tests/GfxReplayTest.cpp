@@ -2,14 +2,19 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include "GfxReplayTestUtils.h"
 #include "configure.h"
 
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/assets/ResourceManager.h"
 #include "esp/gfx/Renderer.h"
 #include "esp/gfx/WindowlessContext.h"
+#include "esp/gfx/replay/BinaryKeyframes.h"
 #include "esp/gfx/replay/Player.h"
 #include "esp/gfx/replay/Recorder.h"
+#include "esp/io/JsonAllTypes.h"
+#include "esp/io/io.h"
+#include "esp/io/json.h"
 #include "esp/scene/SceneManager.h"
 
 #include <Corrade/Containers/Optional.h>
@@ -18,16 +23,80 @@
 #include <Magnum/Math/Range.h>
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 #include <string>
 
 namespace Cr = Corrade;
 namespace Mn = Magnum;
 
 using esp::assets::ResourceManager;
+using esp::gfx::replay::BinaryKeyframeReader;
+using esp::gfx::replay::BinaryKeyframeWriter;
+using esp::gfx::replay::BinaryTransformPrecision;
+using esp::gfx::replay::Keyframe;
 using esp::metadata::MetadataMediator;
 using esp::scene::SceneManager;
 
+namespace {
+
+void expectTransformsEqual(const esp::gfx::replay::Transform& a,
+                           const esp::gfx::replay::Transform& b,
+                           float rotationEpsilon) {
+  EXPECT_EQ(a.translation, b.translation);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(a.rotation.vector()[i], b.rotation.vector()[i],
+                rotationEpsilon);
+  }
+  EXPECT_NEAR(a.rotation.scalar(), b.rotation.scalar(), rotationEpsilon);
+}
+
+void expectKeyframesEqual(const Keyframe& a,
+                          const Keyframe& b,
+                          float rotationEpsilon = 0.f) {
+  ASSERT_EQ(a.loads.size(), b.loads.size());
+  for (std::size_t i = 0; i < a.loads.size(); ++i) {
+    EXPECT_EQ(a.loads[i], b.loads[i]);
+  }
+  ASSERT_EQ(a.creations.size(), b.creations.size());
+  for (std::size_t i = 0; i < a.creations.size(); ++i) {
+    const auto& creationA = a.creations[i].second;
+    const auto& creationB = b.creations[i].second;
+    EXPECT_EQ(a.creations[i].first, b.creations[i].first);
+    EXPECT_EQ(creationA.filepath, creationB.filepath);
+    EXPECT_EQ(creationA.scale, creationB.scale);
+    EXPECT_EQ(creationA.flags, creationB.flags);
+    EXPECT_EQ(creationA.lightSetupKey, creationB.lightSetupKey);
+  }
+  EXPECT_EQ(a.deletions, b.deletions);
+  ASSERT_EQ(a.stateUpdates.size(), b.stateUpdates.size());
+  for (std::size_t i = 0; i < a.stateUpdates.size(); ++i) {
+    EXPECT_EQ(a.stateUpdates[i].first, b.stateUpdates[i].first);
+    EXPECT_EQ(a.stateUpdates[i].second.semanticId,
+              b.stateUpdates[i].second.semanticId);
+    expectTransformsEqual(a.stateUpdates[i].second.absTransform,
+                          b.stateUpdates[i].second.absTransform,
+                          rotationEpsilon);
+  }
+  ASSERT_EQ(a.userTransforms.size(), b.userTransforms.size());
+  for (const auto& pair : a.userTransforms) {
+    ASSERT_EQ(b.userTransforms.count(pair.first), 1);
+    expectTransformsEqual(pair.second, b.userTransforms.at(pair.first),
+                          rotationEpsilon);
+  }
+}
+
+void removeTestFile(const std::string& filepath) {
+  if (!Corrade::Utility::Directory::rm(filepath)) {
+    LOG(WARNING) << "GfxReplayTest : unable to remove temporary test file "
+                 << filepath;
+  }
+}
+
+}  // namespace
+
 // Manipulate the scene and save some keyframes using replay::Recorder
 TEST(GfxReplayTest, recorder) {
   esp::gfx::WindowlessContext::uptr context_ =
@@ -101,6 +170,41 @@ TEST(GfxReplayTest, recorder) {
          Mn::Vector3(4.f, 5.f, 6.f));
 }
 
+// verify the Recorder only reads back nodes that moved since the last keyframe
+TEST(GfxReplayTest, recorderSkipsUnmovedNodes) {
+  SceneManager sceneManager_;
+  int sceneID = sceneManager_.initSceneGraph();
+  auto& sceneGraph = sceneManager_.getSceneGraph(sceneID);
+  auto& parent = sceneGraph.getRootNode().createChild();
+  auto& movedNode = parent.createChild();
+  auto& staticNode = sceneGraph.getRootNode().createChild();
+
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt,
+      esp::assets::RenderAssetInstanceCreationInfo::Flags{}, "");
+  esp::gfx::replay::Recorder recorder;
+  recorder.onCreateRenderAssetInstance(&movedNode, creation);
+  recorder.onCreateRenderAssetInstance(&staticNode, creation);
+
+  recorder.saveKeyframe();
+  EXPECT_EQ(recorder.getNumInstanceStatesReadLastKeyframe(), 2);
+
+  recorder.saveKeyframe();
+  EXPECT_EQ(recorder.getNumInstanceStatesReadLastKeyframe(), 0);
+
+  // moving the parent moves the child
+  parent.setTranslation(Mn::Vector3(1.f, 2.f, 3.f));
+  recorder.saveKeyframe();
+  EXPECT_EQ(recorder.getNumInstanceStatesReadLastKeyframe(), 1);
+
+  const auto& keyframes = recorder.debugGetSavedKeyframes();
+  ASSERT_EQ(keyframes.size(), 3);
+  EXPECT_EQ(keyframes[1].stateUpdates.size(), 0);
+  ASSERT_EQ(keyframes[2].stateUpdates.size(), 1);
+  EXPECT_EQ(keyframes[2].stateUpdates[0].second.absTransform.translation,
+            Mn::Vector3(1.f, 2.f, 3.f));
+}
+
 // construct some render keyframes and play them using replay::Player
 TEST(GfxReplayTest, player) {
   esp::gfx::WindowlessContext::uptr context_ =
@@ -275,3 +379,382 @@ TEST(GfxReplayTest, playerReadInvalidFile) {
                  << testFilepath;
   }
 }
+
+TEST(GfxReplayTest, binaryKeyframesRoundTrip) {
+  const auto keyframes = createTestKeyframes(10);
+  const auto testFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+
+  for (const auto precision : {BinaryTransformPrecision::Float32,
+                               BinaryTransformPrecision::Float16Rotations}) {
+    BinaryKeyframeWriter writer;
+    ASSERT_TRUE(writer.open(testFilepath, precision));
+    for (const auto& keyframe : keyframes) {
+      writer.writeKeyframe(keyframe);
+    }
+    writer.close();
+    EXPECT_TRUE(esp::gfx::replay::isBinaryKeyframeFile(testFilepath));
+
+    const float rotationEpsilon =
+        precision == BinaryTransformPrecision::Float32 ? 0.f : 1.0e-3f;
+    BinaryKeyframeReader reader;
+    ASSERT_TRUE(reader.open(testFilepath));
+    EXPECT_EQ(reader.getPrecision(), precision);
+    ASSERT_EQ(reader.getNumKeyframes(), keyframes.size());
+
+    // any keyframe can be read on its own
+    Keyframe keyframe;
+    ASSERT_TRUE(reader.readKeyframe(7, keyframe));
+    expectKeyframesEqual(keyframes[7], keyframe, rotationEpsilon);
+
+    std::vector<Keyframe> readKeyframes;
+    ASSERT_TRUE(reader.readAllKeyframes(readKeyframes));
+    ASSERT_EQ(readKeyframes.size(), keyframes.size());
+    for (std::size_t i = 0; i < keyframes.size(); ++i) {
+      expectKeyframesEqual(keyframes[i], readKeyframes[i], rotationEpsilon);
+    }
+  }
+
+  removeTestFile(testFilepath);
+}
+
+// a recording that got interrupted has no index but can still be read
+TEST(GfxReplayTest, binaryKeyframesWithoutIndex) {
+  const auto keyframes = createTestKeyframes(3);
+  const auto testFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+  const auto truncatedFilepath = Corrade::Utility::Directory::join(
+      DATA_DIR, "./gfx_replay_test_truncated.bin");
+
+  std::string contents;
+  {
+    BinaryKeyframeWriter writer;
+    ASSERT_TRUE(writer.open(testFilepath));
+    for (const auto& keyframe : keyframes) {
+      writer.writeKeyframe(keyframe);
+    }
+    // keyframes are flushed as they are written
+    std::ifstream file(testFilepath, std::ios::binary);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents = stream.str();
+  }
+
+  // add the start of a keyframe that didn't make it to disk completely
+  std::ofstream truncated(truncatedFilepath, std::ios::binary);
+  truncated << contents << contents.substr(16, 10);
+  truncated.close();
+
+  BinaryKeyframeReader reader;
+  ASSERT_TRUE(reader.open(truncatedFilepath));
+  std::vector<Keyframe> readKeyframes;
+  ASSERT_TRUE(reader.readAllKeyframes(readKeyframes));
+  ASSERT_EQ(readKeyframes.size(), keyframes.size());
+  for (std::size_t i = 0; i < keyframes.size(); ++i) {
+    expectKeyframesEqual(keyframes[i], readKeyframes[i]);
+  }
+
+  removeTestFile(testFilepath);
+  removeTestFile(truncatedFilepath);
+}
+
+// offsets and record sizes past the end of the file are rejected
+TEST(GfxReplayTest, binaryKeyframesOutOfBounds) {
+  const auto keyframes = createTestKeyframes(3);
+  const auto testFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+  {
+    BinaryKeyframeWriter writer;
+    ASSERT_TRUE(writer.open(testFilepath));
+    for (const auto& keyframe : keyframes) {
+      writer.writeKeyframe(keyframe);
+    }
+  }
+  std::string contents;
+  {
+    std::ifstream file(testFilepath, std::ios::binary);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents = stream.str();
+  }
+  auto writeContents = [&](const std::string& patched) {
+    std::ofstream file(testFilepath, std::ios::binary | std::ios::trunc);
+    file << patched;
+  };
+
+  // the first record, right after the 16-byte file header, claims to be
+  // larger than the file
+  std::string patched = contents;
+  const std::uint32_t hugeRecordSize = 0xfffffff0u;
+  std::memcpy(&patched[16], &hugeRecordSize, sizeof(hugeRecordSize));
+  writeContents(patched);
+  {
+    BinaryKeyframeReader reader;
+    ASSERT_TRUE(reader.open(testFilepath));
+    ASSERT_EQ(reader.getNumKeyframes(), keyframes.size());
+    Keyframe keyframe;
+    EXPECT_FALSE(reader.readKeyframe(0, keyframe));
+    ASSERT_TRUE(reader.readKeyframe(1, keyframe));
+    expectKeyframesEqual(keyframes[1], keyframe);
+  }
+
+  // the index, located by the 16-byte trailer, points past the file. The
+  // reader falls back to scanning the keyframes
+  patched = contents;
+  std::uint64_t indexOffset = 0;
+  std::memcpy(&indexOffset, &patched[patched.size() - 16],
+              sizeof(indexOffset));
+  const std::uint64_t pastTheEnd = contents.size() * 2;
+  // after the index marker and the keyframe count
+  std::memcpy(&patched[indexOffset + 12], &pastTheEnd, sizeof(pastTheEnd));
+  writeContents(patched);
+  {
+    BinaryKeyframeReader reader;
+    ASSERT_TRUE(reader.open(testFilepath));
+    std::vector<Keyframe> readKeyframes;
+    ASSERT_TRUE(reader.readAllKeyframes(readKeyframes));
+    ASSERT_EQ(readKeyframes.size(), keyframes.size());
+    expectKeyframesEqual(keyframes[0], readKeyframes[0]);
+  }
+
+  removeTestFile(testFilepath);
+}
+
+TEST(GfxReplayTest, recorderBinaryKeyframeStream) {
+  SceneManager sceneManager_;
+  int sceneID = sceneManager_.initSceneGraph();
+  auto& sceneGraph = sceneManager_.getSceneGraph(sceneID);
+  auto& node = sceneGraph.getRootNode().createChild();
+  const auto testFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt,
+      esp::assets::RenderAssetInstanceCreationInfo::Flags{}, "");
+  esp::gfx::replay::Recorder recorder;
+  recorder.onCreateRenderAssetInstance(&node, creation);
+  recorder.saveKeyframe();
+
+  // the keyframe saved before gets streamed too
+  ASSERT_TRUE(recorder.startBinaryKeyframeStream(testFilepath));
+  for (int i = 0; i < 3; ++i) {
+    node.setTranslation(Mn::Vector3(float(i), 0.f, 0.f));
+    recorder.saveKeyframe();
+  }
+  EXPECT_TRUE(recorder.debugGetSavedKeyframes().empty());
+  recorder.stopBinaryKeyframeStream();
+
+  // the next saved keyframe recreates the instance
+  recorder.saveKeyframe();
+  ASSERT_EQ(recorder.debugGetSavedKeyframes().size(), 1);
+  EXPECT_EQ(recorder.debugGetSavedKeyframes()[0].creations.size(), 1);
+  EXPECT_EQ(recorder.debugGetSavedKeyframes()[0].stateUpdates.size(), 1);
+
+  BinaryKeyframeReader reader;
+  ASSERT_TRUE(reader.open(testFilepath));
+  std::vector<Keyframe> keyframes;
+  ASSERT_TRUE(reader.readAllKeyframes(keyframes));
+  ASSERT_EQ(keyframes.size(), 4);
+  EXPECT_EQ(keyframes[0].creations.size(), 1);
+  ASSERT_EQ(keyframes[3].stateUpdates.size(), 1);
+  EXPECT_EQ(keyframes[3].stateUpdates[0].second.absTransform.translation,
+            Mn::Vector3(2.f, 0.f, 0.f));
+
+  removeTestFile(testFilepath);
+}
+
+// the binary format is smaller than JSON, see GfxReplayBenchmarkTest for
+// read and write times
+TEST(GfxReplayTest, binaryKeyframesVersusJson) {
+  const auto keyframes = createTestKeyframes(500);
+  const auto jsonFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.json");
+  const auto binaryFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+  const auto convertedFilepath = Corrade::Utility::Directory::join(
+      DATA_DIR, "./gfx_replay_test_converted.json");
+
+  {
+    rapidjson::Document document(rapidjson::kObjectType);
+    esp::io::addMember(document, "keyframes", keyframes,
+                       document.GetAllocator());
+    ASSERT_TRUE(esp::io::writeJsonToFile(document, jsonFilepath));
+  }
+  {
+    BinaryKeyframeWriter writer;
+    ASSERT_TRUE(writer.open(binaryFilepath));
+    for (const auto& keyframe : keyframes) {
+      writer.writeKeyframe(keyframe);
+    }
+  }
+
+  auto dummyCallback =
+      [&](const esp::assets::AssetInfo& assetInfo,
+          const esp::assets::RenderAssetInstanceCreationInfo& creation) {
+        return nullptr;
+      };
+  esp::gfx::replay::Player jsonPlayer(dummyCallback);
+  jsonPlayer.readKeyframesFromFile(jsonFilepath);
+  EXPECT_EQ(jsonPlayer.getNumKeyframes(), keyframes.size());
+  esp::gfx::replay::Player binaryPlayer(dummyCallback);
+  binaryPlayer.readKeyframesFromFile(binaryFilepath);
+  EXPECT_EQ(binaryPlayer.getNumKeyframes(), keyframes.size());
+
+  EXPECT_LT(esp::io::fileSize(binaryFilepath),
+            esp::io::fileSize(jsonFilepath));
+
+  // converting back and forth keeps the keyframes
+  ASSERT_TRUE(esp::gfx::replay::convertJsonKeyframesToBinary(jsonFilepath,
+                                                             binaryFilepath));
+  ASSERT_TRUE(esp::gfx::replay::convertBinaryKeyframesToJson(
+      binaryFilepath, convertedFilepath));
+  std::vector<Keyframe> convertedKeyframes;
+  esp::io::readMember(esp::io::parseJsonFile(convertedFilepath), "keyframes",
+                      convertedKeyframes);
+  ASSERT_EQ(convertedKeyframes.size(), keyframes.size());
+  for (std::size_t i = 0; i < keyframes.size(); ++i) {
+    expectKeyframesEqual(keyframes[i], convertedKeyframes[i]);
+  }
+
+  removeTestFile(jsonFilepath);
+  removeTestFile(binaryFilepath);
+  removeTestFile(convertedFilepath);
+}
+
+// setting keyframes from full-state keyframes, with the keyframes read lazily
+// from disk, gives the same scene as applying all keyframes in order
+TEST(GfxReplayTest, playerFullStateKeyframes) {
+  auto keyframes = createTestKeyframes(40);
+  // delete an instance and create another one midway
+  keyframes[10].deletions.push_back(3);
+  keyframes[20].creations.emplace_back(100, keyframes[0].creations[0].second);
+  keyframes[20].stateUpdates.emplace_back(
+      100, esp::gfx::replay::RenderAssetInstanceState{
+               {Mn::Vector3(7.f, 8.f, 9.f), {}}, 1});
+  const auto testFilepath =
+      Corrade::Utility::Directory::join(DATA_DIR, "./gfx_replay_test.bin");
+  {
+    BinaryKeyframeWriter writer;
+    ASSERT_TRUE(writer.open(testFilepath));
+    for (const auto& keyframe : keyframes) {
+      writer.writeKeyframe(keyframe);
+    }
+  }
+
+  SceneManager sceneManager_;
+  auto& seekingRoot =
+      sceneManager_.getSceneGraph(sceneManager_.initSceneGraph())
+          .getRootNode();
+  auto& referenceRoot =
+      sceneManager_.getSceneGraph(sceneManager_.initSceneGraph())
+          .getRootNode();
+  auto createChildOf = [](esp::scene::SceneNode& root) {
+    return [&root](
+               const esp::assets::AssetInfo&,
+               const esp::assets::RenderAssetInstanceCreationInfo&) {
+      return &root.createChild();
+    };
+  };
+  auto getChildTranslations = [](const esp::scene::SceneNode& root) {
+    std::vector<Mn::Vector3> translations;
+    for (const auto& child : root.children()) {
+      translations.push_back(
+          static_cast<const esp::scene::SceneNode&>(child).translation());
+    }
+    std::sort(translations.begin(), translations.end(),
+              [](const Mn::Vector3& a, const Mn::Vector3& b) {
+                return std::lexicographical_compare(
+                    a.data(), a.data() + 3, b.data(), b.data() + 3);
+              });
+    return translations;
+  };
+
+  esp::gfx::replay::Player seekingPlayer(createChildOf(seekingRoot));
+  seekingPlayer.setFullStateKeyframeInterval(8);
+  // invalid intervals are ignored
+  seekingPlayer.setFullStateKeyframeInterval(0);
+  ASSERT_EQ(seekingPlayer.getFullStateKeyframeInterval(), 8);
+  seekingPlayer.readKeyframesFromFile(testFilepath);
+  ASSERT_EQ(seekingPlayer.getNumKeyframes(), keyframes.size());
+
+  // no full-state keyframes
+  esp::gfx::replay::Player referencePlayer(createChildOf(referenceRoot));
+  referencePlayer.setFullStateKeyframeInterval(1000);
+  referencePlayer.debugSetKeyframes(std::move(keyframes));
+
+  for (const int keyframeIndex : {39, 5, 30, 12, -1, 25, 24, 39, 0}) {
+    seekingPlayer.setKeyframeIndex(keyframeIndex);
+    referencePlayer.setKeyframeIndex(keyframeIndex);
+    EXPECT_EQ(getChildTranslations(seekingRoot),
+              getChildTranslations(referenceRoot));
+    if (keyframeIndex == -1) {
+      continue;
+    }
+    Mn::Vector3 seekingTranslation;
+    Mn::Vector3 referenceTranslation;
+    Mn::Quaternion rotation;
+    ASSERT_TRUE(seekingPlayer.getUserTransform("agent", &seekingTranslation,
+                                               &rotation));
+    ASSERT_TRUE(referencePlayer.getUserTransform(
+        "agent", &referenceTranslation, &rotation));
+    EXPECT_EQ(seekingTranslation, referenceTranslation);
+  }
+  EXPECT_LT(seekingPlayer.getNumKeyframesApplied(),
+            referencePlayer.getNumKeyframesApplied());
+
+  removeTestFile(testFilepath);
+}
+
+// recording many instances, of which few move or get deleted per keyframe,
+// only saves the changes, see GfxReplayBenchmarkTest for timings
+TEST(GfxReplayTest, recorderManyInstances) {
+  constexpr int numInstances = 5000;
+  SceneManager sceneManager_;
+  auto& rootNode = sceneManager_.getSceneGraph(sceneManager_.initSceneGraph())
+                       .getRootNode();
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      "box.glb", Corrade::Containers::NullOpt,
+      esp::assets::RenderAssetInstanceCreationInfo::Flags{}, "");
+  esp::gfx::replay::Recorder recorder;
+
+  std::vector<esp::scene::SceneNode*> nodes;
+  for (int i = 0; i < numInstances; ++i) {
+    nodes.push_back(&rootNode.createChild());
+    recorder.onCreateRenderAssetInstance(nodes.back(), creation);
+  }
+  // instances deleted before the keyframe got saved cancel out
+  for (int i = 0; i < numInstances; i += 10) {
+    delete nodes[i];
+    nodes[i] = nullptr;
+  }
+  recorder.saveKeyframe();
+
+  constexpr int numKeyframes = 20;
+  for (int k = 0; k < numKeyframes; ++k) {
+    for (int i = 1 + k; i < numInstances; i += 100) {
+      if (nodes[i]) {
+        nodes[i]->setTranslation(Mn::Vector3(float(k), 0.f, 0.f));
+      }
+    }
+    recorder.saveKeyframe();
+  }
+
+  for (int i = 0; i < numInstances; ++i) {
+    if (i % 2 && nodes[i]) {
+      delete nodes[i];
+      nodes[i] = nullptr;
+    }
+  }
+  recorder.saveKeyframe();
+
+  const auto& keyframes = recorder.debugGetSavedKeyframes();
+  ASSERT_EQ(keyframes.size(), numKeyframes + 2);
+  EXPECT_EQ(keyframes[0].creations.size(), numInstances - numInstances / 10);
+  EXPECT_EQ(keyframes[0].deletions.size(), 0);
+  EXPECT_EQ(keyframes[0].stateUpdates.size(), keyframes[0].creations.size());
+  for (int k = 1; k <= numKeyframes; ++k) {
+    EXPECT_LE(keyframes[k].stateUpdates.size(), numInstances / 100);
+  }
+  EXPECT_EQ(keyframes.back().deletions.size(), numInstances / 2);
+  EXPECT_EQ(keyframes.back().stateUpdates.size(), 0);
+}
@@ -0,0 +1,65 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#ifndef ESP_TESTS_GFXREPLAYTESTUTILS_H_
+#define ESP_TESTS_GFXREPLAYTESTUTILS_H_
+
+/** @file
+ * @brief Keyframes shared by GfxReplayTest and GfxReplayBenchmarkTest
+ */
+
+#include <string>
+#include <vector>
+
+#include <Corrade/Containers/Optional.h>
+#include <Magnum/Math/Quaternion.h>
+
+#include "esp/assets/RenderAssetInstanceCreationInfo.h"
+#include "esp/gfx/replay/Keyframe.h"
+
+/**
+ * @brief Keyframes of a few dozen instances moving every keyframe, with the
+ * last instance deleted in the last keyframe
+ */
+inline std::vector<esp::gfx::replay::Keyframe> createTestKeyframes(
+    int numKeyframes) {
+  namespace Mn = Magnum;
+  using esp::assets::RenderAssetInstanceCreationInfo;
+  constexpr int numInstances = 50;
+  std::vector<esp::gfx::replay::Keyframe> keyframes(numKeyframes);
+
+  RenderAssetInstanceCreationInfo::Flags flags;
+  flags |= RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+  flags |= RenderAssetInstanceCreationInfo::Flag::IsSemantic;
+  for (int i = 0; i < numInstances; ++i) {
+    const std::string filepath =
+        "data/objects/object_" + std::to_string(i % 5) + ".glb";
+    if (i < 5) {
+      keyframes[0].loads.push_back(esp::assets::AssetInfo::fromPath(filepath));
+    }
+    Corrade::Containers::Optional<Mn::Vector3> scale;
+    if (i % 2) {
+      scale = Mn::Vector3(0.5f, 1.f, 2.f);
+    }
+    keyframes[0].creations.emplace_back(
+        i, RenderAssetInstanceCreationInfo(filepath, scale, flags, ""));
+  }
+
+  for (int k = 0; k < numKeyframes; ++k) {
+    for (int i = 0; i < numInstances; ++i) {
+      const float t = 0.01f * k + i;
+      esp::gfx::replay::RenderAssetInstanceState state{
+          {Mn::Vector3(t, 0.5f * i, -t),
+           Mn::Quaternion::rotation(Mn::Rad{t}, Mn::Vector3::yAxis())},
+          i % 3};
+      keyframes[k].stateUpdates.emplace_back(i, state);
+    }
+    keyframes[k].userTransforms["agent"] =
+        esp::gfx::replay::Transform{Mn::Vector3(0.1f * k, 0.f, 0.f), {}};
+  }
+  keyframes.back().deletions.push_back(numInstances - 1);
+  return keyframes;
+}
+
+#endif  // ESP_TESTS_GFXREPLAYTESTUTILS_H_
@@ -108,6 +108,24 @@ TEST(IOTest, tokenizeTest) {
   EXPECT_EQ((std::vector<std::string>{"", "a", "bb", "c"}), t3);
 }
 
+TEST(IOTest, hashTest) {
+  // reference values of 64-bit FNV-1a
+  EXPECT_EQ(hashString(""), 0xcbf29ce484222325ull);
+  EXPECT_EQ(hashString("a"), 0xaf63dc4c8601ec8cull);
+  EXPECT_EQ(hashString("foobar"), 0x85944171f73967e8ull);
+  // hashing in pieces equals hashing at once
+  EXPECT_EQ(hashString("bar", hashBytes("foo", 3)), hashString("foobar"));
+}
+
+TEST(IOTest, temporaryFilenameTest) {
+  const std::string file = "dir/file.bin";
+  const std::string tmp1 = getTemporaryFilename(file);
+  const std::string tmp2 = getTemporaryFilename(file);
+  EXPECT_NE(tmp1, tmp2);
+  EXPECT_EQ(tmp1.find(file + "."), 0);
+  EXPECT_EQ(tmp1.substr(tmp1.size() - 4), ".tmp");
+}
+
 /**
  * @brief Test basic JSON file processing
  */
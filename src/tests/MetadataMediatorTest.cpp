@@ -3,6 +3,7 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <gtest/gtest.h>
+#include "esp/metadata/DatasetSnapshot.h"
 #include "esp/metadata/MetadataMediator.h"
 #include "esp/metadata/managers/AssetAttributesManager.h"
 #include "esp/metadata/managers/AttributesManagerBase.h"
@@ -314,3 +315,77 @@ TEST_F(MetadataMediatorTest, MetadataMediatorTest_CreateTestDataset) {
   testLoadSemanticScene();
 
 }  // MetadataMediatorTest, MetadataMediatorTest_CreateTestDataset
+
+/**
+ * @brief Verify a dataset restored from a snapshot matches the one built from
+ * its configs, and that a snapshot is ignored once a source has changed.
+ */
+TEST_F(MetadataMediatorTest, MetadataMediatorTest_DatasetSnapshot) {
+  LOG(INFO) << "Starting "
+               "MetadataMediatorTest::MetadataMediatorTest_DatasetSnapshot";
+  namespace Dir = Cr::Utility::Directory;
+  const std::string snapshotDir =
+      Dir::join(Dir::tmp(), "MetadataMediatorTestDatasetSnapshot");
+  auto removeSnapshotDir = [&]() {
+    for (const auto& file :
+         Dir::list(snapshotDir, Dir::Flag::SkipDotAndDotDot)) {
+      Dir::rm(Dir::join(snapshotDir, file));
+    }
+    Dir::rm(snapshotDir);
+  };
+  // left over if a previous run failed
+  removeSnapshotDir();
+  auto createWithSnapshots = [&]() {
+    auto mediator = MetadataMediator::create();
+    mediator->setDatasetSnapshotDirectory(snapshotDir);
+    EXPECT_TRUE(mediator->setActiveSceneDatasetName(sceneDatasetConfigFile));
+    return mediator;
+  };
+
+  // built from the configs, writing the snapshot
+  auto parsedMM = createWithSnapshots();
+  ASSERT_FALSE(parsedMM->getLastDatasetFromSnapshot());
+  ASSERT_EQ(Dir::list(snapshotDir, Dir::Flag::SkipDotAndDotDot).size(), 1);
+
+  // restored from the snapshot
+  MM = createWithSnapshots();
+  ASSERT_TRUE(MM->getLastDatasetFromSnapshot());
+  testLoadStages();
+  testLoadObjects();
+  testLoadLights();
+  testLoadNavmesh();
+  testLoadSemanticScene();
+  const auto parsedObjects = parsedMM->getObjectAttributesManager();
+  const auto restoredObjects = MM->getObjectAttributesManager();
+  ASSERT_EQ(restoredObjects->getObjectHandlesBySubstring(),
+            parsedObjects->getObjectHandlesBySubstring());
+  for (const auto& handle : parsedObjects->getObjectHandlesBySubstring()) {
+    EXPECT_EQ(restoredObjects->getObjectIDByHandle(handle),
+              parsedObjects->getObjectIDByHandle(handle));
+  }
+  EXPECT_EQ(MM->getSceneAttributesManager()->getNumObjects(),
+            parsedMM->getSceneAttributesManager()->getNumObjects());
+
+  // a snapshot whose sources changed is rejected
+  using esp::metadata::attributes::SceneDatasetAttributes;
+  const std::string configCopy =
+      Dir::join(snapshotDir, "copy.scene_dataset_config.json");
+  const std::string snapshotFile = Dir::join(snapshotDir, "copy.snapshot");
+  ASSERT_TRUE(Dir::writeString(configCopy, "{}"));
+  auto source = SceneDatasetAttributes::create(
+      configCopy, MM->getPhysicsAttributesManager());
+  source->editNavmeshMap()["navmesh"] = "navmesh_path";
+  ASSERT_TRUE(
+      esp::metadata::writeDatasetSnapshot(*source, configCopy, snapshotFile));
+  auto restored = SceneDatasetAttributes::create(
+      configCopy, MM->getPhysicsAttributesManager());
+  ASSERT_TRUE(esp::metadata::readDatasetSnapshot(snapshotFile, *restored));
+  EXPECT_EQ(restored->getNavmeshMap(), source->getNavmeshMap());
+  ASSERT_TRUE(Dir::writeString(configCopy, "{ }"));
+  auto stale = SceneDatasetAttributes::create(
+      configCopy, MM->getPhysicsAttributesManager());
+  ASSERT_FALSE(esp::metadata::readDatasetSnapshot(snapshotFile, *stale));
+  EXPECT_TRUE(stale->getNavmeshMap().empty());
+
+  removeSnapshotDir();
+}  // MetadataMediatorTest, MetadataMediatorTest_DatasetSnapshot
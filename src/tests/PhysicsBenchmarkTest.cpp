@@ -0,0 +1,97 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <Corrade/TestSuite/Tester.h>
+#include <Corrade/Utility/Directory.h>
+#include <string>
+#include <vector>
+
+#include "esp/assets/ResourceManager.h"
+#include "esp/gfx/WindowlessContext.h"
+#include "esp/physics/PhysicsManager.h"
+#include "esp/scene/SceneManager.h"
+
+#include "configure.h"
+
+namespace Cr = Corrade;
+
+using esp::assets::ResourceManager;
+using esp::metadata::MetadataMediator;
+using esp::physics::PhysicsManager;
+using esp::scene::SceneManager;
+
+namespace Test {
+namespace {
+
+const std::string dataDir = Cr::Utility::Directory::join(SCENE_DATASETS, "../");
+const std::string physicsConfigFile =
+    Cr::Utility::Directory::join(SCENE_DATASETS,
+                                 "../default.physics_config.json");
+
+struct PhysicsBenchmarkTest : Cr::TestSuite::Tester {
+  explicit PhysicsBenchmarkTest();
+  // benchmarks
+  void addObject();
+
+  // must declare these in this order due to avoid deallocation errors
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+  std::shared_ptr<MetadataMediator> metadataMediator_ =
+      MetadataMediator::create();
+  std::unique_ptr<ResourceManager> resourceManager_ =
+      std::make_unique<ResourceManager>(metadataMediator_);
+  SceneManager sceneManager_;
+  PhysicsManager::ptr physicsManager_;
+
+  std::string cubeHandle_;
+  // number of objects added per benchmark run
+  const int numObjects_ = 2000;
+  // the batch size when running benchmarks
+  const unsigned int iterations_ = 1;
+};
+
+PhysicsBenchmarkTest::PhysicsBenchmarkTest() {
+  addBenchmarks({&PhysicsBenchmarkTest::addObject}, 5);
+
+  const int sceneID = sceneManager_.initSceneGraph();
+  auto& rootNode = sceneManager_.getSceneGraph(sceneID).getRootNode();
+  auto physicsManagerAttributes =
+      metadataMediator_->getPhysicsAttributesManager()->createObject(
+          physicsConfigFile, true);
+  auto stageAttributesMgr = metadataMediator_->getStageAttributesManager();
+  stageAttributesMgr->setCurrPhysicsManagerAttributesHandle(
+      physicsManagerAttributes->getHandle());
+  auto stageAttributes = stageAttributesMgr->createObject(
+      Cr::Utility::Directory::join(dataDir,
+                                   "test_assets/scenes/simple_room.glb"),
+      true);
+  resourceManager_->initPhysicsManager(physicsManager_, true, &rootNode,
+                                       physicsManagerAttributes);
+  std::vector<int> tempIDs{sceneID, esp::ID_UNDEFINED};
+  resourceManager_->loadStage(stageAttributes, physicsManager_, &sceneManager_,
+                              tempIDs, false);
+
+  cubeHandle_ = metadataMediator_->getObjectAttributesManager()
+                    ->getObjectHandlesBySubstring("cubeSolid")[0];
+}
+
+void PhysicsBenchmarkTest::addObject() {
+  std::vector<int> objectIds;
+  objectIds.reserve(numObjects_);
+  CORRADE_BENCHMARK(iterations_) {
+    for (int i = 0; i < numObjects_; ++i) {
+      objectIds.push_back(physicsManager_->addObject(cubeHandle_, nullptr));
+    }
+  }
+  for (const int id : objectIds) {
+    CORRADE_VERIFY(id != esp::ID_UNDEFINED);
+    physicsManager_->removeObject(id);
+  }
+  CORRADE_COMPARE(physicsManager_->getNumRigidObjects(), 0);
+}
+
+}  // namespace
+}  // namespace Test
+
+CORRADE_TEST_MAIN(Test::PhysicsBenchmarkTest)
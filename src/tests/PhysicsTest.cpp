@@ -2,6 +2,11 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <Corrade/Containers/ArrayViewStl.h>
 #include <Corrade/Utility/Directory.h>
 #include <gtest/gtest.h>
 #include <string>
@@ -14,6 +19,7 @@
 #include "esp/physics/PhysicsManager.h"
 #ifdef ESP_BUILD_WITH_BULLET
 #include "esp/physics/bullet/BulletPhysicsManager.h"
+#include "esp/physics/bullet/PhysicsWorldBatch.h"
 #endif
 
 #include "configure.h"
@@ -294,6 +300,90 @@ TEST_F(PhysicsManagerTest, DiscreteContactTest) {
   }
 }
 
+TEST_F(PhysicsManagerTest, TestPlacements) {
+  LOG(INFO) << "Starting physics test: TestPlacements";
+
+  std::string stageFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/scenes/plane.glb");
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+
+  initStage(stageFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    ObjectAttributes::ptr ObjectAttributes = ObjectAttributes::create();
+    ObjectAttributes->setRenderAssetHandle(objectFile);
+    ObjectAttributes->setMargin(0.0);
+    auto objectAttributesManager =
+        metadataMediator_->getObjectAttributesManager();
+    objectAttributesManager->registerObject(ObjectAttributes, objectFile);
+
+    // a 2x2x2 box standing 0.1 above the ground plane
+    int obstacleId = physicsManager_->addObject(objectFile, nullptr);
+    physicsManager_->setTranslation(obstacleId, Magnum::Vector3{2.2, 1.1, 0});
+
+    // free, 0.1 into the floor, 0.1 into the obstacle
+    std::vector<esp::core::RigidState> poses(3);
+    poses[0].translation = Magnum::Vector3{-0.5, 1.1, 0};
+    poses[1].translation = Magnum::Vector3{-0.5, 0.9, 0};
+    poses[2].translation = Magnum::Vector3{0.3, 1.1, 0};
+    poses[2].rotation = Magnum::Quaternion::rotation(Magnum::Deg{90.0},
+                                                     Magnum::Vector3::yAxis());
+
+    esp::physics::PlacementTestResults results;
+    ASSERT_TRUE(physicsManager_->testPlacements(objectFile, poses, results));
+    ASSERT_EQ(results.getNumPoses(), 3);
+    EXPECT_FALSE(results.collisions[0]);
+    EXPECT_EQ(results.penetrationDepths[0], 0.0);
+    EXPECT_TRUE(results.collisions[1]);
+    EXPECT_NEAR(results.penetrationDepths[1], 0.1, 0.02);
+    EXPECT_TRUE(results.collisions[2]);
+    EXPECT_NEAR(results.penetrationDepths[2], 0.1, 0.02);
+
+    // testing doesn't add objects
+    EXPECT_EQ(physicsManager_->getNumRigidObjects(), 1);
+
+    // same results as a contact test of an added object
+    int objectId = physicsManager_->addObject(objectFile, nullptr);
+    for (std::size_t i = 0; i < poses.size(); ++i) {
+      physicsManager_->setRigidState(objectId, poses[i]);
+      EXPECT_EQ(physicsManager_->contactTest(objectId),
+                bool(results.collisions[i]));
+    }
+    physicsManager_->removeObject(objectId);
+
+    // same results when split across threads
+    esp::physics::BulletPhysicsManager* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+    bPhysManager->setPlacementTestThreadCount(4);
+    std::vector<esp::core::RigidState> manyPoses;
+    for (int i = 0; i < 100; ++i) {
+      manyPoses.push_back(poses[i % poses.size()]);
+    }
+    ASSERT_TRUE(
+        physicsManager_->testPlacements(objectFile, manyPoses, results));
+    ASSERT_EQ(results.getNumPoses(), 100);
+    for (std::size_t i = 0; i < manyPoses.size(); ++i) {
+      EXPECT_EQ(results.collisions[i], i % poses.size() != 0);
+    }
+    // and again, with the dispatchers of the previous call
+    esp::physics::PlacementTestResults repeatedResults;
+    ASSERT_TRUE(physicsManager_->testPlacements(objectFile, manyPoses,
+                                                repeatedResults));
+    EXPECT_EQ(repeatedResults.collisions, results.collisions);
+
+    // preparing an already tested template doesn't add objects
+    EXPECT_TRUE(physicsManager_->ensurePlacementProbe(objectFile));
+    EXPECT_EQ(physicsManager_->getNumRigidObjects(), 1);
+
+    // unknown templates can't be tested
+    EXPECT_FALSE(physicsManager_->ensurePlacementProbe("not_a_template"));
+    EXPECT_FALSE(
+        physicsManager_->testPlacements("not_a_template", poses, results));
+  }
+}
+
 TEST_F(PhysicsManagerTest, BulletCompoundShapeMargins) {
   // test that all different construction methods for a simple shape result in
   // the same Aabb for the given margin
@@ -358,6 +448,70 @@ TEST_F(PhysicsManagerTest, BulletCompoundShapeMargins) {
     ASSERT_EQ(AabbOb2, objectGroundTruth);
   }
 }
+
+TEST_F(PhysicsManagerTest, SharedCollisionShapes) {
+  // test that instances of a template share their convex hulls
+  LOG(INFO) << "Starting physics test: SharedCollisionShapes";
+
+  std::string objectFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/objects/transform_box.glb");
+
+  initStage(objectFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    ObjectAttributes::ptr ObjectAttributes = ObjectAttributes::create();
+    ObjectAttributes->setRenderAssetHandle(objectFile);
+    ObjectAttributes->setMargin(0.0);
+
+    auto objectAttributesManager =
+        metadataMediator_->getObjectAttributesManager();
+    objectAttributesManager->registerObject(ObjectAttributes, objectFile);
+    ObjectAttributes::ptr objectTemplate =
+        objectAttributesManager->getObjectCopyByHandle(objectFile);
+
+    auto* drawables = &sceneManager_.getSceneGraph(sceneID_).getDrawables();
+    esp::physics::BulletPhysicsManager* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+    auto shapeCache = bPhysManager->getCollisionShapeCache();
+    ASSERT_EQ(shapeCache->getNumEntries(), 0);
+
+    // instances of the same template share one entry
+    std::vector<int> objectIds;
+    for (int i = 0; i < 3; ++i) {
+      objectIds.push_back(physicsManager_->addObject(objectFile, drawables));
+    }
+    ASSERT_EQ(shapeCache->getNumEntries(), 1);
+    const Magnum::Range3D unitBounds({-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0});
+    for (int objectId : objectIds) {
+      ASSERT_EQ(bPhysManager->getCollisionShapeAabb(objectId), unitBounds);
+    }
+
+    // uniformly scaled instances reuse the unscaled hulls
+    objectTemplate->setScale({2.0, 2.0, 2.0});
+    objectAttributesManager->registerObject(objectTemplate);
+    int scaledId = physicsManager_->addObject(objectFile, drawables);
+    ASSERT_EQ(shapeCache->getNumEntries(), 1);
+    ASSERT_EQ(bPhysManager->getCollisionShapeAabb(scaledId),
+              Magnum::Range3D({-2.0, -2.0, -2.0}, {2.0, 2.0, 2.0}));
+
+    // non-uniform scale gets baked into new hulls
+    objectTemplate->setScale({1.0, 2.0, 3.0});
+    objectAttributesManager->registerObject(objectTemplate);
+    int stretchedId = physicsManager_->addObject(objectFile, drawables);
+    ASSERT_EQ(shapeCache->getNumEntries(), 2);
+    ASSERT_EQ(bPhysManager->getCollisionShapeAabb(stretchedId),
+              Magnum::Range3D({-1.0, -2.0, -3.0}, {1.0, 2.0, 3.0}));
+
+    // changing the margin of one instance doesn't affect the others
+    physicsManager_->setMargin(scaledId, 0.1);
+    ASSERT_EQ(bPhysManager->getCollisionShapeAabb(scaledId),
+              Magnum::Range3D({-2.1, -2.1, -2.1}, {2.1, 2.1, 2.1}));
+    for (int objectId : objectIds) {
+      ASSERT_EQ(bPhysManager->getCollisionShapeAabb(objectId), unitBounds);
+    }
+  }
+}
 #endif
 
 TEST_F(PhysicsManagerTest, ConfigurableScaling) {
@@ -428,6 +582,51 @@ TEST_F(PhysicsManagerTest, ConfigurableScaling) {
   }
 }
 
+TEST(PhysicsKinematicIntegratorTest, MatchesVelocityControl) {
+  // batched integration gives the same states as per-object integration
+  using esp::physics::VelocityControl;
+  std::vector<VelocityControl> velControls(5);
+  velControls[0].controllingLinVel = true;
+  velControls[0].linVel = Mn::Vector3{1.0, 2.0, 3.0};
+  velControls[1].controllingLinVel = true;
+  velControls[1].linVelIsLocal = true;
+  velControls[1].linVel = Mn::Vector3{0.0, 0.0, -1.0};
+  velControls[1].controllingAngVel = true;
+  velControls[1].angVelIsLocal = true;
+  velControls[1].angVel = Mn::Vector3{0.5, 1.0, 0.0};
+  velControls[2].controllingAngVel = true;
+  velControls[2].angVel = Mn::Vector3{0.0, 2.0, 0.0};
+  velControls[3].controllingAngVel = true;
+  velControls[3].angVel = Mn::Vector3{0.0};
+  velControls[4].controllingLinVel = true;
+  velControls[4].controllingAngVel = true;
+  velControls[4].linVel = Mn::Vector3{-1.0, 0.0, 0.0};
+  velControls[4].angVel = Mn::Vector3{0.0, 0.0, 3.0};
+
+  const esp::core::RigidState initialState{
+      Mn::Quaternion::rotation(Mn::Deg{30.0}, Mn::Vector3::xAxis()),
+      Mn::Vector3{0.5, -1.0, 2.0}};
+  const float dt = 1.0 / 60.0;
+  const int numSteps = 10;
+
+  esp::physics::KinematicIntegrator integrator;
+  for (const VelocityControl& velControl : velControls) {
+    integrator.add(velControl, initialState);
+  }
+  ASSERT_EQ(integrator.size(), velControls.size());
+  integrator.integrate(dt, numSteps);
+
+  for (std::size_t i = 0; i < velControls.size(); ++i) {
+    esp::core::RigidState expected = initialState;
+    for (int step = 0; step < numSteps; ++step) {
+      expected = velControls[i].integrateTransform(dt, expected);
+    }
+    const esp::core::RigidState actual = integrator.getRigidState(i);
+    EXPECT_EQ(actual.translation, expected.translation);
+    EXPECT_EQ(actual.rotation, expected.rotation);
+  }
+}
+
 TEST_F(PhysicsManagerTest, TestVelocityControl) {
   // test scaling of objects via template configuration (visual and collision)
   LOG(INFO) << "Starting physics test: TestVelocityControl";
@@ -835,6 +1034,8 @@ TEST_F(PhysicsManagerTest, TestRemoveSleepingSupport) {
       for (auto id : cubeIds) {
         ASSERT(!physicsManager_->isActive(id));
       }
+      // so the last step didn't move any of them
+      ASSERT_EQ(physicsManager_->getUpdatedObjectIDs().size(), 0);
 
       // no active contact points
       ASSERT_EQ(physicsManager_->getNumActiveContactPoints(), 0);
@@ -859,6 +1060,231 @@ TEST_F(PhysicsManagerTest, TestRemoveSleepingSupport) {
       }
 
       ASSERT_GT(physicsManager_->getNumActiveContactPoints(), 0);
+
+      // the awake cubes get moved by the next step, the static one doesn't
+      physicsManager_->stepPhysics(0.1);
+      const std::vector<int>& updatedIds =
+          physicsManager_->getUpdatedObjectIDs();
+      for (auto id : cubeIds) {
+        const bool updated = std::find(updatedIds.begin(), updatedIds.end(),
+                                       id) != updatedIds.end();
+        ASSERT_EQ(updated, physicsManager_->getObjectMotionType(id) !=
+                               esp::physics::MotionType::STATIC);
+      }
+    }
+  }
+}
+
+TEST_F(PhysicsManagerTest, SaveRestoreVelocityControl) {
+  // test that restoring a state snapshot reproduces kinematic motion driven
+  // by velocity control
+  LOG(INFO) << "Starting physics test: SaveRestoreVelocityControl";
+  std::string stageFile = Cr::Utility::Directory::join(
+      dataDir, "test_assets/scenes/simple_room.glb");
+  initStage(stageFile);
+
+  auto objectAttributesManager =
+      metadataMediator_->getObjectAttributesManager();
+  const std::string cubeHandle =
+      objectAttributesManager->getObjectHandlesBySubstring("cubeSolid")[0];
+  int objectId = physicsManager_->addObject(cubeHandle, nullptr);
+  physicsManager_->setObjectMotionType(objectId,
+                                       esp::physics::MotionType::KINEMATIC);
+
+  esp::physics::VelocityControl::ptr velControl =
+      physicsManager_->getVelocityControl(objectId);
+  velControl->controllingLinVel = true;
+  velControl->linVelIsLocal = true;
+  velControl->linVel = Magnum::Vector3{1.0, 0, 0};
+  velControl->controllingAngVel = true;
+  velControl->angVel = Magnum::Vector3{0, 1.0, 0};
+
+  const std::vector<char> snapshot = physicsManager_->saveState();
+  physicsManager_->stepPhysics(0.5);
+  const Magnum::Vector3 expectedTranslation =
+      physicsManager_->getTranslation(objectId);
+  const Magnum::Quaternion expectedRotation =
+      physicsManager_->getRotation(objectId);
+
+  // change the control, the snapshot brings it back
+  velControl->controllingLinVel = false;
+  velControl->linVelIsLocal = false;
+  velControl->angVel = Magnum::Vector3{1.0, 0, 0};
+  ASSERT_TRUE(physicsManager_->restoreState(snapshot));
+  ASSERT_TRUE(velControl->controllingLinVel);
+  ASSERT_TRUE(velControl->linVelIsLocal);
+  ASSERT_TRUE(velControl->controllingAngVel);
+  ASSERT_FALSE(velControl->angVelIsLocal);
+  ASSERT_EQ(velControl->angVel, (Magnum::Vector3{0, 1.0, 0}));
+
+  physicsManager_->stepPhysics(0.5);
+  ASSERT_LE(
+      (physicsManager_->getTranslation(objectId) - expectedTranslation)
+          .length(),
+      1e-5);
+  ASSERT_NEAR(std::abs(Magnum::Math::dot(
+                  physicsManager_->getRotation(objectId), expectedRotation)),
+              1.0, 1e-5);
+
+  // corrupt snapshots are rejected before the world is touched. Offsets are
+  // those of the snapshot header and of the single object record following it
+  constexpr std::size_t headerSize = 24;
+  constexpr std::size_t objectCountOffset = 16;
+  constexpr std::size_t motionTypeOffset = headerSize + 4;
+  ASSERT_EQ(physicsManager_->getNumRigidObjects(), 1);
+  std::vector<char> badMotionType = snapshot;
+  badMotionType[motionTypeOffset] = 42;
+  ASSERT_FALSE(physicsManager_->restoreState(badMotionType));
+
+  std::vector<char> duplicateObject = snapshot;
+  duplicateObject.insert(duplicateObject.end(), snapshot.begin() + headerSize,
+                         snapshot.end());
+  const std::uint32_t objectCount = 2;
+  std::memcpy(duplicateObject.data() + objectCountOffset, &objectCount,
+              sizeof(objectCount));
+  ASSERT_FALSE(physicsManager_->restoreState(duplicateObject));
+  ASSERT_EQ(physicsManager_->getNumRigidObjects(), 1);
+  ASSERT_EQ(physicsManager_->getObjectMotionType(objectId),
+            esp::physics::MotionType::KINEMATIC);
+}
+
+#ifdef ESP_BUILD_WITH_BULLET
+TEST_F(PhysicsManagerTest, PhysicsWorldBatch) {
+  // test that batched worlds share the stage and step independently
+  LOG(INFO) << "Starting physics test: PhysicsWorldBatch";
+
+  std::string stageFile =
+      Cr::Utility::Directory::join(dataDir, "test_assets/scenes/plane.glb");
+
+  initStage(stageFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    auto* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+    auto objectAttributesManager =
+        metadataMediator_->getObjectAttributesManager();
+    std::string cubeHandle =
+        objectAttributesManager->getObjectHandlesBySubstring("cubeSolid")[0];
+
+    const int numWorlds = 5;
+    esp::physics::PhysicsWorldBatch batch{*resourceManager_, *bPhysManager,
+                                          numWorlds, 2};
+    ASSERT_EQ(batch.getNumWorlds(), numWorlds);
+    ASSERT_EQ(batch.getNumThreads(), 2);
+    for (int i = 0; i < numWorlds; ++i) {
+      ASSERT_EQ(batch.getWorld(i).getStageCollisionShapeAabb(),
+                bPhysManager->getStageCollisionShapeAabb());
+    }
+
+    const std::vector<int> objectIds{batch.addObject(cubeHandle),
+                                     batch.addObject(cubeHandle)};
+    ASSERT_NE(objectIds[0], esp::ID_UNDEFINED);
+    for (int i = 0; i < numWorlds; ++i) {
+      ASSERT_EQ(batch.getWorld(i).getNumRigidObjects(), 2);
+    }
+
+    // drop the cubes from a different height in each world
+    const std::size_t stride = PhysicsManager::RIGID_STATE_SIZE;
+    std::vector<float> states(numWorlds * objectIds.size() * stride);
+    batch.getRigidStates(objectIds, states);
+    for (int i = 0; i < numWorlds; ++i) {
+      for (std::size_t o = 0; o < objectIds.size(); ++o) {
+        float* state = states.data() + (i * objectIds.size() + o) * stride;
+        state[0] = 4.0f * o;
+        state[1] = 3.0f + i;
+      }
+    }
+    batch.setRigidStates(objectIds, states);
+
+    // the lowest cubes land first
+    batch.stepPhysics(0.5);
+    batch.getRigidStates(objectIds, states);
+    for (int i = 1; i < numWorlds; ++i) {
+      ASSERT_LT(states[(i - 1) * objectIds.size() * stride + 1],
+                states[i * objectIds.size() * stride + 1]);
+    }
+
+    // all cubes come to rest on the shared plane at the same height
+    for (int step = 0; step < 10; ++step) {
+      batch.stepPhysics(0.5);
+    }
+    batch.getRigidStates(objectIds, states);
+    const float restHeight = states[1];
+    ASSERT_GT(restHeight, 0.0f);
+    ASSERT_LT(restHeight, 3.0f);
+    for (int i = 0; i < numWorlds; ++i) {
+      ASSERT_NEAR(batch.getWorld(i).getWorldTime(), 5.5, 1.0e-6);
+      for (std::size_t o = 0; o < objectIds.size(); ++o) {
+        ASSERT_NEAR(states[(i * objectIds.size() + o) * stride + 1],
+                    restHeight, 1.0e-2);
+      }
+    }
+
+    batch.removeObject(objectIds[0]);
+    for (int i = 0; i < numWorlds; ++i) {
+      ASSERT_EQ(batch.getWorld(i).getNumRigidObjects(), 1);
+    }
+  }
+}
+
+TEST_F(PhysicsManagerTest, StageBvhCache) {
+  // test that a stage loaded with a cached BVH collides like a built one
+  LOG(INFO) << "Starting physics test: StageBvhCache";
+
+  // use a copy of the stage, as the cache file gets written next to it
+  const std::string stageFile = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "PhysicsTestStageBvhCache.glb");
+  ASSERT_TRUE(Cr::Utility::Directory::copy(
+      Cr::Utility::Directory::join(dataDir,
+                                   "test_assets/scenes/simple_room.glb"),
+      stageFile));
+  const std::string cacheFile = stageFile + ".bvhcache";
+  Cr::Utility::Directory::rm(cacheFile);
+
+  initStage(stageFile);
+
+  if (physicsManager_->getPhysicsSimulationLibrary() ==
+      PhysicsManager::PhysicsSimulationLibrary::BULLET) {
+    esp::physics::BulletPhysicsManager* bPhysManager =
+        static_cast<esp::physics::BulletPhysicsManager*>(physicsManager_.get());
+    // disabled by default
+    ASSERT_FALSE(Cr::Utility::Directory::exists(cacheFile));
+    ASSERT_FALSE(bPhysManager->getStageLoadedBvhCache());
+
+    const Magnum::Range3D stageAabb =
+        bPhysManager->getStageCollisionShapeAabb();
+    const esp::geo::Ray ray{stageAabb.center(), {0.0, -1.0, 0.0}};
+    esp::physics::RaycastResults expected = physicsManager_->castRay(ray);
+    ASSERT_TRUE(expected.hasHits());
+
+    auto physicsManagerAttributes =
+        physicsManager_->getInitializationAttributes();
+    physicsManagerAttributes->setUseStageBvhCache(true);
+    auto stageAttributes = physicsManager_->getStageInitAttributes();
+    const std::vector<esp::assets::CollisionMeshData>& meshGroup =
+        resourceManager_->getCollisionMesh(
+            stageAttributes->getCollisionAssetHandle());
+
+    // the first manager writes the cache, the second one loads it
+    for (int i = 0; i != 2; ++i) {
+      esp::scene::SceneGraph sceneGraph;
+      esp::physics::BulletPhysicsManager manager{*resourceManager_,
+                                                 physicsManagerAttributes};
+      manager.initPhysics(&sceneGraph.getRootNode());
+      ASSERT_TRUE(manager.addStage(stageAttributes->getHandle(), meshGroup));
+      ASSERT_TRUE(Cr::Utility::Directory::exists(cacheFile));
+      ASSERT_EQ(manager.getStageLoadedBvhCache(), i == 1);
+
+      ASSERT_EQ(manager.getStageCollisionShapeAabb(), stageAabb);
+      esp::physics::RaycastResults results = manager.castRay(ray);
+      ASSERT_EQ(results.hits.size(), expected.hits.size());
+      ASSERT_NEAR(results.hits[0].rayDistance, expected.hits[0].rayDistance,
+                  1e-4);
     }
   }
+
+  Cr::Utility::Directory::rm(cacheFile);
+  Cr::Utility::Directory::rm(stageFile);
 }
+#endif
@@ -6,12 +6,17 @@
 #include <Corrade/Utility/Directory.h>
 #include <Magnum/EigenIntegration/Integration.h>
 #include <Magnum/Math/Range.h>
+#include <Magnum/PixelFormat.h>
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "esp/assets/RenderAssetInstanceCreationInfo.h"
 #include "esp/assets/ResourceManager.h"
+#include "esp/assets/TranscodedTextureCache.h"
 #include "esp/gfx/Renderer.h"
+#include "esp/gfx/TextureResidencyManager.h"
 #include "esp/gfx/WindowlessContext.h"
 #include "esp/scene/SceneManager.h"
 
@@ -116,3 +121,302 @@ TEST(ResourceManagerTest, loadAndCreateRenderAssetInstance) {
       info, creation, &sceneManager_, tempIDs);
   ASSERT(node);
 }
+
+// Load the same render asset from two ResourceManagers sharing the process-wide
+// asset cache and assert the second load reuses the first one's data
+TEST(ResourceManagerTest, sharedAssetCache) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  esp::assets::AssetCache& cache = esp::assets::AssetCache::instance();
+  cache.clear();
+  cache.resetStats();
+
+  std::string boxFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "objects/transform_box.glb");
+  const esp::assets::AssetInfo info = esp::assets::AssetInfo::fromPath(boxFile);
+  esp::assets::RenderAssetInstanceCreationInfo::Flags flags;
+  flags |= esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+  flags |= esp::assets::RenderAssetInstanceCreationInfo::Flag::IsSemantic;
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      boxFile, Corrade::Containers::NullOpt, flags, "");
+
+  {
+    // must declare these in this order due to avoid deallocation errors
+    auto MM = MetadataMediator::create();
+    ResourceManager resourceManagerA(MM);
+    ResourceManager resourceManagerB(MM);
+    resourceManagerA.setUseSharedAssetCache(true);
+    resourceManagerB.setUseSharedAssetCache(true);
+    SceneManager sceneManager_;
+    int sceneID = sceneManager_.initSceneGraph();
+    std::vector<int> tempIDs{sceneID, esp::ID_UNDEFINED};
+
+    ASSERT_NE(resourceManagerA.loadAndCreateRenderAssetInstance(
+                  info, creation, &sceneManager_, tempIDs),
+              nullptr);
+    esp::assets::AssetCache::Stats stats = cache.getStats();
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.numEntries, 1u);
+    ASSERT_GT(stats.byteSize, 0u);
+
+    ASSERT_NE(resourceManagerB.loadAndCreateRenderAssetInstance(
+                  info, creation, &sceneManager_, tempIDs),
+              nullptr);
+    stats = cache.getStats();
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.gpuHits, 1u);
+
+    // both reference the same CPU-side storage instead of equal copies
+    const auto meshIndexA =
+        resourceManagerA.getMeshMetaData(boxFile).meshIndex;
+    const auto meshIndexB =
+        resourceManagerB.getMeshMetaData(boxFile).meshIndex;
+    ASSERT_EQ(meshIndexA.second - meshIndexA.first,
+              meshIndexB.second - meshIndexB.first);
+    for (int i = 0; i <= meshIndexA.second - meshIndexA.first; ++i) {
+      const esp::assets::CollisionMeshData& meshA =
+          resourceManagerA.getMeshCollisionData(meshIndexA.first + i);
+      const esp::assets::CollisionMeshData& meshB =
+          resourceManagerB.getMeshCollisionData(meshIndexB.first + i);
+      ASSERT_NE(meshA.positions.data(), nullptr);
+      ASSERT_EQ(meshA.positions.data(), meshB.positions.data());
+      ASSERT_EQ(meshA.indices.data(), meshB.indices.data());
+    }
+  }
+
+  // the GPU-side data is dropped with its last user, CPU-side data is kept
+  esp::assets::AssetCache::Stats stats = cache.getStats();
+  ASSERT_EQ(stats.numEntries, 1u);
+
+  // a tiny budget never evicts the most recently used entry
+  cache.setMemoryBudget(1);
+  ASSERT_EQ(cache.getStats().numEntries, 1u);
+  cache.setMemoryBudget(0);
+  cache.clear();
+  ASSERT_EQ(cache.getStats().numEntries, 0u);
+  ASSERT_EQ(cache.getStats().byteSize, 0u);
+}
+
+TEST(ResourceManagerTest, textureResidency) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  // full mip chain of an RGBA8 texture, 256x256 down to 1x1
+  auto makeLevels = []() {
+    std::vector<Mn::Trade::ImageData2D> levels;
+    for (int size = 256; size >= 1; size /= 2) {
+      Cr::Containers::Array<char> data{Cr::Containers::ValueInit,
+                                       std::size_t(size * size * 4)};
+      levels.emplace_back(Mn::PixelFormat::RGBA8Unorm, Mn::Vector2i{size},
+                          std::move(data));
+    }
+    return levels;
+  };
+  // size of a mip chain starting at the given resolution
+  auto chainSize = [](int base) {
+    std::size_t bytes = 0;
+    for (int size = base; size >= 1; size /= 2)
+      bytes += size * size * 4;
+    return bytes;
+  };
+
+  // the maximum resolution skips the largest levels
+  {
+    esp::gfx::TextureResidencyManager manager{0, 128};
+    Mn::GL::Texture2D texture;
+    manager.addTexture(texture, makeLevels(), {});
+    esp::gfx::TextureResidencyManager::Stats stats = manager.getStats();
+    EXPECT_EQ(stats.numManagedTextures, 1u);
+    EXPECT_EQ(stats.residentBytes, chainSize(128));
+    EXPECT_EQ(stats.skippedBytes, chainSize(256) - chainSize(128));
+    EXPECT_EQ(texture.imageSize(0), Mn::Vector2i{128});
+  }
+
+  // budget for two full textures and a demoted one, the least recently drawn
+  // gets demoted
+  {
+    esp::gfx::TextureResidencyManager manager{2 * chainSize(256) +
+                                              chainSize(64)};
+    Mn::GL::Texture2D textures[3];
+    for (Mn::GL::Texture2D& texture : textures) {
+      manager.addTexture(texture, makeLevels(), {});
+    }
+    esp::gfx::TextureResidencyManager::Stats stats = manager.getStats();
+    EXPECT_EQ(stats.numDemotedTextures, 1u);
+    EXPECT_EQ(stats.demotions, 1u);
+    EXPECT_EQ(stats.residentBytes, manager.getMemoryBudget());
+    EXPECT_EQ(textures[0].imageSize(0), Mn::Vector2i{64});
+
+    // drawing the demoted texture promotes it and demotes the next oldest
+    manager.touch(&textures[0]);
+    stats = manager.getStats();
+    EXPECT_EQ(stats.promotions, 1u);
+    EXPECT_EQ(stats.demotions, 2u);
+    EXPECT_EQ(textures[0].imageSize(0), Mn::Vector2i{256});
+    EXPECT_EQ(textures[1].imageSize(0), Mn::Vector2i{64});
+    EXPECT_EQ(textures[2].imageSize(0), Mn::Vector2i{256});
+
+    // removing a texture frees its share of the budget
+    manager.removeTexture(textures[2]);
+    manager.touch(&textures[1]);
+    stats = manager.getStats();
+    EXPECT_EQ(stats.numTextures, 2u);
+    EXPECT_EQ(stats.numDemotedTextures, 0u);
+    EXPECT_EQ(stats.residentBytes, 2 * chainSize(256));
+  }
+
+  // textures drawn in the same frame are never demoted, even if together
+  // they exceed the budget
+  {
+    esp::gfx::TextureResidencyManager manager{2 * chainSize(256) +
+                                              chainSize(64)};
+    Mn::GL::Texture2D textures[3];
+    for (Mn::GL::Texture2D& texture : textures) {
+      manager.addTexture(texture, makeLevels(), {});
+    }
+    manager.beginFrame();
+    for (Mn::GL::Texture2D& texture : textures) {
+      manager.touch(&texture);
+    }
+    esp::gfx::TextureResidencyManager::Stats stats = manager.getStats();
+    EXPECT_EQ(stats.numDemotedTextures, 0u);
+    EXPECT_EQ(stats.overBudgetFrames, 1u);
+    EXPECT_EQ(stats.residentBytes, 3 * chainSize(256));
+    for (Mn::GL::Texture2D& texture : textures) {
+      EXPECT_EQ(texture.imageSize(0), Mn::Vector2i{256});
+    }
+
+    // the next frame gets back within budget
+    manager.beginFrame();
+    manager.touch(&textures[0]);
+    stats = manager.getStats();
+    EXPECT_EQ(stats.numDemotedTextures, 1u);
+    EXPECT_EQ(stats.overBudgetFrames, 1u);
+    EXPECT_EQ(stats.residentBytes, manager.getMemoryBudget());
+    EXPECT_EQ(textures[0].imageSize(0), Mn::Vector2i{256});
+  }
+}
+
+TEST(ResourceManagerTest, transcodedTextureCache) {
+  const std::string cacheDir = Cr::Utility::Directory::join(
+      Cr::Utility::Directory::tmp(), "habitat_transcoded_texture_cache_test");
+  const std::string sourceFile =
+      Cr::Utility::Directory::join(cacheDir, "source.glb");
+  ASSERT_TRUE(Cr::Utility::Directory::mkpath(cacheDir));
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(sourceFile, "source"));
+
+  // a compressed level and an uncompressed one with padded rows
+  std::vector<Mn::Trade::ImageData2D> levels;
+  {
+    Cr::Containers::Array<char> data{Cr::Containers::NoInit, 16};
+    for (std::size_t i = 0; i != data.size(); ++i)
+      data[i] = char(i);
+    levels.emplace_back(Mn::CompressedPixelFormat::Bc1RGBAUnorm,
+                        Mn::Vector2i{4}, std::move(data));
+  }
+  {
+    Cr::Containers::Array<char> data{Cr::Containers::ValueInit, 8};
+    data[4] = 'x';
+    levels.emplace_back(Mn::PixelFormat::RGB8Unorm, Mn::Vector2i{1, 2},
+                        std::move(data));
+  }
+
+  esp::assets::TranscodedTextureCache cache{cacheDir};
+  EXPECT_FALSE(cache.load(sourceFile, 3, "Bc1RGBA"));
+  ASSERT_TRUE(cache.save(sourceFile, 3, "Bc1RGBA", levels));
+
+  auto loaded = cache.load(sourceFile, 3, "Bc1RGBA");
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(loaded->size(), 2u);
+  EXPECT_TRUE((*loaded)[0].isCompressed());
+  EXPECT_EQ((*loaded)[0].compressedFormat(),
+            Mn::CompressedPixelFormat::Bc1RGBAUnorm);
+  EXPECT_EQ((*loaded)[0].size(), Mn::Vector2i{4});
+  EXPECT_EQ((*loaded)[0].data()[15], char(15));
+  EXPECT_FALSE((*loaded)[1].isCompressed());
+  EXPECT_EQ((*loaded)[1].format(), Mn::PixelFormat::RGB8Unorm);
+  EXPECT_EQ((*loaded)[1].size(), (Mn::Vector2i{1, 2}));
+  EXPECT_EQ((*loaded)[1].storage().alignment(), 4);
+  EXPECT_EQ((*loaded)[1].data()[4], 'x');
+
+  // corrupted, truncated or incompatible files are ignored. Offsets are
+  // those of the 32-byte file header and the first 32-byte level header
+  const std::string cacheFile =
+      cache.getCacheFilename(sourceFile, 3, "Bc1RGBA");
+  const std::string contents = Cr::Utility::Directory::readString(cacheFile);
+  auto loadPatched = [&](std::size_t offset, std::uint64_t value,
+                         std::size_t size) {
+    std::string patched = contents;
+    std::memcpy(&patched[offset], &value, size);
+    EXPECT_TRUE(Cr::Utility::Directory::writeString(cacheFile, patched));
+    return bool(cache.load(sourceFile, 3, "Bc1RGBA"));
+  };
+  // Magnum format enum fingerprint
+  EXPECT_FALSE(loadPatched(28, 0, 4));
+  // level format
+  EXPECT_FALSE(loadPatched(32 + 4, 0xffff, 4));
+  // level width
+  EXPECT_FALSE(loadPatched(32 + 8, 0, 4));
+  // level byte size, larger than the file or smaller than the image
+  EXPECT_FALSE(loadPatched(32 + 24, std::uint64_t{1} << 40, 8));
+  EXPECT_FALSE(loadPatched(32 + 24, 4, 8));
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(
+      cacheFile, contents.substr(0, contents.size() - 4)));
+  EXPECT_FALSE(cache.load(sourceFile, 3, "Bc1RGBA"));
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(cacheFile, contents));
+  EXPECT_TRUE(cache.load(sourceFile, 3, "Bc1RGBA"));
+
+  // other images and target formats are cached separately
+  EXPECT_FALSE(cache.load(sourceFile, 2, "Bc1RGBA"));
+  EXPECT_FALSE(cache.load(sourceFile, 3, "Etc2RGBA"));
+
+  // a modified source invalidates the cached images
+  ASSERT_TRUE(Cr::Utility::Directory::writeString(sourceFile, "modified"));
+  EXPECT_FALSE(cache.load(sourceFile, 3, "Bc1RGBA"));
+
+  Cr::Utility::Directory::rm(
+      cache.getCacheFilename(sourceFile, 3, "Bc1RGBA"));
+  Cr::Utility::Directory::rm(sourceFile);
+  Cr::Utility::Directory::rm(cacheDir);
+}
+
+TEST(ResourceManagerTest, parallelTextureLoading) {
+  esp::gfx::WindowlessContext::uptr context_ =
+      esp::gfx::WindowlessContext::create_unique(0);
+
+  std::shared_ptr<esp::gfx::Renderer> renderer_ = esp::gfx::Renderer::create();
+
+  std::string roomFile =
+      Cr::Utility::Directory::join(TEST_ASSETS, "scenes/simple_room.glb");
+  const esp::assets::AssetInfo info =
+      esp::assets::AssetInfo::fromPath(roomFile);
+  esp::assets::RenderAssetInstanceCreationInfo::Flags flags;
+  flags |= esp::assets::RenderAssetInstanceCreationInfo::Flag::IsRGBD;
+  esp::assets::RenderAssetInstanceCreationInfo creation(
+      roomFile, Corrade::Containers::NullOpt, flags, "");
+
+  // textures are only tracked, and counted, with residency management on
+  auto loadWithThreads = [&](int threadCount) {
+    auto MM = MetadataMediator::create();
+    ResourceManager resourceManager(MM);
+    resourceManager.setTextureLoadThreadCount(threadCount);
+    resourceManager.setTextureResidency(0, 1 << 16);
+    SceneManager sceneManager_;
+    int sceneID = sceneManager_.initSceneGraph();
+    std::vector<int> tempIDs{sceneID, esp::ID_UNDEFINED};
+    EXPECT_NE(resourceManager.loadAndCreateRenderAssetInstance(
+                  info, creation, &sceneManager_, tempIDs),
+              nullptr);
+    return resourceManager.getTextureResidencyStats();
+  };
+
+  const esp::gfx::TextureResidencyManager::Stats serial = loadWithThreads(1);
+  const esp::gfx::TextureResidencyManager::Stats parallel = loadWithThreads(4);
+  EXPECT_GT(serial.numTextures, 0u);
+  EXPECT_EQ(parallel.numTextures, serial.numTextures);
+  EXPECT_EQ(parallel.numManagedTextures, serial.numManagedTextures);
+  EXPECT_EQ(parallel.residentBytes, serial.residentBytes);
+}
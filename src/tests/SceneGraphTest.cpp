@@ -5,9 +5,11 @@
 #include <gtest/gtest.h>
 
 #include "esp/scene/SceneGraph.h"
+#include "esp/scene/SceneNode.h"
 
 using esp::gfx::DrawableGroup;
 using esp::scene::SceneGraph;
+using esp::scene::SceneNode;
 
 class SceneGraphTest : public ::testing::Test {
  protected:
@@ -38,3 +40,32 @@ TEST_F(SceneGraphTest, DeleteDrawableGroup) {
   EXPECT_EQ(g.getDrawableGroups().size(), numInitialGroups);
   ASSERT_EQ(g.getDrawableGroup(groupName), nullptr);
 }
+
+TEST_F(SceneGraphTest, CachedAbsoluteTransformation) {
+  SceneNode& parent = g.getRootNode().createChild();
+  SceneNode& child = parent.createChild();
+  EXPECT_EQ(child.getAbsoluteTransformationVersion(), 0);
+
+  parent.setTranslation(Magnum::Vector3{1.0f, 2.0f, 3.0f});
+  EXPECT_EQ(child.cachedAbsoluteTransformation().translation(),
+            (Magnum::Vector3{1.0f, 2.0f, 3.0f}));
+  const std::uint64_t version = child.getAbsoluteTransformationVersion();
+  EXPECT_FALSE(child.isDirty());
+
+  // reading a clean node doesn't recompute anything
+  child.cachedAbsoluteTransformation();
+  EXPECT_EQ(child.getAbsoluteTransformationVersion(), version);
+
+  // moving the parent dirties the child
+  parent.translate(Magnum::Vector3{1.0f, 0.0f, 0.0f});
+  EXPECT_TRUE(child.isDirty());
+  EXPECT_EQ(child.cachedAbsoluteTransformation().translation(),
+            (Magnum::Vector3{2.0f, 2.0f, 3.0f}));
+  EXPECT_GT(child.getAbsoluteTransformationVersion(), version);
+
+  // cleaning through another path still bumps the version
+  const std::uint64_t cleanedVersion = child.getAbsoluteTransformationVersion();
+  child.translate(Magnum::Vector3{0.0f, 1.0f, 0.0f});
+  child.setClean();
+  EXPECT_GT(child.getAbsoluteTransformationVersion(), cleanedVersion);
+}
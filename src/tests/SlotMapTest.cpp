@@ -0,0 +1,173 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <Corrade/TestSuite/Tester.h>
+
+#include "esp/core/SlotMap.h"
+
+namespace Cr = Corrade;
+
+using esp::core::SlotMap;
+
+namespace Test {
+namespace {
+
+// stands in for a physics object queried through its id
+struct Object {
+  explicit Object(int value) : value{value} {}
+  virtual ~Object() = default;
+  virtual int getValue() const { return value; }
+  int value;
+};
+
+struct SlotMapTest : Cr::TestSuite::Tester {
+  explicit SlotMapTest();
+  // tests
+  void emplaceAt();
+  void erase();
+  void handles();
+  void clear();
+  // benchmarks of a per-object call, i.e. an id check and a lookup
+  void lookupStdMap();
+  void lookupSlotMap();
+
+  // number of objects in the benchmarks
+  const int numObjects_ = 500;
+  // the batch size when running benchmarks
+  const unsigned int iterations_ = 100;
+  std::map<int, std::unique_ptr<Object>> stdMap_;
+  SlotMap<std::unique_ptr<Object>> slotMap_;
+  std::vector<int> queries_;
+};
+
+SlotMapTest::SlotMapTest() {
+  // clang-format off
+  addTests({&SlotMapTest::emplaceAt,
+            &SlotMapTest::erase,
+            &SlotMapTest::handles,
+            &SlotMapTest::clear});
+  addBenchmarks({&SlotMapTest::lookupStdMap,
+                 &SlotMapTest::lookupSlotMap}, 10);
+  // clang-format on
+
+  for (int id = 0; id < numObjects_; ++id) {
+    stdMap_.emplace(id, std::make_unique<Object>(id));
+    slotMap_.emplace(id, std::make_unique<Object>(id));
+  }
+  // visit the objects in a scattered order
+  for (int i = 0; i < numObjects_; ++i) {
+    queries_.push_back((i * 7919) % numObjects_);
+  }
+}
+
+void SlotMapTest::emplaceAt() {
+  SlotMap<int> map;
+  CORRADE_VERIFY(map.empty());
+  CORRADE_VERIFY(map.emplace(3, 30).second);
+  CORRADE_VERIFY(map.emplace(0, 0).second);
+  // ids need not be contiguous and existing values are kept
+  auto existing = map.emplace(3, 31);
+  CORRADE_VERIFY(!existing.second);
+  CORRADE_COMPARE(*existing.first, 30);
+
+  CORRADE_COMPARE(map.size(), 2);
+  CORRADE_COMPARE(map.count(3), 1);
+  CORRADE_COMPARE(map.count(1), 0);
+  CORRADE_COMPARE(map.count(-1), 0);
+  CORRADE_COMPARE(map.count(100), 0);
+  CORRADE_COMPARE(map.at(3), 30);
+  CORRADE_VERIFY(!map.find(1));
+
+  bool thrown = false;
+  try {
+    map.at(1);
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  CORRADE_VERIFY(thrown);
+}
+
+void SlotMapTest::erase() {
+  SlotMap<int> map;
+  for (int id = 0; id < 4; ++id) {
+    map.emplace(id, id * 10);
+  }
+  CORRADE_COMPARE(map.erase(1), 1);
+  CORRADE_COMPARE(map.erase(1), 0);
+  CORRADE_COMPARE(map.size(), 3);
+  CORRADE_COMPARE(map.count(1), 0);
+  // the moved value is still found by its id
+  CORRADE_COMPARE(map.at(3), 30);
+  CORRADE_COMPARE(map.at(2), 20);
+
+  int sum = 0;
+  for (const auto& value : map) {
+    CORRADE_COMPARE(value.second, value.first * 10);
+    sum += value.first;
+  }
+  CORRADE_COMPARE(sum, 0 + 2 + 3);
+
+  // recycled id
+  CORRADE_VERIFY(map.emplace(1, 11).second);
+  CORRADE_COMPARE(map.at(1), 11);
+}
+
+void SlotMapTest::handles() {
+  SlotMap<int> map;
+  map.emplace(5, 50);
+  SlotMap<int>::Handle handle = map.getHandle(5);
+  CORRADE_COMPARE(handle.id, 5);
+  CORRADE_VERIFY(map.isValid(handle));
+  CORRADE_COMPARE(*map.get(handle), 50);
+  CORRADE_COMPARE(map.getHandle(4).id, -1);
+
+  // a handle doesn't resolve to a new value reusing its id
+  map.erase(5);
+  map.emplace(5, 51);
+  CORRADE_VERIFY(!map.isValid(handle));
+  CORRADE_VERIFY(!map.get(handle));
+  CORRADE_COMPARE(*map.get(map.getHandle(5)), 51);
+}
+
+void SlotMapTest::clear() {
+  SlotMap<int> map;
+  map.emplace(0, 0);
+  map.emplace(1, 10);
+  SlotMap<int>::Handle handle = map.getHandle(1);
+  map.clear();
+  CORRADE_VERIFY(map.empty());
+  CORRADE_COMPARE(map.count(1), 0);
+  map.emplace(1, 11);
+  CORRADE_VERIFY(!map.isValid(handle));
+}
+
+void SlotMapTest::lookupStdMap() {
+  int sum = 0;
+  CORRADE_BENCHMARK(iterations_) for (int id : queries_) {
+    if (stdMap_.count(id) > 0) {
+      sum += stdMap_.at(id)->getValue();
+    }
+  }
+  CORRADE_VERIFY(sum > 0);
+}
+
+void SlotMapTest::lookupSlotMap() {
+  int sum = 0;
+  CORRADE_BENCHMARK(iterations_) for (int id : queries_) {
+    if (slotMap_.count(id) > 0) {
+      sum += slotMap_.at(id)->getValue();
+    }
+  }
+  CORRADE_VERIFY(sum > 0);
+}
+
+}  // namespace
+}  // namespace Test
+
+CORRADE_TEST_MAIN(Test::SlotMapTest)
@@ -3,15 +3,26 @@
 // LICENSE file in the root directory of this source tree.
 
 #include <iostream>
+#include <set>
 #include <string>
 #include <unordered_map>
 
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/PluginManager/PluginMetadata.h>
+#include <Corrade/Utility/ConfigurationGroup.h>
+#include <Magnum/Trade/AbstractImporter.h>
+#include <Magnum/Trade/ImageData.h>
+#include <Magnum/Trade/TextureData.h>
+
 #include "SceneLoader.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
 #include "esp/assets/Mp3dInstanceMeshData.h"
+#include "esp/assets/TranscodedTextureCache.h"
 #include "esp/core/esp.h"
 #include "esp/nav/PathFinder.h"
 #include "esp/scene/SemanticScene.h"
@@ -20,6 +31,9 @@ using namespace esp::assets;
 using namespace esp::scene;
 using namespace esp::nav;
 
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
 int createNavMesh(const std::string& meshFile, const std::string& navmeshFile) {
   SceneLoader loader;
   const AssetInfo info = AssetInfo::fromPath(meshFile);
@@ -150,6 +164,71 @@ int createMp3dSemanticMesh(const std::string& plyFile,
   return 0;
 }
 
+int pretranscodeTextures(const std::string& assetFile,
+                         const std::string& cacheDir,
+                         const std::string& targetFormat) {
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImporter> importerManager
+#ifdef MAGNUM_BUILD_STATIC
+      // avoid using plugins that might depend on different library versions
+      {"nonexistent"}
+#endif
+  ;
+  // same plugin preferences as ResourceManager::loadRenderAssetGeneral()
+  importerManager.setPreferredPlugins("GltfImporter", {"TinyGltfImporter"});
+  Cr::PluginManager::PluginMetadata* const metadata =
+      importerManager.metadata("BasisImporter");
+  if (!metadata) {
+    LOG(ERROR) << "BasisImporter plugin not found";
+    return 1;
+  }
+  metadata->configuration().setValue("format", targetFormat);
+
+  Cr::Containers::Pointer<Mn::Trade::AbstractImporter> importer =
+      importerManager.loadAndInstantiate("AnySceneImporter");
+  if (!importer || !importer->openFile(assetFile)) {
+    LOG(ERROR) << "Cannot open file " << assetFile;
+    return 1;
+  }
+
+  TranscodedTextureCache cache{cacheDir};
+  std::set<unsigned int> images;
+  size_t numCached = 0;
+  for (unsigned int iTexture = 0; iTexture < importer->textureCount();
+       ++iTexture) {
+    Cr::Containers::Optional<Mn::Trade::TextureData> textureData =
+        importer->texture(iTexture);
+    if (!textureData ||
+        textureData->type() != Mn::Trade::TextureData::Type::Texture2D ||
+        !images.insert(textureData->image()).second) {
+      continue;
+    }
+
+    std::vector<Mn::Trade::ImageData2D> levels;
+    const unsigned int levelCount =
+        importer->image2DLevelCount(textureData->image());
+    for (unsigned int level = 0; level != levelCount; ++level) {
+      Cr::Containers::Optional<Mn::Trade::ImageData2D> image =
+          importer->image2D(textureData->image(), level);
+      if (!image) {
+        LOG(ERROR) << "Cannot load image " << textureData->image()
+                   << " level " << level << ", skipping";
+        levels.clear();
+        break;
+      }
+      levels.push_back(std::move(*image));
+    }
+    if (!levels.empty() && cache.save(assetFile, textureData->image(),
+                                      targetFormat, levels)) {
+      ++numCached;
+    }
+  }
+
+  LOG(INFO) << "Cached " << numCached << " of " << images.size()
+            << " images of " << assetFile << " as " << targetFormat << " in "
+            << cacheDir;
+  return numCached == images.size() ? 0 : 2;
+}
+
 int main(int argc, char** argv) {
   if (argc < 4) {
     std::cout << "Usage: datatool task input_file output_file" << std::endl;
@@ -174,6 +253,18 @@ int main(int argc, char** argv) {
       return 64;
     }
     createGibsonSemanticMesh(argv[2], argv[3], argv[4]);
+  } else if (task == "pretranscode_textures") {
+    // target format as named by the BasisImporter, e.g. Bc7RGBA, Etc2RGBA,
+    // Astc4x4RGBA or RGBA8, matching what the simulator picks for the GPU
+    if (argc < 5) {
+      std::cout << "Usage: datatool pretranscode_textures input_asset "
+                   "cache_dir target_format"
+                << std::endl;
+      return 64;
+    }
+    if (int result = pretranscodeTextures(argv[2], argv[3], argv[4])) {
+      return result;
+    }
   } else {
     LOG(ERROR) << "Unrecognized task " << task;
     return 1;
@@ -0,0 +1,326 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/Pointer.h>
+#include <Corrade/PluginManager/Manager.h>
+#include <Corrade/Utility/Arguments.h>
+#include <Corrade/Utility/Directory.h>
+#include <Corrade/Utility/String.h>
+#include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/Trade/AbstractImageConverter.h>
+
+#include "esp/agent/Agent.h"
+#include "esp/core/esp.h"
+#include "esp/gfx/replay/BinaryKeyframes.h"
+#include "esp/gfx/replay/Player.h"
+#include "esp/io/JsonAllTypes.h"
+#include "esp/io/json.h"
+#include "esp/sensor/Sensor.h"
+#include "esp/sim/Simulator.h"
+
+namespace Cr = Corrade;
+namespace Mn = Magnum;
+
+using esp::gfx::replay::Keyframe;
+
+namespace {
+
+/**
+ * @brief Bounded queue handing work from one pipeline stage to the next.
+ * Bounding it keeps a fast stage from running arbitrarily far ahead of a
+ * slow one.
+ */
+template <class T>
+class StageQueue {
+ public:
+  explicit StageQueue(std::size_t capacity) : capacity_(capacity) {}
+
+  //! Blocks while the queue is full
+  void push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notFull_.wait(lock, [&] { return items_.size() < capacity_; });
+    items_.push_back(std::move(item));
+    notEmpty_.notify_one();
+  }
+
+  //! Signal that no more items will be pushed
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    notEmpty_.notify_all();
+  }
+
+  //! Blocks while the queue is empty, false once it's empty and closed
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    notEmpty_.wait(lock, [&] { return !items_.empty() || closed_; });
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    notFull_.notify_one();
+    return true;
+  }
+
+ private:
+  std::size_t capacity_;
+  std::deque<T> items_;
+  bool closed_ = false;
+  std::mutex mutex_;
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+};
+
+struct EncodeJob {
+  std::string filepath;
+  Mn::PixelFormat format = Mn::PixelFormat::RGBA8Unorm;
+  Mn::Vector2i size;
+  Cr::Containers::Array<char> data;
+  //! Index of the converter to use, see main()
+  int converter = 0;
+};
+
+//! Read keyframes, from a binary file one at a time, from a JSON file all at
+//! once, and hand them over in order
+void decodeKeyframes(const std::string& filepath,
+                     StageQueue<Keyframe>& keyframes) {
+  if (esp::gfx::replay::isBinaryKeyframeFile(filepath)) {
+    esp::gfx::replay::BinaryKeyframeReader reader;
+    if (reader.open(filepath)) {
+      Keyframe keyframe;
+      for (int i = 0; i < reader.getNumKeyframes(); ++i) {
+        if (!reader.readKeyframe(i, keyframe)) {
+          break;
+        }
+        keyframes.push(std::move(keyframe));
+      }
+    }
+  } else {
+    std::vector<Keyframe> all;
+    try {
+      esp::io::readMember(esp::io::parseJsonFile(filepath), "keyframes", all);
+    } catch (...) {
+      LOG(ERROR) << "Failed to parse keyframes from " << filepath;
+    }
+    for (auto& keyframe : all) {
+      keyframes.push(std::move(keyframe));
+    }
+  }
+  keyframes.close();
+}
+
+void encodeImages(StageQueue<EncodeJob>& jobs,
+                  std::vector<Mn::Trade::AbstractImageConverter*> converters) {
+  EncodeJob job;
+  while (jobs.pop(job)) {
+    const Mn::ImageView2D image{
+        job.format, job.size,
+        Cr::Containers::ArrayView<const void>{job.data.data(),
+                                              job.data.size()}};
+    if (!converters[job.converter]->exportToFile(image, job.filepath)) {
+      LOG(ERROR) << "Failed to write " << job.filepath;
+    }
+  }
+}
+
+std::string imageFilepath(const std::string& outputDir,
+                          const std::string& sensorUuid,
+                          int keyframeIndex,
+                          const std::string& extension) {
+  std::ostringstream name;
+  name << sensorUuid << "_" << std::setw(6) << std::setfill('0')
+       << keyframeIndex << extension;
+  return Cr::Utility::Directory::join(outputDir, name.str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Cr::Utility::Arguments args;
+  args.addArgument("replay")
+      .setHelp("replay", "replay file to render, JSON or binary")
+      .addArgument("output-dir")
+      .setHelp("output-dir", "directory to write the images to")
+      .addOption("sensors", "color")
+      .setHelp("sensors",
+               "comma-separated sensors to render, color and/or depth")
+      .addOption("width", "640")
+      .setHelp("width", "image width")
+      .addOption("height", "480")
+      .setHelp("height", "image height")
+      .addOption("hfov", "90")
+      .setHelp("hfov", "horizontal field of view in degrees")
+      .addOption("camera-user-transform", "sensor")
+      .setHelp("camera-user-transform",
+               "name of the user transform to place the camera at, see "
+               "Recorder::addUserTransformToKeyframe. Keyframes without it "
+               "keep the previous camera placement.")
+      .addOption("encoder-threads", "2")
+      .setHelp("encoder-threads", "number of threads writing images")
+      .addOption("gpu-device-id", "0")
+      .setHelp("gpu-device-id", "GPU to render with")
+      .setGlobalHelp(
+          "Renders all keyframes of a gfx replay headlessly to image "
+          "sequences. Decoding keyframes and writing images happen on "
+          "separate threads while the main thread updates the scene and "
+          "renders.")
+      .parse(argc, argv);
+
+  const std::string replayFilepath = args.value("replay");
+  const std::string outputDir = args.value("output-dir");
+  const std::string cameraName = args.value("camera-user-transform");
+  const int width = args.value<int>("width");
+  const int height = args.value<int>("height");
+  const int numEncoderThreads = std::max(1, args.value<int>("encoder-threads"));
+  if (!Cr::Utility::Directory::exists(replayFilepath)) {
+    LOG(ERROR) << "Replay file " << replayFilepath << " not found";
+    return 1;
+  }
+  if (!Cr::Utility::Directory::mkpath(outputDir)) {
+    LOG(ERROR) << "Can't create output directory " << outputDir;
+    return 1;
+  }
+
+  // one sensor per requested observation, all at the agent's origin so the
+  // camera user transform places them directly
+  esp::agent::AgentConfiguration agentConfig;
+  agentConfig.sensorSpecifications.clear();
+  std::vector<std::string> extensions;
+  for (const std::string& name :
+       Cr::Utility::String::splitWithoutEmptyParts(args.value("sensors"),
+                                                   ',')) {
+    auto spec = esp::sensor::SensorSpec::create();
+    spec->uuid = name;
+    spec->position = {0, 0, 0};
+    spec->resolution = {height, width};
+    spec->parameters["hfov"] = args.value("hfov");
+    if (name == "color") {
+      spec->sensorType = esp::sensor::SensorType::Color;
+      extensions.emplace_back(".png");
+    } else if (name == "depth") {
+      spec->sensorType = esp::sensor::SensorType::Depth;
+      spec->channels = 1;
+      extensions.emplace_back(".hdr");
+    } else {
+      LOG(ERROR) << "Unsupported sensor " << name
+                 << ", expected color or depth";
+      return 1;
+    }
+    agentConfig.sensorSpecifications.push_back(spec);
+  }
+  if (agentConfig.sensorSpecifications.empty()) {
+    LOG(ERROR) << "No sensors to render";
+    return 1;
+  }
+
+  esp::sim::SimulatorConfiguration simConfig;
+  simConfig.activeSceneName = esp::assets::EMPTY_SCENE;
+  simConfig.gpuDeviceId = args.value<int>("gpu-device-id");
+  simConfig.createRenderer = true;
+  auto simulator = esp::sim::Simulator::create_unique(simConfig);
+  auto agent = simulator->addAgent(agentConfig);
+  esp::scene::SceneNode& cameraNode = agent->node();
+
+  esp::gfx::replay::Player player(
+      std::bind(&esp::sim::Simulator::loadAndCreateRenderAssetInstance,
+                simulator.get(), std::placeholders::_1,
+                std::placeholders::_2));
+
+  // converters are loaded here as plugin loading isn't thread-safe, each
+  // encoder thread then uses its own instances
+  Cr::PluginManager::Manager<Mn::Trade::AbstractImageConverter> manager;
+  std::vector<Cr::Containers::Pointer<Mn::Trade::AbstractImageConverter>>
+      converterStorage;
+  std::vector<std::vector<Mn::Trade::AbstractImageConverter*>> converters(
+      numEncoderThreads);
+  for (auto& threadConverters : converters) {
+    for (const std::string& extension : extensions) {
+      converterStorage.push_back(manager.loadAndInstantiate(
+          extension == ".png" ? "PngImageConverter" : "HdrImageConverter"));
+      if (!converterStorage.back()) {
+        LOG(ERROR) << "Can't load an image converter for " << extension;
+        return 1;
+      }
+      threadConverters.push_back(converterStorage.back().get());
+    }
+  }
+
+  // Each stage queue holds a few items only, enough to even out the time
+  // individual keyframes take in each stage.
+  StageQueue<Keyframe> keyframes{8};
+  StageQueue<EncodeJob> jobs{std::size_t(4 * numEncoderThreads)};
+  std::thread decoder{decodeKeyframes, std::cref(replayFilepath),
+                      std::ref(keyframes)};
+  std::vector<std::thread> encoders;
+  for (int i = 0; i < numEncoderThreads; ++i) {
+    encoders.emplace_back(encodeImages, std::ref(jobs), converters[i]);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  int keyframeIndex = 0;
+  Keyframe keyframe;
+  while (keyframes.pop(keyframe)) {
+    player.applyNextKeyframe(keyframe);
+    Mn::Vector3 translation;
+    Mn::Quaternion rotation;
+    if (player.getUserTransform(cameraName, &translation, &rotation)) {
+      cameraNode.setTranslation(translation);
+      cameraNode.setRotation(rotation);
+    }
+
+    for (std::size_t i = 0; i != agentConfig.sensorSpecifications.size();
+         ++i) {
+      const auto& spec = *agentConfig.sensorSpecifications[i];
+      esp::sensor::Observation observation;
+      if (!simulator->getAgentObservation(0, spec.uuid, observation)) {
+        LOG(ERROR) << "Failed to render " << spec.uuid << " for keyframe "
+                   << keyframeIndex;
+        continue;
+      }
+      // the sensor reuses its buffer for the next observation
+      const auto& buffer = observation.buffer->data;
+      EncodeJob job;
+      job.filepath =
+          imageFilepath(outputDir, spec.uuid, keyframeIndex, extensions[i]);
+      job.format = spec.sensorType == esp::sensor::SensorType::Depth
+                       ? Mn::PixelFormat::R32F
+                       : Mn::PixelFormat::RGBA8Unorm;
+      job.size = {width, height};
+      job.data = Cr::Containers::Array<char>{Cr::Containers::NoInit,
+                                             buffer.size()};
+      std::memcpy(job.data.data(), buffer.data(), buffer.size());
+      job.converter = i;
+      jobs.push(std::move(job));
+    }
+    ++keyframeIndex;
+  }
+
+  jobs.close();
+  decoder.join();
+  for (auto& encoder : encoders) {
+    encoder.join();
+  }
+
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  LOG(INFO) << "Rendered " << keyframeIndex << " keyframes in " << seconds
+            << " s, " << keyframeIndex / seconds << " keyframes per second";
+  return keyframeIndex ? 0 : 1;
+}
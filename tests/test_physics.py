@@ -172,6 +172,24 @@ def test_dynamics():
         sim.set_translation(np.array([-0.569043, 2.04804, 13.6156]), object_id)
         sim.set_translation(np.array([-0.569043, 2.04804, 12.6156]), object2_id)
 
+        # bulk state access agrees with the per-object getters
+        object_ids = [object_id, object2_id]
+        states = sim.get_rigid_states(object_ids)
+        assert states.shape == (2, 7)
+        for i, obj_id in enumerate(object_ids):
+            assert np.allclose(states[i, :3], sim.get_translation(obj_id))
+            rotation = sim.get_rotation(obj_id)
+            assert np.allclose(states[i, 3:6], rotation.vector)
+            assert np.isclose(states[i, 6], rotation.scalar)
+        assert sim.get_rigid_states(object_ids, include_velocities=True).shape == (
+            2,
+            13,
+        )
+        # swapping the states swaps the objects
+        sim.set_rigid_states(object_ids, states[::-1])
+        assert np.allclose(sim.get_rigid_states(object_ids), states[::-1])
+        sim.set_rigid_states(object_ids, states)
+
         # get object MotionType and continue testing if MotionType::DYNAMIC (implies a physics implementation is active)
         if (
             sim.get_object_motion_type(object_id)
@@ -268,6 +286,36 @@ def test_dynamics():
             sim.step_physics(0.1)
             assert sim.get_translation(object_id)[0] > new_object_start[0]
 
+            # restoring a snapshot rewinds the world, removing newer objects
+            snapshot = sim.save_physics_state()
+            snapshot_states = sim.get_rigid_states(
+                object_ids, include_velocities=True
+            )
+            snapshot_time = sim.get_world_time()
+            sim.step_physics(0.1)
+            object3_id = sim.add_object_by_handle(obj_handle_list[0])
+            assert sim.restore_physics_state(snapshot)
+            assert sim.get_existing_object_ids() == object_ids
+            assert sim.get_world_time() == snapshot_time
+            assert np.allclose(
+                sim.get_rigid_states(object_ids, include_velocities=True),
+                snapshot_states,
+            )
+            # stepping from the restored state is repeatable, up to contact
+            # caches which aren't part of the snapshot
+            sim.step_physics(0.1)
+            stepped_states = sim.get_rigid_states(object_ids)
+            assert sim.restore_physics_state(snapshot)
+            sim.step_physics(0.1)
+            assert np.allclose(
+                sim.get_rigid_states(object_ids), stepped_states, atol=1e-3
+            )
+
+            # a snapshot with a removed object can't be restored
+            sim.remove_object(object2_id)
+            assert not sim.restore_physics_state(snapshot)
+            assert sim.get_existing_object_ids() == [object_id]
+
 
 def test_velocity_control():
     cfg_settings = examples.settings.default_sim_settings.copy()
@@ -413,6 +461,36 @@ def test_raycast():
             assert abs(raycast_results.hits[0].ray_distance - 2.8935) < 0.001
             assert raycast_results.hits[0].object_id == 0
 
+            # batched raycast must agree with the single ray version
+            test_rays = [test_ray_1] * 500
+            batch_results = sim.cast_rays(test_rays)
+            assert batch_results.num_rays == 500
+            assert batch_results.num_hits() == 500 * 2
+            assert np.all(np.diff(batch_results.ray_hit_offsets) == 2)
+            assert np.allclose(
+                batch_results.points[0], raycast_results.hits[0].point, atol=0.001
+            )
+            assert np.all(batch_results.object_ids[0::2] == 0)
+            assert np.all(batch_results.object_ids[1::2] == -1)
+
+            # casting into reused results gives the same hits
+            reused_results = habitat_sim.physics.BatchRaycastResults()
+            for _ in range(2):
+                sim.cast_rays(test_rays, reused_results)
+                assert np.array_equal(
+                    reused_results.object_ids, batch_results.object_ids
+                )
+                assert np.allclose(reused_results.points, batch_results.points)
+
+            closest_results = sim.cast_rays(
+                np.array([[0, 0, 0]] * 500), np.array([[1.0, 0, 0]] * 500),
+                closest_only=True,
+            )
+            assert closest_results.num_hits() == 500
+            assert np.allclose(
+                closest_results.ray_distances, raycast_results.hits[0].ray_distance
+            )
+
             # test raycast against a non-collidable object.
             # should not register a hit with the object.
             sim.set_object_is_collidable(False, cube_obj_id)